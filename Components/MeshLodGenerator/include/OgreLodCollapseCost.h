@@ -44,9 +44,9 @@ namespace Ogre
 class _OgreLodExport LodCollapseCost {
 public:
     virtual ~LodCollapseCost() {}
-    /// This is called after the LodInputProvider has initialized LodData.
+    /// This is called after the LodInputProvider has initialized LodData. computeVertexCollapseCost is called from multiple threads here.
     virtual void initCollapseCosts(LodData* data);
-    /// Called from initCollapseCosts for every edge.
+    /// Computes the cost of a single vertex and adds it to the heap. initCollapseCosts does this for all vertices at once in parallel.
     virtual void initVertexCollapseCost(LodData* data, LodData::Vertex* vertex);
     /// Called when edge cost gets invalid.
     virtual void updateVertexCollapseCost(LodData* data, LodData::Vertex* vertex);
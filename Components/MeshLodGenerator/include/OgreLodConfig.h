@@ -163,6 +163,9 @@ struct _OgreLodExport LodConfig {
         Ogre::Real outsideWalkAngle;
         /// If the algorithm makes errors, you can fix it, by adding the edge to the profile.
         LodProfile profile;
+        /// Reorder triangles and vertices of the mesh with MeshOptimiser once the Lod levels are injected.
+        /// Levels sharing a compressed index buffer keep their triangle order. (disabled by default)
+        bool optimiseVertexCache;
         Advanced();
     } advanced;
 };
@@ -62,11 +62,11 @@ struct _OgreLodExport LodData {
     struct Triangle;
     struct VertexHash;
     struct VertexEqual;
+    class CollapseCostHeap;
 
     typedef std::vector<Vertex> VertexList;
     typedef std::vector<Triangle> TriangleList;
     typedef std::unordered_set<Vertex*, VertexHash, VertexEqual> UniqueVertexSet;
-    typedef std::multimap<Real, Vertex*> CollapseCostHeap;
 
     typedef VectorSet<Edge, 8> VEdges;
     typedef VectorSet<Triangle*, 7> VTriangles;
@@ -106,7 +106,7 @@ struct _OgreLodExport LodData {
         
         Vertex* collapseTo;
         bool seam;
-        CollapseCostHeap::iterator costHeapPosition; /// Iterator pointing to the position in the mCollapseCostSet, which allows fast remove.
+        size_t costHeapPosition; /// Position in the mCollapseCostHeap, which allows fast update and remove.
 
         void addEdge(const Edge& edge);
         void removeEdge(const Edge& edge);
@@ -133,6 +133,70 @@ struct _OgreLodExport LodData {
         bool isMalformed();
     };
 
+    /** Indexed 4-ary min-heap of the vertices by collapse cost.
+
+        Each vertex in the heap knows its position, so a changed cost is restored in place
+        instead of erasing and reinserting it. Entries of equal cost keep their insertion
+        order like in a std::multimap, which keeps the generated Lod levels deterministic.
+    */
+    class _OgreLodExport CollapseCostHeap {
+    public:
+        /// costHeapPosition of vertices not in the heap.
+        static const size_t INVALID_POSITION = ~size_t(0);
+
+        struct Entry {
+            Real cost;
+            uint64 order; /// Insertion stamp, orders entries of equal cost.
+            Vertex* vertex;
+        };
+        typedef std::vector<Entry> EntryList;
+        typedef EntryList::const_iterator const_iterator;
+
+        CollapseCostHeap() : mOrder(0) {}
+
+        size_t size() const { return mEntries.size(); }
+        bool empty() const { return mEntries.empty(); }
+        void clear() { mEntries.clear(); mOrder = 0; }
+        void reserve(size_t count) { mEntries.reserve(count); }
+
+        /// The entry with the lowest collapse cost.
+        const Entry& top() const { return mEntries.front(); }
+
+        /// Unordered iteration over all entries.
+        const_iterator begin() const { return mEntries.begin(); }
+        const_iterator end() const { return mEntries.end(); }
+
+        bool contains(const Vertex* vertex) const { return vertex->costHeapPosition != INVALID_POSITION; }
+        Real getCost(const Vertex* vertex) const { return mEntries[vertex->costHeapPosition].cost; }
+
+        void push(Vertex* vertex, Real cost);
+        /// Changes the cost of a vertex in the heap. It is ordered behind the entries of equal cost afterwards.
+        void update(Vertex* vertex, Real cost);
+        void erase(Vertex* vertex);
+
+        /// Adds a vertex without ordering it, build() has to be called before the heap is used.
+        void append(Vertex* vertex, Real cost);
+        /// Orders all entries in linear time, cheaper than pushing them one by one.
+        void build();
+    private:
+        static const size_t ARITY = 4;
+
+        static bool less(const Entry& a, const Entry& b)
+        {
+            return a.cost < b.cost || (a.cost == b.cost && a.order < b.order);
+        }
+        void place(size_t pos, const Entry& entry)
+        {
+            mEntries[pos] = entry;
+            entry.vertex->costHeapPosition = pos;
+        }
+        void siftUp(size_t pos);
+        void siftDown(size_t pos);
+
+        EntryList mEntries;
+        uint64 mOrder;
+    };
+
     union IndexBufferPointer {
         unsigned short* pshort;
         unsigned int* pint;
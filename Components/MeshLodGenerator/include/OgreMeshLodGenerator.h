@@ -35,6 +35,7 @@
 #include "OgreLodOutputProvider.h"
 #include "OgreLodCollapseCost.h"
 #include "OgreLodCollapser.h"
+#include "OgreLodConfig.h"
 #include "OgreSharedPtr.h"
 #include "OgreSingleton.h"
 
@@ -57,6 +58,38 @@ public:
     static MeshLodGenerator* getSingletonPtr();
     static MeshLodGenerator& getSingleton();
 
+    /**
+     * @brief Outcome of a single mesh of generateBatchLodLevels().
+     */
+    struct BatchResult {
+        String meshName;
+        /// The generated levels, including their out* statistics.
+        LodConfig::LodLevelList levels;
+        /// Milliseconds spent loading the mesh and copying its buffers on the calling thread.
+        unsigned long prepareTime;
+        /// Milliseconds spent generating the Lod levels on a worker.
+        unsigned long processTime;
+        /// Milliseconds spent injecting the Lod levels into the mesh on the calling thread.
+        unsigned long injectTime;
+        /// Empty on success, the exception message otherwise.
+        String error;
+
+        BatchResult() : prepareTime(0), processTime(0), injectTime(0) {}
+    };
+    typedef std::vector<BatchResult> BatchResultList;
+
+    /**
+     * @brief Provides the meshes of generateBatchLodLevels(). Called on the calling thread only.
+     */
+    class _OgreLodExport BatchListener {
+    public:
+        virtual ~BatchListener() {}
+        /// Returns the mesh with the given index. Loading it here keeps only the meshes in flight in memory.
+        virtual MeshPtr loadMesh(size_t index) = 0;
+        /// Called once the Lod levels are injected or the mesh failed, e.g. to save and unload it.
+        virtual void meshCompleted(size_t index, const MeshPtr& mesh, const BatchResult& result) {}
+    };
+
     /**
      * @brief Generates the Lod levels for a mesh.
      */
@@ -68,6 +101,35 @@ public:
      */
     virtual void generateLodLevels(LodConfig& lodConfig, LodCollapseCostPtr cost = LodCollapseCostPtr(), LodDataPtr data = LodDataPtr(), LodInputProviderPtr input = LodInputProviderPtr(), LodOutputProviderPtr output = LodOutputProviderPtr(), LodCollapserPtr collapser = LodCollapserPtr());
 
+    /**
+     * @brief Generates the Lod levels of many meshes concurrently.
+     *
+     * Every mesh is reduced with a copy of lodTemplate on one of the worker threads. Its buffers are
+     * copied before and the compressed or plain Lod index buffers are injected after that on the
+     * calling thread, so no render system calls happen on the workers. Failing meshes are reported
+     * in their result without stopping the batch.
+     *
+     * @param meshCount Number of meshes the listener provides.
+     * @param listener Loads the meshes and gets notified when they are done.
+     * @param lodTemplate Lod configuration applied to all meshes, its mesh is ignored.
+     *     Without levels each mesh gets the levels of getAutoconfig().
+     * @param results Receives the per mesh results in listener index order.
+     * @param workerCount Number of worker threads, 0 uses all hardware threads.
+     * @param memoryBudget Approximate bytes of working memory of all meshes in flight, 0 for no limit.
+     *     A mesh exceeding the budget alone is still processed, just not in parallel with others.
+     */
+    void generateBatchLodLevels(size_t meshCount, BatchListener* listener, const LodConfig& lodTemplate,
+                                BatchResultList& results, size_t workerCount = 0, size_t memoryBudget = 0);
+
+    /// @overload
+    void generateBatchLodLevels(const std::vector<MeshPtr>& meshes, const LodConfig& lodTemplate,
+                                BatchResultList& results, size_t workerCount = 0, size_t memoryBudget = 0);
+
+    /**
+     * @brief Approximate working memory needed to generate the Lod levels of a mesh.
+     */
+    static size_t estimateMemoryUsage(const MeshPtr& mesh);
+
     /**
      * @brief Generates the Lod levels for a mesh without configuring it.
      *
@@ -27,17 +27,34 @@
  */
 
 #include "OgreMeshLodPrecompiledHeaders.h"
+#include "OgreParallel.h"
 
 namespace Ogre
 {
     void LodCollapseCost::initCollapseCosts( LodData* data )
     {
+        // The vertex costs only read the mesh, so they are computed in parallel. The heap is
+        // filled in vertex order afterwards to get the same Lod levels on any thread count.
+        size_t vertexCount = data->mVertexList.size();
+        std::vector<Real> collapseCosts(vertexCount);
+        parallelFor(vertexCount, 1024, [this, data, &collapseCosts](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                LodData::Vertex* vertex = &data->mVertexList[i];
+                if (!vertex->edges.empty()) {
+                    collapseCosts[i] = LodData::UNINITIALIZED_COLLAPSE_COST;
+                    vertex->collapseTo = NULL;
+                    computeVertexCollapseCost(data, vertex, collapseCosts[i], vertex->collapseTo);
+                }
+            }
+        });
+
         data->mCollapseCostHeap.clear();
+        data->mCollapseCostHeap.reserve(vertexCount);
         LodData::VertexList::iterator it = data->mVertexList.begin();
         LodData::VertexList::iterator itEnd = data->mVertexList.end();
         for (; it != itEnd; it++) {
             if (!it->edges.empty()) {
-                initVertexCollapseCost(data, &*it);
+                data->mCollapseCostHeap.append(&*it, collapseCosts[it - data->mVertexList.begin()]);
             } else {
 #if OGRE_DEBUG_MODE
                 LogManager::getSingleton().stream() << "In " << data->mMeshName << " never used vertex found with ID: " << data->mCollapseCostHeap.size() << ". "
@@ -49,6 +66,7 @@ namespace Ogre
 #endif
             }
         }
+        data->mCollapseCostHeap.build();
     }
 
     void LodCollapseCost::computeVertexCollapseCost( LodData* data, LodData::Vertex* vertex, Real& collapseCost, LodData::Vertex*& collapseTo )
@@ -71,7 +89,7 @@ namespace Ogre
         computeVertexCollapseCost(data, vertex, collapseCost, collapseTo);
 
         vertex->collapseTo = collapseTo;
-        vertex->costHeapPosition = data->mCollapseCostHeap.emplace(collapseCost, vertex);
+        data->mCollapseCostHeap.push(vertex, collapseCost);
     }
 
     void LodCollapseCost::updateVertexCollapseCost( LodData* data, LodData::Vertex* vertex )
@@ -80,16 +98,15 @@ namespace Ogre
         LodData::Vertex* collapseTo = NULL;
         computeVertexCollapseCost(data, vertex, collapseCost, collapseTo);
 
-        if (vertex->collapseTo != collapseTo || collapseCost != vertex->costHeapPosition->first) {
-            OgreAssert(vertex->costHeapPosition != data->mCollapseCostHeap.end(), "");
-            data->mCollapseCostHeap.erase(vertex->costHeapPosition);
+        if (vertex->collapseTo != collapseTo || collapseCost != data->mCollapseCostHeap.getCost(vertex)) {
+            OgreAssert(data->mCollapseCostHeap.contains(vertex), "");
             if (collapseCost != LodData::UNINITIALIZED_COLLAPSE_COST) {
                 vertex->collapseTo = collapseTo;
-                vertex->costHeapPosition = data->mCollapseCostHeap.emplace(collapseCost, vertex);
+                data->mCollapseCostHeap.update(vertex, collapseCost);
             } else {
+                data->mCollapseCostHeap.erase(vertex);
 #if OGRE_DEBUG_MODE
                 vertex->collapseTo = NULL;
-                vertex->costHeapPosition = data->mCollapseCostHeap.end();
 #endif
             }
         }
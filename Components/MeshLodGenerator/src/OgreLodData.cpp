@@ -118,4 +118,105 @@ bool LodData::Edge::operator== (const LodData::Edge& other) const
     return dst == other.dst;
 }
 
+void LodData::CollapseCostHeap::push(Vertex* vertex, Real cost)
+{
+    append(vertex, cost);
+    siftUp(mEntries.size() - 1);
+}
+
+void LodData::CollapseCostHeap::update(Vertex* vertex, Real cost)
+{
+    size_t pos = vertex->costHeapPosition;
+    OgreAssertDbg(pos < mEntries.size() && mEntries[pos].vertex == vertex, "Vertex is not in the heap");
+    Entry& entry = mEntries[pos];
+    // The new stamp moves it behind its equals, so an unchanged cost still sifts down.
+    bool increased = !(cost < entry.cost);
+    entry.cost = cost;
+    entry.order = mOrder++;
+    if (increased) {
+        siftDown(pos);
+    } else {
+        siftUp(pos);
+    }
+}
+
+void LodData::CollapseCostHeap::erase(Vertex* vertex)
+{
+    size_t pos = vertex->costHeapPosition;
+    OgreAssertDbg(pos < mEntries.size() && mEntries[pos].vertex == vertex, "Vertex is not in the heap");
+    vertex->costHeapPosition = INVALID_POSITION;
+    Entry last = mEntries.back();
+    mEntries.pop_back();
+    if (pos == mEntries.size()) {
+        return;
+    }
+    bool increased = !less(last, mEntries[pos]);
+    place(pos, last);
+    if (increased) {
+        siftDown(pos);
+    } else {
+        siftUp(pos);
+    }
+}
+
+void LodData::CollapseCostHeap::append(Vertex* vertex, Real cost)
+{
+    Entry entry;
+    entry.cost = cost;
+    entry.order = mOrder++;
+    entry.vertex = vertex;
+    vertex->costHeapPosition = mEntries.size();
+    mEntries.push_back(entry);
+}
+
+void LodData::CollapseCostHeap::build()
+{
+    if (mEntries.size() < 2) {
+        return;
+    }
+    // Sift down every parent, starting with the last one.
+    for (size_t pos = (mEntries.size() - 2) / ARITY + 1; pos-- > 0;) {
+        siftDown(pos);
+    }
+}
+
+void LodData::CollapseCostHeap::siftUp(size_t pos)
+{
+    Entry entry = mEntries[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / ARITY;
+        if (!less(entry, mEntries[parent])) {
+            break;
+        }
+        place(pos, mEntries[parent]);
+        pos = parent;
+    }
+    place(pos, entry);
+}
+
+void LodData::CollapseCostHeap::siftDown(size_t pos)
+{
+    Entry entry = mEntries[pos];
+    size_t count = mEntries.size();
+    for (;;) {
+        size_t first = pos * ARITY + 1;
+        if (first >= count) {
+            break;
+        }
+        size_t last = std::min(first + ARITY, count);
+        size_t best = first;
+        for (size_t child = first + 1; child < last; child++) {
+            if (less(mEntries[child], mEntries[best])) {
+                best = child;
+            }
+        }
+        if (!less(mEntries[best], entry)) {
+            break;
+        }
+        place(pos, mEntries[best]);
+        pos = best;
+    }
+    place(pos, entry);
+}
+
 }
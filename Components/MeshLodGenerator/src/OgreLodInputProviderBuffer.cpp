@@ -135,7 +135,7 @@ namespace Ogre
                 }
             } else {
 #if OGRE_DEBUG_MODE
-                v->costHeapPosition = data->mCollapseCostHeap.end();
+                v->costHeapPosition = LodData::CollapseCostHeap::INVALID_POSITION;
 #endif
                 v->seam = false;
                 if(data->mUseVertexNormals){
@@ -147,11 +147,8 @@ namespace Ogre
         for (; vertex < vEnd; vertex += vSize) {
             float* pFloat;
             elemPos->baseVertexPointerToElement(vertex, &pFloat);
-            data->mVertexList.push_back(LodData::Vertex());
+            data->mVertexList.push_back({Vector3(pFloat[0], pFloat[1], pFloat[2]), Vector3::ZERO});
             LodData::Vertex* v = &data->mVertexList.back();
-            v->position.x = pFloat[0];
-            v->position.y = pFloat[1];
-            v->position.z = pFloat[2];
             std::pair<LodData::UniqueVertexSet::iterator, bool> ret;
             ret = data->mUniqueVertexSet.insert(v);
             if (!ret.second) {
@@ -162,7 +159,7 @@ namespace Ogre
             } else {
 #if OGRE_DEBUG_MODE
                 // Needed for an assert, don't remove it.
-                v->costHeapPosition = data->mCollapseCostHeap.end();
+                v->costHeapPosition = LodData::CollapseCostHeap::INVALID_POSITION;
 #endif
                 v->seam = false;
             }
@@ -73,6 +73,9 @@ namespace Ogre
 
         request->output->inject();
         MeshLodGenerator::_configureMeshLodUsage(request->config);
+        if(request->config.advanced.optimiseVertexCache) {
+            MeshOptimiser().optimise(request->config.mesh.get());
+        }
         //lodConfig.mesh->buildEdgeList();
 
         if(mInjectorListener){
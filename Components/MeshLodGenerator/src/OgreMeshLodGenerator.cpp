@@ -27,6 +27,15 @@
  */
 
 #include "OgreMeshLodPrecompiledHeaders.h"
+#include "OgreTimer.h"
+
+#include <deque>
+
+#if OGRE_THREAD_SUPPORT
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 namespace Ogre
 {
@@ -186,6 +195,9 @@ void MeshLodGenerator::_process(LodConfig& lodConfig,
         // This will be processed in LodWorkQueueInjector if we use background queue.
         output->inject();
         _configureMeshLodUsage(lodConfig);
+        if(lodConfig.advanced.optimiseVertexCache) {
+            MeshOptimiser().optimise(lodConfig.mesh.get());
+        }
         //lodConfig.mesh->buildEdgeList();
     }
 }
@@ -301,6 +313,241 @@ void MeshLodGenerator::_generateManualLodLevels(LodConfig& lodConfig)
     _configureMeshLodUsage(lodConfig);
 }
 
+namespace
+{
+/// A mesh of generateBatchLodLevels() with its generator components.
+struct LodBatchJob {
+    size_t index;
+    size_t memory;
+    LodConfig config;
+    LodCollapseCostPtr cost;
+    LodDataPtr data;
+    LodInputProviderPtr input;
+    LodOutputProviderPtr output;
+    LodCollapserPtr collapser;
+    MeshLodGenerator::BatchResult result;
+};
+
+/// Adapts a list of loaded meshes to a BatchListener.
+class LodMeshListBatchListener : public MeshLodGenerator::BatchListener
+{
+    const std::vector<MeshPtr>& mMeshes;
+public:
+    LodMeshListBatchListener(const std::vector<MeshPtr>& meshes) : mMeshes(meshes) {}
+    MeshPtr loadMesh(size_t index) override { return mMeshes[index]; }
+};
+}
+
+size_t MeshLodGenerator::estimateMemoryUsage(const MeshPtr& mesh)
+{
+    size_t vertexCount = mesh->sharedVertexData ? mesh->sharedVertexData->vertexCount : 0;
+    size_t indexCount = 0;
+    for (SubMesh* submesh : mesh->getSubMeshes()) {
+        if (!submesh->useSharedVertices) {
+            vertexCount += submesh->vertexData->vertexCount;
+        }
+        indexCount += submesh->indexData->indexCount;
+    }
+    // LodData with the copied input buffers, plus the output index buffers of a few Lod levels.
+    return vertexCount * (sizeof(LodData::Vertex) + 2 * sizeof(Vector3)) +
+        indexCount / 3 * sizeof(LodData::Triangle) + indexCount * sizeof(uint32) * 4;
+}
+
+void MeshLodGenerator::generateBatchLodLevels(const std::vector<MeshPtr>& meshes, const LodConfig& lodTemplate,
+                                              BatchResultList& results, size_t workerCount, size_t memoryBudget)
+{
+    LodMeshListBatchListener listener(meshes);
+    generateBatchLodLevels(meshes.size(), &listener, lodTemplate, results, workerCount, memoryBudget);
+}
+
+void MeshLodGenerator::generateBatchLodLevels(size_t meshCount, BatchListener* listener, const LodConfig& lodTemplate,
+                                              BatchResultList& results, size_t workerCount, size_t memoryBudget)
+{
+    OgreAssert(listener, "A BatchListener is needed");
+    results.clear();
+    results.resize(meshCount);
+
+    if (workerCount == 0) {
+        workerCount = std::max<size_t>(OGRE_THREAD_HARDWARE_CONCURRENCY, 1);
+    }
+    workerCount = std::min(workerCount, meshCount);
+
+    // Loads the mesh and copies its buffers on this thread, as render systems may not be accessed by the workers.
+    auto prepare = [this, listener, &lodTemplate](size_t index) {
+        std::unique_ptr<LodBatchJob> job(new LodBatchJob());
+        Timer timer;
+        job->index = index;
+        job->memory = 0;
+        job->config = lodTemplate;
+        job->config.advanced.useBackgroundQueue = true;
+        try {
+            job->config.mesh = listener->loadMesh(index);
+            OgreAssert(job->config.mesh, "BatchListener returned no mesh");
+            job->result.meshName = job->config.mesh->getName();
+            if (job->config.levels.empty()) {
+                getAutoconfig(job->config.mesh, job->config);
+            }
+            bool hasGeneratedLevels = false;
+            for (const LodLevel& level : job->config.levels) {
+                hasGeneratedLevels = hasGeneratedLevels || level.manualMeshName.empty();
+            }
+            if (hasGeneratedLevels) {
+                job->memory = estimateMemoryUsage(job->config.mesh);
+                _resolveComponents(job->config, job->cost, job->data, job->input, job->output, job->collapser);
+            } else {
+                _generateManualLodLevels(job->config);
+            }
+        } catch (const std::exception& e) {
+            job->result.error = e.what();
+        }
+        job->result.prepareTime = timer.getMilliseconds();
+        return job;
+    };
+    auto process = [this](LodBatchJob* job) {
+        Timer timer;
+        if (job->input && job->result.error.empty()) {
+            try {
+                _process(job->config, job->cost.get(), job->data.get(), job->input.get(), job->output.get(), job->collapser.get());
+            } catch (const std::exception& e) {
+                job->result.error = e.what();
+            }
+        }
+        job->result.processTime = timer.getMilliseconds();
+    };
+    auto finish = [listener, &results](std::unique_ptr<LodBatchJob> job) {
+        Timer timer;
+        if (job->output && job->result.error.empty()) {
+            try {
+                job->output->inject();
+                _configureMeshLodUsage(job->config);
+                if (job->config.advanced.optimiseVertexCache) {
+                    MeshOptimiser().optimise(job->config.mesh.get());
+                }
+            } catch (const std::exception& e) {
+                job->result.error = e.what();
+            }
+        }
+        job->result.injectTime = timer.getMilliseconds();
+        job->result.levels = job->config.levels;
+        BatchResult& result = results[job->index];
+        result = job->result;
+        MeshPtr mesh = job->config.mesh;
+        size_t index = job->index;
+        // Free the working data before the listener gets the chance to unload the mesh.
+        job.reset();
+        listener->meshCompleted(index, mesh, result);
+    };
+
+    size_t next = 0;
+    size_t inFlight = 0;
+    size_t memoryInFlight = 0;
+    std::unique_ptr<LodBatchJob> waiting; // Prepared, but exceeding the memory budget.
+    std::deque<LodBatchJob*> queued;
+    std::deque<LodBatchJob*> finished;
+
+#if OGRE_THREAD_SUPPORT
+    std::mutex mutex;
+    std::condition_variable wakeWorker;
+    std::condition_variable wakeCaller;
+    bool quit = false;
+    std::vector<std::thread> workers;
+
+    // Jobs are owned by the queues while in flight, so stop the workers before leaving in any case.
+    struct WorkerGuard {
+        std::mutex& mutex;
+        std::condition_variable& wakeWorker;
+        bool& quit;
+        std::vector<std::thread>& workers;
+        std::deque<LodBatchJob*>& queued;
+        std::deque<LodBatchJob*>& finished;
+        ~WorkerGuard()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                quit = true;
+            }
+            wakeWorker.notify_all();
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            for (LodBatchJob* job : queued) {
+                delete job;
+            }
+            for (LodBatchJob* job : finished) {
+                delete job;
+            }
+        }
+    } guard = { mutex, wakeWorker, quit, workers, queued, finished };
+
+    if (workerCount > 1) {
+        for (size_t i = 0; i < workerCount; i++) {
+            workers.emplace_back([&]() {
+                std::unique_lock<std::mutex> lock(mutex);
+                for (;;) {
+                    wakeWorker.wait(lock, [&]() { return quit || !queued.empty(); });
+                    if (quit) {
+                        return;
+                    }
+                    LodBatchJob* job = queued.front();
+                    queued.pop_front();
+                    lock.unlock();
+                    process(job);
+                    lock.lock();
+                    finished.push_back(job);
+                    wakeCaller.notify_one();
+                }
+            });
+        }
+    }
+#endif
+
+    while (next < meshCount || waiting || inFlight) {
+        // Start as many meshes as the workers and the memory budget allow.
+        while (inFlight < std::max<size_t>(workerCount, 1) && (waiting || next < meshCount)) {
+            if (!waiting) {
+                waiting = prepare(next++);
+            }
+            if (inFlight && memoryBudget && memoryInFlight + waiting->memory > memoryBudget) {
+                break;
+            }
+            inFlight++;
+            memoryInFlight += waiting->memory;
+#if OGRE_THREAD_SUPPORT
+            if (!workers.empty()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    queued.push_back(waiting.release());
+                }
+                wakeWorker.notify_one();
+                continue;
+            }
+#endif
+            process(waiting.get());
+            finished.push_back(waiting.release());
+        }
+
+        std::deque<std::unique_ptr<LodBatchJob> > done;
+        {
+#if OGRE_THREAD_SUPPORT
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCaller.wait(lock, [&]() { return !finished.empty(); });
+#endif
+            for (LodBatchJob* job : finished) {
+                done.emplace_back(job);
+            }
+            finished.clear();
+        }
+        // Inject on this thread, the workers continue meanwhile.
+        while (!done.empty()) {
+            std::unique_ptr<LodBatchJob> job = std::move(done.front());
+            done.pop_front();
+            inFlight--;
+            memoryInFlight -= job->memory;
+            finish(std::move(job));
+        }
+    }
+}
+
 void MeshLodGenerator::_initWorkQueue()
 {
     if (!LodWorkQueueWorker::getSingletonPtr()) {
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreMesh.h"
 #include "OgreSubMesh.h"
 #include "OgreLogManager.h"
+#include "OgreMeshOptimiser.h"
 
 #include "OgreMeshLodGenerator.h"
 #include "OgreLodWorkQueueWorker.h"
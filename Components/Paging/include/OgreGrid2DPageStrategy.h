@@ -237,6 +237,9 @@ namespace Ogre
         void destroyData(PageStrategyData* d);
         void updateDebugDisplay(Page* p, SceneNode* sn);
         PageID getPageID(const Vector3& worldPos, PagedWorldSection* section);
+    protected:
+        /// For subclasses which reuse the grid under a different strategy name
+        Grid2DPageStrategy(const String& name, PageManager* manager);
     };
 
     /** @} */
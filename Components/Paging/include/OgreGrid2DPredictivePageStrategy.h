@@ -0,0 +1,106 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_Grid2DPredictivePageStrategy_H__
+#define __Ogre_Grid2DPredictivePageStrategy_H__
+
+#include "OgrePagingPrerequisites.h"
+#include "OgreGrid2DPageStrategy.h"
+
+namespace Ogre
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Paging
+    *  Some details on paging component
+    *  @{
+    */
+
+    /** Page strategy which loads pages of a regular 2D grid ahead of a moving camera.
+    @remarks
+        This uses the same Grid2DPageStrategyData as Grid2DPageStrategy, so it can
+        replace it on any existing section. The velocity of every camera is tracked
+        and the load and hold radii are applied both around the camera and around
+        the position it will reach after the look ahead time.
+    @par
+        Only a limited number of page loads are in flight per section. Missing pages
+        are requested closest first, where pages around the predicted position count
+        as closer than those behind the camera. Pending loads of pages which fell out
+        of the load range are cancelled, so they do not hold up the WorkQueue.
+    */
+    class _OgrePagingExport Grid2DPredictivePageStrategy : public Grid2DPageStrategy
+    {
+    public:
+        Grid2DPredictivePageStrategy(PageManager* manager);
+
+        ~Grid2DPredictivePageStrategy();
+
+        // Overridden members
+        void frameEnd(Real timeElapsed, PagedWorldSection* section);
+        void notifyCamera(Camera* cam, PagedWorldSection* section);
+
+        /** Set how many seconds ahead the camera position is predicted (default 2). */
+        void setLookAheadTime(Real seconds) { mLookAheadTime = seconds; }
+        /** Get how many seconds ahead the camera position is predicted. */
+        Real getLookAheadTime() const { return mLookAheadTime; }
+
+        /** Set the number of page loads which may be in flight per section (default 4).
+        @remarks
+            Lower values let the strategy react faster to changes of direction,
+            higher values keep more WorkQueue threads busy.
+        */
+        void setMaxPendingLoads(size_t count) { mMaxPendingLoads = count; }
+        /** Get the number of page loads which may be in flight per section. */
+        size_t getMaxPendingLoads() const { return mMaxPendingLoads; }
+
+        /** Get the current velocity of a camera as seen by this strategy.
+        @return The smoothed velocity in world units per second, or zero if the
+            camera is not tracked for this section.
+        */
+        Vector3 getCameraVelocity(const Camera* cam, const PagedWorldSection* section) const;
+
+    private:
+        struct CameraState
+        {
+            Vector3 position;
+            Vector3 velocity;
+            uint64 time;
+        };
+        typedef std::map<std::pair<const PagedWorldSection*, const Camera*>, CameraState> CameraStateMap;
+        CameraStateMap mCameraStates;
+
+        Real mLookAheadTime;
+        size_t mMaxPendingLoads;
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#endif
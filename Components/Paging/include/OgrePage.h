@@ -57,6 +57,9 @@ namespace Ogre
         unsigned long mFrameLastHeld;
         ContentCollectionList mContentCollections;
         uint16 mWorkQueueChannel;
+        WorkQueue::RequestID mRequestID;
+        uint64 mLoadRequestTime;
+        Real mLoadLatency;
         bool mDeferredProcessInProgress;
         bool mModified;
 
@@ -66,6 +69,7 @@ namespace Ogre
         struct PageData : public PageAlloc
         {
             ContentCollectionList collectionsToAdd;
+            ~PageData();
         };
         /// Structure for holding background page requests
         struct PageRequest
@@ -75,8 +79,8 @@ namespace Ogre
         };
         struct PageResponse
         {
-            PageData* pageData;
-            PageResponse() : pageData(0) {}
+            /// shared, so that aborted responses free the prepared data
+            SharedPtr<PageData> pageData;
         };
 
 
@@ -123,6 +127,19 @@ namespace Ogre
         */
         virtual void unload();
 
+        /** Cancel a pending background load of this page.
+        @remarks
+            The request is aborted in the WorkQueue, so it does not occupy a worker
+            if it has not started yet and its result is discarded otherwise. The page
+            stays empty until load is called again.
+        */
+        void abortLoad();
+
+        /** Get the time in milliseconds it took from the last load request until
+            the page content was available, or 0 if it has not been loaded yet.
+        */
+        Real getLoadLatency() const { return mLoadLatency; }
+
 
         /** Returns whether this page was 'held' in the last frame, that is
             was it either directly needed, or requested to stay in memory (held - as
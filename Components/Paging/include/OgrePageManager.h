@@ -432,6 +432,41 @@ namespace Ogre
         /** Get whether paging operations are currently allowed to happen. */
         bool getPagingOperationsEnabled() const { return mPagingEnabled; }
 
+        /** Page load statistics of all worlds managed by this class.
+        @remarks
+            Latencies are measured from the load request of a Page until its
+            content is available on the main thread, in milliseconds.
+            Page::getLoadLatency gives the value of an individual page.
+        */
+        struct PageLoadStatistics
+        {
+            /// Number of load requests issued
+            size_t requested;
+            /// Number of requests which delivered their data
+            size_t completed;
+            /// Number of completed requests which failed to prepare the page
+            size_t failed;
+            /// Number of requests cancelled before they completed
+            size_t aborted;
+            /// Latency of the most recently completed request
+            Real lastLatency;
+            /// Average latency of all completed requests
+            Real averageLatency;
+            /// Highest latency of all completed requests
+            Real maxLatency;
+        };
+        /** Get the page load statistics gathered since construction or the last reset. */
+        const PageLoadStatistics& getPageLoadStatistics() const { return mLoadStats; }
+        /** Reset the page load statistics. */
+        void resetPageLoadStatistics();
+
+        /// Internal method to notify the manager of a new page load request
+        void _notifyPageLoadRequested(Page* page);
+        /// Internal method to notify the manager of a completed page load request
+        void _notifyPageLoadCompleted(Page* page, Real latency, bool succeeded);
+        /// Internal method to notify the manager of an aborted page load request
+        void _notifyPageLoadAborted(Page* page);
+
 
     private:
 
@@ -466,8 +501,10 @@ namespace Ogre
         EventRouter mEventRouter;
         uint8 mDebugDisplayLvl;
         bool mPagingEnabled;
+        PageLoadStatistics mLoadStats;
 
         Grid2DPageStrategy* mGrid2DPageStrategy;
+        Grid2DPredictivePageStrategy* mGrid2DPredictivePageStrategy;
         Grid3DPageStrategy* mGrid3DPageStrategy;
         SimplePageContentCollectionFactory* mSimpleCollectionFactory;
     };
@@ -31,6 +31,7 @@ THE SOFTWARE.
 // Convenience header for user applications to reference all of the paging component
 
 #include "OgreGrid2DPageStrategy.h"
+#include "OgreGrid2DPredictivePageStrategy.h"
 #include "OgrePage.h"
 #include "OgrePageConnection.h"
 #include "OgrePageContent.h"
@@ -285,6 +285,12 @@ namespace Ogre
         : PageStrategy("Grid2D", manager)
     {
 
+    }
+    //---------------------------------------------------------------------
+    Grid2DPageStrategy::Grid2DPageStrategy(const String& name, PageManager* manager)
+        : PageStrategy(name, manager)
+    {
+
     }
     //---------------------------------------------------------------------
     Grid2DPageStrategy::~Grid2DPageStrategy()
@@ -0,0 +1,211 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreGrid2DPredictivePageStrategy.h"
+
+#include <cmath>
+
+#include "OgreCamera.h"
+#include "OgrePagedWorldSection.h"
+#include "OgrePage.h"
+#include "OgreRoot.h"
+#include "OgreTimer.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Time constant of the velocity smoothing, in seconds
+        const Real VELOCITY_SMOOTHING = 0.25f;
+        /// Cameras not seen for this many seconds start again from rest
+        const Real STALE_TIME = 1.0f;
+
+        struct CellRange
+        {
+            int32 xmin, xmax, ymin, ymax;
+
+            bool contains(int32 x, int32 y) const
+            {
+                return x >= xmin && x <= xmax && y >= ymin && y <= ymax;
+            }
+        };
+
+        /// Cells within radius (in cells) of cell x, y, clamped to the cell range of the grid
+        CellRange getCellRange(const Grid2DPageStrategyData* data, int32 x, int32 y, Real radius)
+        {
+            Real fxmin = (Real)x - radius;
+            Real fxmax = (Real)x + radius;
+            Real fymin = (Real)y - radius;
+            Real fymax = (Real)y + radius;
+
+            // Round UP max, round DOWN min
+            CellRange r;
+            r.xmin = fxmin < data->getCellRangeMinX() ? data->getCellRangeMinX() : (int32)std::floor(fxmin);
+            r.xmax = fxmax > data->getCellRangeMaxX() ? data->getCellRangeMaxX() : (int32)std::ceil(fxmax);
+            r.ymin = fymin < data->getCellRangeMinY() ? data->getCellRangeMinY() : (int32)std::floor(fymin);
+            r.ymax = fymax > data->getCellRangeMaxY() ? data->getCellRangeMaxY() : (int32)std::ceil(fymax);
+            return r;
+        }
+
+        Real getSeconds(uint64 from, uint64 to)
+        {
+            return (to - from) * 1e-6f;
+        }
+    }
+    //---------------------------------------------------------------------
+    Grid2DPredictivePageStrategy::Grid2DPredictivePageStrategy(PageManager* manager)
+        : Grid2DPageStrategy("Grid2DPredictive", manager)
+        , mLookAheadTime(2)
+        , mMaxPendingLoads(4)
+    {
+    }
+    //---------------------------------------------------------------------
+    Grid2DPredictivePageStrategy::~Grid2DPredictivePageStrategy()
+    {
+    }
+    //---------------------------------------------------------------------
+    void Grid2DPredictivePageStrategy::frameEnd(Real timeElapsed, PagedWorldSection* section)
+    {
+        // we are never told about destroyed cameras, so forget the ones we no longer see
+        uint64 now = Root::getSingleton().getTimer()->getMicroseconds();
+        for (CameraStateMap::iterator i = mCameraStates.begin(); i != mCameraStates.end();)
+        {
+            if (getSeconds(i->second.time, now) > STALE_TIME)
+                i = mCameraStates.erase(i);
+            else
+                ++i;
+        }
+    }
+    //---------------------------------------------------------------------
+    void Grid2DPredictivePageStrategy::notifyCamera(Camera* cam, PagedWorldSection* section)
+    {
+        Grid2DPageStrategyData* stratData = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+
+        // track the camera velocity
+        const Vector3& pos = cam->getDerivedPosition();
+        uint64 now = Root::getSingleton().getTimer()->getMicroseconds();
+        CameraState fresh = {pos, Vector3::ZERO, now};
+        CameraState& state = mCameraStates.emplace(std::make_pair(section, cam), fresh).first->second;
+        Real dt = getSeconds(state.time, now);
+        if (dt > STALE_TIME)
+        {
+            state.velocity = Vector3::ZERO;
+        }
+        else if (dt > 0)
+        {
+            Real blend = 1 - std::exp(-dt / VELOCITY_SMOOTHING);
+            state.velocity += ((pos - state.position) / dt - state.velocity) * blend;
+        }
+        state.position = pos;
+        state.time = now;
+
+        Vector2 gridpos, predictedGridpos;
+        stratData->convertWorldToGridSpace(pos, gridpos);
+        stratData->convertWorldToGridSpace(pos + state.velocity * mLookAheadTime, predictedGridpos);
+        // looking further ahead than this only keeps pages which are stale by the time we get there
+        Vector2 ahead = predictedGridpos - gridpos;
+        Real aheadDistance = ahead.length();
+        Real maxAheadDistance = 2 * stratData->getHoldRadius();
+        if (aheadDistance > maxAheadDistance)
+        {
+            predictedGridpos = gridpos + ahead * (maxAheadDistance / aheadDistance);
+            aheadDistance = maxAheadDistance;
+        }
+
+        int32 x, y, px, py;
+        stratData->determineGridLocation(gridpos, &x, &y);
+        stratData->determineGridLocation(predictedGridpos, &px, &py);
+
+        Real loadRadius = stratData->getLoadRadiusInCells();
+        Real holdRadius = stratData->getHoldRadiusInCells();
+        CellRange load = getCellRange(stratData, x, y, loadRadius);
+        CellRange hold = getCellRange(stratData, x, y, holdRadius);
+        CellRange predictedLoad = getCellRange(stratData, px, py, loadRadius);
+        CellRange predictedHold = getCellRange(stratData, px, py, holdRadius);
+
+        typedef std::pair<Real, PageID> Candidate;
+        std::vector<Candidate> candidates;
+        size_t pending = 0;
+
+        int32 ymax = std::max(hold.ymax, predictedHold.ymax);
+        int32 xmax = std::max(hold.xmax, predictedHold.xmax);
+        for (int32 cy = std::min(hold.ymin, predictedHold.ymin); cy <= ymax; ++cy)
+        {
+            for (int32 cx = std::min(hold.xmin, predictedHold.xmin); cx <= xmax; ++cx)
+            {
+                bool inLoad = load.contains(cx, cy) || predictedLoad.contains(cx, cy);
+                // other pages will by inference be marked for unloading
+                if (!inLoad && !hold.contains(cx, cy) && !predictedHold.contains(cx, cy))
+                    continue;
+
+                PageID pageID = stratData->calculatePageID(cx, cy);
+                Page* page = section->getPage(pageID);
+                if (inLoad)
+                {
+                    if (page)
+                    {
+                        page->touch();
+                        pending += page->isDeferredProcessInProgress();
+                        continue;
+                    }
+                    // pages around the predicted position are only needed once we
+                    // got there, so they are half the way there further away
+                    Vector2 mid;
+                    stratData->getMidPointGridSpace(cx, cy, mid);
+                    Real score = std::min(mid.distance(gridpos),
+                                          mid.distance(predictedGridpos) + aheadDistance * 0.5f);
+                    candidates.push_back(Candidate(score, pageID));
+                }
+                else if (page && page->isDeferredProcessInProgress())
+                {
+                    // the camera moved away before the page arrived, cancel the request
+                    section->unloadPage(page);
+                }
+                else if (page)
+                {
+                    // in the outer 'hold' range, keep it but don't actively load
+                    page->touch();
+                }
+            }
+        }
+
+        if (pending >= mMaxPendingLoads || candidates.empty())
+            return;
+
+        size_t count = std::min(candidates.size(), mMaxPendingLoads - pending);
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+        for (size_t i = 0; i < count; ++i)
+            section->loadPage(candidates[i].second);
+    }
+    //---------------------------------------------------------------------
+    Vector3 Grid2DPredictivePageStrategy::getCameraVelocity(const Camera* cam,
+                                                             const PagedWorldSection* section) const
+    {
+        CameraStateMap::const_iterator i = mCameraStates.find(std::make_pair(section, cam));
+        return i != mCameraStates.end() ? i->second.velocity : Vector3::ZERO;
+    }
+}
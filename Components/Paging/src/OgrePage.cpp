@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "OgrePageContentCollection.h"
 #include "OgreLogManager.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreTimer.h"
 #include <iomanip>
 
 namespace Ogre
@@ -49,10 +50,22 @@ namespace Ogre
     const uint16 Page::WORKQUEUE_PREPARE_REQUEST = 1;
     const uint16 Page::WORKQUEUE_CHANGECOLLECTION_REQUEST = 3;
 
+    //---------------------------------------------------------------------
+    Page::PageData::~PageData()
+    {
+        for (ContentCollectionList::iterator i = collectionsToAdd.begin();
+            i != collectionsToAdd.end(); ++i)
+        {
+            delete *i;
+        }
+    }
     //---------------------------------------------------------------------
     Page::Page(PageID pageID, PagedWorldSection* parent)
         : mID(pageID)
         , mParent(parent)
+        , mRequestID(0)
+        , mLoadRequestTime(0)
+        , mLoadLatency(0)
         , mDeferredProcessInProgress(false)
         , mModified(false)
         , mDebugNode(0)
@@ -66,6 +79,9 @@ namespace Ogre
     //---------------------------------------------------------------------
     Page::~Page()
     {
+        // nobody is going to handle the result any more
+        abortLoad();
+
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
         wq->removeRequestHandler(mWorkQueueChannel, this);
         wq->removeResponseHandler(mWorkQueueChannel, this);
@@ -184,12 +200,27 @@ namespace Ogre
             destroyAllContentCollections();
             PageRequest req(this);
             mDeferredProcessInProgress = true;
-            Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, WORKQUEUE_PREPARE_REQUEST, 
-                req, 0, synchronous);
+            mLoadRequestTime = Root::getSingleton().getTimer()->getMicroseconds();
+            getManager()->_notifyPageLoadRequested(this);
+            WorkQueue::RequestID id = Root::getSingleton().getWorkQueue()->addRequest(
+                mWorkQueueChannel, WORKQUEUE_PREPARE_REQUEST, req, 0, synchronous);
+            // a synchronous request has already been handled
+            if (mDeferredProcessInProgress)
+                mRequestID = id;
         }
 
     }
     //---------------------------------------------------------------------
+    void Page::abortLoad()
+    {
+        if (!mDeferredProcessInProgress)
+            return;
+
+        Root::getSingleton().getWorkQueue()->abortRequest(mRequestID);
+        mDeferredProcessInProgress = false;
+        getManager()->_notifyPageLoadAborted(this);
+    }
+    //---------------------------------------------------------------------
     void Page::unload()
     {
         destroyAllContentCollections();
@@ -215,7 +246,7 @@ namespace Ogre
         if (preq.srcPage != this)
             return false;
         else
-            return true;
+            return ResponseHandler::canHandleResponse(res, srcQ);
 
     }
     //---------------------------------------------------------------------
@@ -229,11 +260,11 @@ namespace Ogre
             return 0;
 
         PageResponse res;
-        res.pageData = OGRE_NEW PageData();
+        res.pageData.reset(OGRE_NEW PageData());
         WorkQueue::Response* response = 0;
         try
         {
-            prepareImpl(res.pageData);
+            prepareImpl(res.pageData.get());
             response = OGRE_NEW WorkQueue::Response(req, true, res);
         }
         catch (Exception& e)
@@ -265,10 +296,12 @@ namespace Ogre
             loadImpl();
         }
 
-        OGRE_DELETE pres.pageData;
-
         mDeferredProcessInProgress = false;
 
+        uint64 now = Root::getSingleton().getTimer()->getMicroseconds();
+        mLoadLatency = (now - mLoadRequestTime) * 0.001f;
+        getManager()->_notifyPageLoadCompleted(this, mLoadLatency, res->succeeded());
+
     }
     //---------------------------------------------------------------------
     bool Page::prepareImpl(PageData* dataToPopulate)
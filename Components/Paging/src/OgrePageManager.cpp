@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgrePagedWorldSection.h"
 #include "OgrePagedWorld.h"
 #include "OgreGrid2DPageStrategy.h"
+#include "OgreGrid2DPredictivePageStrategy.h"
 #include "OgreGrid3DPageStrategy.h"
 #include "OgreSimplePageContentCollection.h"
 #include "OgreStreamSerialiser.h"
@@ -49,6 +50,7 @@ namespace Ogre
         , mDebugDisplayLvl(0)
         , mPagingEnabled(true)
         , mGrid2DPageStrategy(0)
+        , mGrid2DPredictivePageStrategy(0)
         , mGrid3DPageStrategy(0)
         , mSimpleCollectionFactory(0)
     {
@@ -61,6 +63,7 @@ namespace Ogre
 
         createStandardStrategies();
         createStandardContentFactories();
+        resetPageLoadStatistics();
 
     }
     //---------------------------------------------------------------------
@@ -74,6 +77,7 @@ namespace Ogre
         mCameraList.clear();
         
         OGRE_DELETE mGrid3DPageStrategy;
+        OGRE_DELETE mGrid2DPredictivePageStrategy;
         OGRE_DELETE mGrid2DPageStrategy;
         OGRE_DELETE mSimpleCollectionFactory;
     }
@@ -83,6 +87,9 @@ namespace Ogre
         mGrid2DPageStrategy = OGRE_NEW Grid2DPageStrategy(this);
         addStrategy(mGrid2DPageStrategy);
 
+        mGrid2DPredictivePageStrategy = OGRE_NEW Grid2DPredictivePageStrategy(this);
+        addStrategy(mGrid2DPredictivePageStrategy);
+
         mGrid3DPageStrategy = OGRE_NEW Grid3DPageStrategy(this);
         addStrategy(mGrid3DPageStrategy);
     }
@@ -505,6 +512,31 @@ namespace Ogre
         return mCameraList;
     }
     //---------------------------------------------------------------------
+    void PageManager::resetPageLoadStatistics()
+    {
+        mLoadStats = PageLoadStatistics();
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_notifyPageLoadRequested(Page* page)
+    {
+        ++mLoadStats.requested;
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_notifyPageLoadCompleted(Page* page, Real latency, bool succeeded)
+    {
+        ++mLoadStats.completed;
+        if (!succeeded)
+            ++mLoadStats.failed;
+        mLoadStats.lastLatency = latency;
+        mLoadStats.averageLatency += (latency - mLoadStats.averageLatency) / mLoadStats.completed;
+        mLoadStats.maxLatency = std::max(mLoadStats.maxLatency, latency);
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_notifyPageLoadAborted(Page* page)
+    {
+        ++mLoadStats.aborted;
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     void PageManager::EventRouter::cameraPreRenderScene(Camera* cam)
     {
@@ -214,6 +214,14 @@ public:
     /** Abstract method that writes a source code to the given output stream in the target shader language. */
     virtual void writeSourceCode(std::ostream& os, const String& targetLanguage) const = 0;
 
+    /** Append everything that determines the source code of this atom to the given key.
+    @remarks
+    ProgramManager compares these keys to find existing GPU programs before writing any source code.
+    The default implementation appends the source code itself, so only override it if the key
+    covers all the state of the subclass.
+    */
+    virtual void appendStructuralKey(String& key, const String& targetLanguage) const;
+
 // Attributes.
 protected:
     /** Class default constructor. */
@@ -221,6 +229,9 @@ protected:
 
     void writeOperands(std::ostream& os, OperandVector::const_iterator begin, OperandVector::const_iterator end) const;
 
+    /// append the function name and the operands to the key, tagged with the atom type
+    void appendOperandsKey(String& key, char atomType) const;
+
     // The owner group execution order.
     int mGroupExecutionOrder;
     OperandVector mOperands;
@@ -248,6 +259,8 @@ public:
     */
     virtual void writeSourceCode(std::ostream& os, const String& targetLanguage) const;
 
+    void appendStructuralKey(String& key, const String& targetLanguage) const;
+
     /** Return the function name */
     const String& getFunctionName() const { return mFunctionName; }
 
@@ -293,6 +306,7 @@ public:
     /// @note the argument order is reversed comered to all other function invocations
     AssignmentAtom(const Out& lhs, const In& rhs, int groupOrder);
     void writeSourceCode(std::ostream& os, const String& targetLanguage) const;
+    void appendStructuralKey(String& key, const String& targetLanguage) const;
 };
 
 /// shorthand for "dst = texture(sampler, uv);" instead of using FFP_SampleTexture
@@ -302,6 +316,7 @@ public:
     explicit SampleTextureAtom(int groupOrder) { mGroupExecutionOrder = groupOrder; }
     SampleTextureAtom(const In& sampler, const In& texcoord, const Out& dst, int groupOrder);
     void writeSourceCode(std::ostream& os, const String& targetLanguage) const;
+    void appendStructuralKey(String& key, const String& targetLanguage) const;
 };
 
 /// shorthand for "dst = a OP b;"
@@ -312,6 +327,7 @@ public:
     explicit BinaryOpAtom(char op, int groupOrder) : mOp(op) { mGroupExecutionOrder = groupOrder; }
     BinaryOpAtom(char op, const In& a, const In& b, const Out& dst, int groupOrder);
     void writeSourceCode(std::ostream& os, const String& targetLanguage) const;
+    void appendStructuralKey(String& key, const String& targetLanguage) const;
 };
 
 typedef std::vector<FunctionAtom*>                 FunctionAtomInstanceList;
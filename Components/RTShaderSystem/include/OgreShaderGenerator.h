@@ -149,6 +149,9 @@ public:
     /** 
     Set the output shader cache path. Generated shader code will be written to this path.
     In case of empty cache path shaders will be generated directly from system memory.
+    @remarks
+    The path also keeps an index of the written programs by their structure, so the next run
+    reads the code of known programs from there instead of generating it again.
     @param cachePath The cache path of the shader.  
     The default is empty cache path.
     */
@@ -165,6 +168,26 @@ public:
     */
     void flushShaderCache();
 
+    /**
+    Write the shader based techniques that were built so far to a manifest.
+    @remarks
+    Loading the manifest at the next start creates these techniques again and generates their
+    programs up front, see loadManifest(). Together with the shader cache path and the microcode
+    cache of the GpuProgramManager, this moves the shader generation out of the first frames.
+    @param stream The destination stream.
+    */
+    void saveManifest(const DataStreamPtr& stream) const;
+
+    /**
+    Create the shader based techniques listed in a manifest and generate their programs.
+    @remarks
+    Materials that do not exist yet are skipped. The programs are generated by validating the
+    listed schemes, which writes the program code on worker threads.
+    @param stream The source stream.
+    @return The number of shader based techniques created.
+    */
+    size_t loadManifest(const DataStreamPtr& stream);
+
     /** 
     Return a global render state associated with the given scheme name.
     Modifying this render state will affect all techniques that belongs to that scheme.
@@ -495,6 +518,22 @@ private:
         /** Build the render state and acquire the CPU/GPU programs */
         void buildTargetRenderState();
 
+        /** Compose the render state of this pass from the custom and the scheme render states.
+        @remarks First step of buildTargetRenderState. Sub render states may modify the destination
+        pass here, so this has to run on the main thread.
+        */
+        void composeTargetRenderState();
+
+        /** Create the CPU programs of the composed render state and write their source code.
+        @remarks Second step of buildTargetRenderState, passes can run it on worker threads concurrently.
+        */
+        void prepareTargetRenderState();
+
+        /** Create the GPU programs of the composed render state and bind them to the destination pass.
+        @remarks Last step of buildTargetRenderState, which has to run on the main thread.
+        */
+        void acquireTargetRenderState();
+
         /** Get source pass. */
         Pass* getSrcPass() { return mSrcPass; }
 
@@ -525,6 +564,8 @@ private:
 		IlluminationStage mStage;
         // Custom render state.
         RenderState* mCustomRenderState;
+        // Render state between composeTargetRenderState and acquireTargetRenderState.
+        TargetRenderStatePtr mTargetRenderState;
     };
 
     
@@ -551,6 +592,11 @@ private:
         /** Build the render state. */
         void buildTargetRenderState();
 
+        /** Create the destination technique and compose the render states of its passes.
+        @remarks The passes still have to prepare and acquire their programs afterwards.
+        */
+        void composeTargetRenderState();
+
 		/** Build the render state for illumination passes. */
 		void buildIlluminationTargetRenderState();
 
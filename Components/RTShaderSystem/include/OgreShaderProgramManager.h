@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreSingleton.h"
 #include "OgreGpuProgram.h"
 #include "OgreStringVector.h"
+#include "OgreShaderProgramSet.h"
 
 namespace Ogre {
 namespace RTShader {
@@ -124,7 +125,16 @@ private:
     */
     void destroyCpuProgram(Program* shaderProgram);
 
+    /** Run the program processor on the CPU programs of the given program set and write their source code.
+    @remarks
+    This does not create any GPU program and only reads the state of this manager, so different
+    program sets can be prepared concurrently as long as no GPU programs are created meanwhile.
+    @param programSet The program set container.
+    */
+    void prepareGpuPrograms(ProgramSet* programSet);
+
     /** Create GPU programs for the given program set based on the CPU programs it contains.
+    @note prepareGpuPrograms must have been called on the program set before.
     @param programSet The program set container.
     */
     void createGpuPrograms(ProgramSet* programSet);
@@ -137,15 +147,40 @@ private:
     */
     static String generateHash(const String& programString, const String& defines);
 
+    /**
+    Generates a key covering everything a ProgramWriter reads from a CPU program
+    @remarks
+    Programs with equal keys result in the same source code, so the key identifies
+    an existing GPU program without writing the source code first.
+    @param shaderProgram The CPU program instance.
+    @param language The target shader language.
+    @param profiles The profiles string for program compilation.
+    */
+    static String generateStructuralKey(Program* shaderProgram, const String& language, const String& profiles);
+
+    /** Write the source code of the given CPU program, unless a GPU program with the same structure exists.
+    @param shaderProgram The CPU program instance.
+    @param programWriter The program writer instance.
+    @param language The target shader language.
+    @param profiles The profiles string for program compilation.
+    @param source Receives the key, name and source code of the program.
+    */
+    void writeGpuProgramSource(Program* shaderProgram,
+        ProgramWriter* programWriter,
+        const String& language,
+        const String& profiles,
+        ProgramSet::GpuProgramSource& source);
+
     /** Create GPU program based on the give CPU program.
     @param shaderProgram The CPU program instance.
+    @param source The source code written by writeGpuProgramSource.
     @param programWriter The program writer instance.
     @param language The target shader language.
     @param profiles The profiles string for program compilation.
-    @param profilesList The profiles string for program compilation as string list.
     @param cachePath The output path to write the program into.
     */
-    GpuProgramPtr createGpuProgram(Program* shaderProgram, 
+    GpuProgramPtr createGpuProgram(Program* shaderProgram,
+        ProgramSet::GpuProgramSource& source,
         ProgramWriter* programWriter,
         const String& language,
         const String& profiles,
@@ -163,6 +198,21 @@ private:
     */
     void removeProgramProcessor(const String& lang);
 
+    /** Load the index of the program cache stored in the given directory.
+    @remarks
+    The index maps the structural keys of the CPU programs to the program files written to the
+    shader cache, so the code of known programs is read from there instead of being generated.
+    An index written with a different render system is discarded.
+    @param cachePath The shader cache path, an empty string disables the index.
+    */
+    void loadProgramCache(const String& cachePath);
+
+    /** Add a program file of the shader cache to the index.
+    @param structuralKey The structural key of the CPU program.
+    @param programName The name of the GPU program.
+    */
+    void addToProgramCache(const String& structuralKey, const String& programName);
+
     /** Destroy a GPU program by name.
     @param gpuProgram The program to destroy.
     */
@@ -187,6 +237,12 @@ private:
     GpuProgramsMap mVertexShaderMap;
     // The generated fragment shaders.
     GpuProgramsMap mFragmentShaderMap;
+    // Map between structural keys and the names of the generated shaders.
+    std::unordered_map<String, String> mProgramNameByKey;
+    // Map between hashed structural keys and the names of the shaders in the shader cache.
+    std::unordered_map<String, String> mCachedProgramNames;
+    // The shader cache path of the program cache index.
+    String mProgramCachePath;
     // The default program processors.
     ProgramProcessorList mDefaultProgramProcessors;
 
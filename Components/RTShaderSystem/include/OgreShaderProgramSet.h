@@ -62,8 +62,24 @@ public:
 
     // Protected methods.
 private:
+    /// Source code of a CPU program, written before the GPU program is created.
+    struct GpuProgramSource
+    {
+        /// Structural key of the CPU program, see ProgramManager::generateStructuralKey.
+        String key;
+        /// Name of the GPU program.
+        String name;
+        /// Generated code, empty if a GPU program with the same key existed already.
+        String source;
+        /// Whether the code was read from the shader cache instead of being generated.
+        bool cached;
+
+        GpuProgramSource() : cached(false) {}
+    };
+
     void setCpuProgram(std::unique_ptr<Program>&& program);
     void setGpuProgram(const GpuProgramPtr& program);
+    GpuProgramSource& getGpuProgramSource(GpuProgramType type);
 
     // Vertex shader CPU program.
     std::unique_ptr<Program> mVSCpuProgram;
@@ -73,6 +89,10 @@ private:
     GpuProgramPtr mVSGpuProgram;
     // Fragment shader CPU program.
     GpuProgramPtr mPSGpuProgram;
+    // Vertex shader source code.
+    GpuProgramSource mVSSource;
+    // Fragment shader source code.
+    GpuProgramSource mPSSource;
 
     friend class ProgramManager;
     friend class TargetRenderState;
@@ -164,7 +164,17 @@ public:
     */
     void addSubRenderStateInstance(SubRenderState* subRenderState);
 
+    /** Create the CPU programs of this render state and write their source code.
+    @remarks
+    This is the part of acquirePrograms that does not touch any GPU resource. It only modifies
+    this render state and its sub render states, so different render states can be prepared on
+    worker threads at the same time.
+    */
+    void prepareCpuPrograms();
+
     /** Acquire CPU/GPU programs set associated with the given render state and bind them to the pass.
+    @remarks
+    Calls prepareCpuPrograms first, unless it was called already.
     @param pass The pass to bind the programs to.
     */
     void acquirePrograms(Pass* pass);
@@ -91,6 +91,8 @@ public:
     One should use these program class API to create a representation of the sub state he wished to
     implement.
     @param programSet container class of CPU and GPU programs that this sub state will affect on.
+    @note Sub render states of different passes run this concurrently when a scheme is validated.
+    Changes to the passes or other shared objects belong to @ref preAddToRenderState.
     */
     virtual bool createCpuSubPrograms(ProgramSet* programSet);
 
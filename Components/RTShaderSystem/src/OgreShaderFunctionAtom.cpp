@@ -246,6 +246,39 @@ void FunctionAtom::writeOperands(std::ostream& os, OperandVector::const_iterator
     }
 }
 
+//-----------------------------------------------------------------------
+void FunctionAtom::appendStructuralKey(String& key, const String& targetLanguage) const
+{
+    StringStream os;
+    writeSourceCode(os, targetLanguage);
+    key += os.str();
+    key += '\n';
+}
+
+//-----------------------------------------------------------------------
+void FunctionAtom::appendOperandsKey(String& key, char atomType) const
+{
+    key += atomType;
+    key += mFunctionName;
+    key += '(';
+    for (const auto& op : mOperands)
+    {
+        // the name is all the writer uses of the parameter, its declaration is part of the program key
+        key += op.getParameter()->toString();
+        key += char(op.getSemantic());
+        key += char(op.getMask());
+        key += char(op.getIndirectionLevel());
+    }
+    key += ')';
+}
+
+//-----------------------------------------------------------------------
+void FunctionInvocation::appendStructuralKey(String& key, const String& targetLanguage) const
+{
+    appendOperandsKey(key, 'F');
+    key += mReturnType;
+}
+
 //-----------------------------------------------------------------------
 bool FunctionInvocation::operator == ( const FunctionInvocation& rhs ) const
 {
@@ -388,6 +421,11 @@ void AssignmentAtom::writeSourceCode(std::ostream& os, const String& targetLangu
     os << ";";
 }
 
+void AssignmentAtom::appendStructuralKey(String& key, const String& targetLanguage) const
+{
+    appendOperandsKey(key, 'A');
+}
+
 SampleTextureAtom::SampleTextureAtom(const In& sampler, const In& texcoord, const Out& lhs, int groupOrder)
 {
     setOperands({sampler, texcoord, lhs});
@@ -431,6 +469,11 @@ void SampleTextureAtom::writeSourceCode(std::ostream& os, const String& targetLa
     os << ");";
 }
 
+void SampleTextureAtom::appendStructuralKey(String& key, const String& targetLanguage) const
+{
+    appendOperandsKey(key, 'S');
+}
+
 BinaryOpAtom::BinaryOpAtom(char op, const In& a, const In& b, const Out& dst, int groupOrder) {
     // do this backwards for compatibility with FFP_FUNC_ASSIGN calls
     setOperands({a, b, dst});
@@ -459,5 +502,11 @@ void BinaryOpAtom::writeSourceCode(std::ostream& os, const String& targetLanguag
     os << ";";
 }
 
+void BinaryOpAtom::appendStructuralKey(String& key, const String& targetLanguage) const
+{
+    // mFunctionName holds the operator
+    appendOperandsKey(key, 'B');
+}
+
 }
 }
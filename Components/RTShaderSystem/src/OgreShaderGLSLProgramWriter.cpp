@@ -215,6 +215,8 @@ void GLSLProgramWriter::writeMainSourceCode(std::ostream& os, Program* program)
     }
     os << std::endl;
 
+    // Local copies of written inputs, kept per program so one writer can serve several threads.
+    std::set<String> localRenames;
     for (const auto& pFuncInvoc : curFunction->getAtomInstances())
     {
         for (auto& operand : pFuncInvoc->getOperandList())
@@ -239,7 +241,7 @@ void GLSLProgramWriter::writeMainSourceCode(std::ostream& os, Program* program)
                 }
 
                 // now we check if we already declared a redirector var
-                if(doLocalRename && mLocalRenames.find(param->getName()) == mLocalRenames.end())
+                if(doLocalRename && localRenames.find(param->getName()) == localRenames.end())
                 {
                     // Declare the copy variable and assign the original
                     String newVar = "local_" + param->getName();
@@ -247,7 +249,7 @@ void GLSLProgramWriter::writeMainSourceCode(std::ostream& os, Program* program)
 
                     // From now on we replace it automatic
                     param->_rename(newVar, true);
-                    mLocalRenames.insert(newVar);
+                    localRenames.insert(newVar);
                 }
             }
 
@@ -97,8 +97,6 @@ protected:
 
     // Attributes.
 protected:
-    std::set<String> mLocalRenames;
-
     // Map parameter content to vertex attributes 
     ParamContentToStringMap mContentToPerVertexAttributes;
     // Holds the current glsl version
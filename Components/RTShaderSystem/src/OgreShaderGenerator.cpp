@@ -25,6 +25,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreShaderPrecompiledHeaders.h"
+#include "OgreParallel.h"
 
 namespace Ogre {
 
@@ -1325,9 +1326,70 @@ void ShaderGenerator::setShaderCachePath( const String& cachePath )
             outFile.close();
             remove(outTestFileName.c_str());
         }
+
+        mProgramManager->loadProgramCache(mShaderCachePath);
     }
 }
 
+//-----------------------------------------------------------------------------
+void ShaderGenerator::saveManifest(const DataStreamPtr& stream) const
+{
+    OGRE_LOCK_AUTO_MUTEX;
+
+    StringStream manifest;
+    for (const auto& matEntry : mMaterialEntriesMap)
+    {
+        for (SGTechnique* techEntry : matEntry.second->getTechniqueList())
+        {
+            // Skip techniques that were never used.
+            if (techEntry->getBuildDestinationTechnique())
+                continue;
+
+            manifest << matEntry.first.first << '\t' << matEntry.first.second << '\t'
+                     << techEntry->getSourceTechnique()->getSchemeName() << '\t'
+                     << techEntry->getDestinationTechniqueSchemeName() << '\t'
+                     << techEntry->overProgrammablePass() << '\n';
+        }
+    }
+
+    String str = manifest.str();
+    stream->write(str.c_str(), str.size());
+}
+
+//-----------------------------------------------------------------------------
+size_t ShaderGenerator::loadManifest(const DataStreamPtr& stream)
+{
+    OGRE_LOCK_AUTO_MUTEX;
+
+    std::set<String> schemes;
+    size_t numCreated = 0;
+    while (!stream->eof())
+    {
+        StringVector entry = StringUtil::split(stream->getLine(), "\t");
+        if (entry.size() != 5)
+            continue;
+
+        auto mat = MaterialManager::getSingleton().getByName(entry[0], entry[1]);
+        if (!mat)
+        {
+            LogManager::getSingleton().logMessage("RTSS: skipping unknown material '" + entry[0] + "' of the manifest");
+            continue;
+        }
+
+        if (createShaderBasedTechnique(*mat, entry[2], entry[3], StringConverter::parseBool(entry[4])))
+        {
+            schemes.insert(entry[3]);
+            numCreated++;
+        }
+    }
+
+    // Generate the programs of all materials at once.
+    for (const auto& schemeName : schemes)
+        validateScheme(schemeName);
+
+    return numCreated;
+}
+
 //-----------------------------------------------------------------------------
 ShaderGenerator::SGMaterialIterator ShaderGenerator::findMaterialEntryIt(const String& materialName, const String& groupName)
 {
@@ -1446,7 +1508,16 @@ ShaderGenerator::SGPass::~SGPass()
 
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGPass::buildTargetRenderState()
+{
+    composeTargetRenderState();
+    prepareTargetRenderState();
+    acquireTargetRenderState();
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGPass::composeTargetRenderState()
 {   
+    mTargetRenderState.reset();
     if(mSrcPass->isProgrammable() && !mParent->overProgrammablePass() && !isIlluminationPass()) return;
     const String& schemeName = mParent->getDestinationTechniqueSchemeName();
     const RenderState* renderStateGlobal = ShaderGenerator::getSingleton().getRenderState(schemeName);
@@ -1489,8 +1560,25 @@ void ShaderGenerator::SGPass::buildTargetRenderState()
     FFPRenderStateBuilder::buildRenderState(this, targetRenderState.get());
 #endif
 
-    targetRenderState->acquirePrograms(mDstPass);
-    mDstPass->getUserObjectBindings().setUserAny(TargetRenderState::UserKey, targetRenderState);
+    mTargetRenderState = targetRenderState;
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGPass::prepareTargetRenderState()
+{
+    if (mTargetRenderState)
+        mTargetRenderState->prepareCpuPrograms();
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGPass::acquireTargetRenderState()
+{
+    if (!mTargetRenderState)
+        return;
+
+    mTargetRenderState->acquirePrograms(mDstPass);
+    mDstPass->getUserObjectBindings().setUserAny(TargetRenderState::UserKey, mTargetRenderState);
+    mTargetRenderState.reset();
 }
 
 //-----------------------------------------------------------------------------
@@ -1628,6 +1716,22 @@ void ShaderGenerator::SGTechnique::destroySGPasses()
 
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGTechnique::buildTargetRenderState()
+{
+    composeTargetRenderState();
+
+    // Build render state for each pass.
+    for (SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
+    {
+        (*itPass)->prepareTargetRenderState();
+        (*itPass)->acquireTargetRenderState();
+    }
+
+    // Turn off the build destination technique flag.
+    mBuildDstTechnique = false;
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::composeTargetRenderState()
 {
     // Remove existing destination technique and passes
     // in order to build it again from scratch.
@@ -1654,15 +1758,12 @@ void ShaderGenerator::SGTechnique::buildTargetRenderState()
     createSGPasses();
 
 
-    // Build render state for each pass.
+    // Compose render state for each pass.
     for (SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
     {
 		assert(!(*itPass)->isIlluminationPass()); // this is not so important, but intended to be so here.
-        (*itPass)->buildTargetRenderState();
+        (*itPass)->composeTargetRenderState();
     }
-
-    // Turn off the build destination technique flag.
-    mBuildDstTechnique = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -1811,13 +1912,32 @@ void ShaderGenerator::SGScheme::validate()
     if (mOutOfDate == false)
         return;
 
-    // Build render state for each technique and acquire GPU programs.
+    // Build render state for each technique. This modifies the materials, so it stays on this thread.
+    SGTechniqueList techniques;
+    SGPassList passes;
     for (SGTechnique* curTechEntry : mTechniqueEntries)
     {
-        if (curTechEntry->getBuildDestinationTechnique())
-            curTechEntry->buildTargetRenderState();
+        if (!curTechEntry->getBuildDestinationTechnique())
+            continue;
+
+        curTechEntry->composeTargetRenderState();
+        techniques.push_back(curTechEntry);
+        passes.insert(passes.end(), curTechEntry->getPassList().begin(), curTechEntry->getPassList().end());
     }
-    
+
+    // Generating the CPU programs and their source code only touches the render state of each pass.
+    parallelFor(passes.size(), 4, [&passes](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            passes[i]->prepareTargetRenderState();
+    });
+
+    // GPU programs must be created by the rendering thread.
+    for (SGPass* pass : passes)
+        pass->acquireTargetRenderState();
+
+    for (SGTechnique* curTechEntry : techniques)
+        curTechEntry->setBuildDestinationTechnique(false);
+
     // Mark this scheme as up to date.
     mOutOfDate = false;
 }
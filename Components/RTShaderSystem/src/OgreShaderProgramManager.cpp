@@ -93,6 +93,7 @@ void ProgramManager::flushGpuProgramsCache()
 {
     flushGpuProgramsCache(mVertexShaderMap);
     flushGpuProgramsCache(mFragmentShaderMap);
+    mProgramNameByKey.clear();
 }
 
 size_t ProgramManager::getShaderCount(GpuProgramType type) const
@@ -145,7 +146,7 @@ void ProgramManager::destroyDefaultProgramProcessors()
 }
 
 //-----------------------------------------------------------------------------
-void ProgramManager::createGpuPrograms(ProgramSet* programSet)
+void ProgramManager::prepareGpuPrograms(ProgramSet* programSet)
 {
     // Before we start we need to make sure that the pixel shader input
     //  parameters are the same as the vertex output, this required by 
@@ -164,25 +165,41 @@ void ProgramManager::createGpuPrograms(ProgramSet* programSet)
     auto programWriter = ProgramWriterManager::getSingleton().getProgramWriter(language);
 
     ProgramProcessorIterator itProcessor = mProgramProcessorsMap.find(language);
-    ProgramProcessor* programProcessor = NULL;
 
     if (itProcessor == mProgramProcessorsMap.end())
     {
         OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
             "Could not find processor for language '" + language,
-            "ProgramManager::createGpuPrograms");       
+            "ProgramManager::prepareGpuPrograms");
     }
 
-    programProcessor = itProcessor->second;
-    
     // Call the pre creation of GPU programs method.
-    if (!programProcessor->preCreateGpuPrograms(programSet))
+    if (!itProcessor->second->preCreateGpuPrograms(programSet))
         OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "preCreateGpuPrograms failed");
-    
+
+    // Write the shader programs
+    for(auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+    {
+        writeGpuProgramSource(programSet->getCpuProgram(type), programWriter, language,
+                              ShaderGenerator::getSingleton().getShaderProfiles(type),
+                              programSet->getGpuProgramSource(type));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::createGpuPrograms(ProgramSet* programSet)
+{
+    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
+
+    auto programWriter = ProgramWriterManager::getSingleton().getProgramWriter(language);
+
+    ProgramProcessor* programProcessor = mProgramProcessorsMap.at(language);
+
     // Create the shader programs
     for(auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
     {
-        auto gpuProgram = createGpuProgram(programSet->getCpuProgram(type), programWriter, language,
+        auto gpuProgram = createGpuProgram(programSet->getCpuProgram(type), programSet->getGpuProgramSource(type),
+                                           programWriter, language,
                                            ShaderGenerator::getSingleton().getShaderProfiles(type),
                                            ShaderGenerator::getSingleton().getShaderCachePath());
         programSet->setGpuProgram(gpuProgram);
@@ -198,29 +215,93 @@ void ProgramManager::createGpuPrograms(ProgramSet* programSet)
 }
 
 //-----------------------------------------------------------------------------
-GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram, 
-                                               ProgramWriter* programWriter,
-                                               const String& language,
-                                               const String& profiles,
-                                               const String& cachePath)
+void ProgramManager::writeGpuProgramSource(Program* shaderProgram,
+                                           ProgramWriter* programWriter,
+                                           const String& language,
+                                           const String& profiles,
+                                           ProgramSet::GpuProgramSource& source)
 {
+    const GpuProgramsMap& programMap =
+        shaderProgram->getType() == GPT_VERTEX_PROGRAM ? mVertexShaderMap : mFragmentShaderMap;
+
+    // Look for a program with the same structure before writing any code.
+    // The maps are only read here, so this may run on several threads at once.
+    source.key = generateStructuralKey(shaderProgram, language, profiles);
+    source.cached = false;
+    auto itKey = mProgramNameByKey.find(source.key);
+    if (itKey != mProgramNameByKey.end() && programMap.find(itKey->second) != programMap.end())
+    {
+        source.name = itKey->second;
+        source.source.clear();
+        return;
+    }
+
+    // Then for one written by a previous run.
+    auto itCached = mCachedProgramNames.find(generateHash(source.key, BLANKSTRING));
+    if (itCached != mCachedProgramNames.end())
+    {
+        const String programFileName =
+            mProgramCachePath + itCached->second + "." + programWriter->getTargetLanguage();
+        std::ifstream programFile(programFileName.c_str());
+        if (programFile)
+        {
+            StringStream buffer;
+            programFile >> buffer.rdbuf();
+            source.name = itCached->second;
+            source.source = buffer.str();
+            source.cached = true;
+            return;
+        }
+    }
+
     std::stringstream sourceCodeStringStream;
 
     // Generate source code.
     programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
-    String source = sourceCodeStringStream.str();
+    source.source = sourceCodeStringStream.str();
 
     // Generate program name.
-    String programName = generateHash(source, shaderProgram->getPreprocessorDefines());
+    source.name = generateHash(source.source, shaderProgram->getPreprocessorDefines());
 
     if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
     {
-        programName += "_VS";
+        source.name += "_VS";
     }
     else if (shaderProgram->getType() == GPT_FRAGMENT_PROGRAM)
     {
-        programName += "_FS";
+        source.name += "_FS";
     }
+}
+
+//-----------------------------------------------------------------------------
+GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram, 
+                                               ProgramSet::GpuProgramSource& programSource,
+                                               ProgramWriter* programWriter,
+                                               const String& language,
+                                               const String& profiles,
+                                               const String& cachePath)
+{
+    GpuProgramsMap& programMap =
+        shaderProgram->getType() == GPT_VERTEX_PROGRAM ? mVertexShaderMap : mFragmentShaderMap;
+
+    // Another program set might have created a program with the same structure meanwhile.
+    auto itKey = mProgramNameByKey.find(programSource.key);
+    if (itKey != mProgramNameByKey.end())
+    {
+        GpuProgramsMapIterator itProgram = programMap.find(itKey->second);
+        if (itProgram != programMap.end())
+            return itProgram->second;
+
+        // the program was released in the meantime
+        mProgramNameByKey.erase(itKey);
+    }
+
+    if (programSource.source.empty())
+        writeGpuProgramSource(shaderProgram, programWriter, language, profiles, programSource);
+
+    const String& structuralKey = programSource.key;
+    const String& programName = programSource.name;
+    String source = programSource.source;
 
     // Try to get program by name.
     HighLevelGpuProgramPtr pGpuProgram =
@@ -228,6 +309,8 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
             programName, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
 
     if(pGpuProgram) {
+        mProgramNameByKey[structuralKey] = programName;
+        addToProgramCache(structuralKey, programName);
         return static_pointer_cast<GpuProgram>(pGpuProgram);
     }
 
@@ -237,7 +320,7 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
         ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, language, shaderProgram->getType());
 
     // Case cache directory specified -> create program from file.
-    if (!cachePath.empty())
+    if (!cachePath.empty() && !programSource.cached)
     {
         const String  programFullName = programName + "." + programWriter->getTargetLanguage();
         const String  programFileName = cachePath + programFullName;
@@ -294,10 +377,74 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
     {
         mFragmentShaderMap[programName] = pGpuProgram;
     }
+    mProgramNameByKey[structuralKey] = programName;
+    addToProgramCache(structuralKey, programName);
     
     return static_pointer_cast<GpuProgram>(pGpuProgram);
 }
 
+//-----------------------------------------------------------------------------
+static const char* PROGRAM_CACHE_INDEX = "RTShaderCache.txt";
+
+static String getProgramCacheSignature()
+{
+    // the written code depends on the version of the writers and the shading language version
+    auto rs = Root::getSingleton().getRenderSystem();
+    return StringUtil::format("RTShaderCache %x %s %d", OGRE_VERSION, rs ? rs->getName().c_str() : "None",
+                              rs ? rs->getNativeShadingLanguageVersion() : 0);
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::loadProgramCache(const String& cachePath)
+{
+    mCachedProgramNames.clear();
+    mProgramCachePath = cachePath;
+
+    if (cachePath.empty())
+        return;
+
+    const String indexFileName = cachePath + PROGRAM_CACHE_INDEX;
+    const String signature = getProgramCacheSignature();
+
+    std::ifstream indexFile(indexFileName.c_str());
+    String line;
+    if (indexFile && std::getline(indexFile, line) && line == signature)
+    {
+        while (std::getline(indexFile, line))
+        {
+            StringVector entry = StringUtil::split(line, " ");
+            if (entry.size() == 2)
+                mCachedProgramNames[entry[0]] = entry[1];
+        }
+        LogManager::getSingleton().stream()
+            << "RTSS: " << mCachedProgramNames.size() << " programs in the cache index " << indexFileName;
+        return;
+    }
+    indexFile.close();
+
+    // start a new index, as the cached programs were written for a different setup
+    std::ofstream outFile(indexFileName.c_str());
+    outFile << signature << "\n";
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::addToProgramCache(const String& structuralKey, const String& programName)
+{
+    if (mProgramCachePath.empty())
+        return;
+
+    String hash = generateHash(structuralKey, BLANKSTRING);
+    auto itCached = mCachedProgramNames.find(hash);
+    if (itCached != mCachedProgramNames.end() && itCached->second == programName)
+        return;
+
+    mCachedProgramNames[hash] = programName;
+
+    // later entries override earlier ones when loading
+    std::ofstream indexFile((mProgramCachePath + PROGRAM_CACHE_INDEX).c_str(), std::ios::app);
+    indexFile << hash << " " << programName << "\n";
+}
+
 
 //-----------------------------------------------------------------------------
 String ProgramManager::generateHash(const String& programString, const String& defines)
@@ -311,6 +458,50 @@ String ProgramManager::generateHash(const String& programString, const String& d
     return StringUtil::format("%08x%08x%08x%08x", hash[0], hash[1], hash[2], hash[3]);
 }
 
+//-----------------------------------------------------------------------------
+static void appendParameterKey(String& key, const ParameterPtr& param)
+{
+    key += param->toString();
+    key += '\0';
+    int32 fields[] = {param->getType(), param->getSemantic(), param->getIndex(), param->getContent(),
+                      int32(param->getSize())};
+    key.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+}
+
+static void appendParametersKey(String& key, const ShaderParameterList& params)
+{
+    for (const auto& param : params)
+        appendParameterKey(key, param);
+    key += '|';
+}
+
+//-----------------------------------------------------------------------------
+String ProgramManager::generateStructuralKey(Program* shaderProgram, const String& language, const String& profiles)
+{
+    String key;
+    key.reserve(4096);
+
+    key += char(shaderProgram->getType());
+    key += char(shaderProgram->getUseColumnMajorMatrices());
+    key += language + '|' + profiles + '|' + shaderProgram->getPreprocessorDefines() + '|';
+
+    for (unsigned int i = 0; i < shaderProgram->getDependencyCount(); ++i)
+        key += shaderProgram->getDependency(i) + '|';
+
+    for (const auto& param : shaderProgram->getParameters())
+        appendParameterKey(key, param);
+    key += '|';
+
+    Function* main = shaderProgram->getMain();
+    appendParametersKey(key, main->getInputParameters());
+    appendParametersKey(key, main->getOutputParameters());
+    appendParametersKey(key, main->getLocalParameters());
+
+    for (auto atom : main->getAtomInstances())
+        atom->appendStructuralKey(key, language);
+
+    return key;
+}
 
 //-----------------------------------------------------------------------------
 void ProgramManager::addProgramProcessor(const String& lang, ProgramProcessor* processor)
@@ -35,7 +35,9 @@ ProgramProcessor::ProgramProcessor()
 {
     mMaxTexCoordSlots = 16;
     mMaxTexCoordFloats = mMaxTexCoordSlots * 4;
-    
+
+    // built up front, as programs of different passes are processed concurrently
+    buildMergeCombinations();
 }
 
 //-----------------------------------------------------------------------------
@@ -286,12 +288,6 @@ void ProgramProcessor::mergeParametersByPredefinedCombinations(ShaderParameterLi
                                                                MergeParameterList& mergedParams)
 {
 
-    // Make sure the merge combinations are ready.
-    if (mParamMergeCombinations.empty())
-    {
-        buildMergeCombinations();
-    }
-
     // Create the full used merged params - means FLOAT4 params that all of their components are used.
     for (unsigned int i=0; i < mParamMergeCombinations.size(); ++i)
     {
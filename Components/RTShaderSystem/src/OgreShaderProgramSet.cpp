@@ -83,6 +83,20 @@ void ProgramSet::setGpuProgram(const GpuProgramPtr& program)
     }
 }
 
+//-----------------------------------------------------------------------------
+ProgramSet::GpuProgramSource& ProgramSet::getGpuProgramSource(GpuProgramType type)
+{
+    switch(type)
+    {
+    case GPT_VERTEX_PROGRAM:
+        return mVSSource;
+    case GPT_FRAGMENT_PROGRAM:
+        return mPSSource;
+    default:
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "", "");
+    }
+}
+
 //-----------------------------------------------------------------------------
 const GpuProgramPtr& ProgramSet::getGpuProgram(GpuProgramType type) const
 {
@@ -142,9 +142,17 @@ void TargetRenderState::bindUniformParameters(Program* pCpuProgram, const GpuPro
     }
 }
 
-void TargetRenderState::acquirePrograms(Pass* pass)
+void TargetRenderState::prepareCpuPrograms()
 {
     createCpuPrograms();
+    ProgramManager::getSingleton().prepareGpuPrograms(mProgramSet.get());
+}
+
+//-----------------------------------------------------------------------------
+void TargetRenderState::acquirePrograms(Pass* pass)
+{
+    if (!mProgramSet)
+        prepareCpuPrograms();
     ProgramManager::getSingleton().createGpuPrograms(mProgramSet.get());
 
     bool hasError = false;
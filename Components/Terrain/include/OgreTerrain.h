@@ -819,6 +819,18 @@ namespace Ogre
         /// @overload
         float getHeightAtWorldPosition(const Vector3& pos) const;
 
+        /** Get the height data for many world positions at once.
+
+            Gives the same results as getHeightAtWorldPosition, but interpolates several
+            points at a time using SIMD and splits large batches across threads.
+            This can be called from any thread as long as no parallel write to
+            the heightmap data occurs.
+        @param positions Positions in world space, clamped to the edge of the terrain
+        @param count Number of positions
+        @param outHeights Array receiving @c count heights
+        */
+        void getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* outHeights) const;
+
         /** Get a pointer to all the delta data for this terrain.
         @remarks
             The delta data is a measure at a given vertex of by how much vertically
@@ -1219,6 +1231,7 @@ namespace Ogre
         @param rect Rectangle describing the area in which heights have altered 
         @return A Rectangle describing the area which was updated (may be wider
             than the input rectangle)
+        @remarks Large areas are split into bands of rows which are processed in parallel.
         */
         Rect calculateHeightDeltas(const Rect& rect);
 
@@ -1235,6 +1248,8 @@ namespace Ogre
         @param rect Rectangle describing the area of heights that were changed
         @param outFinalRect Output rectangle describing the area updated
         @return Pointer to a PixelBox full of normals (caller responsible for deletion)
+        @remarks Normals are the central differences of the heights. Large areas are
+            processed in parallel, and with SIMD where available.
         */
         PixelBox* calculateNormals(const Rect& rect, Rect& outFinalRect);
 
@@ -1253,6 +1268,9 @@ namespace Ogre
             needs to be calculated additionally (e.g. from a neighbour)
         @param outFinalRect Output rectangle describing the area updated in the lightmap
         @return Pointer to a PixelBox full of lighting data (caller responsible for deletion)
+        @remarks Shadows are found by sweeping lines of texels along the light direction
+            while tracking the horizon, rather than casting a ray per texel. Neighbours
+            are included in the sweep so shadows are cast across terrain boundaries.
         */
         PixelBox* calculateLightmap(const Rect& rect, const Rect& extraTargetRect, Rect& outFinalRect);
 
@@ -1283,6 +1301,20 @@ namespace Ogre
          */
         std::pair<bool, Vector3> rayIntersects(const Ray& ray, 
             bool cascadeToNeighbours = false, Real distanceLimit = 0); //const;
+
+        /** Test many rays for intersection with the terrain.
+
+            Equivalent to calling rayIntersects for every ray, but splits large batches
+            across threads.
+         @param rays The rays to test
+         @param count Number of rays
+         @param outResults Array receiving @c count results, as returned by rayIntersects
+         @param cascadeToNeighbours Whether the rays will be projected onto neighbours
+         @param distanceLimit The distance from the ray origin at which we will stop looking,
+            0 indicates no limit
+         */
+        void rayIntersectsBatch(const Ray* rays, size_t count, std::pair<bool, Vector3>* outResults,
+            bool cascadeToNeighbours = false, Real distanceLimit = 0);
         
         /// Get the AABB (local coords) of the entire terrain
         const AxisAlignedBox& getAABB() const;
@@ -1689,6 +1721,11 @@ namespace Ogre
         float* mHeightData;
         /// The delta information defining how a vertex moves before it is removed at a lower LOD
         float* mDeltaData;
+        /** Min / max height pyramid used to skip empty space in ray queries.
+            Level i stores interleaved min and max heights of blocks of 2^(i+1) quads
+            squared, down to a single block covering the whole terrain.
+        */
+        std::vector<std::vector<float> > mHeightBounds;
         Alignment mAlign;
         Real mWorldSize;
         uint16 mSize;
@@ -1845,6 +1882,10 @@ namespace Ogre
     private:
         /// Test a single quad of the terrain for ray intersection.
         OGRE_FORCE_INLINE std::pair<bool, Vector3> checkQuadIntersection(int x, int y, const Ray& ray) const;
+        /// Update the min / max height pyramid for a rectangle of changed heights
+        void updateHeightBounds(const Rect& rect);
+        /// Find the first quad hit by a ray in local vertex space, descending the height pyramid
+        std::pair<bool, Vector3> rayIntersectsHeightBounds(const Ray& localRay, int level, uint32 bx, uint32 bz) const;
     };
 
 
@@ -1880,6 +1921,7 @@ namespace Ogre
         Real mCompositeMapDistance;
         String mResourceGroup;
         bool mUseVertexCompressionWhenAvailable;
+        uint8 mHeightDataQuantisationBits;
 
     public:
         TerrainGlobalOptions();
@@ -2060,6 +2102,26 @@ namespace Ogre
          */
         void setUseVertexCompressionWhenAvailable(bool enable) { mUseVertexCompressionWhenAvailable = enable; }
 
+        /** Get the number of bits heights are quantised to when saving terrains.
+        */
+        uint8 getHeightDataQuantisationBits() const { return mHeightDataQuantisationBits; }
+
+        /** Set the number of bits heights are quantised to when saving terrains.
+        @remarks
+            When non-zero, Terrain::save stores heights as integers between the minimum
+            and maximum height of the terrain, and each LOD level only stores the residual
+            against the level above it. This makes terrain files much smaller and lets
+            TerrainLodManager refine the coarse LOD levels without decoding the detailed ones.
+            The height error is at most half of (max height - min height) / (2^bits - 1).
+            The default is 0, which saves exact floating point heights.
+        @param bits Between 0 and 16
+        */
+        void setHeightDataQuantisationBits(uint8 bits)
+        {
+            OgreAssert(bits <= 16, "at most 16 bits are supported");
+            mHeightDataQuantisationBits = bits;
+        }
+
         /// @copydoc Singleton::getSingleton()
         static TerrainGlobalOptions& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
@@ -34,9 +34,13 @@
 
 %template(LayerInstanceList) std::vector<Ogre::Terrain::LayerInstance>;
 %template(TerrainRayResult) std::pair<bool, Ogre::Vector3>;
+%ignore Ogre::Terrain::getHeightsAtWorldPositions;
+%ignore Ogre::Terrain::rayIntersectsBatch;
 %include "OgreTerrain.h"
 
 %ignore Ogre::TerrainGroup::rayIntersects;
+%ignore Ogre::TerrainGroup::rayIntersectsBatch;
+%ignore Ogre::TerrainGroup::getHeightsAtWorldPositions;
 %ignore Ogre::TerrainGroup::getTerrainIterator; // deprecated
 %include "OgreTerrainGroup.h"
 
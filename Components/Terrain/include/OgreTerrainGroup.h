@@ -419,6 +419,22 @@ namespace Ogre
         */
         float getHeightAtWorldPosition(const Vector3& pos, Terrain** ppTerrain = 0);
 
+        /** Get the height data for many world positions at once.
+
+            Like getHeightAtWorldPosition, but consecutive positions on the same terrain
+            are evaluated in one go using Terrain::getHeightsAtWorldPositions. Sorting the
+            positions spatially therefore helps.
+            This can be called from any thread as long as no parallel write to
+            the terrain data occurs.
+        @param positions Positions in world space
+        @param count Number of positions
+        @param outHeights Array receiving @c count heights, 0 where there is no terrain
+        @param outTerrains Optional array receiving the terrain used for each position,
+            or null where there was none
+        */
+        void getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* outHeights,
+                                        Terrain** outTerrains = 0) const;
+
         /** Test for intersection of a given ray with any terrain in the group. If the ray hits
          a terrain, the point of intersection and terrain instance is returned.
          @param ray The ray to test for intersection
@@ -429,6 +445,18 @@ namespace Ogre
          the terrain data occurs.
          */
         RayResult rayIntersects(const Ray& ray, Real distanceLimit = 0) const; 
+
+        /** Test many rays for intersection with the terrains in the group.
+
+            Equivalent to calling rayIntersects for every ray, but splits large batches
+            across threads.
+         @param rays The rays to test
+         @param count Number of rays
+         @param outResults Array receiving @c count results
+         @param distanceLimit The distance from the ray origin at which we will stop looking,
+            0 indicates no limit
+         */
+        void rayIntersectsBatch(const Ray* rays, size_t count, RayResult* outResults, Real distanceLimit = 0) const;
         
         typedef std::vector<Terrain*> TerrainList; 
         /** Test intersection of a box with the terrain. 
@@ -96,7 +96,12 @@ namespace Ogre
         virtual void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
 
         void updateToLodLevel(int lodLevel, bool synchronous = false);
-        /// Save each LOD level separately compressed so seek is possible
+        /** Save each LOD level separately compressed so seek is possible
+        @remarks
+            If TerrainGlobalOptions::getHeightDataQuantisationBits is non-zero, heights are
+            quantised and each level only stores the residuals against the interpolation
+            of the level above it. Delta data is then derived from the heights on load.
+        */
         static void saveLodData(StreamSerialiser& stream, Terrain* terrain);
 
         /** Copy geometry data from buffer to mHeightData/mDeltaData
@@ -110,7 +115,9 @@ namespace Ogre
           @param lowerLodBound Lower bound of LOD levels to load
           @param higherLodBound Upper bound of LOD levels to load
           @remarks Geometry data are uncompressed using inflate() and stored into
-                allocated buffer
+                allocated buffer. For quantised data the levels above lowerLodBound are
+                decoded as well, as the residuals are relative to them, but only the
+                requested levels are written to the terrain.
           */
         void readLodData(uint16 lowerLodBound, uint16 higherLodBound);
         void waitForDerivedProcesses();
@@ -147,6 +154,11 @@ namespace Ogre
                 0: 01 03 05 06 07 08 09 11 13 15 16 17 18 19 21 23
           */
         static void separateData(float* data, uint16 size, uint16 numLodLevels, LodsData& lods );
+        /// Write the quantised residuals of every LOD level, coarsest first
+        static void saveQuantisedLodData(StreamSerialiser& stream, Terrain* terrain, uint8 bits);
+        /// Decode a quantised LOD level into quantisedHeights, which must hold the levels above it
+        void readQuantisedLodLevel(StreamSerialiser& stream, uint lodLevel, uint16* quantisedHeights,
+                                   bool fillBuffer);
     private:
         Terrain* mTerrain;
         DataStreamPtr mDataStream;
@@ -49,6 +49,14 @@ THE SOFTWARE.
 #include "OgreTimer.h"
 #include "OgreTerrainMaterialGeneratorA.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreParallel.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE
+#include <xmmintrin.h>
+#elif __OGRE_HAVE_NEON
+#include <arm_neon.h>
+#endif
 
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 // we do lots of conversions here, casting them all is tedious & cluttered, we know what we're doing
@@ -58,7 +66,7 @@ namespace Ogre
 {
     //---------------------------------------------------------------------
     const uint32 Terrain::TERRAIN_CHUNK_ID = StreamSerialiser::makeIdentifier("TERR");
-    const uint16 Terrain::TERRAIN_CHUNK_VERSION = 2;
+    const uint16 Terrain::TERRAIN_CHUNK_VERSION = 3;
     const uint32 Terrain::TERRAINGENERALINFO_CHUNK_ID = StreamSerialiser::makeIdentifier("TGIN");
     const uint16 Terrain::TERRAINGENERALINFO_CHUNK_VERSION = 1;
     const uint32 Terrain::TERRAINLAYERDECLARATION_CHUNK_ID = StreamSerialiser::makeIdentifier("TDCL");
@@ -114,6 +122,7 @@ namespace Ogre
         , mCompositeMapDistance(4000)
         , mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mUseVertexCompressionWhenAvailable(true)
+        , mHeightDataQuantisationBits(0)
     {
     }
     //---------------------------------------------------------------------
@@ -312,6 +321,37 @@ namespace Ogre
             mLodManager->open(filename);
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /** Since version 3 blend maps are stored as the difference of each byte to the
+            same channel of the previous pixel, which deflates much better as blend maps
+            are mostly smooth or constant. Works in place.
+        */
+        void encodeBlendMap(Image& img)
+        {
+            size_t bpp = img.getBPP() / 8;
+            size_t rowSize = img.getWidth() * bpp;
+            for (uint32 y = 0; y < img.getHeight(); ++y)
+            {
+                uchar* row = img.getData(0, y);
+                for (size_t i = rowSize; i-- > bpp;)
+                    row[i] -= row[i - bpp];
+            }
+        }
+
+        void decodeBlendMap(Image& img)
+        {
+            size_t bpp = img.getBPP() / 8;
+            size_t rowSize = img.getWidth() * bpp;
+            for (uint32 y = 0; y < img.getHeight(); ++y)
+            {
+                uchar* row = img.getData(0, y);
+                for (size_t i = bpp; i < rowSize; ++i)
+                    row[i] += row[i - bpp];
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void Terrain::save(StreamSerialiser& stream)
     {
         // wait for any queued processes to finish
@@ -361,9 +401,12 @@ namespace Ogre
 
             // load packed CPU data
             int numBlendTex = getBlendTextureCount(numLayers);
+            Image tmp(PF_BYTE_RGBA, mLayerBlendMapSize, mLayerBlendMapSize);
             for (int i = 0; i < numBlendTex; ++i)
             {
-                stream.write(mCpuBlendMapStorage[i].getData(), mCpuBlendMapStorage[i].getSize());
+                memcpy(tmp.getData(), mCpuBlendMapStorage[i].getData(), tmp.getSize());
+                encodeBlendMap(tmp);
+                stream.write(tmp.getData(), tmp.getSize());
             }
         }
         else
@@ -380,6 +423,7 @@ namespace Ogre
             {
                 // Must blit back in CPU format!
                 tex->getBuffer()->blitToMemory(tmp.getPixelBox());
+                encodeBlendMap(tmp);
                 stream.write(tmp.getData(), tmp.getSize());
             }
         }
@@ -704,6 +748,8 @@ namespace Ogre
         {
             mCpuBlendMapStorage.emplace_back(PF_BYTE_RGBA, mLayerBlendMapSize, mLayerBlendMapSize);
             stream.read(mCpuBlendMapStorage.back().getData(), mCpuBlendMapStorage.back().getSize());
+            if (mainChunk->version > 2)
+                decodeBlendMap(mCpuBlendMapStorage.back());
         }
 
         // derived data
@@ -760,6 +806,7 @@ namespace Ogre
         // Create & load quadtree
         mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0);
         mQuadTree->prepare(stream);
+        updateHeightBounds(Rect(0, 0, mSize, mSize));
 
         // stop uncompressing
         if(mainChunk->version > 1)
@@ -895,6 +942,7 @@ namespace Ogre
 
         // calculate entire terrain
         Rect rect(0, 0, mSize, mSize);
+        updateHeightBounds(rect);
         calculateHeightDeltas(rect);
         finaliseHeightDeltas(rect, true);
 
@@ -1287,6 +1335,118 @@ namespace Ogre
         return getHeightAtWorldPosition(pos.x, pos.y, pos.z);
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /** Height on the rendered triangles of four quads, see getHeightAtTerrainPosition.
+        @param fx, fy Position inside the quads, from 0 to 1
+        @param h0, h1, h2, h3 Heights at the corners (x, y), (x+1, y), (x+1, y+1), (x, y+1)
+        @param oddRow 1 for quads on an odd row, whose diagonal runs the other way
+        */
+        void interpolateQuadHeights(const float* fx, const float* fy, const float* h0, const float* h1,
+            const float* h2, const float* h3, const float* oddRow, float* outHeights)
+        {
+            /* even: lower right of the diagonal uses 0 1 2, upper left 0 2 3
+               odd: lower left of the diagonal uses 0 1 3, upper right 1 2 3
+            even     odd
+            3---2   3---2
+            | / |   | \ |
+            0---1   0---1
+            */
+#if __OGRE_HAVE_SSE
+            __m128 x = _mm_loadu_ps(fx), y = _mm_loadu_ps(fy);
+            __m128 v0 = _mm_loadu_ps(h0), v1 = _mm_loadu_ps(h1), v2 = _mm_loadu_ps(h2), v3 = _mm_loadu_ps(h3);
+            __m128 one = _mm_set1_ps(1.0f);
+            __m128 evenLower = _mm_add_ps(v0, _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(v1, v0)), _mm_mul_ps(y, _mm_sub_ps(v2, v1))));
+            __m128 evenUpper = _mm_add_ps(v0, _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(v2, v3)), _mm_mul_ps(y, _mm_sub_ps(v3, v0))));
+            __m128 oddLower = _mm_add_ps(v0, _mm_add_ps(_mm_mul_ps(x, _mm_sub_ps(v1, v0)), _mm_mul_ps(y, _mm_sub_ps(v3, v0))));
+            __m128 oddUpper = _mm_add_ps(v2, _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, x), _mm_sub_ps(v3, v2)),
+                                                        _mm_mul_ps(_mm_sub_ps(one, y), _mm_sub_ps(v1, v2))));
+            __m128 upper = _mm_cmpgt_ps(y, x);
+            __m128 even = _mm_or_ps(_mm_and_ps(upper, evenUpper), _mm_andnot_ps(upper, evenLower));
+            __m128 lower = _mm_cmpgt_ps(_mm_sub_ps(one, y), x);
+            __m128 odd = _mm_or_ps(_mm_and_ps(lower, oddLower), _mm_andnot_ps(lower, oddUpper));
+            __m128 isOdd = _mm_cmpgt_ps(_mm_loadu_ps(oddRow), _mm_setzero_ps());
+            _mm_storeu_ps(outHeights, _mm_or_ps(_mm_and_ps(isOdd, odd), _mm_andnot_ps(isOdd, even)));
+#elif __OGRE_HAVE_NEON
+            float32x4_t x = vld1q_f32(fx), y = vld1q_f32(fy);
+            float32x4_t v0 = vld1q_f32(h0), v1 = vld1q_f32(h1), v2 = vld1q_f32(h2), v3 = vld1q_f32(h3);
+            float32x4_t one = vdupq_n_f32(1.0f);
+            float32x4_t evenLower = vaddq_f32(v0, vaddq_f32(vmulq_f32(x, vsubq_f32(v1, v0)), vmulq_f32(y, vsubq_f32(v2, v1))));
+            float32x4_t evenUpper = vaddq_f32(v0, vaddq_f32(vmulq_f32(x, vsubq_f32(v2, v3)), vmulq_f32(y, vsubq_f32(v3, v0))));
+            float32x4_t oddLower = vaddq_f32(v0, vaddq_f32(vmulq_f32(x, vsubq_f32(v1, v0)), vmulq_f32(y, vsubq_f32(v3, v0))));
+            float32x4_t oddUpper = vaddq_f32(v2, vaddq_f32(vmulq_f32(vsubq_f32(one, x), vsubq_f32(v3, v2)),
+                                                           vmulq_f32(vsubq_f32(one, y), vsubq_f32(v1, v2))));
+            float32x4_t even = vbslq_f32(vcgtq_f32(y, x), evenUpper, evenLower);
+            float32x4_t odd = vbslq_f32(vcgtq_f32(vsubq_f32(one, y), x), oddLower, oddUpper);
+            vst1q_f32(outHeights, vbslq_f32(vcgtq_f32(vld1q_f32(oddRow), vdupq_n_f32(0)), odd, even));
+#else
+            for (int i = 0; i < 4; ++i)
+            {
+                float x = fx[i], y = fy[i];
+                if (oddRow[i] > 0)
+                {
+                    outHeights[i] = (1 - y) > x ? h0[i] + x * (h1[i] - h0[i]) + y * (h3[i] - h0[i])
+                                                : h2[i] + (1 - x) * (h3[i] - h2[i]) + (1 - y) * (h1[i] - h2[i]);
+                }
+                else
+                {
+                    outHeights[i] = y > x ? h0[i] + x * (h2[i] - h3[i]) + y * (h3[i] - h0[i])
+                                          : h0[i] + x * (h1[i] - h0[i]) + y * (h2[i] - h1[i]);
+                }
+            }
+#endif
+        }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* outHeights) const
+    {
+        // heights of vertices not yet streamed in are interpolated by getHeightAtPoint
+        int highestLod = mLodManager ? mLodManager->getHighestLodPrepared() : -1;
+        bool fullDetail = highestLod <= 0;
+        Real factor = (Real)mSize - 1.0f;
+        uint32 lastQuad = mSize - 2u;
+
+        parallelFor(count, 4096, [&](size_t begin, size_t end)
+        {
+            float fx[4], fy[4], h0[4], h1[4], h2[4], h3[4], oddRow[4], heights[4];
+            for (size_t i = begin; i < end; i += 4)
+            {
+                size_t n = std::min(end - i, size_t(4));
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    Vector3 pos = Vector3::ZERO;
+                    if (k < n)
+                        getTerrainPosition(positions[i + k], &pos);
+                    // clamp to the edge, the last row / column is the end of the last quad
+                    Real x = Math::saturate(pos.x) * factor;
+                    Real y = Math::saturate(pos.y) * factor;
+                    uint32 qx = std::min(static_cast<uint32>(x), lastQuad);
+                    uint32 qy = std::min(static_cast<uint32>(y), lastQuad);
+                    fx[k] = x - qx;
+                    fy[k] = y - qy;
+                    oddRow[k] = qy % 2 ? 1.0f : 0.0f;
+                    if (fullDetail)
+                    {
+                        const float* h = mHeightData + qy * mSize + qx;
+                        h0[k] = h[0];
+                        h1[k] = h[1];
+                        h2[k] = h[mSize + 1];
+                        h3[k] = h[mSize];
+                    }
+                    else
+                    {
+                        h0[k] = getHeightAtPoint(qx, qy);
+                        h1[k] = getHeightAtPoint(qx + 1, qy);
+                        h2[k] = getHeightAtPoint(qx + 1, qy + 1);
+                        h3[k] = getHeightAtPoint(qx, qy + 1);
+                    }
+                }
+                interpolateQuadHeights(fx, fy, h0, h1, h2, h3, oddRow, heights);
+                memcpy(outHeights + i, heights, n * sizeof(float));
+            }
+        });
+    }
+    //---------------------------------------------------------------------
     const float* Terrain::getDeltaData() const
     {
         return mDeltaData;
@@ -1845,6 +2005,9 @@ namespace Ogre
         mModified = true;
         mHeightDataModified = true;
 
+        // keep ray queries conservative right away, unlike the derived data
+        // this is cheap enough to not defer
+        updateHeightBounds(rect);
     }
     //---------------------------------------------------------------------
     void Terrain::_dirtyCompositeMapRect(const Rect& rect)
@@ -1964,6 +2127,8 @@ namespace Ogre
         OGRE_FREE(mDeltaData, MEMCATEGORY_GEOMETRY);
         mDeltaData = 0;
 
+        mHeightBounds.clear();
+
         OGRE_DELETE mQuadTree;
         mQuadTree = 0;
 
@@ -2033,6 +2198,40 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /** Maximum height delta per quadtree cell.
+
+            Quadtree nodes start and end on multiples of the leaf size and share
+            their boundary vertices, so every vertex of a cell (with boundary rows
+            and columns being cells of their own) belongs to the same nodes. The
+            deltas can therefore be reduced per cell in parallel and passed on to
+            the quadtree once per cell afterwards.
+        */
+        struct HeightDeltaCells
+        {
+            int leafSize;
+            int count;
+            std::vector<Real> maxDelta;
+
+            HeightDeltaCells(int terrainSize, int leafSz)
+                : leafSize(leafSz), count(2 * ((terrainSize - 1) / leafSz) + 2),
+                  maxDelta(count * count, -std::numeric_limits<Real>::max())
+            {
+            }
+
+            int index(int v) const { return 2 * (v / leafSize) + (v % leafSize ? 1 : 0); }
+            /// a vertex belonging to the same nodes as all vertices of the cell
+            int representative(int i) const { return (i / 2) * leafSize + i % 2; }
+
+            void notifyDelta(int x, int y, Real delta)
+            {
+                Real& d = maxDelta[index(y) * count + index(x)];
+                d = std::max(d, delta);
+            }
+        };
+    }
+    //---------------------------------------------------------------------
     Rect Terrain::calculateHeightDeltas(const Rect& rect)
     {
         Rect clampedRect = rect.intersect(Rect(0, 0, mSize, mSize));
@@ -2070,113 +2269,141 @@ namespace Ogre
             if (lodRect.bottom % step)
                 lodRect.bottom += step - (lodRect.bottom % step);
 
-            for (int j = lodRect.top; j < lodRect.bottom - step; j += step )
+            // Rows of quads are processed in parallel, in bands aligned to the
+            // quadtree cells so each band only touches its own cells
+            HeightDeltaCells cells(mSize, mMaxBatchSize - 1);
+            int bandRows = std::max(step, cells.leafSize);
+            int firstBand = lodRect.top / bandRows;
+            int rowEnd = lodRect.bottom - step;
+            size_t numBands = rowEnd > lodRect.top ? (rowEnd - 1) / bandRows - firstBand + 1 : 0;
+            size_t bandVertices = std::max(size_t(1), size_t(bandRows) * lodRect.width());
+            parallelFor(numBands, std::max(size_t(1), size_t(65536) / bandVertices),
+                        [&](size_t bandBegin, size_t bandEnd)
             {
-                for (int i = lodRect.left; i < lodRect.right - step; i += step )
+                int jBegin = std::max<int>(lodRect.top, (firstBand + bandBegin) * bandRows);
+                int jEnd = std::min<int>(rowEnd, (firstBand + bandEnd) * bandRows);
+                for (int j = jBegin; j < jEnd; j += step )
                 {
-                    // Form planes relating to the lower detail tris to be produced
-                    // For even tri strip rows, they are this shape:
-                    // 2---3
-                    // | / |
-                    // 0---1
-                    // For odd tri strip rows, they are this shape:
-                    // 2---3
-                    // | \ |
-                    // 0---1
-
-                    Vector3 v0, v1, v2, v3;
-                    getPointAlign(i, j, ALIGN_X_Y, &v0);
-                    getPointAlign(i + step, j, ALIGN_X_Y, &v1);
-                    getPointAlign(i, j + step, ALIGN_X_Y, &v2);
-                    getPointAlign(i + step, j + step, ALIGN_X_Y, &v3);
-
-                    Vector4 t1, t2;
-                    bool backwardTri = false;
-                    // Odd or even in terms of target level
-                    if ((j / step) % 2 == 0)
-                    {
-                        t1 = Math::calculateFaceNormalWithoutNormalize(v0, v1, v3);
-                        t2 = Math::calculateFaceNormalWithoutNormalize(v0, v3, v2);
-                    }
-                    else
+                    for (int i = lodRect.left; i < lodRect.right - step; i += step )
                     {
-                        t1 = Math::calculateFaceNormalWithoutNormalize(v1, v3, v2);
-                        t2 = Math::calculateFaceNormalWithoutNormalize(v0, v1, v2);
-                        backwardTri = true;
-                    }
-
-                    // include the bottommost row of vertices if this is the last row
-                    int yubound = (j == (mSize - step)? step : step - 1);
-                    for ( int y = 0; y <= yubound; y++ )
-                    {
-                        // include the rightmost col of vertices if this is the last col
-                        int xubound = (i == (mSize - step)? step : step - 1);
-                        for ( int x = 0; x <= xubound; x++ )
+                        // Form planes relating to the lower detail tris to be produced
+                        // For even tri strip rows, they are this shape:
+                        // 2---3
+                        // | / |
+                        // 0---1
+                        // For odd tri strip rows, they are this shape:
+                        // 2---3
+                        // | \ |
+                        // 0---1
+
+                        Vector3 v0, v1, v2, v3;
+                        getPointAlign(i, j, ALIGN_X_Y, &v0);
+                        getPointAlign(i + step, j, ALIGN_X_Y, &v1);
+                        getPointAlign(i, j + step, ALIGN_X_Y, &v2);
+                        getPointAlign(i + step, j + step, ALIGN_X_Y, &v3);
+
+                        Vector4 t1, t2;
+                        bool backwardTri = false;
+                        // Odd or even in terms of target level
+                        if ((j / step) % 2 == 0)
                         {
-                            int fulldetailx = static_cast<int>(i + x);
-                            int fulldetaily = static_cast<int>(j + y);
-                            if ( fulldetailx % step == 0 && 
-                                fulldetaily % step == 0 )
-                            {
-                                // Skip, this one is a vertex at this level
-                                continue;
-                            }
-
-                            Real ypct = (Real)y / (Real)step;
-                            Real xpct = (Real)x / (Real)step;
+                            t1 = Math::calculateFaceNormalWithoutNormalize(v0, v1, v3);
+                            t2 = Math::calculateFaceNormalWithoutNormalize(v0, v3, v2);
+                        }
+                        else
+                        {
+                            t1 = Math::calculateFaceNormalWithoutNormalize(v1, v3, v2);
+                            t2 = Math::calculateFaceNormalWithoutNormalize(v0, v1, v2);
+                            backwardTri = true;
+                        }
 
-                            //interpolated height
-                            Vector3 actualPos;
-                            getPointAlign(fulldetailx, fulldetaily, ALIGN_X_Y, &actualPos);
-                            Real interp_h;
-                            // Determine which tri we're on 
-                            if ((xpct > ypct && !backwardTri) ||
-                                (xpct > (1-ypct) && backwardTri))
-                            {
-                                // Solve for x/z
-                                interp_h = 
-                                    (-t1.x * actualPos.x
-                                    - t1.y * actualPos.y
-                                    - t1.w) / t1.z;
-                            }
-                            else
+                        // include the bottommost row of vertices if this is the last row
+                        int yubound = (j == (mSize - step)? step : step - 1);
+                        for ( int y = 0; y <= yubound; y++ )
+                        {
+                            // include the rightmost col of vertices if this is the last col
+                            int xubound = (i == (mSize - step)? step : step - 1);
+                            for ( int x = 0; x <= xubound; x++ )
                             {
-                                // Second tri
-                                interp_h = 
-                                    (-t2.x * actualPos.x
-                                    - t2.y * actualPos.y
-                                    - t2.w) / t2.z;
-                            }
+                                int fulldetailx = static_cast<int>(i + x);
+                                int fulldetaily = static_cast<int>(j + y);
+                                if ( fulldetailx % step == 0 && 
+                                    fulldetaily % step == 0 )
+                                {
+                                    // Skip, this one is a vertex at this level
+                                    continue;
+                                }
+
+                                Real ypct = (Real)y / (Real)step;
+                                Real xpct = (Real)x / (Real)step;
+
+                                //interpolated height
+                                Vector3 actualPos;
+                                getPointAlign(fulldetailx, fulldetaily, ALIGN_X_Y, &actualPos);
+                                Real interp_h;
+                                // Determine which tri we're on 
+                                if ((xpct > ypct && !backwardTri) ||
+                                    (xpct > (1-ypct) && backwardTri))
+                                {
+                                    // Solve for x/z
+                                    interp_h = 
+                                        (-t1.x * actualPos.x
+                                        - t1.y * actualPos.y
+                                        - t1.w) / t1.z;
+                                }
+                                else
+                                {
+                                    // Second tri
+                                    interp_h = 
+                                        (-t2.x * actualPos.x
+                                        - t2.y * actualPos.y
+                                        - t2.w) / t2.z;
+                                }
+
+                                Real actual_h = actualPos.z;
+                                Real delta = interp_h - actual_h;
+
+                                // max(delta) is the worst case scenario at this LOD
+                                // compared to the original heightmap
+
+                                // collect per quadtree cell, passed on below
+                                cells.notifyDelta(fulldetailx, fulldetaily, delta);
+
+
+                                // If this vertex is being removed at this LOD, 
+                                // then save the height difference since that's the move
+                                // it will need to make. Vertices to be removed at this LOD
+                                // are halfway between the steps, but exclude those that
+                                // would have been eliminated at earlier levels
+                                int halfStep = step / 2;
+                                if (
+                                 ((fulldetailx % step) == halfStep && (fulldetaily % halfStep) == 0) ||
+                                 ((fulldetaily % step) == halfStep && (fulldetailx % halfStep) == 0))
+                                {
+                                    // Save height difference 
+                                    mDeltaData[fulldetailx + (fulldetaily * mSize)] = delta;
+                                }
 
-                            Real actual_h = actualPos.z;
-                            Real delta = interp_h - actual_h;
-
-                            // max(delta) is the worst case scenario at this LOD
-                            // compared to the original heightmap
-
-                            // tell the quadtree about this 
-                            mQuadTree->notifyDelta(fulldetailx, fulldetaily, sourceLevel, delta);
-
-
-                            // If this vertex is being removed at this LOD, 
-                            // then save the height difference since that's the move
-                            // it will need to make. Vertices to be removed at this LOD
-                            // are halfway between the steps, but exclude those that
-                            // would have been eliminated at earlier levels
-                            int halfStep = step / 2;
-                            if (
-                             ((fulldetailx % step) == halfStep && (fulldetaily % halfStep) == 0) ||
-                             ((fulldetaily % step) == halfStep && (fulldetailx % halfStep) == 0))
-                            {
-                                // Save height difference 
-                                mDeltaData[fulldetailx + (fulldetaily * mSize)] = delta;
                             }
 
                         }
+                    } // i
+                } // j
+            });
 
+            for (int cy = 0; cy < cells.count; ++cy)
+            {
+                for (int cx = 0; cx < cells.count; ++cx)
+                {
+                    Real delta = cells.maxDelta[cy * cells.count + cx];
+                    if (delta != -std::numeric_limits<Real>::max())
+                    {
+                        // tell the quadtree about this
+                        mQuadTree->notifyDelta(cells.representative(cx), cells.representative(cy),
+                                               sourceLevel, delta);
                     }
-                } // i
-            } // j
+                }
+            }
 
         } // targetLevel
 
@@ -2339,47 +2566,11 @@ namespace Ogre
             }
             return Result(false, Vector3());
         }
-        // get intersection point and move inside
-        Vector3 cur = localRay.getPoint(aabbTest.second);
-
-        // now check every quad the ray touches
-        int quadX = std::min(std::max(static_cast<int>(cur.x), 0), (int)mSize-2);
-        int quadZ = std::min(std::max(static_cast<int>(cur.z), 0), (int)mSize-2);
-        int flipX = (rayDirection.x < 0 ? 0 : 1);
-        int flipZ = (rayDirection.z < 0 ? 0 : 1);
-        int xDir = (rayDirection.x < 0 ? -1 : 1);
-        int zDir = (rayDirection.z < 0 ? -1 : 1);
-
-        Result result(true, Vector3::ZERO);
-        Real dummyHighValue = (Real)mSize * 10000.0f;
-
-
-        while (cur.y >= (minHeight - 1e-3) && cur.y <= (maxHeight + 1e-3))
-        {
-            if (quadX < 0 || quadX >= (int)mSize-1 || quadZ < 0 || quadZ >= (int)mSize-1)
-                break;
-
-            result = checkQuadIntersection(quadX, quadZ, localRay);
-            if (result.first)
-                break;
-
-            // determine next quad to test
-            Real xDist = Math::RealEqual(rayDirection.x, 0.0) ? dummyHighValue : 
-                (quadX - cur.x + flipX) / rayDirection.x;
-            Real zDist = Math::RealEqual(rayDirection.z, 0.0) ? dummyHighValue : 
-                (quadZ - cur.z + flipZ) / rayDirection.z;
-            if (xDist < zDist)
-            {
-                quadX += xDir;
-                cur += rayDirection * xDist;
-            }
-            else
-            {
-                quadZ += zDir;
-                cur += rayDirection * zDist;
-            }
-
-        }
+        // descend the height pyramid, visiting only the blocks the ray passes
+        // through below their maximum height, nearest first
+        Result result(false, Vector3::ZERO);
+        if (!mHeightBounds.empty())
+            result = rayIntersectsHeightBounds(localRay, int(mHeightBounds.size()) - 1, 0, 0);
 
         if (result.first)
         {
@@ -2415,6 +2606,16 @@ namespace Ogre
         return result;
     }
     //---------------------------------------------------------------------
+    void Terrain::rayIntersectsBatch(const Ray* rays, size_t count, std::pair<bool, Vector3>* outResults,
+        bool cascadeToNeighbours /* = false */, Real distanceLimit /* = 0 */)
+    {
+        parallelFor(count, 64, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                outResults[i] = rayIntersects(rays[i], cascadeToNeighbours, distanceLimit);
+        });
+    }
+    //---------------------------------------------------------------------
     std::pair<bool, Vector3> Terrain::checkQuadIntersection(int x, int z, const Ray& ray) const
     {
         // build the two planes belonging to the quad's triangles
@@ -2451,6 +2652,9 @@ namespace Ogre
         // Then test that the intersection points are actually
         // still inside the triangle (with a small error margin)
         // Also check which triangle it is in
+        // A ray can pass through both triangles, so keep the nearest hit
+        std::pair<bool, Vector3> result(false, Vector3());
+        Real nearest = 0;
         RayTestResult planeInt = ray.intersects(Plane(p1));
         if (planeInt.first)
         {
@@ -2458,21 +2662,125 @@ namespace Ogre
             Vector3 rel = where - v1;
             if (rel.x >= -0.01 && rel.x <= 1.01 && rel.z >= -0.01 && rel.z <= 1.01 // quad bounds
                 && ((rel.x >= rel.z && !oddRow) || (rel.x >= (1 - rel.z) && oddRow))) // triangle bounds
-                return std::pair<bool, Vector3>(true, where);
+            {
+                result = std::pair<bool, Vector3>(true, where);
+                nearest = planeInt.second;
+            }
         }
         planeInt = ray.intersects(Plane(p2));
-        if (planeInt.first)
+        if (planeInt.first && (!result.first || planeInt.second < nearest))
         {
             Vector3 where = ray.getPoint(planeInt.second);
             Vector3 rel = where - v1;
             if (rel.x >= -0.01 && rel.x <= 1.01 && rel.z >= -0.01 && rel.z <= 1.01 // quad bounds
                 && ((rel.x <= rel.z && !oddRow) || (rel.x <= (1 - rel.z) && oddRow))) // triangle bounds
-                return std::pair<bool, Vector3>(true, where);
+                result = std::pair<bool, Vector3>(true, where);
         }
 
+        return result;
+    }
+    //---------------------------------------------------------------------
+    std::pair<bool, Vector3> Terrain::rayIntersectsHeightBounds(const Ray& localRay, int level,
+        uint32 bx, uint32 bz) const
+    {
+        if (level < 0)
+            return checkQuadIntersection(bx, bz, localRay);
+
+        uint32 blocks = (mSize - 1u) >> (level + 1);
+        const float* bounds = &mHeightBounds[level][2 * (bz * blocks + bx)];
+        // pad a little, so rays running along block edges are not lost
+        const Real pad = 1e-3f;
+        Real blockSize = Real(2u << level);
+        AxisAlignedBox box(bx * blockSize - pad, bounds[0] - pad, bz * blockSize - pad,
+                           (bx + 1) * blockSize + pad, bounds[1] + pad, (bz + 1) * blockSize + pad);
+        if (!localRay.intersects(box).first)
+            return std::pair<bool, Vector3>(false, Vector3());
+
+        // the ray can cross at most three of the children: the one nearest to its
+        // start first, then one of the sides and the opposite one last
+        static const uint32 childOrder[4][2] = { {0, 0}, {1, 0}, {0, 1}, {1, 1} };
+        uint32 flipX = localRay.getDirection().x < 0 ? 1 : 0;
+        uint32 flipZ = localRay.getDirection().z < 0 ? 1 : 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            std::pair<bool, Vector3> result = rayIntersectsHeightBounds(localRay, level - 1,
+                bx * 2 + (childOrder[i][0] ^ flipX), bz * 2 + (childOrder[i][1] ^ flipZ));
+            if (result.first)
+                return result;
+        }
         return std::pair<bool, Vector3>(false, Vector3());
     }
     //---------------------------------------------------------------------
+    void Terrain::updateHeightBounds(const Rect& rect)
+    {
+        if (!mHeightData)
+            return;
+
+        uint32 quads = mSize - 1u;
+        size_t numLevels = Bitwise::mostSignificantBitSet(quads);
+        Rect clampedRect = rect.intersect(Rect(0, 0, mSize, mSize));
+        if (mHeightBounds.size() != numLevels || mHeightBounds[0].size() != size_t(quads / 2) * (quads / 2) * 2)
+        {
+            // (re)build everything
+            mHeightBounds.resize(numLevels);
+            for (size_t level = 0; level < numLevels; ++level)
+            {
+                uint32 blocks = quads >> (level + 1);
+                mHeightBounds[level].assign(size_t(blocks) * blocks * 2, 0.0f);
+            }
+            clampedRect = Rect(0, 0, mSize, mSize);
+        }
+        if (clampedRect.isNull())
+            return;
+
+        for (size_t level = 0; level < numLevels; ++level)
+        {
+            uint32 blockSize = 2u << level;
+            uint32 blocks = quads >> (level + 1);
+            // vertices on a block boundary belong to the blocks on both sides
+            uint32 left = clampedRect.left > 0 ? (clampedRect.left - 1) / blockSize : 0;
+            uint32 top = clampedRect.top > 0 ? (clampedRect.top - 1) / blockSize : 0;
+            uint32 right = std::min((clampedRect.right - 1) / blockSize, blocks - 1);
+            uint32 bottom = std::min((clampedRect.bottom - 1) / blockSize, blocks - 1);
+
+            float* bounds = &mHeightBounds[level][0];
+            for (uint32 bz = top; bz <= bottom; ++bz)
+            {
+                for (uint32 bx = left; bx <= right; ++bx)
+                {
+                    float minHeight = std::numeric_limits<float>::max();
+                    float maxHeight = -std::numeric_limits<float>::max();
+                    if (level == 0)
+                    {
+                        // the 3x3 vertices of 2x2 quads
+                        for (uint32 z = bz * 2; z <= bz * 2 + 2; ++z)
+                        {
+                            const float* h = mHeightData + z * mSize + bx * 2;
+                            for (int x = 0; x < 3; ++x)
+                            {
+                                minHeight = std::min(minHeight, h[x]);
+                                maxHeight = std::max(maxHeight, h[x]);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        // the 2x2 children of the previous level
+                        const float* children = &mHeightBounds[level - 1][0];
+                        for (uint32 z = bz * 2; z <= bz * 2 + 1; ++z)
+                        {
+                            const float* child = children + 2 * (z * blocks * 2 + bx * 2);
+                            minHeight = std::min(minHeight, std::min(child[0], child[2]));
+                            maxHeight = std::max(maxHeight, std::max(child[1], child[3]));
+                        }
+                    }
+                    bounds[2 * (bz * blocks + bx)] = minHeight;
+                    bounds[2 * (bz * blocks + bx) + 1] = maxHeight;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     const MaterialPtr& Terrain::getMaterial() const
     {
         if (!mMaterial || 
@@ -3255,53 +3563,103 @@ namespace Ogre
         PixelBox* pixbox = OGRE_NEW PixelBox(static_cast<uint32>(widenedRect.width()),
                                              static_cast<uint32>(widenedRect.height()), 1, PF_BYTE_RGB, pData);
 
-        // Evaluate normal like this
-        //  3---2---1
-        //  | \ | / |
-        //  4---P---0
-        //  | / | \ |
-        //  5---6---7
+        // Normals are taken from the central differences of the heights, in
+        // terrain axes n = (h(x-1) - h(x+1), h(y-1) - h(y+1), 2 * scale), and
+        // then mapped to the axes of the alignment. Interior vertices read the
+        // height data directly, four at a time where SIMD is available, while
+        // vertices on the edge sample the neighbours.
+        const float twoScale = 2.0f * mScale;
+        auto storeNormal = [&](int x, int y, float nx, float ny, float nz)
+        {
+            Vector3 n = convertTerrainToWorldAxes(Vector3(nx, ny, nz));
+
+            // encode as RGB, object space
+            // invert the Y to deal with image space
+            long storeX = x - widenedRect.left;
+            long storeY = widenedRect.bottom - y - 1;
+
+            uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX) * 3;
+            *pStore++ = static_cast<uint8>((n.x + 1.0f) * 0.5f * 255.0f);
+            *pStore++ = static_cast<uint8>((n.y + 1.0f) * 0.5f * 255.0f);
+            *pStore++ = static_cast<uint8>((n.z + 1.0f) * 0.5f * 255.0f);
+        };
+        auto edgeNormal = [&](int x, int y)
+        {
+            // works out the slope from the actual sample positions, as these are
+            // clamped if there is no neighbour
+            Vector3 left, right, down, up;
+            getPointFromSelfOrNeighbour(x - 1, y, &left);
+            getPointFromSelfOrNeighbour(x + 1, y, &right);
+            getPointFromSelfOrNeighbour(x, y - 1, &down);
+            getPointFromSelfOrNeighbour(x, y + 1, &up);
+            Vector3 dx = convertWorldToTerrainAxes(right - left);
+            Vector3 dy = convertWorldToTerrainAxes(up - down);
+            Vector3 n(-dx.z / dx.x, -dy.z / dy.y, 1);
+            n.normalise();
+            storeNormal(x, y, n.x, n.y, n.z);
+        };
+        auto interiorNormal = [&](int x, int y)
+        {
+            const float* h = mHeightData + y * mSize + x;
+            float nx = h[-1] - h[1];
+            float ny = h[-(int)mSize] - h[mSize];
+            float invLen = 1.0f / std::sqrt(nx * nx + ny * ny + twoScale * twoScale);
+            storeNormal(x, y, nx * invLen, ny * invLen, twoScale * invLen);
+        };
 
-        for (int y = widenedRect.top; y < widenedRect.bottom; ++y)
+        int interiorEnd = (int)mSize - 1;
+        size_t rowVertices = std::max(1, widenedRect.width());
+        parallelFor(widenedRect.height(), std::max(size_t(1), 16384 / rowVertices), [&](size_t begin, size_t end)
         {
-            for (int x = widenedRect.left; x < widenedRect.right; ++x)
+            for (int y = widenedRect.top + begin; y < widenedRect.top + (int)end; ++y)
             {
-                Vector3 cumulativeNormal = Vector3::ZERO;
-
-                // Build points to sample
-                Vector3 centrePoint;
-                Vector3 adjacentPoints[8];
-                getPointFromSelfOrNeighbour(x  , y,   &centrePoint);
-                getPointFromSelfOrNeighbour(x+1, y,   &adjacentPoints[0]);
-                getPointFromSelfOrNeighbour(x+1, y+1, &adjacentPoints[1]);
-                getPointFromSelfOrNeighbour(x,   y+1, &adjacentPoints[2]);
-                getPointFromSelfOrNeighbour(x-1, y+1, &adjacentPoints[3]);
-                getPointFromSelfOrNeighbour(x-1, y,   &adjacentPoints[4]);
-                getPointFromSelfOrNeighbour(x-1, y-1, &adjacentPoints[5]);
-                getPointFromSelfOrNeighbour(x,   y-1, &adjacentPoints[6]);
-                getPointFromSelfOrNeighbour(x+1, y-1, &adjacentPoints[7]);
-
-                for (int i = 0; i < 8; ++i)
+                if (y < 1 || y >= interiorEnd)
                 {
-                    cumulativeNormal += Math::calculateBasicFaceNormal(centrePoint, adjacentPoints[i], adjacentPoints[(i+1)%8]);
+                    for (int x = widenedRect.left; x < widenedRect.right; ++x)
+                        edgeNormal(x, y);
+                    continue;
                 }
 
-                // normalise & store normal
-                cumulativeNormal.normalise();
-
-                // encode as RGB, object space
-                // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
-
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX) * 3;
-                *pStore++ = static_cast<uint8>((cumulativeNormal.x + 1.0f) * 0.5f * 255.0f);
-                *pStore++ = static_cast<uint8>((cumulativeNormal.y + 1.0f) * 0.5f * 255.0f);
-                *pStore++ = static_cast<uint8>((cumulativeNormal.z + 1.0f) * 0.5f * 255.0f);
-
-
+                int x = widenedRect.left;
+                int xEnd = std::min<int>(widenedRect.right, interiorEnd);
+                if (x < 1)
+                    edgeNormal(x++, y);
+#if __OGRE_HAVE_SSE || (__OGRE_HAVE_NEON && defined(__aarch64__))
+                float nx[4], ny[4], nz[4];
+                for (; x + 4 <= xEnd; x += 4)
+                {
+                    const float* h = mHeightData + y * mSize + x;
+#   if __OGRE_HAVE_SSE
+                    __m128 vx = _mm_sub_ps(_mm_loadu_ps(h - 1), _mm_loadu_ps(h + 1));
+                    __m128 vy = _mm_sub_ps(_mm_loadu_ps(h - mSize), _mm_loadu_ps(h + mSize));
+                    __m128 vz = _mm_set1_ps(twoScale);
+                    __m128 len = _mm_sqrt_ps(_mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+                    __m128 invLen = _mm_div_ps(_mm_set1_ps(1.0f), len);
+                    _mm_storeu_ps(nx, _mm_mul_ps(vx, invLen));
+                    _mm_storeu_ps(ny, _mm_mul_ps(vy, invLen));
+                    _mm_storeu_ps(nz, _mm_mul_ps(vz, invLen));
+#   else
+                    float32x4_t vx = vsubq_f32(vld1q_f32(h - 1), vld1q_f32(h + 1));
+                    float32x4_t vy = vsubq_f32(vld1q_f32(h - mSize), vld1q_f32(h + mSize));
+                    float32x4_t vz = vdupq_n_f32(twoScale);
+                    float32x4_t len = vsqrtq_f32(vaddq_f32(
+                        vaddq_f32(vmulq_f32(vx, vx), vmulq_f32(vy, vy)), vmulq_f32(vz, vz)));
+                    float32x4_t invLen = vdivq_f32(vdupq_n_f32(1.0f), len);
+                    vst1q_f32(nx, vmulq_f32(vx, invLen));
+                    vst1q_f32(ny, vmulq_f32(vy, invLen));
+                    vst1q_f32(nz, vmulq_f32(vz, invLen));
+#   endif
+                    for (int i = 0; i < 4; ++i)
+                        storeNormal(x + i, y, nx[i], ny[i], nz[i]);
+                }
+#endif
+                for (; x < xEnd; ++x)
+                    interiorNormal(x, y);
+                for (; x < widenedRect.right; ++x)
+                    edgeNormal(x, y);
             }
-        }
+        });
 
         finalRect = widenedRect;
 
@@ -3434,43 +3792,141 @@ namespace Ogre
         PixelBox* pixbox = OGRE_NEW PixelBox(static_cast<uint32>(widenedRect.width()),
                                              static_cast<uint32>(widenedRect.height()), 1, PF_L8, pData);
 
+        // add a little height padding to stop shadowing self
         Real heightPad = (getMaxHeight() - getMinHeight()) * 1.0e-3f;
 
-        for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
-        {
-            for (long x = widenedRect.left; x < widenedRect.right; ++x)
-            {
-                float litVal = 1.0f;
-
-                // convert to terrain space (not points, allow this to go between points)
-                float Tx = (float)x / (float)(mLightmapSizeActual-1);
-                float Ty = (float)y / (float)(mLightmapSizeActual-1);
+        // Rather than casting a ray towards the light from every texel, sweep
+        // lines of texels parallel to the light direction, starting on the side
+        // facing the light. Along a line, a texel is shadowed if any texel before
+        // it rises above the ray towards the light, which only needs a running
+        // maximum (the horizon) instead of a search.
+        // Everything happens in lightmap texel units, with the light direction
+        // converted to terrain axes (x / y horizontal, z up).
+        Vector3 toLight = convertWorldToTerrainAxes(-lightVec);
+        toLight.normalise();
+        Real horizLen = Math::Sqrt(toLight.x * toLight.x + toLight.y * toLight.y);
 
-                // get world space point
-                // add a little height padding to stop shadowing self
-                Vector3 wpos = Vector3::ZERO;
-                getPosition(Tx, Ty, getHeightAtTerrainPosition(Tx, Ty) + heightPad, &wpos);
-                wpos += getPosition();
-                // build ray, cast backwards along light direction
-                Ray ray(wpos, -lightVec);
+        long lmSize = static_cast<long>(mLightmapSizeActual);
+        if (horizLen < 1e-6f || lmSize < 2)
+        {
+            // light from straight above lights everything, from below nothing
+            memset(pData, toLight.z > 0 ? 255 : 0, widenedRect.width() * widenedRect.height());
+            return pixbox;
+        }
 
-                // Cascade into neighbours when casting, but don't travel further
-                // than world size
-                std::pair<bool, Vector3> rayHit = rayIntersects(ray, true, mWorldSize);
+        // Neighbours are sampled as well, so that shadows are cast across
+        // terrain boundaries. Grab them once, the sweep runs on several threads
+        struct NeighbourSample
+        {
+            const Terrain* terrain;
+            Real heightOffset;
+        };
+        NeighbourSample neighbours[3][3];
+        bool hasNeighbours = false;
+        {
+            OGRE_LOCK_RW_MUTEX_READ(mNeighbourMutex);
+            for (int ny = -1; ny <= 1; ++ny)
+            {
+                for (int nx = -1; nx <= 1; ++nx)
+                {
+                    NeighbourSample& n = neighbours[ny + 1][nx + 1];
+                    n.terrain = (nx || ny) ? getNeighbour(getNeighbourIndex(nx, ny)) : this;
+                    n.heightOffset = 0;
+                    if (n.terrain && n.terrain != this)
+                    {
+                        n.heightOffset = convertWorldToTerrainAxes(n.terrain->getPosition() - getPosition()).z;
+                        hasNeighbours = true;
+                    }
+                }
+            }
+        }
 
-                if (rayHit.first)
-                    litVal = 0.0f;
+        const Real lowest = -std::numeric_limits<Real>::max();
+        Real texelToTerrain = 1.0f / (Real)(lmSize - 1);
+        // height at a fractional lightmap texel, which may lie on a neighbour
+        auto sampleHeight = [&](Real tx, Real ty) -> Real
+        {
+            tx *= texelToTerrain;
+            ty *= texelToTerrain;
+            int nx = tx < 0 ? -1 : (tx > 1 ? 1 : 0);
+            int ny = ty < 0 ? -1 : (ty > 1 ? 1 : 0);
+            const NeighbourSample& n = neighbours[ny + 1][nx + 1];
+            if (!n.terrain)
+                return lowest;
+            tx = Math::saturate(tx - nx);
+            ty = Math::saturate(ty - ny);
+            return n.terrain->getHeightAtTerrainPosition(tx, ty) + n.heightOffset;
+        };
 
-                // encode as L8
-                // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
+        // walk one texel per step along the dominant axis ('major'), moving
+        // 'minorPerStep' texels along the other one
+        bool majorX = std::abs(toLight.x) >= std::abs(toLight.y);
+        Real lightMajor = majorX ? toLight.x : toLight.y;
+        Real lightMinor = majorX ? toLight.y : toLight.x;
+        long towardsLight = lightMajor > 0 ? 1 : -1;
+        // texels along a line are minorPerStep * major + c
+        Real minorPerStep = lightMinor / lightMajor;
+        // horizontal distance and rise of the light ray per step
+        Real stepDist = mWorldSize * texelToTerrain * horizLen / std::abs(lightMajor);
+        Real risePerStep = stepDist * toLight.z / horizLen;
+
+        long majorLo = majorX ? widenedRect.left : widenedRect.top;
+        long majorHi = (majorX ? widenedRect.right : widenedRect.bottom) - 1;
+        long minorLo = majorX ? widenedRect.top : widenedRect.left;
+        long minorHi = (majorX ? widenedRect.bottom : widenedRect.right) - 1;
+
+        // start the sweep where the light enters; like the ray casting this
+        // replaces, look at most mWorldSize towards the light
+        long reach = static_cast<long>(Math::Ceil(std::abs(lightMajor) * (lmSize - 1)));
+        long upMost = towardsLight > 0 ? majorHi + reach : majorLo - reach;
+        if (!hasNeighbours)
+            upMost = towardsLight > 0 ? std::min(upMost, lmSize - 1) : std::max(upMost, 0L);
+        long downMost = towardsLight > 0 ? majorLo : majorHi;
+        long steps = std::abs(upMost - downMost) + 1;
+
+        // lines are spaced one texel apart along the minor axis, so exactly one
+        // line passes within half a texel of every texel in the target area
+        Real minorShiftLo = std::min(minorPerStep * majorLo, minorPerStep * majorHi);
+        Real minorShiftHi = std::max(minorPerStep * majorLo, minorPerStep * majorHi);
+        long firstLine = static_cast<long>(Math::Floor(minorLo - minorShiftHi)) - 1;
+        long lastLine = static_cast<long>(Math::Ceil(minorHi - minorShiftLo)) + 1;
+        size_t numLines = static_cast<size_t>(lastLine - firstLine + 1);
+
+        size_t rowBytes = static_cast<size_t>(widenedRect.width());
+        parallelFor(numLines, 16, [&](size_t begin, size_t end)
+        {
+            for (size_t line = begin; line < end; ++line)
+            {
+                Real c = static_cast<Real>(firstLine + static_cast<long>(line));
+                // keys are heights with the rise of the light ray removed
+                Real horizon = lowest;
+                for (long step = 0; step < steps; ++step)
+                {
+                    long major = upMost - step * towardsLight;
+                    Real minor = minorPerStep * major + c;
+                    Real rise = risePerStep * step;
 
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX);
-                *pStore = (unsigned char)(litVal * 255.0);
+                    long texel = static_cast<long>(Math::Floor(minor + 0.5f));
+                    if (major >= majorLo && major <= majorHi && texel >= minorLo && texel <= minorHi)
+                    {
+                        long x = majorX ? major : texel;
+                        long y = majorX ? texel : major;
+                        Real h = getHeightAtTerrainPosition(x * texelToTerrain, y * texelToTerrain);
+                        bool lit = horizon <= h + rise + heightPad;
+
+                        // encode as L8
+                        // invert the Y to deal with image space
+                        size_t storeX = static_cast<size_t>(x - widenedRect.left);
+                        size_t storeY = static_cast<size_t>(widenedRect.bottom - y - 1);
+                        pData[storeY * rowBytes + storeX] = lit ? 255 : 0;
+                    }
 
+                    Real h = majorX ? sampleHeight(major, minor) : sampleHeight(minor, major);
+                    if (h != lowest)
+                        horizon = std::max(horizon, h + rise);
+                }
             }
-        }
+        });
 
         return pixbox;
 
@@ -4483,6 +4939,7 @@ namespace Ogre
             Rect rect;
             rect.top = 0; rect.bottom = mSize;
             rect.left = 0; rect.right = mSize;
+            updateHeightBounds(rect);
             calculateHeightDeltas(rect);
             finaliseHeightDeltas(rect, true);
 
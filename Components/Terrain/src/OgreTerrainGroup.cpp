@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreTerrainAutoUpdateLod.h"
 #include "OgreTerrainMaterialGeneratorA.h"
+#include "OgreParallel.h"
 #include <cmath>
 #include <iomanip>
 
@@ -512,6 +513,48 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    void TerrainGroup::getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* outHeights,
+                                                  Terrain** outTerrains /*= 0*/) const
+    {
+        // hand runs of positions on the same terrain over in one go
+        size_t runStart = 0;
+        Terrain* runTerrain = 0;
+        for (size_t i = 0; i <= count; ++i)
+        {
+            Terrain* terrain = 0;
+            if (i < count)
+            {
+                long x, y;
+                convertWorldPositionToTerrainSlot(positions[i], &x, &y);
+                TerrainSlot* slot = getTerrainSlot(x, y);
+                if (slot && slot->instance && slot->instance->isLoaded())
+                    terrain = slot->instance;
+                if (outTerrains)
+                    outTerrains[i] = terrain;
+            }
+
+            if (i == count || terrain != runTerrain)
+            {
+                if (runTerrain)
+                    runTerrain->getHeightsAtWorldPositions(positions + runStart, i - runStart, outHeights + runStart);
+                else
+                    std::fill(outHeights + runStart, outHeights + i, 0.0f);
+                runStart = i;
+                runTerrain = terrain;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::rayIntersectsBatch(const Ray* rays, size_t count, RayResult* outResults,
+                                          Real distanceLimit /*= 0*/) const
+    {
+        parallelFor(count, 64, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                outResults[i] = rayIntersects(rays[i], distanceLimit);
+        });
+    }
+    //---------------------------------------------------------------------
     TerrainGroup::RayResult TerrainGroup::rayIntersects(const Ray& ray, Real distanceLimit /* = 0*/) const 
     {
         long curr_x, curr_z;
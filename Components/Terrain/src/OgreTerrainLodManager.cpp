@@ -36,7 +36,102 @@ namespace Ogre
 {
     const uint16 TerrainLodManager::WORKQUEUE_LOAD_LOD_DATA_REQUEST = 1;
     const uint32 TerrainLodManager::TERRAINLODDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TLDA");
-    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 1;
+    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 2;
+
+    namespace
+    {
+        /// How the data of a version 2 LOD chunk is stored
+        enum LodDataEncoding
+        {
+            /// height & delta floats, as in version 1
+            LOD_ENCODING_FLOAT = 0,
+            /// quantised height residuals against the interpolated LOD level above
+            LOD_ENCODING_QUANTISED = 1
+        };
+
+        /// Call func(x, y) for every vertex introduced at lodLevel, in the order separateData stores them
+        template<typename F>
+        void forEachLodVertex(uint16 size, uint16 numLodLevels, uint lodLevel, const F& func)
+        {
+            unsigned int inc = 1 << lodLevel;
+            unsigned int prev = 1 << (lodLevel + 1);
+            bool coarsest = lodLevel == numLodLevels - static_cast<uint>(1);
+
+            for (uint16 y = 0; y < size; y += inc)
+            {
+                for (uint16 x = 0; x < size-1; x += inc)
+                    if (coarsest || (x % prev) || (y % prev))
+                        func(x, y);
+                if (coarsest || (y % prev))
+                    func(size-1, y);
+                if (y+inc > size)
+                    break;
+            }
+        }
+
+        /** Find the two vertices of the LOD level above lodLevel whose average is the height
+            that Terrain::calculateHeightDeltas interpolates for a vertex introduced at lodLevel.
+        */
+        void getLodParents(uint16 size, uint lodLevel, uint x, uint y, size_t& a, size_t& b)
+        {
+            uint half = 1 << lodLevel;
+            uint step = half << 1;
+            if (y % step == 0)
+            {
+                // on a horizontal edge
+                a = y * size + x - half;
+                b = a + step;
+            }
+            else if (x % step == 0)
+            {
+                // on a vertical edge
+                a = (y - half) * size + x;
+                b = (y + half) * size + x;
+            }
+            else
+            {
+                // on the diagonal, which alternates with the tri strip rows
+                uint i = x - half, j = y - half;
+                if ((j / step) % 2 == 0)
+                {
+                    a = j * size + i;
+                    b = (j + step) * size + i + step;
+                }
+                else
+                {
+                    a = j * size + i + step;
+                    b = (j + step) * size + i;
+                }
+            }
+        }
+
+        /// Append a zigzag varint, so small residuals of either sign take a single byte
+        void writeResidual(std::vector<uint8>& bytes, int32 residual)
+        {
+            uint32 z = (uint32(residual) << 1) ^ uint32(residual >> 31);
+            while (z >= 0x80)
+            {
+                bytes.push_back(uint8(z | 0x80));
+                z >>= 7;
+            }
+            bytes.push_back(uint8(z));
+        }
+
+        int32 readResidual(const uint8*& src, const uint8* end)
+        {
+            uint32 z = 0;
+            for (int shift = 0; shift < 32; shift += 7)
+            {
+                if (src == end)
+                    break;
+                uint8 byte = *src++;
+                z |= uint32(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return int32(z >> 1) ^ -int32(z & 1);
+            }
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt terrain LOD data", "TerrainLodManager::readLodData");
+        }
+    }
 
     TerrainLodManager::TerrainLodManager(Terrain* t, DataStreamPtr& stream)
         : mTerrain(t)
@@ -306,21 +401,87 @@ namespace Ogre
     // save each LOD level separately compressed so seek is possible
     void TerrainLodManager::saveLodData(StreamSerialiser& stream, Terrain* terrain)
     {
+        uint8 bits = TerrainGlobalOptions::getSingleton().getHeightDataQuantisationBits();
+        if (bits)
+        {
+            saveQuantisedLodData(stream, terrain, bits);
+            return;
+        }
+
         uint16 numLodLevels = terrain->getNumLodLevels();
 
         LodsData lods;
         separateData(terrain->mHeightData, terrain->getSize(), numLodLevels, lods);
         separateData(terrain->mDeltaData, terrain->getSize(), numLodLevels, lods);
 
+        uint8 encoding = LOD_ENCODING_FLOAT;
         for (int level = numLodLevels - 1; level >=0; level--)
         {
             stream.writeChunkBegin(TERRAINLODDATA_CHUNK_ID, TERRAINLODDATA_CHUNK_VERSION);
+            stream.write(&encoding);
             stream.startDeflate();
             stream.write(&(lods[level][0]), lods[level].size());
             stream.stopDeflate();
             stream.writeChunkEnd(TERRAINLODDATA_CHUNK_ID);
         }
     }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::saveQuantisedLodData(StreamSerialiser& stream, Terrain* terrain, uint8 bits)
+    {
+        uint16 numLodLevels = terrain->getNumLodLevels();
+        uint16 size = terrain->getSize();
+        size_t numVertices = size_t(size) * size;
+        const float* heights = terrain->mHeightData;
+
+        // quantise against the height range of this terrain
+        auto range = std::minmax_element(heights, heights + numVertices);
+        float minHeight = *range.first;
+        long maxValue = (1l << bits) - 1;
+        float heightStep = (*range.second - minHeight) / maxValue;
+
+        std::vector<uint16> quantisedHeights(numVertices, 0);
+        if (heightStep > 0)
+        {
+            for (size_t i = 0; i < numVertices; ++i)
+                quantisedHeights[i] = uint16(std::min(std::lround((heights[i] - minHeight) / heightStep), maxValue));
+        }
+
+        uint8 encoding = LOD_ENCODING_QUANTISED;
+        std::vector<uint8> residuals;
+        for (int level = numLodLevels - 1; level >= 0; level--)
+        {
+            // the coarsest level is predicted from the previously stored vertex, all
+            // others from the interpolation of the level above, which is what the
+            // morphing deltas are relative to as well
+            bool coarsest = level == numLodLevels - 1;
+            int32 previous = 0;
+            residuals.clear();
+            forEachLodVertex(size, numLodLevels, level, [&](uint x, uint y)
+            {
+                int32 value = quantisedHeights[y * size + x];
+                int32 predicted = previous;
+                if (!coarsest)
+                {
+                    size_t a, b;
+                    getLodParents(size, level, x, y, a, b);
+                    predicted = (int32(quantisedHeights[a]) + quantisedHeights[b] + 1) >> 1;
+                }
+                writeResidual(residuals, value - predicted);
+                previous = value;
+            });
+
+            uint32 numBytes = uint32(residuals.size());
+            stream.writeChunkBegin(TERRAINLODDATA_CHUNK_ID, TERRAINLODDATA_CHUNK_VERSION);
+            stream.write(&encoding);
+            stream.write(&minHeight);
+            stream.write(&heightStep);
+            stream.write(&numBytes);
+            stream.startDeflate();
+            stream.write(residuals.data(), residuals.size());
+            stream.stopDeflate();
+            stream.writeChunkEnd(TERRAINLODDATA_CHUNK_ID);
+        }
+    }
 
     void TerrainLodManager::readLodData(uint16 lowerLodBound, uint16 higherLodBound)
     {
@@ -339,37 +500,94 @@ namespace Ogre
             stream.readChunkBegin(Terrain::TERRAINGENERALINFO_CHUNK_ID, Terrain::TERRAINGENERALINFO_CHUNK_VERSION);
             stream.readChunkEnd(Terrain::TERRAINGENERALINFO_CHUNK_ID);
 
-            // skip the previous lod data
-            for(int skip=numLodLevels-1-lowerLodBound; skip>0; skip--)
-            {
-                stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID, TERRAINLODDATA_CHUNK_VERSION);
-                stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
-            }
-
             // uncompress
-            uint maxSize = 2 * mTerrain->getGeoDataSizeAtLod(higherLodBound);
-            float *lodData = OGRE_ALLOC_T(float, maxSize, MEMCATEGORY_GENERAL);
+            LodData lodData;
+            std::vector<uint16> quantisedHeights;
 
-            for(int level=lowerLodBound; level>=higherLodBound; level-- )
+            for(int level=numLodLevels-1; level>=higherLodBound; level-- )
             {
-                // both height data and delta data
-                uint dataSize = 2 * mTerrain->getGeoDataSizeAtLod(level);
-
-                // reach and read the target lod data
                 const StreamSerialiser::Chunk *c = stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID,
                         TERRAINLODDATA_CHUNK_VERSION);
-                stream.startDeflate(c->length);
-                stream.read(lodData, dataSize);
-                stream.stopDeflate();
-                stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
+                uint8 encoding = LOD_ENCODING_FLOAT;
+                if (c->version > 1)
+                    stream.read(&encoding);
 
-                fillBufferAtLod(level, lodData, dataSize);
+                if (encoding == LOD_ENCODING_QUANTISED)
+                {
+                    // residuals are relative to the levels above, so these are decoded
+                    // even if they are already prepared
+                    if (quantisedHeights.empty())
+                        quantisedHeights.resize(size_t(mTerrain->getSize()) * mTerrain->getSize());
+                    readQuantisedLodLevel(stream, level, quantisedHeights.data(), level <= lowerLodBound);
+                }
+                else if (level <= lowerLodBound)
+                {
+                    // both height data and delta data
+                    uint dataSize = 2 * mTerrain->getGeoDataSizeAtLod(level);
+                    lodData.resize(dataSize);
+
+                    stream.startDeflate(c->length - stream.getOffsetFromChunkStart());
+                    stream.read(lodData.data(), dataSize);
+                    stream.stopDeflate();
+
+                    fillBufferAtLod(level, lodData.data(), dataSize);
+                }
+                // else skip the previous lod data
+                stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
             }
             stream.readChunkEnd(Terrain::TERRAIN_CHUNK_ID);
-
-            OGRE_FREE(lodData, MEMCATEGORY_GENERAL);
         }
     }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::readQuantisedLodLevel(StreamSerialiser& stream, uint lodLevel,
+                                                  uint16* quantisedHeights, bool fillBuffer)
+    {
+        float minHeight, heightStep;
+        uint32 numBytes;
+        stream.read(&minHeight);
+        stream.read(&heightStep);
+        stream.read(&numBytes);
+
+        std::vector<uint8> residuals(numBytes);
+        stream.startDeflate(stream.getCurrentChunk()->length - stream.getOffsetFromChunkStart());
+        stream.read(residuals.data(), numBytes);
+        stream.stopDeflate();
+
+        uint16 numLodLevels = mTerrain->getNumLodLevels();
+        uint16 size = mTerrain->getSize();
+        bool coarsest = lodLevel == numLodLevels - static_cast<uint>(1);
+        const uint8* src = residuals.data();
+        const uint8* end = src + residuals.size();
+        int32 previous = 0;
+
+        forEachLodVertex(size, numLodLevels, lodLevel, [&](uint x, uint y)
+        {
+            size_t i = y * size + x;
+            size_t a = i, b = i;
+            int32 predicted = previous;
+            if (!coarsest)
+            {
+                getLodParents(size, lodLevel, x, y, a, b);
+                predicted = (int32(quantisedHeights[a]) + quantisedHeights[b] + 1) >> 1;
+            }
+            int32 value = predicted + readResidual(src, end);
+            if (value < 0 || value > 0xffff)
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt terrain LOD data",
+                            "TerrainLodManager::readLodData");
+            quantisedHeights[i] = uint16(value);
+            previous = value;
+
+            if (fillBuffer)
+            {
+                mTerrain->mHeightData[i] = minHeight + value * heightStep;
+                // the coarsest level is never morphed, and neither are the far edges
+                // as Terrain::calculateHeightDeltas does not reach them
+                bool morphed = !coarsest && x != size - 1u && y != size - 1u;
+                mTerrain->mDeltaData[i] = !morphed ? 0 :
+                    (0.5f * (float(quantisedHeights[a]) + quantisedHeights[b]) - value) * heightStep;
+            }
+        });
+    }
     void TerrainLodManager::fillBufferAtLod(uint lodLevel, const float* data, uint dataSize )
     {
         unsigned int inc = 1 << lodLevel;
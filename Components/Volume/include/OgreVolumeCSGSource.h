@@ -71,6 +71,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
     };
 
     /** A plane.
@@ -102,6 +111,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
     };
 
     /** A not rotated cube.
@@ -166,6 +184,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
     };
 
     /** Abstract operation volume source holding two sources as operants.
@@ -244,6 +271,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
     };
 
     /** Builds the union between two sources.
@@ -271,6 +307,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
     };
 
     /** Builds the difference between two sources.
@@ -299,6 +344,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
     };
 
     /** Source which does a unary operation to another one.
@@ -359,6 +413,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
     };
 
     /** Scales the given volume source.
@@ -386,6 +449,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
     };
 
     class _OgreVolumeExport CSGNoiseSource: public CSGUnarySource
@@ -429,6 +501,20 @@ namespace Volume {
             return mSrc->getValue(position) + toAdd;
         }
 
+        /* Gets the density values of many positions, see Source::getValues.
+        @param x
+            The x coordinates of the positions.
+        @param y
+            The y coordinates of the positions.
+        @param z
+            The z coordinates of the positions.
+        @param count
+            The amount of positions.
+        @param values
+            Receives the values.
+        */
+        void getInternalValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
     public:
         
         /** Constructor.
@@ -464,6 +550,15 @@ namespace Volume {
         /** Overridden from Source.
         */
         virtual Real getValue(const Vector3 &position) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Overridden from Source.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
         
         /** Gets the initial seed.
         @return
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __Ogre_Volume_CacheSource_H__
 
 #include "OgreVector.h"
+#include "OgreCommon.h"
 
 #include "OgreVolumeSource.h"
 #include "OgreVolumePrerequisites.h"
@@ -57,12 +58,36 @@ namespace Volume {
     {
     protected:
         
-        /// Map for the cache
-        typedef std::map<Vector3, Vector4> UMapPositionValue;
-        mutable UMapPositionValue mCache;
+        /// An entry of the cache.
+        struct CacheEntry
+        {
+            /// The cached position.
+            Vector3 position;
+            /// The density value and gradient at the position.
+            Vector4 value;
+            /// Whether this slot holds a value.
+            bool used;
+
+            CacheEntry() : used(false)
+            {
+            }
+        };
+
+        /** Open addressing hash table for the cache. All values live in one array
+            which can be freed at once with clear.
+        */
+        typedef std::vector<CacheEntry> VecCacheEntry;
+        mutable VecCacheEntry mCache;
+
+        /// The amount of used entries in the cache.
+        mutable size_t mCacheCount;
 
         /// The source to cache.
         const Source *mSrc;
+
+        /** Doubles the size of the cache table and reinserts the cached values.
+        */
+        void growCache(void) const;
         
         /** Gets a density value and gradient from the cache.
         @param position
@@ -72,18 +97,27 @@ namespace Volume {
         */
         inline Vector4 getFromCache(const Vector3 &position) const
         {
-            Vector4 result;
-            std::map<Vector3, Vector4>::iterator it = mCache.find(position);
-            if (it == mCache.end())
+            // Keep the table at most half full so the probe sequences stay short.
+            if ((mCacheCount + 1) * 2 > mCache.size())
             {
-                result = mSrc->getValueAndGradient(position);
-                mCache[position] = result;
+                growCache();
             }
-            else
+            const size_t mask = mCache.size() - 1;
+            size_t slot = FastHash((const char*)&position, sizeof(Vector3)) & mask;
+            while (mCache[slot].used)
             {
-                result = it->second;
+                if (memcmp(&mCache[slot].position, &position, sizeof(Vector3)) == 0)
+                {
+                    return mCache[slot].value;
+                }
+                slot = (slot + 1) & mask;
             }
-            return result;
+            CacheEntry &entry = mCache[slot];
+            entry.position = position;
+            entry.value = mSrc->getValueAndGradient(position);
+            entry.used = true;
+            ++mCacheCount;
+            return entry.value;
         }
 
     public:
@@ -102,6 +136,11 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const;
 
+        /** Frees all cached values at once, for example after the chunks using this
+            source have been loaded.
+        */
+        void clear(void);
+
     };
     /** @} */
     /** @} */
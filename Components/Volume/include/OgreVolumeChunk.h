@@ -125,9 +125,22 @@ namespace Volume {
         /// The parameters with which the chunktree got loaded.
         ChunkParameters *parameters;
 
+        /// The scene node the chunktree got loaded into.
+        SceneNode *parentNode;
+
+        /// The back lower left corner of the whole chunktree.
+        Vector3 totalFrom;
+
+        /// The front upper right corner of the whole chunktree.
+        Vector3 totalTo;
+
+        /// The amount of LOD levels of the chunktree.
+        size_t levels;
+
         /** Constructor.
         */
-        ChunkTreeSharedData(const ChunkParameters *params) : octreeVisible(false), dualGridVisible(false), volumeVisible(true), chunksBeingProcessed(0)
+        ChunkTreeSharedData(const ChunkParameters *params) : octreeVisible(false), dualGridVisible(false), volumeVisible(true), chunksBeingProcessed(0),
+            parentNode(0), totalFrom(Vector3::ZERO), totalTo(Vector3::ZERO), levels(0)
         {
             this->parameters = new ChunkParameters(*params);
         }
@@ -178,6 +191,9 @@ namespace Volume {
         /// Holds some shared data among all chunks of the tree.
         ChunkTreeSharedData *mShared;
 
+        /// Counts the geometry requests of this chunk so results of outdated ones can be dropped.
+        uint32 mRevision;
+
         /** Loads a single chunk of the tree.
         @param parent
             The parent scene node for the volume
@@ -352,6 +368,17 @@ namespace Volume {
         */
         virtual void load(SceneNode *parent, const Vector3 &from, const Vector3 &to, size_t level, const ChunkParameters *parameters);
 
+        /** Regenerates the parts of a loaded chunktree which intersect the given area, for example
+        after the source got modified by a brush. Only the chunks of all levels intersecting the
+        area get their density evaluated and their mesh rebuilt, in the background if the tree
+        was loaded async. Each of them keeps showing its old mesh until the new one is ready.
+        Must be called on the root chunk. Sources caching values like the CacheSource must be
+        cleared beforehand.
+        @param dirtyArea
+            The changed area in volume space.
+        */
+        virtual void updateRegion(const AxisAlignedBox &dirtyArea);
+
         /** Loads a TextureSource volume scene from a config file.
         @param parent
             The parent scene node for the volume.
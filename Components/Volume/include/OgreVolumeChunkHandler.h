@@ -78,6 +78,9 @@ namespace Volume {
 
         /// Whether this is an update of an existing tree
         bool isUpdate;
+
+        /// The revision of the origin chunk when the request was made.
+        uint32 revision;
     } ChunkRequest;
     
     /** Handles the WorkQueue management of the chunks.
@@ -158,6 +158,10 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const;
 
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
         /** Gets the width of the texture.
         @return
             The width of the texture.
@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 
 #include "OgreVolumeGridSource.h"
+#include "OgreBitwise.h"
 
 namespace Ogre {
 namespace Volume {
@@ -56,6 +57,24 @@ namespace Volume {
         /// influencing the compression rate on serialization.
         Real mMaxClampedAbsoluteDensity;
         
+        /** Gets the volume value of a position, clamped to the grid.
+        @param x
+            The x position.
+        @param y
+            The y position.
+        @param z
+            The z position.
+        @return
+            The density.
+        */
+        inline float getHalfFloatValue(size_t x, size_t y, size_t z) const
+        {
+            x = x >= mWidth ? mWidth - 1 : x;
+            y = y >= mHeight ? mHeight - 1 : y;
+            z = z >= mDepth ? mDepth - 1 : z;
+            return Bitwise::halfToFloat(mData[(mDepth - z - 1) * mDepthTimesHeight + x * mHeight + y]);
+        }
+
         /** Overridden from GridSource.
         */
         virtual float getVolumeGridValue(size_t x, size_t y, size_t z) const;
@@ -96,6 +115,10 @@ namespace Volume {
         */
         ~HalfFloatGridSource(void);
 
+        /** Overridden from GridSource, reads the grid without virtual calls.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
     };
     /** @} */
     /** @} */
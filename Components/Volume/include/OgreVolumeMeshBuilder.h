@@ -138,9 +138,10 @@ namespace Volume {
         /// The buffer binding.
         static const unsigned short MAIN_BINDING;
 
-        /// Map to get a vertex index.
-        typedef std::map<Vertex, size_t> UMapVertexIndex;
-        UMapVertexIndex mIndexMap;
+        /** Open addressing hash table to weld vertices. Holds the index into mVertices plus one,
+            zero marks a free slot. Unlike a map, it does not allocate per vertex.
+        */
+        VecIndices mIndexSlots;
 
          /// Holds the vertices of the mesh.
         VecVertex mVertices;
@@ -160,54 +161,66 @@ namespace Volume {
         */
         inline void addVertex(const Vertex &v)
         {
-            size_t i = 0;
-            if (mIndexMap.find(v) == mIndexMap.end())
+            // Keep the table at most half full so the probe sequences stay short.
+            if ((mVertices.size() + 1) * 2 > mIndexSlots.size())
             {
-                i = mVertices.size();
-                mIndexMap[v] = i;
-                mVertices.push_back(v);
-
-                // Update bounding box
-                if (!mBoxInit)
-                {
-                    mBox.setExtents(v.x, v.y, v.z, v.x, v.y, v.z);
-                    mBoxInit = true;
-                }
-                else
+                growIndexSlots();
+            }
+            const size_t mask = mIndexSlots.size() - 1;
+            size_t slot = FastHash((const char*)&v, sizeof(Vertex)) & mask;
+            while (mIndexSlots[slot])
+            {
+                size_t known = mIndexSlots[slot] - 1;
+                if (memcmp(&mVertices[known], &v, sizeof(Vertex)) == 0)
                 {
-                    if (v.x < mBox.getMinimum().x)
-                    {
-                        mBox.setMinimumX(v.x);
-                    }
-                    if (v.y < mBox.getMinimum().y)
-                    {
-                        mBox.setMinimumY(v.y);
-                    }
-                    if (v.z < mBox.getMinimum().z)
-                    {
-                        mBox.setMinimumZ(v.z);
-                    }
-                    if (v.x > mBox.getMaximum().x)
-                    {
-                        mBox.setMaximumX(v.x);
-                    }
-                    if (v.y > mBox.getMaximum().y)
-                    {
-                        mBox.setMaximumY(v.y);
-                    }
-                    if (v.z > mBox.getMaximum().z)
-                    {
-                        mBox.setMaximumZ(v.z);
-                    }
+                    mIndices.push_back(known);
+                    return;
                 }
+                slot = (slot + 1) & mask;
+            }
+            size_t i = mVertices.size();
+            mIndexSlots[slot] = i + 1;
+            mVertices.push_back(v);
+            // Update bounding box
+            if (!mBoxInit)
+            {
+                mBox.setExtents(v.x, v.y, v.z, v.x, v.y, v.z);
+                mBoxInit = true;
             }
             else
             {
-                i = mIndexMap[v];
+                if (v.x < mBox.getMinimum().x)
+                {
+                    mBox.setMinimumX(v.x);
+                }
+                if (v.y < mBox.getMinimum().y)
+                {
+                    mBox.setMinimumY(v.y);
+                }
+                if (v.z < mBox.getMinimum().z)
+                {
+                    mBox.setMinimumZ(v.z);
+                }
+                if (v.x > mBox.getMaximum().x)
+                {
+                    mBox.setMaximumX(v.x);
+                }
+                if (v.y > mBox.getMaximum().y)
+                {
+                    mBox.setMaximumY(v.y);
+                }
+                if (v.z > mBox.getMaximum().z)
+                {
+                    mBox.setMaximumZ(v.z);
+                }
             }
             mIndices.push_back(i);
         }
 
+        /** Doubles the size of the vertex hash table and reinserts the known vertices.
+        */
+        void growIndexSlots(void);
+
     public:
         
         /** Adds a cube to a manual object rendering lines. Corner numeration:
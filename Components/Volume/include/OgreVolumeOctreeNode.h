@@ -79,6 +79,17 @@ namespace Volume {
             The manual object to add the lines to if this is a leaf in the octree.
         */
         void buildOctreeGridLines(ManualObject *manual) const;
+
+        /** Splits this cell recursively like split but only collects the leaves still
+            missing their center value instead of evaluating the source for each one.
+        @param splitPolicy
+            Defines the policy deciding whether to split this node or not.
+        @param geometricError
+            The accepted geometric error.
+        @param pendingLeaves
+            Receives the leaves without center value.
+        */
+        void splitRecursive(const OctreeNodeSplitPolicy *splitPolicy, const Real geometricError, std::vector<OctreeNode*> &pendingLeaves);
     public:
 
         /// Even in an OCtree, the amount of children should not be hardcoded.
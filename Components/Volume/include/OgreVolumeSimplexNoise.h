@@ -86,6 +86,25 @@ namespace Volume {
             return g.x * x + g.y * y + g.z * z;
         }
                 
+        /** Finds the simplex of a position and the offsets and gradient indices of its
+        four corners.
+        @param xIn
+            The first dimension parameter.
+        @param yIn
+            The second dimension parameter.
+        @param zIn
+            The third dimension parameter.
+        @param x
+            Receives the first dimension offsets of the corners.
+        @param y
+            Receives the second dimension offsets of the corners.
+        @param z
+            Receives the third dimension offsets of the corners.
+        @param gi
+            Receives the gradient indices of the corners.
+        */
+        void getCorners(Real xIn, Real yIn, Real zIn, Real *x, Real *y, Real *z, int *gi) const;
+
         /** Initializes the SimplexNoise instance.
         */
         void init(unsigned long definedSeed);
@@ -113,6 +132,25 @@ namespace Volume {
             The noise value.
         */
         Real noise(Real xIn, Real yIn, Real zIn) const;
+
+        /** 3D noise function for many positions at once, adds the scaled noise of
+        the scaled positions to the given values.
+        @param xIn
+            The first dimension parameters.
+        @param yIn
+            The second dimension parameters.
+        @param zIn
+            The third dimension parameters.
+        @param count
+            The amount of positions.
+        @param frequency
+            The factor to scale the positions with.
+        @param amplitude
+            The factor to scale the noise values with.
+        @param values
+            The values to add the noise to.
+        */
+        void addNoise(const Real *xIn, const Real *yIn, const Real *zIn, size_t count, Real frequency, Real amplitude, Real *values) const;
         
         /** Gets the current seed.
         @return
@@ -101,6 +101,44 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const = 0;
 
+        /** Gets the density values of many positions at once. The positions are given as
+        separate coordinate arrays so implementations can process several of them in SIMD
+        registers. The default implementation calls getValue for each position.
+        @param x
+            The x coordinates of the positions.
+        @param y
+            The y coordinates of the positions.
+        @param z
+            The z coordinates of the positions.
+        @param count
+            The amount of positions.
+        @param values
+            Receives the densities, must hold count elements.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
+        /** Gets the density values and gradients of many positions at once, see getValues.
+        The default implementation calls getValueAndGradient for each position.
+        @param x
+            The x coordinates of the positions.
+        @param y
+            The y coordinates of the positions.
+        @param z
+            The z coordinates of the positions.
+        @param count
+            The amount of positions.
+        @param gradientX
+            Receives the x components of the gradients, must hold count elements.
+        @param gradientY
+            Receives the y components of the gradients, must hold count elements.
+        @param gradientZ
+            Receives the z components of the gradients, must hold count elements.
+        @param values
+            Receives the densities, must hold count elements.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+            Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const;
+
         /** Serializes a volume source to a discrete grid file with deflated
         compression. To achieve better compression, all density values are clamped
         within a maximum absolute value of (to - from).length() / 16.0. The values
@@ -51,6 +51,24 @@ namespace Volume {
         /// The raw volume data.
         float *mData;
         
+        /** Gets the volume value of a position, clamped to the texture.
+        @param x
+            The x position.
+        @param y
+            The y position.
+        @param z
+            The z position.
+        @return
+            The density.
+        */
+        inline float getTextureValue(size_t x, size_t y, size_t z) const
+        {
+            x = x >= mWidth ? mWidth - 1 : x;
+            y = y >= mHeight ? mHeight - 1 : y;
+            z = z >= mDepth ? mDepth - 1 : z;
+            return mData[(mDepth - z - 1) * mWidthTimesHeight + y * mWidth + x];
+        }
+
         /** Overridden from GridSource.
         */
         virtual float getVolumeGridValue(size_t x, size_t y, size_t z) const;
@@ -83,6 +101,10 @@ namespace Volume {
         */
         ~TextureSource(void);
 
+        /** Overridden from GridSource, reads the grid without virtual calls.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const;
+
     };
     /** @} */
     /** @} */
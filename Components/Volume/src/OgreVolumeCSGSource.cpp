@@ -27,9 +27,78 @@ THE SOFTWARE.
 #include "OgreVolumeCSGSource.h"
 #include <algorithm>
 
+#include "OgreVolumeSourceBatch.h"
+
 namespace Ogre {
 namespace Volume {
 
+namespace {
+    /// Multiplies the values with a factor.
+    void scaleValues(Real *values, size_t count, Real factor)
+    {
+        const Real4 f(factor);
+        forEachReal4(count, [&](size_t i, size_t n)
+        {
+            (f * Real4::load(values + i, n)).store(values + i, n);
+        });
+    }
+
+    /** Picks for each position the smaller (or bigger if takeMax) value of a and
+    b, b being multiplied by signB first.
+    */
+    void combineValues(const Source *a, const Source *b, Real signB, bool takeMax,
+        const Real *x, const Real *y, const Real *z, size_t count, Real *values)
+    {
+        const Real4 sign(signB);
+        Real valuesB[SOURCE_BATCH_BLOCK];
+        for (size_t begin = 0; begin < count; begin += SOURCE_BATCH_BLOCK)
+        {
+            size_t n = std::min(SOURCE_BATCH_BLOCK, count - begin);
+            Real *valuesA = values + begin;
+            a->getValues(x + begin, y + begin, z + begin, n, valuesA);
+            b->getValues(x + begin, y + begin, z + begin, n, valuesB);
+            forEachReal4(n, [&](size_t i, size_t m)
+            {
+                Real4 valueA = Real4::load(valuesA + i, m);
+                Real4 valueB = sign * Real4::load(valuesB + i, m);
+                Real4 result = takeMax ? selectLess(valueB, valueA, valueA, valueB) : selectLess(valueA, valueB, valueA, valueB);
+                result.store(valuesA + i, m);
+            });
+        }
+    }
+
+    /** Like combineValues but picks the gradient with the value.
+    */
+    void combineValuesAndGradients(const Source *a, const Source *b, Real signB, bool takeMax,
+        const Real *x, const Real *y, const Real *z, size_t count, Real *gradientX, Real *gradientY, Real *gradientZ, Real *values)
+    {
+        const Real4 sign(signB);
+        Real gradientBX[SOURCE_BATCH_BLOCK], gradientBY[SOURCE_BATCH_BLOCK], gradientBZ[SOURCE_BATCH_BLOCK], valuesB[SOURCE_BATCH_BLOCK];
+        for (size_t begin = 0; begin < count; begin += SOURCE_BATCH_BLOCK)
+        {
+            size_t n = std::min(SOURCE_BATCH_BLOCK, count - begin);
+            Real *resultA[4] = {gradientX + begin, gradientY + begin, gradientZ + begin, values + begin};
+            const Real *resultB[4] = {gradientBX, gradientBY, gradientBZ, valuesB};
+            a->getValuesAndGradients(x + begin, y + begin, z + begin, n, resultA[0], resultA[1], resultA[2], resultA[3]);
+            b->getValuesAndGradients(x + begin, y + begin, z + begin, n, gradientBX, gradientBY, gradientBZ, valuesB);
+            forEachReal4(n, [&](size_t i, size_t m)
+            {
+                Real4 valueA = Real4::load(resultA[3] + i, m);
+                Real4 valueB = sign * Real4::load(valuesB + i, m);
+                Real4 left = takeMax ? valueB : valueA;
+                Real4 right = takeMax ? valueA : valueB;
+                for (int c = 0; c < 4; ++c)
+                {
+                    Real4 componentA = Real4::load(resultA[c] + i, m);
+                    Real4 componentB = sign * Real4::load(resultB[c] + i, m);
+                    // left < right picks a in both modes.
+                    selectLess(left, right, componentA, componentB).store(resultA[c] + i, m);
+                }
+            });
+        }
+    }
+}
+
     Vector3 CSGCubeSource::mBoxNormals[6] = {
         Vector3::UNIT_X,
         Vector3::UNIT_Y,
@@ -49,13 +118,15 @@ namespace Volume {
 
     Vector4 CSGSphereSource::getValueAndGradient(const Vector3 &position) const
     {
-        Vector3 pMinCenter = position- mCenter;
-        Vector3 gradient = pMinCenter;
+        Vector3 gradient = position - mCenter;
+        // Normalise before reading the components, the order of evaluation of
+        // constructor arguments is unspecified.
+        Real distance = gradient.normalise();
         return Vector4(
             gradient.x,
             gradient.y,
             gradient.z,
-            mR - gradient.normalise()
+            mR - distance
             );
     }
     
@@ -69,6 +140,41 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGSphereSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        const Real4 centerX(mCenter.x), centerY(mCenter.y), centerZ(mCenter.z), r(mR);
+        forEachReal4(count, [&](size_t i, size_t n)
+        {
+            Real4 dX = Real4::load(x + i, n) - centerX;
+            Real4 dY = Real4::load(y + i, n) - centerY;
+            Real4 dZ = Real4::load(z + i, n) - centerZ;
+            (r - sqrt(dX * dX + dY * dY + dZ * dZ)).store(values + i, n);
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGSphereSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        const Real4 centerX(mCenter.x), centerY(mCenter.y), centerZ(mCenter.z), r(mR), zero((Real)0.0), one((Real)1.0);
+        forEachReal4(count, [&](size_t i, size_t n)
+        {
+            Real4 dX = Real4::load(x + i, n) - centerX;
+            Real4 dY = Real4::load(y + i, n) - centerY;
+            Real4 dZ = Real4::load(z + i, n) - centerZ;
+            Real4 distance = sqrt(dX * dX + dY * dY + dZ * dZ);
+            Real4 invDistance = one / distance;
+            // Like Vector3::normalise, leave the zero vector alone.
+            selectLess(zero, distance, dX * invDistance, dX).store(gradientX + i, n);
+            selectLess(zero, distance, dY * invDistance, dY).store(gradientY + i, n);
+            selectLess(zero, distance, dZ * invDistance, dZ).store(gradientZ + i, n);
+            (r - distance).store(values + i, n);
+        });
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGPlaneSource::CSGPlaneSource(const Real d, const Vector3 &normal) : mD(d), mNormal(normal.normalisedCopy())
     {
     }
@@ -96,6 +202,28 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGPlaneSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        const Real4 normalX(mNormal.x), normalY(mNormal.y), normalZ(mNormal.z), d(mD);
+        forEachReal4(count, [&](size_t i, size_t n)
+        {
+            (d - (normalX * Real4::load(x + i, n) + normalY * Real4::load(y + i, n) + normalZ * Real4::load(z + i, n))).store(values + i, n);
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGPlaneSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        std::fill(gradientX, gradientX + count, mNormal.x);
+        std::fill(gradientY, gradientY + count, mNormal.y);
+        std::fill(gradientZ, gradientZ + count, mNormal.z);
+        CSGPlaneSource::getValues(x, y, z, count, values);
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGCubeSource::CSGCubeSource(const Vector3 &min, const Vector3 &max)
     {
         mBox.setExtents(min, max);
@@ -127,6 +255,55 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGCubeSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        const Vector3 &boxMin = mBox.getMinimum();
+        const Vector3 &boxMax = mBox.getMaximum();
+        const Real4 minX(boxMin.x), minY(boxMin.y), minZ(boxMin.z), maxX(boxMax.x), maxY(boxMax.y), maxZ(boxMax.z), zero((Real)0.0);
+        forEachReal4(count, [&](size_t i, size_t n)
+        {
+            Real4 pX = Real4::load(x + i, n);
+            Real4 pY = Real4::load(y + i, n);
+            Real4 pZ = Real4::load(z + i, n);
+            Real4 dMinX = pX - minX, dMinY = pY - minY, dMinZ = pZ - minZ;
+            Real4 dMaxX = maxX - pX, dMaxY = maxY - pY, dMaxZ = maxZ - pZ;
+            // The nearest face if inside, this is negative if outside.
+            Real4 inside = min(min(min(dMinX, dMinY), min(dMinZ, dMaxX)), min(dMaxY, dMaxZ));
+            // The distance to the box if outside, see AxisAlignedBox::squaredDistance.
+            Real4 outX = max(max(-dMinX, -dMaxX), zero);
+            Real4 outY = max(max(-dMinY, -dMaxY), zero);
+            Real4 outZ = max(max(-dMinZ, -dMaxZ), zero);
+            Real4 outside = -sqrt(outX * outX + outY * outY + outZ * outZ);
+            selectLess(inside, zero, outside, inside).store(values + i, n);
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGCubeSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        // The same Prewitt approximation like in getValueAndGradient.
+        centralDifferences(x, y, z, count, (Real)1.0,
+            [this](const Real *px, const Real *py, const Real *pz, size_t n, Real *v) { CSGCubeSource::getValues(px, py, pz, n, v); },
+            gradientX, gradientY, gradientZ);
+        const Real4 zero((Real)0.0), minusOne((Real)-1.0);
+        forEachReal4(count, [&](size_t i, size_t n)
+        {
+            Real4 gX = Real4::load(gradientX + i, n);
+            Real4 gY = Real4::load(gradientY + i, n);
+            Real4 gZ = Real4::load(gradientZ + i, n);
+            Real4 length = sqrt(gX * gX + gY * gY + gZ * gZ);
+            Real4 scale = selectLess(zero, length, minusOne / length, minusOne);
+            (gX * scale).store(gradientX + i, n);
+            (gY * scale).store(gradientY + i, n);
+            (gZ * scale).store(gradientZ + i, n);
+        });
+        CSGCubeSource::getValues(x, y, z, count, values);
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGOperationSource::CSGOperationSource(const Source *a, const Source *b) : mA(a), mB(b)
     {
     }
@@ -205,6 +382,21 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGIntersectionSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        combineValues(mA, mB, (Real)1.0, false, x, y, z, count, values);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGIntersectionSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        combineValuesAndGradients(mA, mB, (Real)1.0, false, x, y, z, count, gradientX, gradientY, gradientZ, values);
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGUnionSource::CSGUnionSource(const Source *a, const Source *b) : CSGOperationSource(a, b)
     {
     }
@@ -243,6 +435,21 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGUnionSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        combineValues(mA, mB, (Real)1.0, true, x, y, z, count, values);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGUnionSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        combineValuesAndGradients(mA, mB, (Real)1.0, true, x, y, z, count, gradientX, gradientY, gradientZ, values);
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGDifferenceSource::CSGDifferenceSource(const Source *a, const Source *b) : CSGOperationSource(a, b)
     {
     }
@@ -281,6 +488,21 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGDifferenceSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        combineValues(mA, mB, (Real)-1.0, false, x, y, z, count, values);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGDifferenceSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        combineValuesAndGradients(mA, mB, (Real)-1.0, false, x, y, z, count, gradientX, gradientY, gradientZ, values);
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGUnarySource::CSGUnarySource(const Source *src) : mSrc(src)
     {
     }
@@ -333,6 +555,26 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGNegateSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        mSrc->getValues(x, y, z, count, values);
+        scaleValues(values, count, (Real)-1.0);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGNegateSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        mSrc->getValuesAndGradients(x, y, z, count, gradientX, gradientY, gradientZ, values);
+        scaleValues(gradientX, count, (Real)-1.0);
+        scaleValues(gradientY, count, (Real)-1.0);
+        scaleValues(gradientZ, count, (Real)-1.0);
+        scaleValues(values, count, (Real)-1.0);
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGScaleSource::CSGScaleSource(const Source *src, const Real scale) : CSGUnarySource(src), mScale(scale)
     {
     }
@@ -353,6 +595,35 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGScaleSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        const Real invScale = (Real)1.0 / mScale;
+        forEachTransformedBlock(x, y, z, count,
+            [invScale](Real &px, Real &py, Real &pz) { px *= invScale; py *= invScale; pz *= invScale; },
+            [&](size_t begin, size_t n, const Real *px, const Real *py, const Real *pz) { mSrc->getValues(px, py, pz, n, values + begin); });
+        scaleValues(values, count, mScale);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGScaleSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        const Real invScale = (Real)1.0 / mScale;
+        forEachTransformedBlock(x, y, z, count,
+            [invScale](Real &px, Real &py, Real &pz) { px *= invScale; py *= invScale; pz *= invScale; },
+            [&](size_t begin, size_t n, const Real *px, const Real *py, const Real *pz)
+            {
+                mSrc->getValuesAndGradients(px, py, pz, n, gradientX + begin, gradientY + begin, gradientZ + begin, values + begin);
+            });
+        scaleValues(gradientX, count, mScale);
+        scaleValues(gradientY, count, mScale);
+        scaleValues(gradientZ, count, mScale);
+        scaleValues(values, count, mScale);
+    }
+    
+    //-----------------------------------------------------------------------
+
     void CSGNoiseSource::setData(void)
     {
         mGradientOff = fabs(mFrequencies[0]);
@@ -369,6 +640,27 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGNoiseSource::getInternalValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        Real toAdd[SOURCE_BATCH_BLOCK];
+        for (size_t begin = 0; begin < count; begin += SOURCE_BATCH_BLOCK)
+        {
+            size_t n = std::min(SOURCE_BATCH_BLOCK, count - begin);
+            std::fill(toAdd, toAdd + n, (Real)0.0);
+            for (size_t i = 0; i < mNumOctaves; ++i)
+            {
+                mNoise.addNoise(x + begin, y + begin, z + begin, n, mFrequencies[i], mAmplitudes[i], toAdd);
+            }
+            mSrc->getValues(x + begin, y + begin, z + begin, n, values + begin);
+            for (size_t i = 0; i < n; ++i)
+            {
+                values[begin + i] += toAdd[i];
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     CSGNoiseSource::CSGNoiseSource(const Source *src, Real *frequencies, Real *amplitudes, size_t numOctaves, long seed) :
         CSGUnarySource(src), mFrequencies(frequencies), mAmplitudes(amplitudes), mNumOctaves(numOctaves), mNoise(seed)
     {
@@ -403,6 +695,27 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void CSGNoiseSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        getInternalValues(x, y, z, count, values);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void CSGNoiseSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        centralDifferences(x, y, z, count, mGradientOff,
+            [this](const Real *px, const Real *py, const Real *pz, size_t n, Real *v) { getInternalValues(px, py, pz, n, v); },
+            gradientX, gradientY, gradientZ);
+        scaleValues(gradientX, count, (Real)-1.0);
+        scaleValues(gradientY, count, (Real)-1.0);
+        scaleValues(gradientZ, count, (Real)-1.0);
+        getInternalValues(x, y, z, count, values);
+    }
+    
+    //-----------------------------------------------------------------------
+
     long CSGNoiseSource::getSeed(void) const
     {
         return mSeed;
@@ -38,12 +38,34 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
 
-    CacheSource::CacheSource(const Source *src) : mSrc(src)
+    CacheSource::CacheSource(const Source *src) : mCacheCount(0), mSrc(src)
     {
     }
     
     //-----------------------------------------------------------------------
 
+    void CacheSource::growCache(void) const
+    {
+        VecCacheEntry old(std::max<size_t>(mCache.size() * 2, 1024));
+        old.swap(mCache);
+        const size_t mask = mCache.size() - 1;
+        for (const auto& e : old)
+        {
+            if (!e.used)
+            {
+                continue;
+            }
+            size_t slot = FastHash((const char*)&e.position, sizeof(Vector3)) & mask;
+            while (mCache[slot].used)
+            {
+                slot = (slot + 1) & mask;
+            }
+            mCache[slot] = e;
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     Vector4 CacheSource::getValueAndGradient(const Vector3 &position) const
     {
         return getFromCache(position);
@@ -56,5 +78,13 @@ namespace Volume {
         return getFromCache(position).w;
     }
 
+    //-----------------------------------------------------------------------
+
+    void CacheSource::clear(void)
+    {
+        VecCacheEntry().swap(mCache);
+        mCacheCount = 0;
+    }
+
+}
 }
-}
\ No newline at end of file
@@ -71,6 +71,7 @@ namespace Volume {
             req.level = level;
             req.maxLevels = maxLevels;
             req.isUpdate = mShared->parameters->updateFrom != Vector3::ZERO || mShared->parameters->updateTo != Vector3::ZERO;
+            req.revision = ++mRevision;
 
             req.origin = this;
             req.root = OGRE_NEW OctreeNode(from, to);
@@ -161,27 +162,37 @@ namespace Volume {
             {
                 return;
             }
-            // Free memory from old mesh version
-            if (mRenderOp.vertexData)
+
+            // The old mesh stays until loadGeometry swaps in the new one, unless there won't be one.
+            if (!contributesToVolumeMesh(from, to))
             {
+                setChunkVisible(false, true);
+                mVisible = false;
+                mInvisible = true;
+                // Outdate pending requests.
+                ++mRevision;
                 OGRE_DELETE mRenderOp.vertexData;
                 mRenderOp.vertexData = 0;
-            }
-            if (mRenderOp.indexData)
-            {
                 OGRE_DELETE mRenderOp.indexData;
                 mRenderOp.indexData = 0;
+                if (mNode && isAttached())
+                {
+                    mNode->detachObject(this);
+                }
+                return;
             }
         }
-
-        // Set to invisible for now.
-        mVisible = false;
-        mInvisible = true;
-        
-        // Don't generate this chunk if it doesn't contribute to the whole volume.
-        if (!contributesToVolumeMesh(from, to))
+        else
         {
-            return;
+            // Set to invisible for now.
+            mVisible = false;
+            mInvisible = true;
+
+            // Don't generate this chunk if it doesn't contribute to the whole volume.
+            if (!contributesToVolumeMesh(from, to))
+            {
+                return;
+            }
         }
     
         loadChunk(parent, from, to, totalFrom, totalTo, level, maxLevels);
@@ -208,7 +219,14 @@ namespace Volume {
 
     void Chunk::loadGeometry(MeshBuilder *meshBuilder, DualGridGenerator *dualGridGenerator, OctreeNode *root, size_t level, bool isUpdate)
     {
-        size_t chunkTriangles = meshBuilder->generateBuffers(mRenderOp);
+        // Build the buffers aside and swap them in at once, an updated chunk renders its old mesh until here.
+        RenderOperation renderOp;
+        size_t chunkTriangles = meshBuilder->generateBuffers(renderOp);
+        OGRE_DELETE mRenderOp.vertexData;
+        OGRE_DELETE mRenderOp.indexData;
+        mRenderOp.operationType = renderOp.operationType;
+        mRenderOp.vertexData = renderOp.vertexData;
+        mRenderOp.indexData = renderOp.indexData;
         mInvisible = chunkTriangles == 0;
 
         if (mShared->parameters->lodCallback)
@@ -218,16 +236,36 @@ namespace Volume {
 
         mBox = meshBuilder->getBoundingBox();
 
+        if (isUpdate && isAttached())
+        {
+            mNode->detachObject(this);
+        }
         if (!mInvisible)
         {
-            if (isUpdate)
-            {
-                mNode->detachObject(this);
-            }
             mNode->attachObject(this);
         }
 
-        mVisible = false;
+        // Keep the visibility of updated chunks, frameStarted takes care of them from here on.
+        if (!isUpdate || mInvisible)
+        {
+            mVisible = false;
+        }
+
+        if (isUpdate)
+        {
+            if (mDualGrid)
+            {
+                mNode->detachObject(mDualGrid);
+                mShared->parameters->sceneManager->destroyEntity(mDualGrid);
+                mDualGrid = 0;
+            }
+            if (mOctree)
+            {
+                mNode->detachObject(mOctree);
+                mShared->parameters->sceneManager->destroyEntity(mOctree);
+                mOctree = 0;
+            }
+        }
 
         if (mShared->parameters->createDualGridVisualization)
         {
@@ -251,7 +289,7 @@ namespace Volume {
     //-----------------------------------------------------------------------
 
     Chunk::Chunk(void) : mNode(0), mError(false), mDualGrid(0), mOctree(0), mChildren(0),
-        mInvisible(false), isRoot(false), mShared(0)
+        mInvisible(false), isRoot(false), mShared(0), mRevision(0)
     {
     }
     
@@ -326,11 +364,13 @@ namespace Volume {
         if (parameters->updateFrom == Vector3::ZERO && parameters->updateTo == Vector3::ZERO)
         {
             mShared = new ChunkTreeSharedData(parameters);
+            mShared->parentNode = parent;
+            mShared->totalFrom = from;
+            mShared->totalTo = to;
+            mShared->levels = level;
             parent->scale(Vector3(parameters->scale));
         }
 
-        mShared->chunksBeingProcessed = 0;
-        
         doLoad(parent, from, to, from, to, level, level);
 
         // Wait for the threads.
@@ -353,6 +393,38 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void Chunk::updateRegion(const AxisAlignedBox &dirtyArea)
+    {
+        OgreAssert(isRoot && mShared, "updateRegion must be called on the root of a loaded chunktree");
+        if (!dirtyArea.isFinite())
+        {
+            return;
+        }
+
+        // Reuse the update path of load with the stored tree dimensions.
+        ChunkParameters *parameters = mShared->parameters;
+        Vector3 oldUpdateFrom = parameters->updateFrom;
+        Vector3 oldUpdateTo = parameters->updateTo;
+        parameters->updateFrom = dirtyArea.getMinimum();
+        parameters->updateTo = dirtyArea.getMaximum();
+
+        doLoad(mShared->parentNode, mShared->totalFrom, mShared->totalTo, mShared->totalFrom, mShared->totalTo, mShared->levels, mShared->levels);
+
+        parameters->updateFrom = oldUpdateFrom;
+        parameters->updateTo = oldUpdateTo;
+
+        if (!parameters->async)
+        {
+            while(mShared->chunksBeingProcessed)
+            {
+                OGRE_THREAD_SLEEP(0);
+                mChunkHandler.processWorkQueue();
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
     void Chunk::load(SceneNode *parent, SceneManager *sceneManager, const String& filename, bool validSourceResult, MeshBuilderCallback *lodCallback, const String& resourceGroup)
     {
         ConfigFile config;
@@ -99,7 +99,15 @@ namespace Volume {
         if (res->succeeded())
         {
             ChunkRequest cReq = any_cast<ChunkRequest>(res->getRequest()->getData());
-            cReq.origin->loadGeometry(cReq.meshBuilder, cReq.dualGridGenerator, cReq.root, cReq.level, cReq.isUpdate);
+            // The chunk got updated again while this request was processed, the newer one will deliver.
+            if (cReq.revision != cReq.origin->mRevision)
+            {
+                cReq.origin->mShared->chunksBeingProcessed--;
+            }
+            else
+            {
+                cReq.origin->loadGeometry(cReq.meshBuilder, cReq.dualGridGenerator, cReq.root, cReq.level, cReq.isUpdate);
+            }
             OGRE_DELETE cReq.root;
             OGRE_DELETE cReq.dualGridGenerator;
             OGRE_DELETE cReq.meshBuilder;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRay.h"
 #include "OgreVolumeCSGSource.h"
+#include "OgreVolumeSourceBatch.h"
 
 namespace Ogre {
 namespace Volume {
@@ -198,6 +199,14 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
     
+    void GridSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        sampleGrid(x, y, z, count, Vector3(mPosXScale, mPosYScale, mPosZScale), mTrilinearValue,
+            [this](size_t gridX, size_t gridY, size_t gridZ) { return getVolumeGridValue(gridX, gridY, gridZ); }, values);
+    }
+    
+    //-----------------------------------------------------------------------
+    
     size_t GridSource::getWidth(void) const
     {
         return mWidth;
@@ -231,7 +240,6 @@ namespace Volume {
         // cells anyway.
         bool oldTrilinearValue = mTrilinearValue;
         mTrilinearValue = false;
-        float value;
         int x, y;
         Vector3 scaledCenter(center.x * mPosXScale, center.y * mPosYScale, center.z * mPosZScale);
         int xStart = Math::Clamp(static_cast<int>(scaledCenter.x - radius * mPosXScale), 0, static_cast<int>(mWidth));
@@ -240,18 +248,23 @@ namespace Volume {
         int yEnd = Math::Clamp(static_cast<int>(scaledCenter.y + radius * mPosYScale), 0, static_cast<int>(mHeight));
         int zStart = Math::Clamp(static_cast<int>(scaledCenter.z - radius * mPosZScale), 0, static_cast<int>(mDepth));
         int zEnd = Math::Clamp(static_cast<int>(scaledCenter.z + radius * mPosZScale), 0, static_cast<int>(mDepth));
-        Vector3 pos;
+        // Evaluate the operation a row of x at once.
+        size_t rowLength = xEnd > xStart ? xEnd - xStart : 0;
+        std::vector<Real> rowX(rowLength), rowY(rowLength), rowZ(rowLength), values(rowLength);
+        for (x = xStart; x < xEnd; ++x)
+        {
+            rowX[x - xStart] = x * worldWidthScale;
+        }
         for (int z = zStart; z < zEnd; ++z)
         {
+            std::fill(rowZ.begin(), rowZ.end(), z * worldDepthScale);
             for (y = yStart; y < yEnd; ++y)
             {
+                std::fill(rowY.begin(), rowY.end(), y * worldHeightScale);
+                operation->getValues(rowX.data(), rowY.data(), rowZ.data(), rowLength, values.data());
                 for (x = xStart; x < xEnd; ++x)
                 {
-                    pos.x = x * worldWidthScale;
-                    pos.y = y * worldHeightScale;
-                    pos.z = z * worldDepthScale;
-                    value = operation->getValue(pos);
-                    setVolumeGridValue(x, y, z, value);
+                    setVolumeGridValue(x, y, z, (float)values[x - xStart]);
                 }
             }
         }
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreVolumeIsoSurfaceTablesMC.h"
 #include "OgreVolumeSource.h"
 #include "OgreVolumeMeshBuilder.h"
+#include "OgreVolumeSourceBatch.h"
 
 namespace Ogre {
 namespace Volume {
@@ -45,18 +46,18 @@ namespace Volume {
     {
         unsigned char cubeIndex = 0;
         Vector4 values[8];
+        if (volumeValues)
+        {
+            std::copy(volumeValues, volumeValues + 8, values);
+        }
+        else
+        {
+            getSourceValuesAndGradients(mSrc, corners, 8, values);
+        }
 
         // Find out the case.
         for (size_t i = 0; i < 8; ++i)
         {
-            if (volumeValues)
-            {
-                values[i] = volumeValues[i];
-            }
-            else
-            {
-                values[i] = mSrc->getValueAndGradient(corners[i]);
-            }
             if (values[i].w >= ISO_LEVEL)
             {
                 cubeIndex |= 1 << i;
@@ -139,6 +140,13 @@ namespace Volume {
         unsigned char squareIndex = 0;
         Vector4 values[4];
 
+        const Vector3 squareCorners[4] = {corners[indices[0]], corners[indices[1]], corners[indices[2]], corners[indices[3]]};
+        Vector4 innerVals[4];
+        if (!volumeValues)
+        {
+            getSourceValuesAndGradients(mSrc, squareCorners, 4, innerVals);
+        }
+
         // Find out the case.
         for (size_t i = 0; i < 4; ++i)
         {
@@ -148,7 +156,7 @@ namespace Volume {
             }
             else
             {
-                values[i] = mSrc->getValueAndGradient(corners[indices[i]]);
+                values[i] = innerVals[i];
             }
             if (values[i].w >= ISO_LEVEL)
             {
@@ -162,6 +170,12 @@ namespace Volume {
             return;
         }
 
+        // The gradients of the corners are needed for the normals.
+        if (volumeValues)
+        {
+            getSourceValuesAndGradients(mSrc, squareCorners, 4, innerVals);
+        }
+
         int edge = msEdges[squareIndex];
 
         // Find the intersection vertices.
@@ -172,30 +186,15 @@ namespace Volume {
         intersectionPoints[4] = corners[indices[2]];
         intersectionPoints[6] = corners[indices[3]];
 
-        Vector4 innerVal = mSrc->getValueAndGradient(intersectionPoints[0]);
-        intersectionNormals[0].x = innerVal.x;
-        intersectionNormals[0].y = innerVal.y;
-        intersectionNormals[0].z = innerVal.z;
-        intersectionNormals[0].normalise();
-        intersectionNormals[0] *= innerVal.w + (Real)1.0;
-        innerVal = mSrc->getValueAndGradient(intersectionPoints[2]);
-        intersectionNormals[2].x = innerVal.x;
-        intersectionNormals[2].y = innerVal.y;
-        intersectionNormals[2].z = innerVal.z;
-        intersectionNormals[2].normalise();
-        intersectionNormals[2] *= innerVal.w + (Real)1.0;
-        innerVal = mSrc->getValueAndGradient(intersectionPoints[4]);
-        intersectionNormals[4].x = innerVal.x;
-        intersectionNormals[4].y = innerVal.y;
-        intersectionNormals[4].z = innerVal.z;
-        intersectionNormals[4].normalise();
-        intersectionNormals[4] *= innerVal.w + (Real)1.0;
-        innerVal = mSrc->getValueAndGradient(intersectionPoints[6]);
-        intersectionNormals[6].x = innerVal.x;
-        intersectionNormals[6].y = innerVal.y;
-        intersectionNormals[6].z = innerVal.z;
-        intersectionNormals[6].normalise();
-        intersectionNormals[6] *= innerVal.w + (Real)1.0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            Vector3 &normal = intersectionNormals[i * 2];
+            normal.x = innerVals[i].x;
+            normal.y = innerVals[i].y;
+            normal.z = innerVals[i].z;
+            normal.normalise();
+            normal *= innerVals[i].w + (Real)1.0;
+        }
 
         if (edge & 1)
         {
@@ -62,6 +62,23 @@ namespace Volume {
     MeshBuilder::MeshBuilder(void) : mBoxInit(false)
     {
     }
+
+    //-----------------------------------------------------------------------
+
+    void MeshBuilder::growIndexSlots(void)
+    {
+        mIndexSlots.assign(std::max<size_t>(mIndexSlots.size() * 2, 1024), 0);
+        const size_t mask = mIndexSlots.size() - 1;
+        for (size_t i = 0; i < mVertices.size(); ++i)
+        {
+            size_t slot = FastHash((const char*)&mVertices[i], sizeof(Vertex)) & mask;
+            while (mIndexSlots[slot])
+            {
+                slot = (slot + 1) & mask;
+            }
+            mIndexSlots[slot] = i + 1;
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -104,6 +104,30 @@ namespace Volume {
     //-----------------------------------------------------------------------
 
     void OctreeNode::split(const OctreeNodeSplitPolicy *splitPolicy, const Source *src, const Real geometricError)
+    {
+        std::vector<OctreeNode*> pendingLeaves;
+        splitRecursive(splitPolicy, geometricError, pendingLeaves);
+
+        // Evaluate the remaining center values as one batch.
+        const size_t count = pendingLeaves.size();
+        std::vector<Real> x(count), y(count), z(count), gradientX(count), gradientY(count), gradientZ(count), values(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3 center = pendingLeaves[i]->getCenter();
+            x[i] = center.x;
+            y[i] = center.y;
+            z[i] = center.z;
+        }
+        src->getValuesAndGradients(x.data(), y.data(), z.data(), count, gradientX.data(), gradientY.data(), gradientZ.data(), values.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+            pendingLeaves[i]->setCenterValue(Vector4(gradientX[i], gradientY[i], gradientZ[i], values[i]));
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void OctreeNode::splitRecursive(const OctreeNodeSplitPolicy *splitPolicy, const Real geometricError, std::vector<OctreeNode*> &pendingLeaves)
     {
         if (splitPolicy->doSplit(this, geometricError))
         {
@@ -119,27 +143,27 @@ namespace Volume {
             */
             mChildren = new OctreeNode*[OCTREE_CHILDREN_COUNT];
             mChildren[0] = createInstance(mFrom, newCenter);
-            mChildren[0]->split(splitPolicy, src, geometricError);
+            mChildren[0]->splitRecursive(splitPolicy, geometricError, pendingLeaves);
             mChildren[1] = createInstance(mFrom + xWidth, newCenter + xWidth);
-            mChildren[1]->split(splitPolicy, src, geometricError);
+            mChildren[1]->splitRecursive(splitPolicy, geometricError, pendingLeaves);
             mChildren[2] = createInstance(mFrom + xWidth + zWidth, newCenter + xWidth + zWidth);
-            mChildren[2]->split(splitPolicy, src, geometricError);
+            mChildren[2]->splitRecursive(splitPolicy, geometricError, pendingLeaves);
             mChildren[3] = createInstance(mFrom + zWidth, newCenter + zWidth);
-            mChildren[3]->split(splitPolicy, src, geometricError);
+            mChildren[3]->splitRecursive(splitPolicy, geometricError, pendingLeaves);
             mChildren[4] = createInstance(mFrom + yWidth, newCenter + yWidth);
-            mChildren[4]->split(splitPolicy, src, geometricError);
+            mChildren[4]->splitRecursive(splitPolicy, geometricError, pendingLeaves);
             mChildren[5] = createInstance(mFrom + yWidth + xWidth, newCenter + yWidth + xWidth);
-            mChildren[5]->split(splitPolicy, src, geometricError);
+            mChildren[5]->splitRecursive(splitPolicy, geometricError, pendingLeaves);
             mChildren[6] = createInstance(mFrom + yWidth + xWidth + zWidth, newCenter + yWidth + xWidth + zWidth);
-            mChildren[6]->split(splitPolicy, src, geometricError);
+            mChildren[6]->splitRecursive(splitPolicy, geometricError, pendingLeaves);
             mChildren[7] = createInstance(mFrom + yWidth + zWidth, newCenter + yWidth + zWidth);
-            mChildren[7]->split(splitPolicy, src, geometricError);
+            mChildren[7]->splitRecursive(splitPolicy, geometricError, pendingLeaves);
         }
         else
         {
             if (mCenterValue.x == (Real)0.0 && mCenterValue.y == (Real)0.0 && mCenterValue.z == (Real)0.0 && mCenterValue.w == (Real)0.0)
             {
-                setCenterValue(src->getValueAndGradient(getCenter()));
+                pendingLeaves.push_back(this);
             }
         }
     }
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "OgreVolumeSource.h"
 #include "OgreVolumeOctreeNode.h"
+#include "OgreVolumeSourceBatch.h"
 #include <float.h>
 
 namespace Ogre {
@@ -60,14 +61,20 @@ namespace Volume {
         }
 
         // Error metric of http://www.andrew.cmu.edu/user/jessicaz/publication/meshing/
-        Real f000 = mSrc->getValue(from);
-        Real f001 = mSrc->getValue(node->getCorner3());
-        Real f010 = mSrc->getValue(node->getCorner4());
-        Real f011 = mSrc->getValue(node->getCorner7());
-        Real f100 = mSrc->getValue(node->getCorner1());
-        Real f101 = mSrc->getValue(node->getCorner2());
-        Real f110 = mSrc->getValue(node->getCorner5());
-        Real f111 = mSrc->getValue(to);
+        const Vector3 corners[8] = {
+            from, node->getCorner3(), node->getCorner4(), node->getCorner7(),
+            node->getCorner1(), node->getCorner2(), node->getCorner5(), to
+        };
+        Real cornerValues[8];
+        getSourceValues(mSrc, corners, 8, cornerValues);
+        Real f000 = cornerValues[0];
+        Real f001 = cornerValues[1];
+        Real f010 = cornerValues[2];
+        Real f011 = cornerValues[3];
+        Real f100 = cornerValues[4];
+        Real f101 = cornerValues[5];
+        Real f110 = cornerValues[6];
+        Real f111 = cornerValues[7];
 
         Vector3 positions[19][2] = {
             {node->getCenterBackBottom(), Vector3((Real)0.5, (Real)0.0, (Real)0.0)},
@@ -93,13 +100,20 @@ namespace Volume {
             {node->getCenterFrontTop(), Vector3((Real)0.5, (Real)1.0, (Real)1.0)}
         };
 
+        Vector3 samplePositions[19];
+        for (size_t i = 0; i < 19; ++i)
+        {
+            samplePositions[i] = positions[i][0];
+        }
+        Vector4 values[19];
+        getSourceValuesAndGradients(mSrc, samplePositions, 19, values);
     
         Real error = (Real)0.0;
         Vector4 value;
         Vector3 gradient;
         for (size_t i = 0; i < 19; ++i)
         {
-            value = mSrc->getValueAndGradient(positions[i][0]);
+            value = values[i];
             gradient.x = value.x;
             gradient.y = value.y;
             gradient.z = value.z;
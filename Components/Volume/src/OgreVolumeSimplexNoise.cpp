@@ -30,6 +30,8 @@ THE SOFTWARE.
 
 #include <cmath>
 
+#include "OgreVolumeSourceBatch.h"
+
 namespace Ogre {
 namespace Volume {
 
@@ -86,9 +88,8 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
     
-    Real SimplexNoise::noise(Real xIn, Real yIn, Real zIn) const
+    void SimplexNoise::getCorners(Real xIn, Real yIn, Real zIn, Real *x, Real *y, Real *z, int *gi) const
     {
-        Real n0, n1, n2, n3; // Noise contributions from the four corners
         // Skew the input space to determine which simplex cell we're in
         Real s = (xIn + yIn + zIn) * F3; // Very nice and simple skew factor for 3D
         int i = (int)std::floor(xIn + s);
@@ -101,6 +102,9 @@ namespace Volume {
         Real x0 = xIn - X0; // The x,y,z distances from the cell origin
         Real y0 = yIn - Y0;
         Real z0 = zIn - Z0;
+        x[0] = x0;
+        y[0] = y0;
+        z[0] = z0;
         // For the 3D case, the simplex shape is a slightly irregular tetrahedron.
         // Determine which simplex we are in.
         int i1, j1, k1; // Offsets for second corner of simplex in (i,j,k) coords
@@ -169,67 +173,87 @@ namespace Volume {
         // a step of (0,1,0) in (i,j,k) means a step of (-c,1-c,-c) in (x,y,z), and
         // a step of (0,0,1) in (i,j,k) means a step of (-c,-c,1-c) in (x,y,z), where
         // c = 1/6.
-        Real x1 = x0 - i1 + G3; // Offsets for second corner in (x,y,z) coords
-        Real y1 = y0 - j1 + G3;
-        Real z1 = z0 - k1 + G3;
-        Real x2 = x0 - i2 + (Real)2.0 * G3; // Offsets for third corner in (x,y,z) coords
-        Real y2 = y0 - j2 + (Real)2.0*G3;
-        Real z2 = z0 - k2 + (Real)2.0*G3;
-        Real x3 = x0 - (Real)1.0 + (Real)3.0 * G3; // Offsets for last corner in (x,y,z) coords
-        Real y3 = y0 - (Real)1.0 + (Real)3.0 * G3;
-        Real z3 = z0 - (Real)1.0 + (Real)3.0 * G3;
+        x[1] = x0 - i1 + G3; // Offsets for second corner in (x,y,z) coords
+        y[1] = y0 - j1 + G3;
+        z[1] = z0 - k1 + G3;
+        x[2] = x0 - i2 + (Real)2.0 * G3; // Offsets for third corner in (x,y,z) coords
+        y[2] = y0 - j2 + (Real)2.0*G3;
+        z[2] = z0 - k2 + (Real)2.0*G3;
+        x[3] = x0 - (Real)1.0 + (Real)3.0 * G3; // Offsets for last corner in (x,y,z) coords
+        y[3] = y0 - (Real)1.0 + (Real)3.0 * G3;
+        z[3] = z0 - (Real)1.0 + (Real)3.0 * G3;
         // Work out the hashed gradient indices of the four simplex corners
         int ii = i & 255;
         int jj = j & 255;
         int kk = k & 255;
-        int gi0 = permMod12[ii + perm[jj + perm[kk]]];
-        int gi1 = permMod12[ii + i1 + perm[jj + j1 + perm[kk + k1]]];
-        int gi2 = permMod12[ii + i2 + perm[jj + j2 + perm[kk + k2]]];
-        int gi3 = permMod12[ii + 1 + perm[jj + 1 + perm[kk + 1]]];
+        gi[0] = permMod12[ii + perm[jj + perm[kk]]];
+        gi[1] = permMod12[ii + i1 + perm[jj + j1 + perm[kk + k1]]];
+        gi[2] = permMod12[ii + i2 + perm[jj + j2 + perm[kk + k2]]];
+        gi[3] = permMod12[ii + 1 + perm[jj + 1 + perm[kk + 1]]];
+    }
+    
+    //-----------------------------------------------------------------------
+    
+    Real SimplexNoise::noise(Real xIn, Real yIn, Real zIn) const
+    {
+        Real x[4], y[4], z[4];
+        int gi[4];
+        getCorners(xIn, yIn, zIn, x, y, z, gi);
         // Calculate the contribution from the four corners
-        Real t0 = (Real)0.6 - x0 * x0 - y0 * y0 - z0 * z0;
-        if (t0 < 0)
-        {
-            n0 = 0.0;
-        }
-        else
-        {
-            t0 *= t0;
-            n0 = t0 * t0 * dot(grad3[gi0], x0, y0, z0);
-        }
-        Real t1 = (Real)0.6 - x1 * x1 - y1 * y1 - z1 * z1;
-        if (t1 < 0)
-        {
-            n1 = 0.0;
-        }
-        else
-        {
-            t1 *= t1;
-            n1 = t1 * t1 * dot(grad3[gi1], x1, y1, z1);
-        }
-        Real t2 = (Real)0.6 - x2 * x2 - y2 * y2 - z2 * z2;
-        if (t2 < 0)
-        {
-            n2 = 0.0;
-        }
-        else
-        {
-            t2 *= t2;
-            n2 = t2 * t2 * dot(grad3[gi2], x2, y2, z2);
-        }
-        Real t3 = (Real)0.6 - x3 * x3 - y3 * y3 - z3 * z3;
-        if (t3 < 0)
-        {
-            n3 = 0.0;
-        }
-        else
+        Real n = (Real)0.0;
+        for (int c = 0; c < 4; ++c)
         {
-            t3 *= t3;
-            n3 = t3 * t3 * dot(grad3[gi3], x3, y3, z3);
+            Real t = (Real)0.6 - x[c] * x[c] - y[c] * y[c] - z[c] * z[c];
+            if (t >= 0)
+            {
+                t *= t;
+                n += t * t * dot(grad3[gi[c]], x[c], y[c], z[c]);
+            }
         }
         // Add contributions from each corner to get the final noise value.
         // The result is scaled to stay just inside [-1,1]
-        return (Real)32.0 * (n0 + n1 + n2 + n3);
+        return (Real)32.0 * n;
+    }
+    
+    //-----------------------------------------------------------------------
+    
+    void SimplexNoise::addNoise(const Real *xIn, const Real *yIn, const Real *zIn, size_t count, Real frequency, Real amplitude, Real *values) const
+    {
+        // Finding the simplices is scalar, the contributions of their corners are
+        // calculated for four positions at once.
+        forEachReal4(count, [&](size_t begin, size_t n)
+        {
+            Real x[4][4], y[4][4], z[4][4], gx[4][4], gy[4][4], gz[4][4];
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                // Unused lanes just repeat the first position.
+                size_t i = begin + (lane < n ? lane : 0);
+                Real cx[4], cy[4], cz[4];
+                int gi[4];
+                getCorners(xIn[i] * frequency, yIn[i] * frequency, zIn[i] * frequency, cx, cy, cz, gi);
+                for (int c = 0; c < 4; ++c)
+                {
+                    x[c][lane] = cx[c];
+                    y[c][lane] = cy[c];
+                    z[c][lane] = cz[c];
+                    gx[c][lane] = grad3[gi[c]].x;
+                    gy[c][lane] = grad3[gi[c]].y;
+                    gz[c][lane] = grad3[gi[c]].z;
+                }
+            }
+            Real4 sum((Real)0.0);
+            for (int c = 0; c < 4; ++c)
+            {
+                Real4 cx = Real4::load(x[c]);
+                Real4 cy = Real4::load(y[c]);
+                Real4 cz = Real4::load(z[c]);
+                Real4 t = max(Real4((Real)0.6) - cx * cx - cy * cy - cz * cz, Real4((Real)0.0));
+                t = t * t;
+                sum = sum + t * t * (Real4::load(gx[c]) * cx + Real4::load(gy[c]) * cy + Real4::load(gz[c]) * cz);
+            }
+            Real4 result = Real4::load(values + begin, n) + Real4((Real)32.0) * sum * Real4(amplitude);
+            result.store(values + begin, n);
+        });
     }
     
     //-----------------------------------------------------------------------
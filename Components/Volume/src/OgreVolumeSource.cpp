@@ -61,6 +61,31 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
 
+    void Source::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = getValue(Vector3(x[i], y[i], z[i]));
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Source::getValuesAndGradients(const Real *x, const Real *y, const Real *z, size_t count,
+        Real *gradientX, Real *gradientY, Real *gradientZ, Real *values) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector4 value = getValueAndGradient(Vector3(x[i], y[i], z[i]));
+            gradientX[i] = value.x;
+            gradientY[i] = value.y;
+            gradientZ[i] = value.z;
+            values[i] = value.w;
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
     void Source::serialize(const Vector3 &from, const Vector3 &to, float voxelWidth, const String &file)
     {
         Real maxClampedAbsoluteDensity = (from - to).length() / (Real)16.0;
@@ -93,23 +118,27 @@ namespace Volume {
         ser.write<size_t>(&gridHeight);
         ser.write<size_t>(&gridDepth);
 
-        // Go over the volume and write the density data.
-        Vector3 pos;
+        // Go over the volume and write the density data, a column of y at once.
+        std::vector<Real> columnX(gridHeight), columnY(gridHeight), columnZ(gridHeight), values(gridHeight);
         Real realVal;
         size_t x;
         size_t y;
         uint16 buffer[SERIALIZATION_CHUNK_SIZE];
         size_t bufferI = 0;
+        for (y = 0; y < gridHeight; ++y)
+        {
+            columnY[y] = y * voxelWidth + from.y;
+        }
         for (size_t z = 0; z < gridDepth; ++z)
         {
+            std::fill(columnZ.begin(), columnZ.end(), z * voxelWidth + from.z);
             for (x = 0; x < gridWidth; ++x)
             {
+                std::fill(columnX.begin(), columnX.end(), x * voxelWidth + from.x);
+                getValues(columnX.data(), columnY.data(), columnZ.data(), gridHeight, values.data());
                 for (y = 0; y < gridHeight; ++y)
                 {
-                    pos.x = x * voxelWidth + from.x;
-                    pos.y = y * voxelWidth + from.y;
-                    pos.z = z * voxelWidth + from.z;
-                    realVal = Math::Clamp<Real>(getValue(pos), -maxClampedAbsoluteDensity, maxClampedAbsoluteDensity);
+                    realVal = Math::Clamp<Real>(values[y], -maxClampedAbsoluteDensity, maxClampedAbsoluteDensity);
                     buffer[bufferI] = Bitwise::floatToHalf(realVal);
                     bufferI++;
                     if (bufferI == SERIALIZATION_CHUNK_SIZE)
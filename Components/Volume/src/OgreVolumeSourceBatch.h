@@ -0,0 +1,320 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Ogre_Volume_SourceBatch_H__
+#define __Ogre_Volume_SourceBatch_H__
+
+// Internal include file -- shared by the batched density evaluation of the
+// volume sources. Do not use externally.
+
+#include "OgrePlatformInformation.h"
+#include "OgreMath.h"
+#include "OgreVector.h"
+#include "OgreVolumeSource.h"
+
+#include <algorithm>
+
+// both imply single precision Reals
+#if __OGRE_HAVE_SSE
+#   include <xmmintrin.h>
+#   define OGRE_VOLUME_SSE 1
+#elif __OGRE_HAVE_NEON && defined(__aarch64__)
+#   include <arm_neon.h>
+#   define OGRE_VOLUME_NEON 1
+#endif
+
+namespace Ogre {
+namespace Volume {
+
+    /// How many positions the combining sources evaluate at once on the stack.
+    const size_t SOURCE_BATCH_BLOCK = 64;
+
+    /** Four Real lanes, mapped to SSE or NEON registers where available.
+    */
+    struct Real4
+    {
+#if OGRE_VOLUME_SSE
+        __m128 v;
+        Real4() {}
+        Real4(__m128 val) : v(val) {}
+        explicit Real4(Real s) : v(_mm_set1_ps(s)) {}
+        static Real4 load(const Real* p) { return _mm_loadu_ps(p); }
+        void store(Real* p) const { _mm_storeu_ps(p, v); }
+        Real4 operator+(const Real4& o) const { return _mm_add_ps(v, o.v); }
+        Real4 operator-(const Real4& o) const { return _mm_sub_ps(v, o.v); }
+        Real4 operator*(const Real4& o) const { return _mm_mul_ps(v, o.v); }
+        Real4 operator/(const Real4& o) const { return _mm_div_ps(v, o.v); }
+        friend Real4 min(const Real4& a, const Real4& b) { return _mm_min_ps(a.v, b.v); }
+        friend Real4 max(const Real4& a, const Real4& b) { return _mm_max_ps(a.v, b.v); }
+        friend Real4 sqrt(const Real4& a) { return _mm_sqrt_ps(a.v); }
+        /// a < b ? x : y per lane
+        friend Real4 selectLess(const Real4& a, const Real4& b, const Real4& x, const Real4& y)
+        {
+            __m128 m = _mm_cmplt_ps(a.v, b.v);
+            return _mm_or_ps(_mm_and_ps(m, x.v), _mm_andnot_ps(m, y.v));
+        }
+#elif OGRE_VOLUME_NEON
+        float32x4_t v;
+        Real4() {}
+        Real4(float32x4_t val) : v(val) {}
+        explicit Real4(Real s) : v(vdupq_n_f32(s)) {}
+        static Real4 load(const Real* p) { return vld1q_f32(p); }
+        void store(Real* p) const { vst1q_f32(p, v); }
+        Real4 operator+(const Real4& o) const { return vaddq_f32(v, o.v); }
+        Real4 operator-(const Real4& o) const { return vsubq_f32(v, o.v); }
+        Real4 operator*(const Real4& o) const { return vmulq_f32(v, o.v); }
+        Real4 operator/(const Real4& o) const { return vdivq_f32(v, o.v); }
+        friend Real4 min(const Real4& a, const Real4& b) { return vminq_f32(a.v, b.v); }
+        friend Real4 max(const Real4& a, const Real4& b) { return vmaxq_f32(a.v, b.v); }
+        friend Real4 sqrt(const Real4& a) { return vsqrtq_f32(a.v); }
+        /// a < b ? x : y per lane
+        friend Real4 selectLess(const Real4& a, const Real4& b, const Real4& x, const Real4& y)
+        {
+            return vbslq_f32(vcltq_f32(a.v, b.v), x.v, y.v);
+        }
+#else
+        Real v[4];
+        Real4() {}
+        explicit Real4(Real s) { v[0] = v[1] = v[2] = v[3] = s; }
+        static Real4 load(const Real* p) { Real4 r; for (int i = 0; i < 4; ++i) r.v[i] = p[i]; return r; }
+        void store(Real* p) const { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+        Real4 operator+(const Real4& o) const { Real4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] + o.v[i]; return r; }
+        Real4 operator-(const Real4& o) const { Real4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] - o.v[i]; return r; }
+        Real4 operator*(const Real4& o) const { Real4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] * o.v[i]; return r; }
+        Real4 operator/(const Real4& o) const { Real4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] / o.v[i]; return r; }
+        friend Real4 min(const Real4& a, const Real4& b) { Real4 r; for (int i = 0; i < 4; ++i) r.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i]; return r; }
+        friend Real4 max(const Real4& a, const Real4& b) { Real4 r; for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] < b.v[i] ? b.v[i] : a.v[i]; return r; }
+        friend Real4 sqrt(const Real4& a) { Real4 r; for (int i = 0; i < 4; ++i) r.v[i] = std::sqrt(a.v[i]); return r; }
+        /// a < b ? x : y per lane
+        friend Real4 selectLess(const Real4& a, const Real4& b, const Real4& x, const Real4& y)
+        {
+            Real4 r;
+            for (int i = 0; i < 4; ++i)
+                r.v[i] = a.v[i] < b.v[i] ? x.v[i] : y.v[i];
+            return r;
+        }
+#endif
+        /// Load up to four values, the missing lanes are zero.
+        static Real4 load(const Real* p, size_t n)
+        {
+            if (n == 4)
+                return load(p);
+            Real tmp[4] = {0, 0, 0, 0};
+            for (size_t i = 0; i < n; ++i)
+                tmp[i] = p[i];
+            return load(tmp);
+        }
+        /// Store the first n lanes.
+        void store(Real* p, size_t n) const
+        {
+            if (n == 4)
+            {
+                store(p);
+                return;
+            }
+            Real tmp[4];
+            store(tmp);
+            for (size_t i = 0; i < n; ++i)
+                p[i] = tmp[i];
+        }
+        Real4 operator-() const { return Real4(Real(0)) - *this; }
+    };
+
+    /** Calls func(i, n) for consecutive groups of n <= 4 positions, n is only
+        less than 4 for the last one.
+    */
+    template<typename F> inline void forEachReal4(size_t count, const F& func)
+    {
+        for (size_t i = 0; i < count; i += 4)
+            func(i, std::min<size_t>(4, count - i));
+    }
+
+    /** Evaluates a source on scaled or offset copies of the positions in blocks of
+        SOURCE_BATCH_BLOCK, func(begin, n, x, y, z) gets the transformed block.
+    */
+    template<typename Transform, typename F>
+    inline void forEachTransformedBlock(const Real* x, const Real* y, const Real* z, size_t count,
+                                        const Transform& transform, const F& func)
+    {
+        Real tx[SOURCE_BATCH_BLOCK], ty[SOURCE_BATCH_BLOCK], tz[SOURCE_BATCH_BLOCK];
+        for (size_t begin = 0; begin < count; begin += SOURCE_BATCH_BLOCK)
+        {
+            size_t n = std::min(SOURCE_BATCH_BLOCK, count - begin);
+            for (size_t i = 0; i < n; ++i)
+            {
+                tx[i] = x[begin + i];
+                ty[i] = y[begin + i];
+                tz[i] = z[begin + i];
+                transform(tx[i], ty[i], tz[i]);
+            }
+            func(begin, n, tx, ty, tz);
+        }
+    }
+
+    /** Gets the densities of positions given as vectors with batched calls.
+    */
+    inline void getSourceValues(const Source* src, const Vector3* positions, size_t count, Real* values)
+    {
+        Real x[SOURCE_BATCH_BLOCK], y[SOURCE_BATCH_BLOCK], z[SOURCE_BATCH_BLOCK];
+        for (size_t begin = 0; begin < count; begin += SOURCE_BATCH_BLOCK)
+        {
+            size_t n = std::min(SOURCE_BATCH_BLOCK, count - begin);
+            for (size_t i = 0; i < n; ++i)
+            {
+                x[i] = positions[begin + i].x;
+                y[i] = positions[begin + i].y;
+                z[i] = positions[begin + i].z;
+            }
+            src->getValues(x, y, z, n, values + begin);
+        }
+    }
+
+    /** Gets the densities and gradients of positions given as vectors with batched calls,
+        the results are laid out like in Source::getValueAndGradient.
+    */
+    inline void getSourceValuesAndGradients(const Source* src, const Vector3* positions, size_t count, Vector4* results)
+    {
+        Real x[SOURCE_BATCH_BLOCK], y[SOURCE_BATCH_BLOCK], z[SOURCE_BATCH_BLOCK];
+        Real gx[SOURCE_BATCH_BLOCK], gy[SOURCE_BATCH_BLOCK], gz[SOURCE_BATCH_BLOCK], w[SOURCE_BATCH_BLOCK];
+        for (size_t begin = 0; begin < count; begin += SOURCE_BATCH_BLOCK)
+        {
+            size_t n = std::min(SOURCE_BATCH_BLOCK, count - begin);
+            for (size_t i = 0; i < n; ++i)
+            {
+                x[i] = positions[begin + i].x;
+                y[i] = positions[begin + i].y;
+                z[i] = positions[begin + i].z;
+            }
+            src->getValuesAndGradients(x, y, z, n, gx, gy, gz, w);
+            for (size_t i = 0; i < n; ++i)
+            {
+                results[begin + i] = Vector4(gx[i], gy[i], gz[i], w[i]);
+            }
+        }
+    }
+
+    /** Calculates the central differences of a batched density function along the
+        three axes, gradient = getValues(position + offset) - getValues(position - offset).
+    */
+    template<typename F>
+    inline void centralDifferences(const Real* x, const Real* y, const Real* z, size_t count, Real offset,
+                                   const F& getValues, Real* gradientX, Real* gradientY, Real* gradientZ)
+    {
+        Real px[SOURCE_BATCH_BLOCK], py[SOURCE_BATCH_BLOCK], pz[SOURCE_BATCH_BLOCK];
+        Real plus[SOURCE_BATCH_BLOCK], minus[SOURCE_BATCH_BLOCK];
+        const Real* in[3] = {x, y, z};
+        Real* moved[3] = {px, py, pz};
+        Real* out[3] = {gradientX, gradientY, gradientZ};
+        for (size_t begin = 0; begin < count; begin += SOURCE_BATCH_BLOCK)
+        {
+            size_t n = std::min(SOURCE_BATCH_BLOCK, count - begin);
+            for (int axis = 0; axis < 3; ++axis)
+                std::copy(in[axis] + begin, in[axis] + begin + n, moved[axis]);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    moved[axis][i] = in[axis][begin + i] + offset;
+                getValues(px, py, pz, n, plus);
+                for (size_t i = 0; i < n; ++i)
+                    moved[axis][i] = in[axis][begin + i] - offset;
+                getValues(px, py, pz, n, minus);
+                std::copy(in[axis] + begin, in[axis] + begin + n, moved[axis]);
+                for (size_t i = 0; i < n; ++i)
+                    out[axis][begin + i] = plus[i] - minus[i];
+            }
+        }
+    }
+
+    /** Samples a grid at many positions like GridSource::getValue. fetch(x, y, z) returns
+        the density of a grid cell clamping the indices, scale maps a position to the grid.
+        The eight fetches per position are scalar, the trilinear blend is done four
+        positions at once.
+    */
+    template<typename Fetch>
+    inline void sampleGrid(const Real* x, const Real* y, const Real* z, size_t count, const Vector3& scale,
+                           bool trilinear, const Fetch& fetch, Real* values)
+    {
+        if (!trilinear)
+        {
+            // Nearest neighbour
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i] = (Real)fetch((size_t)(x[i] * scale.x + (Real)0.5), (size_t)(y[i] * scale.y + (Real)0.5),
+                                        (size_t)(z[i] * scale.z + (Real)0.5));
+            }
+            return;
+        }
+        forEachReal4(count, [&](size_t begin, size_t n)
+        {
+            Real f[8][4], d[3][4];
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                // Unused lanes just repeat the first position.
+                size_t i = begin + (lane < n ? lane : 0);
+                Real scaledX = x[i] * scale.x;
+                Real scaledY = y[i] * scale.y;
+                Real scaledZ = z[i] * scale.z;
+                size_t x0 = (size_t)scaledX;
+                size_t x1 = (size_t)ceil(scaledX);
+                size_t y0 = (size_t)scaledY;
+                size_t y1 = (size_t)ceil(scaledY);
+                size_t z0 = (size_t)scaledZ;
+                size_t z1 = (size_t)ceil(scaledZ);
+                d[0][lane] = scaledX - (Real)x0;
+                d[1][lane] = scaledY - (Real)y0;
+                d[2][lane] = scaledZ - (Real)z0;
+                f[0][lane] = fetch(x0, y0, z0);
+                f[1][lane] = fetch(x1, y0, z0);
+                f[2][lane] = fetch(x0, y1, z0);
+                f[3][lane] = fetch(x0, y0, z1);
+                f[4][lane] = fetch(x1, y0, z1);
+                f[5][lane] = fetch(x0, y1, z1);
+                f[6][lane] = fetch(x1, y1, z0);
+                f[7][lane] = fetch(x1, y1, z1);
+            }
+            const Real4 one((Real)1.0);
+            Real4 dX = Real4::load(d[0]), dY = Real4::load(d[1]), dZ = Real4::load(d[2]);
+            Real4 oneMinX = one - dX;
+            Real4 oneMinY = one - dY;
+            Real4 oneMinZ = one - dZ;
+            Real4 oneMinXoneMinY = oneMinX * oneMinY;
+            Real4 dXOneMinY = dX * oneMinY;
+            Real4 value = oneMinZ * (Real4::load(f[0]) * oneMinXoneMinY
+                + Real4::load(f[1]) * dXOneMinY
+                + Real4::load(f[2]) * oneMinX * dY)
+                + dZ * (Real4::load(f[3]) * oneMinXoneMinY
+                + Real4::load(f[4]) * dXOneMinY
+                + Real4::load(f[5]) * oneMinX * dY)
+                + dX * dY * (Real4::load(f[6]) * oneMinZ
+                + Real4::load(f[7]) * dZ);
+            value.store(values + begin, n);
+        });
+    }
+}
+}
+
+#endif
@@ -31,16 +31,14 @@ THE SOFTWARE.
 #include "OgreMemoryAllocatorConfig.h"
 #include "OgreLogManager.h"
 #include "OgreTimer.h"
+#include "OgreVolumeSourceBatch.h"
 
 namespace Ogre {
 namespace Volume {
 
     float TextureSource::getVolumeGridValue(size_t x, size_t y, size_t z) const
     {
-        x = x >= mWidth ? mWidth - 1 : x;
-        y = y >= mHeight ? mHeight - 1 : y;
-        z = z >= mDepth ? mDepth - 1 : z;
-        return mData[(mDepth - z - 1) * mWidthTimesHeight + y * mWidth + x];
+        return getTextureValue(x, y, z);
     }
     
     //-----------------------------------------------------------------------
@@ -92,5 +90,13 @@ namespace Volume {
         OGRE_FREE(mData, MEMCATEGORY_GENERAL);
     }
 
+    //-----------------------------------------------------------------------
+
+    void TextureSource::getValues(const Real *x, const Real *y, const Real *z, size_t count, Real *values) const
+    {
+        sampleGrid(x, y, z, count, Vector3(mPosXScale, mPosYScale, mPosZScale), mTrilinearValue,
+            [this](size_t gridX, size_t gridY, size_t gridZ) { return getTextureValue(gridX, gridY, gridZ); }, values);
+    }
+
 }
 }
@@ -18,6 +18,7 @@
 #include "OgrePredefinedControllers.h"
 #include "OgrePixelCountLodStrategy.h"
 #include "OgreDefaultDebugDrawer.h"
+#include "OgreMeshOptimiser.h"
 %}
 
 %include stdint.i
@@ -831,6 +832,7 @@ SHARED_PTR(Mesh);
     SHARED_PTR(PatchMesh);
     %include "OgrePatchMesh.h"
 %include "OgreMeshSerializer.h"
+%include "OgreMeshOptimiser.h"
 %include "OgreMeshManager.h"
 %include "OgreLodStrategy.h"
 %include "OgrePixelCountLodStrategy.h"
@@ -597,6 +597,8 @@ namespace Ogre {
         bool isVisible(const Sphere& bound, FrustumPlane* culledBy = 0) const;
         /// @copydoc Frustum::isVisible(const Vector3&, FrustumPlane*) const
         bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
+        /// @copydoc Frustum::isVisible(const AxisAlignedBox* const*, size_t, bool*) const
+        void isVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const;
         /// @copydoc Frustum::getWorldSpaceCorners
         const Corners& getWorldSpaceCorners(void) const;
         /// @copydoc Frustum::getFrustumPlane
@@ -99,6 +99,9 @@ namespace Ogre {
         */
         MeshPtr mMesh;
 
+        /// Simplified mesh used for occlusion culling
+        MeshPtr mOccluderMesh;
+
         /** List of SubEntities (point to SubMeshes).
         */
         SubEntityList mSubEntityList;
@@ -342,6 +345,20 @@ namespace Ogre {
         */
         const MeshPtr& getMesh(void) const;
 
+        /** Sets a simplified mesh hiding everything behind it, when occlusion culling is enabled
+        @remarks
+            The occluder is placed with the transform of this Entity in its bind pose and must not
+            extend beyond the geometry it stands for. As only the node of the Entity is used, an
+            invisible Entity can provide the occluder of geometry rendered otherwise, e.g. by
+            StaticGeometry.
+        @param mesh the occluder, or a null pointer to stop occluding
+        @see SceneManager::setOcclusionCullingEnabled
+        */
+        void setOccluderMesh(const MeshPtr& mesh);
+
+        /// Gets the occluder of this Entity, if any
+        const MeshPtr& getOccluderMesh(void) const { return mOccluderMesh; }
+
         /** Gets a pointer to a SubEntity, ie a part of an Entity.
         */
         SubEntity* getSubEntity(size_t index) const { return mSubEntityList.at(index); }
@@ -576,6 +593,20 @@ namespace Ogre {
         const AxisAlignedBox& getWorldBoundingBox(bool derive = false) const override;
         const Sphere& getWorldBoundingSphere(bool derive = false) const override;
 
+        /** Finds the nearest triangle of this entity hit by a ray.
+        @remarks
+            The triangles of the first LOD level of the visible sub-entities are tested. Unanimated
+            geometry is tested against a hierarchy cached by the SubMesh, so only the first call reads
+            back its buffers. Software animated geometry is tested against the blended buffers, while
+            hardware animated geometry is tested in its bind pose; see addSoftwareAnimationRequest.
+        @param ray The ray in world space
+        @param subMeshIndex Receives the index of the SubMesh which was hit, if not NULL
+        @param triangleIndex Receives the index of the triangle within the SubMesh, if not NULL
+        @return Whether a triangle was hit, and the distance along the ray
+        */
+        std::pair<bool, Real> intersectTriangles(const Ray& ray, int* subMeshIndex = NULL,
+                                                 int* triangleIndex = NULL);
+
         EdgeData* getEdgeList(void) override;
         const ShadowRenderableList& getShadowVolumeRenderableList(
             const Light* light, const HardwareIndexBufferPtr& indexBuffer,
@@ -448,6 +448,22 @@ namespace Ogre
         */
         virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
 
+        /** Tests whether the given bounding boxes are visible in the Frustum.
+        @remarks
+            Gives the same results as calling isVisible(const AxisAlignedBox&, FrustumPlane*) for
+            each box, but tests the boxes in batches of 4 against each plane, which lets the
+            compiler use SIMD instructions. Once the frustum planes are up to date, e.g. after
+            calling getFrustumPlanes(), this only reads the frustum and may be called from
+            several threads at once.
+        @param bounds
+            Bounding boxes to be checked (world space).
+        @param count
+            Number of bounding boxes.
+        @param visible
+            Receives the visibility of each box.
+        */
+        virtual void isVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const;
+
         uint32 getTypeFlags(void) const override;
         const AxisAlignedBox& getBoundingBox(void) const override;
         Real getBoundingRadius(void) const override;
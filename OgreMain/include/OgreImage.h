@@ -426,7 +426,9 @@ namespace Ogre {
         {
             FILTER_NEAREST,
             FILTER_LINEAR,
-            FILTER_BILINEAR = FILTER_LINEAR
+            FILTER_BILINEAR = FILTER_LINEAR,
+            /// separable Lanczos (a = 3), sharper than bilinear when minifying. 2D only
+            FILTER_LANCZOS
         };
         /** Scale a 1D, 2D or 3D image volume. 
             @param  src         PixelBox containing the source pointer, dimensions and format
@@ -439,6 +441,20 @@ namespace Ogre {
         
         /** Resize a 2D image, applying the appropriate filter. */
         void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
+
+        /** Generate the full mipmap chain down to 1x1 from the top level of every face
+
+            Any mipmaps the image already contains are replaced.
+            @param gammaCorrected the image is sRGB encoded, so filter in linear space
+            @param filter FILTER_BILINEAR is a box filter for power of two sizes,
+                FILTER_LANCZOS keeps more detail in the smaller levels
+            @param alphaCoverageRef alpha test reference of cut-out textures. If
+                non-zero, the alpha of each mipmap is scaled so the fraction of
+                texels passing the test matches the top level, which stops
+                foliage and fences from fading out in the distance.
+        */
+        Image& generateMipmaps(bool gammaCorrected = false, Filter filter = FILTER_BILINEAR,
+                               float alphaCoverageRef = 0);
         
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(uint32 mipmaps, uint32 faces, uint32 width, uint32 height, uint32 depth, PixelFormat format);
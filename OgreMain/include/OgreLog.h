@@ -108,6 +108,16 @@ namespace Ogre {
 
         typedef std::vector<LogListener*> mtLogListener;
         mtLogListener mListeners;
+
+        struct AsyncWriter;
+        /// Queue and thread writing the messages in asynchronous mode, NULL otherwise
+        std::unique_ptr<AsyncWriter> mAsyncWriter;
+
+        /// Reusable message buffer of Stream
+        struct StreamBuffer;
+
+        /// Pass a message to the listeners and write it out, the caller must hold the mutex
+        void writeMessage(const String& message, LogMessageLevel lml, bool maskDebug, time_t time);
     public:
 
         class Stream;
@@ -142,6 +152,28 @@ namespace Ogre {
         /** Get a stream object targeting this log. */
         Stream stream(LogMessageLevel lml = LML_NORMAL, bool maskDebug = false);
 
+        /** Sets whether messages are written out on a separate thread
+        @remarks
+            In asynchronous mode, logMessage only queues the message, so threads logging a lot,
+            like the resource loading threads, do not wait for the disk. A writer thread then
+            passes the messages to the listeners and writes them to the console and the file,
+            in the order they were queued. The queue holds a fixed number of messages and
+            logging blocks while it is full. Messages of #LML_CRITICAL are written out before
+            logMessage returns, so they are not lost if the application terminates right after.
+            Do not change the mode while other threads log to this log.
+        @param async whether to write asynchronously
+        @param queueSize the number of messages the queue holds, rounded up to a power of two
+        */
+        void setAsynchronous(bool async, size_t queueSize = 1024);
+
+        /// Get whether messages are written out on a separate thread
+        bool isAsynchronous() const { return mAsyncWriter != nullptr; }
+
+        /** Waits until all messages logged so far are written to the file
+        @remarks This happens automatically when the log is destroyed.
+        */
+        void flush();
+
         /**
         @remarks
             Enable or disable outputting log messages to the debugger.
@@ -192,54 +224,38 @@ namespace Ogre {
             Each Stream object is not thread safe, so do not pass it between
             threads. Multiple threads can hold their own Stream instances pointing
             at the same Log though and that is threadsafe.
+        @par
+            The message is formatted into a buffer owned by the calling thread, which
+            is reused by the next Stream of that thread.
         */
-        class _OgrePrivate Stream
+        class _OgreExport Stream
         {
         private:
             Log* mTarget;
             LogMessageLevel mLevel;
             bool mMaskDebug;
-            typedef StringStream BaseStream;
-            BaseStream mCache;
+            StreamBuffer* mBuffer;
+            std::ostream* mCache;
 
         public:
 
             /// Simple type to indicate a flush of the stream to the log
             struct Flush {};
 
-            Stream(Log* target, LogMessageLevel lml, bool maskDebug)
-                :mTarget(target), mLevel(lml), mMaskDebug(maskDebug)
-            {
-
-            }
+            Stream(Log* target, LogMessageLevel lml, bool maskDebug);
             // move constructor
-            Stream(Stream&& rhs) = default;
+            Stream(Stream&& rhs);
 
-            ~Stream()
-            {
-                // flush on destroy
-                if (mCache.tellp() > 0)
-                {
-                    mTarget->logMessage(mCache.str(), mLevel, mMaskDebug);
-                }
-            }
+            ~Stream();
 
             template <typename T>
             Stream& operator<< (const T& v)
             {
-                mCache << v;
+                *mCache << v;
                 return *this;
             }
 
-            Stream& operator<< (const Flush& v)
-            {
-                                (void)v;
-                mTarget->logMessage(mCache.str(), mLevel, mMaskDebug);
-                mCache.str(BLANKSTRING);
-                return *this;
-            }
-
-
+            Stream& operator<< (const Flush& v);
         };
 
     };
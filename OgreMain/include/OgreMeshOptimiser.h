@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _OgreMeshOptimiser_H_
+#define _OgreMeshOptimiser_H_
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Class for reordering mesh geometry so that it renders efficiently.
+
+        Three passes are applied to every triangle list of a Mesh:
+        - triangles are reordered for the post transform vertex cache, following
+          Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+        - the resulting sequence is split into clusters, which are sorted front to back
+          around the mesh centre to reduce overdraw. Clusters are only split where the
+          cache efficiency degrades by less than the overdraw threshold.
+        - vertices are reordered to the order in which they are first referenced, so
+          vertex fetch is sequential. Bone assignments, poses and morph animation are
+          remapped accordingly.
+
+        The generated LOD levels are reordered for the vertex cache as well, unless they
+        share their index buffer with other levels.
+    */
+    class _OgreExport MeshOptimiser
+    {
+    public:
+        /// Efficiency of a triangle list for a simulated FIFO post transform cache
+        struct Statistics
+        {
+            /// Average Cache Miss Ratio: transformed vertices per triangle, between 0.5 and 3
+            float acmr;
+            /// Average Transform to Vertex Ratio: transformed vertices per referenced vertex, at least 1
+            float atvr;
+
+            Statistics() : acmr(0), atvr(0) {}
+        };
+
+        /// Statistics of the first LOD level of all triangle lists of a Mesh
+        struct Result
+        {
+            Statistics before;
+            Statistics after;
+        };
+
+        MeshOptimiser();
+
+        /** Sets the size of the FIFO cache used for statistics and for splitting overdraw clusters.
+            Defaults to 16, which matches a wide range of hardware.
+        */
+        void setCacheSize(uint32 size) { mCacheSize = size; }
+        uint32 getCacheSize() const { return mCacheSize; }
+
+        /** Sets by how much the ACMR may degrade when reordering for overdraw.
+            Defaults to 1.05, use 0 to skip the overdraw pass.
+        */
+        void setOverdrawThreshold(float threshold) { mOverdrawThreshold = threshold; }
+        float getOverdrawThreshold() const { return mOverdrawThreshold; }
+
+        /** Sets whether vertices are reordered for vertex fetch. Defaults to true.
+        */
+        void setReorderVertices(bool reorder) { mReorderVertices = reorder; }
+        bool getReorderVertices() const { return mReorderVertices; }
+
+        /** Optimises all triangle lists of the mesh in place.
+            Edge lists are rebuilt if they were built before.
+        */
+        Result optimise(Mesh* mesh);
+
+        /** Reorders the triangles of an indexed triangle list for the post transform vertex cache.
+        */
+        static void optimiseVertexCache(uint32* indices, size_t indexCount, size_t vertexCount);
+
+        /** Reorders clusters of a cache optimised triangle list front to back.
+            @param indices the triangle list, usually the output of optimiseVertexCache
+            @param indexCount number of indices
+            @param positions vertex positions the indices refer to
+            @param vertexCount number of positions
+            @param cacheSize size of the simulated FIFO cache
+            @param threshold allowed ACMR degradation, e.g. 1.05
+        */
+        static void optimiseOverdraw(uint32* indices, size_t indexCount, const Vector3* positions,
+                                     size_t vertexCount, uint32 cacheSize, float threshold);
+
+        /** Calculates the cache efficiency of an indexed triangle list.
+        */
+        static Statistics analyseVertexCache(const uint32* indices, size_t indexCount, size_t vertexCount,
+                                             uint32 cacheSize);
+
+    private:
+        uint32 mCacheSize;
+        float mOverdrawThreshold;
+        bool mReorderVertices;
+
+        void reorderVertices(Mesh* mesh, VertexData* vertexData, ushort target);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -43,6 +43,14 @@ namespace Ogre {
     {
         /// Latest version available
         MESH_VERSION_LATEST,
+
+        /// OGRE version v13.5+, v1.10 layout with vertex and index data stored
+        /// as aligned blobs that are uploaded without parsing
+        MESH_VERSION_1_10_MAPPED,
+
+        /// OGRE version v13.5+, v1.10 layout with quantized and deflated vertex and
+        /// index data. Lossy, see MeshSerializer::exportMesh
+        MESH_VERSION_1_10_COMPRESSED,
         
         /// OGRE version v1.10+
         MESH_VERSION_1_10,
@@ -112,6 +120,11 @@ namespace Ogre {
          to a .mesh file in the specified format version. Note that picking a
          format version other that the latest will cause some information to be
          lost.
+         @note #MESH_VERSION_1_10_COMPRESSED is lossy: positions are quantized to 16 bit
+         against the bounding box of their geometry, unit normals and tangents are octahedral
+         encoded with 16 bit per component and texture coordinates in [-4; 4] are stored as
+         half floats. All streams are then deflated. After loading, the mesh has the same
+         VertexDeclaration as the exported one.
          @param pMesh Pointer to the Mesh to export
          @param filename The destination filename
          @param version Mesh version to write
@@ -41,6 +41,7 @@ namespace Ogre {
 
     // Forward declaration
     class MovableObjectFactory;
+    class SceneQueryTree;
 
     /** \addtogroup Core
     *  @{
@@ -154,6 +155,10 @@ namespace Ogre {
         mutable ulong mLightListUpdated;
         /// the light mask defined for this movable. This will be taken into consideration when deciding which light should affect this movable
         uint32 mLightMask;
+        /// Scene query tree tracking the world AABB of this object, if any
+        SceneQueryTree* mSceneQueryTree;
+        /// Leaf of this object in mSceneQueryTree
+        int mSceneQueryProxy;
 
         // Static members
         /// Default query flags
@@ -161,6 +166,10 @@ namespace Ogre {
         /// Default visibility flags
         static uint32 msDefaultVisibilityFlags;
 
+        /// Notify the scene query tree that mWorldAABB changed
+        void _notifyWorldBoundsChanged() const;
+
+        friend class SceneQueryTree;
 
 
     public:
@@ -0,0 +1,87 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Parallel_H__
+#define __Parallel_H__
+
+#include "OgrePrerequisites.h"
+
+#include <functional>
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Calls @c task(i) for each i in [0, count) on the calling thread and the parallelFor workers.
+
+        Used by parallelFor, which should be preferred.
+    */
+    _OgreExport void _parallelForTasks(size_t count, const std::function<void(size_t)>& task);
+
+    /** Splits [0, count) into contiguous ranges and calls @c func(begin, end) for each.
+
+        This is a blocking fork-join helper for data parallel loops that are too short
+        lived to go through the WorkQueue. The ranges are processed by the calling thread
+        and a set of worker threads, one per additional hardware thread, which is started
+        on first use and shared by all calls. So parallelFor may be called every frame and
+        from within another parallelFor.
+        Each call must only write data belonging to its own range. Exceptions thrown by
+        any range are rethrown on the calling thread after all ranges finished.
+
+        Without thread support @c func is simply called once for the whole range.
+    @param count number of items
+    @param minItems minimal number of items per range, below which splitting the work
+        does not pay off the synchronisation
+    @param func callable taking (size_t begin, size_t end)
+    */
+    template<typename F> void parallelFor(size_t count, size_t minItems, const F& func)
+    {
+        size_t ranges = 1;
+#if OGRE_THREAD_SUPPORT
+        ranges = std::min(count / std::max(minItems, size_t(1)),
+                          size_t(OGRE_THREAD_HARDWARE_CONCURRENCY));
+#endif
+        if (ranges < 2)
+        {
+            if (count)
+                func(size_t(0), count);
+            return;
+        }
+
+        _parallelForTasks(ranges, [&func, count, ranges](size_t i) {
+            func(count * i / ranges, count * (i + 1) / ranges);
+        });
+    }
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -43,6 +43,8 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 
 #include "OgrePrerequisites.h"
 #include "OgreSingleton.h"
+#include "Threading/OgreThreadHeaders.h"
+#include <thread>
 #include "OgreHeaderPrefix.h"
 
 #if OGRE_PROFILING == 1
@@ -50,6 +52,8 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileBegin( a ) Ogre::Profiler::getSingleton().beginProfile( (a) )
 #   define OgreProfileEnd( a ) Ogre::Profiler::getSingleton().endProfile( (a) )
 #   define OgreProfileGroup( a, g ) Ogre::Profile OGRE_TOKEN_PASTE(_OgreProfileInstance, __LINE__) ( (a), (g) )
+#   define OgreProfileStatic( a ) Ogre::Profile _OgreProfileInstance( Ogre::Profile::StaticName{ "" a } )
+#   define OgreProfileStaticGroup( a, g ) Ogre::Profile OGRE_TOKEN_PASTE(_OgreProfileInstance, __LINE__) ( Ogre::Profile::StaticName{ "" a }, (g) )
 #   define OgreProfileBeginGroup( a, g ) Ogre::Profiler::getSingleton().beginProfile( (a), (g) )
 #   define OgreProfileEndGroup( a, g ) Ogre::Profiler::getSingleton().endProfile( (a), (g) )
 #   define OgreProfileBeginGPUEvent( g ) Ogre::Profiler::getSingleton().beginGPUEvent(g)
@@ -60,6 +64,8 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileBegin( a )
 #   define OgreProfileEnd( a )
 #   define OgreProfileGroup( a, g ) 
+#   define OgreProfileStatic( a )
+#   define OgreProfileStaticGroup( a, g )
 #   define OgreProfileBeginGroup( a, g ) 
 #   define OgreProfileEndGroup( a, g ) 
 #   define OgreProfileBeginGPUEvent( e )
@@ -142,6 +148,19 @@ namespace Ogre {
 
     };
 
+    /// A single profile call recorded for the trace
+    struct ProfileTraceEvent
+    {
+        /// The name of the profile
+        const char* name;
+        /// The time the profile began in microseconds
+        uint64 begin;
+        /// The time the profile ended in microseconds
+        uint64 end;
+        /// The index of the recording thread, in the order the threads started recording
+        uint32 thread;
+    };
+
     /// Represents an individual profile call
     class _OgreExport ProfileInstance : public ProfilerAlloc
     {
@@ -275,6 +294,18 @@ namespace Ogre {
             */
             void endProfile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
 
+            /** Begins a profile named by a string that stays valid as long as the profiler, like a
+                string literal
+            @remarks
+                Unlike beginProfile, the name is recorded in the trace without being looked up,
+                so nothing is allocated. The macros OgreProfileStatic(name) and
+                OgreProfileStaticGroup(name, group) use this for string literals.
+            */
+            void beginStaticProfile(const char* profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+
+            /// Ends a profile begun with beginStaticProfile
+            void endStaticProfile(const char* profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+
             /** Mark the beginning of a GPU event group
              @remarks Can be safely called in the middle of the profile.
              */
@@ -300,6 +331,47 @@ namespace Ogre {
             /** Gets whether this profiler is enabled */
             bool getEnabled() const;
 
+            /** Sets whether the profiles of all threads are recorded for exportChromeTrace
+            @remarks
+                The statistics of setEnabled only cover the thread which created the profiler,
+                while the trace covers WorkQueue threads as well. Each thread records the begin
+                and end time of its profiles into its own ring buffer without locking, so once
+                the buffer is full the oldest events are overwritten. The trace respects the
+                profile group mask, but not disabled profiles.
+            */
+            void setTraceEnabled(bool enabled) { mTraceEnabled = enabled; }
+
+            /** Gets whether the profiles of all threads are recorded */
+            bool getTraceEnabled() const { return mTraceEnabled; }
+
+            /** Sets the number of events each thread keeps for the trace, 65536 by default
+            @remarks Only applies to threads which did not record anything yet.
+            */
+            void setTraceBufferSize(size_t numEvents);
+
+            /** Gets the number of events each thread keeps for the trace */
+            size_t getTraceBufferSize() const { return mTraceBufferSize; }
+
+            /** Names the calling thread in the trace */
+            void setTraceThreadName(const String& name);
+
+            /** Gets the recorded events of all threads, ordered by their begin time
+            @remarks
+                Threads may continue recording meanwhile. Events overwritten while they are
+                being copied are left out.
+            */
+            void getTraceEvents(std::vector<ProfileTraceEvent>& events);
+
+            /** Writes the recorded events of all threads in the Chrome trace event format
+            @remarks
+                The result can be loaded into chrome://tracing or Perfetto, showing the
+                worker threads on the same timeline as the frame.
+            */
+            void exportChromeTrace(std::ostream& stream);
+
+            /** Discards the recorded events of all threads */
+            void clearTrace();
+
             /** Enables a previously disabled profile 
             @remarks Can be safely called in the middle of the profile.
             */
@@ -379,6 +451,21 @@ namespace Ogre {
         private:
             friend class ProfileInstance;
 
+            struct ThreadTrace;
+            typedef std::vector<std::shared_ptr<ThreadTrace> > ThreadTraceList;
+
+            /// The trace buffer of the calling thread, registered on first use
+            ThreadTrace* getThreadTrace();
+            /// Returns a copy of the name that lives as long as the profiler, without locking once the thread used it
+            const char* getTraceName(const String& name);
+            void beginTraceEvent(const char* name);
+            void endTraceEvent(const char* name);
+
+            /// Updates the statistics of setEnabled with the begin of a profile
+            void beginProfileStats(const String& profileName, uint32 groupID);
+            /// Updates the statistics of setEnabled with the end of a profile
+            void endProfileStats(const String& profileName, uint32 groupID);
+
             typedef std::vector<ProfileSessionListener*> TProfileSessionListener;
             TProfileSessionListener mListeners;
 
@@ -439,6 +526,20 @@ namespace Ogre {
             Real mAverageFrameTime;
             bool mResetExtents;
 
+            /// The thread the statistics are gathered for
+            std::thread::id mMainThread;
+
+            /// Whether the profiles of all threads are recorded
+            std::atomic<bool> mTraceEnabled;
+            size_t mTraceBufferSize;
+            /// Identifies this profiler in the thread local trace buffer lookup
+            uint64 mTraceId;
+            /// The trace buffers of all threads which recorded anything, by thread index
+            ThreadTraceList mThreadTraces;
+            /// Copies of the names recorded by beginProfile
+            std::set<String> mTraceNames;
+            OGRE_MUTEX(mTraceMutex);
+
 
     }; // end class
 
@@ -457,15 +558,37 @@ namespace Ogre {
 
     public:
         Profile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT)
-            : mName(profileName), mGroupID(groupID)
+            : mName(profileName), mStaticName(NULL), mGroupID(groupID)
         {
             Profiler::getSingleton().beginProfile(profileName, groupID);
         }
-        ~Profile() { Profiler::getSingleton().endProfile(mName, mGroupID); }
+        /// A name that stays valid as long as the profiler, like a string literal
+        struct StaticName
+        {
+            const char* name;
+        };
+        /** Profile named by a string literal, which is recorded without copying it
+        @remarks
+            Use the macro OgreProfileStatic(name), which only accepts string literals.
+        */
+        Profile(StaticName profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT)
+            : mStaticName(profileName.name), mGroupID(groupID)
+        {
+            Profiler::getSingleton().beginStaticProfile(mStaticName, groupID);
+        }
+        ~Profile()
+        {
+            if (mStaticName)
+                Profiler::getSingleton().endStaticProfile(mStaticName, mGroupID);
+            else
+                Profiler::getSingleton().endProfile(mName, mGroupID);
+        }
 
     private:
         /// The name of this profile
         String mName;
+        /// The name of this profile if it is a string literal
+        const char* mStaticName;
         /// The group ID
         uint32 mGroupID;
     };
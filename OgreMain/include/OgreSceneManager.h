@@ -90,6 +90,8 @@ namespace Ogre {
     class InstancedGeometry;
     class Rectangle2D;
     class LodListener;
+    class SceneQueryTree;
+    class OcclusionBuffer;
     struct MovableObjectLodChangedEvent;
     struct EntityMeshLodChangedEvent;
     struct EntityMaterialLodChangedEvent;
@@ -1032,6 +1034,26 @@ namespace Ogre {
         /// Visibility mask used to show / hide objects
         uint32 mVisibilityMask;
         bool mFindVisibleObjects;
+        /// Whether the visible scene nodes are searched for on several threads
+        bool mParallelCulling;
+
+        /// Entities with an occluder mesh
+        std::vector<Entity*> mOccluders;
+        /// Depth of the occluders seen by the current camera, NULL if occlusion culling is disabled
+        std::unique_ptr<OcclusionBuffer> mOcclusionBuffer;
+        uint32 mOcclusionBufferWidth;
+        uint32 mOcclusionBufferHeight;
+
+        /** Rasterise the occluders visible to the given camera, called before searching for
+            visible objects.
+        @param cam the camera to cull for
+        @param onlyShadowCasters true in the shadow texture pass, where nothing is occluded
+        */
+        void _updateOcclusionBuffer(const Camera* cam, bool onlyShadowCasters);
+
+        /// Bounding volume hierarchy of the movable objects, used by the default scene queries
+        std::unique_ptr<SceneQueryTree> mSceneQueryTree;
+        bool mSceneQueryTreeEnabled;
 
         /** Render a group in the ordinary way */
         void renderBasicQueueGroupObjects(RenderQueueGroup* pGroup,
@@ -2574,6 +2596,22 @@ namespace Ogre {
 
         /** Destroys a scene query of any type. */
         void destroyQuery(SceneQuery* query);
+
+        /** Sets whether the default scene queries use a bounding volume hierarchy.
+        @remarks
+            The hierarchy is built on the first query and afterwards maintained incrementally
+            whenever the world bounds of a movable object are updated, so it only pays off
+            if the scene is queried regularly. Without it, every query tests all movable
+            objects. Scene managers with their own scene queries never build it.
+        */
+        void setSceneQueryTreeEnabled(bool enabled);
+        /// @copydoc setSceneQueryTreeEnabled
+        bool getSceneQueryTreeEnabled() const { return mSceneQueryTreeEnabled; }
+
+        /** Get the bounding volume hierarchy used by the default scene queries (internal use only)
+        @return the hierarchy, which is built on the first call, or NULL if disabled
+        */
+        SceneQueryTree* _getSceneQueryTree();
         /// @}
 
         /// @name Shadow Setup
@@ -3282,6 +3320,50 @@ namespace Ogre {
         */
         bool getFindVisibleObjects(void) { return mFindVisibleObjects; }
 
+        /** Sets whether the visible scene nodes are searched for on several threads.
+        @remarks
+            The subtrees below the root node are distributed across worker threads, which test
+            the bounds of the nodes against the camera in batches. The visible nodes are then
+            added to the render queue on the calling thread, in the same order as without
+            this option, so the rendering result does not change. This only pays off for
+            large scene graphs, so scenes of a few hundred nodes are still culled on the
+            calling thread. Cameras overriding Camera::isVisible(const AxisAlignedBox&,
+            FrustumPlane*) must also override the batch version used here.
+        */
+        void setParallelCullingEnabled(bool enabled) { mParallelCulling = enabled; }
+        /// @copydoc setParallelCullingEnabled
+        bool getParallelCullingEnabled() const { return mParallelCulling; }
+
+        /** Sets whether scene nodes hidden behind occluders are culled.
+        @remarks
+            Before searching for visible objects, the occluders of the Entities inside the view
+            frustum are rasterised into a low resolution depth buffer on worker threads. Scene nodes
+            whose bounds are completely behind the occluders are then skipped like the ones outside
+            the frustum. This only works for perspective cameras and is disabled in shadow texture
+            passes. Only Entities with an occluder mesh act as occluders.
+        @see Entity::setOccluderMesh
+        */
+        void setOcclusionCullingEnabled(bool enabled);
+        /// @copydoc setOcclusionCullingEnabled
+        bool getOcclusionCullingEnabled() const { return mOcclusionBuffer != nullptr; }
+
+        /** Sets the resolution of the occlusion buffer
+        @remarks
+            A higher resolution culls objects closer to the silhouette of the occluders at a
+            higher cost. The default is 256x128.
+        */
+        void setOcclusionBufferSize(uint32 width, uint32 height);
+
+        /** Checks whether the given world space box is hidden behind the occluders.
+        @remarks
+            This is always false if occlusion culling is disabled or the occlusion buffer was
+            built for another camera. Safe to call from several threads at once.
+        */
+        bool _isOccluded(const Camera* cam, const AxisAlignedBox& box) const;
+
+        /// Internal method to notify the manager that an Entity got or lost its occluder mesh
+        void _notifyOccluder(Entity* ent, bool add);
+
         /** Set whether to automatically normalise normals on objects whenever they
             are scaled.
         @remarks
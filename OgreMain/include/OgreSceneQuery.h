@@ -347,6 +347,10 @@ namespace Ogre {
         MovableObject* movable;
         /// The world fragment, or NULL if this is not a fragment result
         SceneQuery::WorldFragment* worldFragment;
+        /// The SubMesh which was hit, or -1 if no triangles were tested
+        int subMeshIndex;
+        /// The triangle of the SubMesh which was hit, or -1 if no triangles were tested
+        int triangleIndex;
         /// Comparison operator for sorting
         bool operator < (const RaySceneQueryResultEntry& rhs) const
         {
@@ -363,6 +367,7 @@ namespace Ogre {
         Ray mRay;
     private:
         bool mSortByDistance;
+        bool mQueryTriangles;
         ushort mMaxResults;
         RaySceneQueryResult mResult;
 
@@ -384,7 +389,7 @@ namespace Ogre {
             bounding volumes. For this reason the caller is advised to use more detailed 
             intersection tests on the results if a more accurate result is required; OGRE uses 
             bounds checking in order to give the most speedy results since not all applications 
-            need extreme accuracy.
+            need extreme accuracy. Entities can be tested more accurately with setQueryTriangles.
         @param sort If true, results will be sorted.
         @param maxresults If sorting is enabled, this value can be used to constrain the maximum number
             of results that are returned. Please note (as above) that the use of bounding volumes mean that
@@ -397,6 +402,18 @@ namespace Ogre {
         /** Gets the maximum number of results returned from the query (only relevant if 
         results are being sorted) */
         virtual ushort getMaxResults(void) const;
+        /** Sets whether entities are tested against their triangles.
+        @remarks
+            By default, objects are reported as soon as the ray hits their bounding box. With this
+            option, entities are only reported if the ray hits one of their triangles, along with the
+            exact distance and the indices of the SubMesh and triangle which were hit. See
+            Entity::intersectTriangles for details.
+        @par
+            The triangles are only tested by the collection-returning version of execute.
+        */
+        void setQueryTriangles(bool query) { mQueryTriangles = query; }
+        /** Gets whether entities are tested against their triangles. */
+        bool getQueryTriangles(void) const { return mQueryTriangles; }
         /** Executes the query, returning the results back in one list.
         @remarks
             This method executes the scene query as configured, gathers the results
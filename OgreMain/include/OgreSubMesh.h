@@ -38,6 +38,8 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    class TriangleBVH;
+
     /** \addtogroup Core
     *  @{
     */
@@ -222,8 +224,20 @@ namespace Ogre {
          */
         SubMesh * clone(const String& newName, Mesh *parentMesh = 0);
 
+        /** Get the triangle hierarchy used for triangle accurate ray queries (internal use only)
+        @remarks
+            The hierarchy is built from the first LOD level on the first call, which reads back the
+            vertex and index buffers once. Call _discardTriangleBVH after modifying them.
+        */
+        const TriangleBVH* _getTriangleBVH();
+        /// Discard the triangle hierarchy, so it is rebuilt on the next ray query
+        void _discardTriangleBVH();
+
     private:
 
+        /// Triangle hierarchy for ray queries, built on demand
+        std::unique_ptr<TriangleBVH> mTriangleBVH;
+
         /// Flag indicating that bone assignments need to be recompiled
         bool mBoneAssignmentsOutOfDate;
 
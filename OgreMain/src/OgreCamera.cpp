@@ -928,6 +928,18 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Camera::isVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->isVisible(bounds, count, visible);
+        }
+        else
+        {
+            Frustum::isVisible(bounds, count, visible);
+        }
+    }
+    //-----------------------------------------------------------------------
     const Frustum::Corners& Camera::getWorldSpaceCorners(void) const
     {
         if (mCullFrustum)
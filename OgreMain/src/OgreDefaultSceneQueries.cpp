@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreSceneQueryTree.h"
 
 namespace Ogre {
     //---------------------------------------------------------------------
@@ -42,6 +43,29 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
     {
+        if (SceneQueryTree* tree = mParentSceneMgr->_getSceneQueryTree())
+        {
+            auto passes = [this](const MovableObject* m) {
+                return (m->getTypeFlags() & mQueryTypeMask) && (m->getQueryFlags() & mQueryMask) &&
+                       m->isInScene();
+            };
+            tree->forEachObject([&](MovableObject* a) {
+                if (!passes(a))
+                    return true;
+
+                const AxisAlignedBox& box1 = a->getWorldBoundingBox();
+                return tree->query([&box1](const AxisAlignedBox& node) { return box1.intersects(node); },
+                                   [&](MovableObject* b) {
+                                       // report every pair once
+                                       if (!std::less<MovableObject*>()(a, b) || !passes(b) ||
+                                           !box1.intersects(b->getWorldBoundingBox()))
+                                           return true;
+                                       return listener->queryResult(a, b);
+                                   });
+            });
+            return;
+        }
+
         // Iterate over all movable types
         const auto& factories = Root::getSingleton().getMovableObjectFactories();
         auto factIt = factories.begin();
@@ -126,6 +150,18 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
     {
+        if (SceneQueryTree* tree = mParentSceneMgr->_getSceneQueryTree())
+        {
+            tree->query([this](const AxisAlignedBox& node) { return mAABB.intersects(node); },
+                        [&](MovableObject* a) {
+                            if ((a->getTypeFlags() & mQueryTypeMask) && (a->getQueryFlags() & mQueryMask) &&
+                                a->isInScene() && mAABB.intersects(a->getWorldBoundingBox()))
+                                return listener->queryResult(a);
+                            return true;
+                        });
+            return;
+        }
+
         // Iterate over all movable types
         for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
         {
@@ -158,11 +194,22 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultRaySceneQuery::execute(RaySceneQueryListener* listener)
     {
-        // Note that because we have no scene partitioning, we actually
-        // perform a complete scene search even if restricted results are
-        // requested; smarter scene manager queries can utilise the paritioning 
-        // of the scene in order to reduce the number of intersection tests 
-        // required to fulfil the query
+        if (SceneQueryTree* tree = mParentSceneMgr->_getSceneQueryTree())
+        {
+            tree->query([this](const AxisAlignedBox& node) { return mRay.intersects(node).first; },
+                        [&](MovableObject* a) {
+                            if (!(a->getTypeFlags() & mQueryTypeMask) || !(a->getQueryFlags() & mQueryMask) ||
+                                !a->isInScene())
+                                return true;
+
+                            std::pair<bool, Real> result = mRay.intersects(a->getWorldBoundingBox());
+                            return !result.first || listener->queryResult(a, result.second);
+                        });
+            return;
+        }
+
+        // Without the scene query tree, we perform a complete scene search
+        // even if restricted results are requested
 
         // Iterate over all movable types
         for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
@@ -202,6 +249,18 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultSphereSceneQuery::execute(SceneQueryListener* listener)
     {
+        if (SceneQueryTree* tree = mParentSceneMgr->_getSceneQueryTree())
+        {
+            tree->query([this](const AxisAlignedBox& node) { return mSphere.intersects(node); },
+                        [&](MovableObject* a) {
+                            if ((a->getTypeFlags() & mQueryTypeMask) && (a->getQueryFlags() & mQueryMask) &&
+                                a->isInScene() && mSphere.intersects(a->getWorldBoundingBox()))
+                                return listener->queryResult(a);
+                            return true;
+                        });
+            return;
+        }
+
         // Iterate over all movable types
         for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
         {
@@ -215,8 +274,8 @@ namespace Ogre {
                 if (!a->isInScene() || !(a->getQueryFlags() & mQueryMask))
                     continue;
 
-                // Do sphere / sphere test
-                if (mSphere.intersects(a->getWorldBoundingSphere()))
+                // Do sphere / box test
+                if (mSphere.intersects(a->getWorldBoundingBox()))
                 {
                     if (!listener->queryResult(a)) return;
                 }
@@ -238,6 +297,25 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
     {
+        if (SceneQueryTree* tree = mParentSceneMgr->_getSceneQueryTree())
+        {
+            auto intersects = [this](const AxisAlignedBox& box) {
+                for (const auto& vol : mVolumes)
+                {
+                    if (vol.intersects(box))
+                        return true;
+                }
+                return false;
+            };
+            tree->query(intersects, [&](MovableObject* a) {
+                if ((a->getTypeFlags() & mQueryTypeMask) && (a->getQueryFlags() & mQueryMask) &&
+                    a->isInScene() && intersects(a->getWorldBoundingBox()))
+                    return listener->queryResult(a);
+                return true;
+            });
+            return;
+        }
+
         // Iterate over all movable types
         for(const auto& factIt : Root::getSingleton().getMovableObjectFactories())
         {
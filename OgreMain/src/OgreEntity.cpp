@@ -33,6 +33,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreOptimisedUtil.h"
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
+#include "OgreTriangleBVH.h"
 
 
 namespace Ogre {
@@ -272,6 +273,7 @@ namespace Ogre {
         _deinitialise();
         // Unregister our listener
         mMesh->removeListener(this);
+        setOccluderMesh(MeshPtr());
     }
     //-----------------------------------------------------------------------
     void Entity::_releaseManualHardwareResources()
@@ -294,6 +296,13 @@ namespace Ogre {
         return mMesh;
     }
     //-----------------------------------------------------------------------
+    void Entity::setOccluderMesh(const MeshPtr& mesh)
+    {
+        if (mManager && bool(mesh) != bool(mOccluderMesh))
+            mManager->_notifyOccluder(this, bool(mesh));
+        mOccluderMesh = mesh;
+    }
+    //-----------------------------------------------------------------------
     SubEntity* Entity::getSubEntity(const String& name) const
     {
         ushort index = mMesh->_getSubMeshIndex(name);
@@ -578,6 +587,67 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    std::pair<bool, Real> Entity::intersectTriangles(const Ray& ray, int* subMeshIndex, int* triangleIndex)
+    {
+        // transform into object space without normalising, so distances stay the same
+        Affine3 worldToObject = _getParentNodeFullTransform().inverse();
+        Ray objectRay(worldToObject * ray.getOrigin(), worldToObject.linear() * ray.getDirection());
+
+        bool softwareAnimation = hasSkeleton() || hasVertexAnimation();
+        softwareAnimation &= !isHardwareAnimationEnabled() || getSoftwareAnimationRequests() > 0;
+        if (softwareAnimation)
+            _updateAnimation();
+
+        std::pair<bool, Real> nearest(false, Math::POS_INFINITY);
+        std::vector<Vector3> vertices;
+        for (size_t i = 0; i < mSubEntityList.size(); i++)
+        {
+            SubEntity* se = mSubEntityList[i];
+            SubMesh* subMesh = se->getSubMesh();
+            if (!se->isVisible())
+                continue;
+
+            const VertexData* animated = NULL;
+            if (softwareAnimation)
+            {
+                bool vertexAnimation = subMesh->useSharedVertices
+                                           ? mMesh->getSharedVertexDataAnimationType() != VAT_NONE
+                                           : subMesh->getVertexAnimationType() != VAT_NONE;
+                if (hasSkeleton())
+                    animated = subMesh->useSharedVertices ? mSkelAnimVertexData.get() : se->mSkelAnimVertexData.get();
+                else if (vertexAnimation)
+                    animated = subMesh->useSharedVertices ? mSoftwareVertexAnimVertexData.get()
+                                                          : se->mSoftwareVertexAnimVertexData.get();
+            }
+
+            uint32 triangle = 0;
+            std::pair<bool, Real> hit;
+            if (animated)
+            {
+                // blended positions change every frame, so there is nothing to cache
+                TriangleBVH::readTriangles(animated, subMesh->indexData, subMesh->operationType, vertices);
+                hit = TriangleBVH::intersects(objectRay, vertices, nearest.second, triangle);
+            }
+            else
+            {
+                hit = subMesh->_getTriangleBVH()->intersects(objectRay, nearest.second, triangle);
+            }
+
+            if (hit.first)
+            {
+                nearest = hit;
+                if (subMeshIndex)
+                    *subMeshIndex = int(i);
+                if (triangleIndex)
+                    *triangleIndex = int(triangle);
+            }
+        }
+
+        if (!nearest.first)
+            nearest.second = 0;
+        return nearest;
+    }
+    //-----------------------------------------------------------------------
     void Entity::_updateRenderQueue(RenderQueue* queue)
     {
         // Do nothing if not initialised yet
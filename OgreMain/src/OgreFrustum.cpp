@@ -290,6 +290,58 @@ namespace Ogre {
 
         return true;
     }
+    //-----------------------------------------------------------------------
+    void Frustum::isVisible(const AxisAlignedBox* const* bounds, size_t count, bool* visible) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        for (size_t first = 0; first < count; first += 4)
+        {
+            size_t num = std::min(count - first, size_t(4));
+
+            // Gather the boxes as structure of arrays, so each plane is tested against
+            // all of them at once. Null and infinite boxes are resolved afterwards.
+            Real cx[4] = {0}, cy[4] = {0}, cz[4] = {0};
+            Real hx[4] = {0}, hy[4] = {0}, hz[4] = {0};
+            for (size_t i = 0; i < num; ++i)
+            {
+                const AxisAlignedBox& bound = *bounds[first + i];
+                if (!bound.isFinite())
+                    continue;
+                Vector3 centre = bound.getCenter();
+                Vector3 halfSize = bound.getHalfSize();
+                cx[i] = centre.x; cy[i] = centre.y; cz[i] = centre.z;
+                hx[i] = halfSize.x; hy[i] = halfSize.y; hz[i] = halfSize.z;
+            }
+
+            // Same test as Plane::getSide, a box is culled if it is on the
+            // negative side of any plane
+            int culled[4] = {0};
+            for (int plane = 0; plane < 6; ++plane)
+            {
+                // Skip far plane if infinite view frustum
+                if (plane == FRUSTUM_PLANE_FAR && mFarDist == 0)
+                    continue;
+
+                const Plane& p = mFrustumPlanes[plane];
+                for (int i = 0; i < 4; ++i)
+                {
+                    Real dist = p.normal.x * cx[i] + p.normal.y * cy[i] + p.normal.z * cz[i] + p.d;
+                    Real maxAbsDist = std::abs(p.normal.x * hx[i]) + std::abs(p.normal.y * hy[i]) +
+                                      std::abs(p.normal.z * hz[i]);
+                    culled[i] |= dist < -maxAbsDist;
+                }
+            }
+
+            for (size_t i = 0; i < num; ++i)
+            {
+                const AxisAlignedBox& bound = *bounds[first + i];
+                // Null boxes always invisible, infinite boxes always visible
+                visible[first + i] = bound.isFinite() ? !culled[i] : bound.isInfinite();
+            }
+        }
+    }
     //---------------------------------------------------------------------
     uint32 Frustum::getTypeFlags(void) const
     {
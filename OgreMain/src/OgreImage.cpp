@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreImage.h"
 #include "OgreImageCodec.h"
+#include "OgreImageProcessing.h"
 #include "OgreImageResampler.h"
 
 namespace Ogre {
@@ -495,6 +496,15 @@ namespace Ogre {
         Image::scale(temp.getPixelBox(), getPixelBox(), filter);
     }
     //-----------------------------------------------------------------------
+    /// large images are resampled in bands of destination rows, in parallel
+    template<class Resampler> static void scaleBanded(const PixelBox& src, const PixelBox& dst)
+    {
+        size_t bytes = PixelUtil::getMemorySize(dst.getWidth(), dst.getHeight(), dst.getDepth(), dst.format);
+        processRowBands(dst.getHeight(), bytes, [&src, &dst](size_t begin, size_t end) {
+            Resampler::scale(src, dst, begin, end);
+        });
+    }
+    //-----------------------------------------------------------------------
     void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter) 
     {
         assert(PixelUtil::isAccessible(src.format));
@@ -515,14 +525,14 @@ namespace Ogre {
             // super-optimized: no conversion
             switch (PixelUtil::getNumElemBytes(src.format)) 
             {
-            case 1: NearestResampler<1>::scale(src, temp); break;
-            case 2: NearestResampler<2>::scale(src, temp); break;
-            case 3: NearestResampler<3>::scale(src, temp); break;
-            case 4: NearestResampler<4>::scale(src, temp); break;
-            case 6: NearestResampler<6>::scale(src, temp); break;
-            case 8: NearestResampler<8>::scale(src, temp); break;
-            case 12: NearestResampler<12>::scale(src, temp); break;
-            case 16: NearestResampler<16>::scale(src, temp); break;
+            case 1: scaleBanded<NearestResampler<1> >(src, temp); break;
+            case 2: scaleBanded<NearestResampler<2> >(src, temp); break;
+            case 3: scaleBanded<NearestResampler<3> >(src, temp); break;
+            case 4: scaleBanded<NearestResampler<4> >(src, temp); break;
+            case 6: scaleBanded<NearestResampler<6> >(src, temp); break;
+            case 8: scaleBanded<NearestResampler<8> >(src, temp); break;
+            case 12: scaleBanded<NearestResampler<12> >(src, temp); break;
+            case 16: scaleBanded<NearestResampler<16> >(src, temp); break;
             default:
                 // never reached
                 assert(false);
@@ -551,10 +561,10 @@ namespace Ogre {
                 // super-optimized: byte-oriented math, no conversion
                 switch (PixelUtil::getNumElemBytes(src.format)) 
                 {
-                case 1: LinearResampler_Byte<1>::scale(src, temp); break;
-                case 2: LinearResampler_Byte<2>::scale(src, temp); break;
-                case 3: LinearResampler_Byte<3>::scale(src, temp); break;
-                case 4: LinearResampler_Byte<4>::scale(src, temp); break;
+                case 1: scaleBanded<LinearResampler_Byte<1> >(src, temp); break;
+                case 2: scaleBanded<LinearResampler_Byte<2> >(src, temp); break;
+                case 3: scaleBanded<LinearResampler_Byte<3> >(src, temp); break;
+                case 4: scaleBanded<LinearResampler_Byte<4> >(src, temp); break;
                 default:
                     // never reached
                     assert(false);
@@ -570,17 +580,167 @@ namespace Ogre {
                 if (scaled.format == PF_FLOAT32_RGB || scaled.format == PF_FLOAT32_RGBA)
                 {
                     // float32 to float32, avoid unpack/repack overhead
-                    LinearResampler_Float32::scale(src, scaled);
+                    scaleBanded<LinearResampler_Float32>(src, scaled);
                     break;
                 }
                 // else, fall through
             default:
                 // non-optimized: floating-point math, performs conversion but always works
-                LinearResampler::scale(src, scaled);
+                scaleBanded<LinearResampler>(src, scaled);
+            }
+            break;
+
+        case FILTER_LANCZOS:
+            if (src.getDepth() > 1 || scaled.getDepth() > 1)
+            {
+                // no 3D kernel
+                scale(src, scaled, FILTER_BILINEAR);
+                break;
+            }
+            {
+                // always resample in FLOAT32_RGBA
+                Image srcbuf;
+                PixelBox srcf = src;
+                if (src.format != PF_FLOAT32_RGBA)
+                {
+                    srcbuf.create(PF_FLOAT32_RGBA, src.getWidth(), src.getHeight());
+                    PixelUtil::bulkPixelConversion(src, srcbuf.getPixelBox());
+                    srcf = srcbuf.getPixelBox();
+                }
+                if (scaled.format != PF_FLOAT32_RGBA)
+                {
+                    buf.create(PF_FLOAT32_RGBA, scaled.getWidth(), scaled.getHeight());
+                    temp = buf.getPixelBox();
+                }
+                LanczosResampler_Float32::scale(srcf, temp);
+                if (temp.data != scaled.data)
+                    PixelUtil::bulkPixelConversion(temp, scaled);
             }
             break;
         }
     }
+    //-----------------------------------------------------------------------------
+    static float sRGBToLinear(float c)
+    {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    static float linearToSRGB(float c)
+    {
+        c = Math::saturate(c);
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+    /// applies func to the RGB channels of a consecutive FLOAT32_RGBA box
+    template<typename F> static void transformRGB(const PixelBox& box, F func)
+    {
+        float* data = reinterpret_cast<float*>(box.data);
+        size_t width = box.getWidth();
+        size_t rows = box.getHeight() * box.getDepth();
+        processRowBands(rows, box.getConsecutiveSize(), [data, width, func](size_t begin, size_t end) {
+            for (size_t i = begin * width * 4; i < end * width * 4; i += 4)
+            {
+                data[i + 0] = func(data[i + 0]);
+                data[i + 1] = func(data[i + 1]);
+                data[i + 2] = func(data[i + 2]);
+            }
+        });
+    }
+    /// fraction of texels of a FLOAT32_RGBA box where alpha * alphaScale passes the alpha test
+    static float getAlphaCoverage(const PixelBox& box, float alphaRef, float alphaScale)
+    {
+        const float* data = reinterpret_cast<const float*>(box.data);
+        size_t count = box.getWidth() * box.getHeight() * box.getDepth();
+        size_t passed = 0;
+        for (size_t i = 0; i < count; i++)
+            passed += data[i * 4 + 3] * alphaScale >= alphaRef;
+        return float(passed) / count;
+    }
+    /// scales alpha of a FLOAT32_RGBA box so its alpha test coverage matches the given one
+    static void scaleAlphaToCoverage(const PixelBox& box, float alphaRef, float coverage)
+    {
+        // coverage grows with the scale, so bisect
+        float lo = 0, hi = 4, alphaScale = 1;
+        for (int i = 0; i < 10; i++)
+        {
+            float c = getAlphaCoverage(box, alphaRef, alphaScale);
+            if (c < coverage)
+                lo = alphaScale;
+            else if (c > coverage)
+                hi = alphaScale;
+            else
+                break;
+            alphaScale = (lo + hi) / 2;
+        }
+
+        float* data = reinterpret_cast<float*>(box.data);
+        size_t count = box.getWidth() * box.getHeight() * box.getDepth();
+        for (size_t i = 0; i < count; i++)
+            data[i * 4 + 3] = Math::saturate(data[i * 4 + 3] * alphaScale);
+    }
+    //-----------------------------------------------------------------------------
+    Image& Image::generateMipmaps(bool gammaCorrected, Filter filter, float alphaCoverageRef)
+    {
+        OgreAssert(mAutoDelete, "generating mipmaps for dynamic images is not supported");
+        OgreAssert(!PixelUtil::isCompressed(mFormat), "compressed formats are not supported");
+
+        uint32 numFaces = getNumFaces();
+        uint32 numMips = Bitwise::mostSignificantBitSet(std::max(std::max(mWidth, mHeight), mDepth));
+        bool alphaTest = alphaCoverageRef > 0 && getHasAlpha();
+
+        // reassign buffer to temp image, make sure auto-delete is true
+        Image top;
+        top.loadDynamicImage(mBuffer, mWidth, mHeight, mDepth, mFormat, true, numFaces, mNumMipmaps);
+
+        // do not delete[] mBuffer!  top will destroy it
+        mBuffer = 0;
+        create(mFormat, mWidth, mHeight, mDepth, numFaces, numMips);
+
+        for (uint32 face = 0; face < numFaces; face++)
+        {
+            PixelUtil::bulkPixelConversion(top.getPixelBox(face), getPixelBox(face));
+
+            if (!gammaCorrected && !alphaTest && filter != FILTER_LANCZOS)
+            {
+                // directly in the image format, which has the fastest resamplers
+                for (uint32 mip = 1; mip <= numMips; mip++)
+                    scale(getPixelBox(face, mip - 1), getPixelBox(face, mip), filter);
+                continue;
+            }
+
+            // in linear FLOAT32_RGBA, always filtering the previous, unadjusted level
+            Image levels[2];
+            Image encoded;
+            levels[0].create(PF_FLOAT32_RGBA, mWidth, mHeight, mDepth);
+            PixelUtil::bulkPixelConversion(getPixelBox(face), levels[0].getPixelBox());
+            if (gammaCorrected)
+                transformRGB(levels[0].getPixelBox(), sRGBToLinear);
+
+            float coverage = alphaTest ? getAlphaCoverage(levels[0].getPixelBox(), alphaCoverageRef, 1) : 0;
+
+            for (uint32 mip = 1; mip <= numMips; mip++)
+            {
+                PixelBox dst = getPixelBox(face, mip);
+                const Image& prev = levels[(mip - 1) % 2];
+                Image& cur = levels[mip % 2];
+                cur.create(PF_FLOAT32_RGBA, dst.getWidth(), dst.getHeight(), dst.getDepth());
+                scale(prev.getPixelBox(), cur.getPixelBox(), filter);
+
+                if (!gammaCorrected && !alphaTest)
+                {
+                    PixelUtil::bulkPixelConversion(cur.getPixelBox(), dst);
+                    continue;
+                }
+
+                encoded = cur;
+                if (alphaTest)
+                    scaleAlphaToCoverage(encoded.getPixelBox(), alphaCoverageRef, coverage);
+                if (gammaCorrected)
+                    transformRGB(encoded.getPixelBox(), linearToSRGB);
+                PixelUtil::bulkPixelConversion(encoded.getPixelBox(), dst);
+            }
+        }
+
+        return *this;
+    }
 
     //-----------------------------------------------------------------------------    
 
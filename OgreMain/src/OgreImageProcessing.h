@@ -0,0 +1,85 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ImageProcessing_H__
+#define __ImageProcessing_H__
+
+// Internal include file -- shared by the pixel conversion and the image
+// resampling code. Do not use externally.
+
+#include "OgrePlatformInformation.h"
+#include "OgreParallel.h"
+
+// Integer SIMD kernels need SSE2 on x86, which (unlike SSE) is not implied by
+// __OGRE_HAVE_SSE on 32 bit targets, so check what the compiler really emits.
+#if __OGRE_HAVE_SSE
+#   include <xmmintrin.h>
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define OGRE_IMAGE_SSE2 1
+#       include <emmintrin.h>
+#   endif
+#elif __OGRE_HAVE_NEON
+#   define OGRE_IMAGE_NEON 1
+#   include <arm_neon.h>
+#endif
+
+#ifndef OGRE_IMAGE_SSE2
+#   define OGRE_IMAGE_SSE2 0
+#endif
+#ifndef OGRE_IMAGE_NEON
+#   define OGRE_IMAGE_NEON 0
+#endif
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Image
+    *  @{
+    */
+
+    /** Splits @c rows into contiguous bands and calls @c func(begin, end) for each.
+
+        Bands are processed on separate threads when the image is large enough to
+        amortise the thread start-up. Each band must only write its own rows.
+        Exceptions thrown by a band are rethrown on the calling thread.
+    @param rows number of rows to process
+    @param bytes total amount of data written, used to decide on the band count
+    */
+    template<typename F> void processRowBands(size_t rows, size_t bytes, const F& func)
+    {
+        // below this a band is cheaper than starting a thread for it
+        const size_t MIN_BAND_BYTES = 256 * 1024;
+        const size_t MIN_BAND_ROWS = 16;
+        size_t rowBytes = std::max(bytes / std::max(rows, size_t(1)), size_t(1));
+        parallelFor(rows, std::max(MIN_BAND_ROWS, (MIN_BAND_BYTES + rowBytes - 1) / rowBytes), func);
+    }
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define OGREIMAGERESAMPLER_H
 
 #include <algorithm>
+#include <vector>
 
 // this file is inlined into OgreImage.cpp!
 // do not include anywhere else.
@@ -47,17 +48,20 @@ namespace Ogre {
 // sx2 = upper-bound integer x-position in source
 // sxf = fractional weight between sx1 and sx2
 // x,y,z = location of output pixel in destination
+//
+// all resamplers only write the destination rows [rowBegin, rowEnd) of every
+// slice, so Image::scale can hand out disjoint bands of rows to threads
 
 // nearest-neighbor resampler, does not convert formats.
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as simplifying memcpy() and replacing multiplies with bitshifts
 template<unsigned int elemsize> struct NearestResampler {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
         // assert(src.format == dst.format);
 
-        // srcdata stays at beginning, pdst is a moving pointer
-        uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        // srcdata and dstdata stay at beginning
+        uchar* srcdata = src.getTopLeftFrontPixelPtr();
+        uchar* dstdata = dst.getTopLeftFrontPixelPtr();
 
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -68,12 +72,13 @@ template<unsigned int elemsize> struct NearestResampler {
         // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
         // for the center of the destination pixel, not the top-left corner
         uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48 += stepz) {
+        for (size_t z = 0; z < dst.getDepth(); z++, sz_48 += stepz) {
             size_t srczoff = (size_t)(sz_48 >> 48) * src.slicePitch;
             
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48 += stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + rowBegin * stepy;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48 += stepy) {
                 size_t srcyoff = (size_t)(sy_48 >> 48) * src.rowPitch;
+                uchar* pdst = dstdata + elemsize*(y*dst.rowPitch + z*dst.slicePitch);
             
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48 += stepx) {
@@ -82,9 +87,7 @@ template<unsigned int elemsize> struct NearestResampler {
                     memcpy(pdst, psrc, elemsize);
                     pdst += elemsize;
                 }
-                pdst += elemsize*dst.getRowSkip();
             }
-            pdst += elemsize*dst.getSliceSkip();
         }
     }
 };
@@ -92,13 +95,13 @@ template<unsigned int elemsize> struct NearestResampler {
 
 // default floating-point linear resampler, does format conversion
 struct LinearResampler {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
         size_t srcelemsize = PixelUtil::getNumElemBytes(src.format);
         size_t dstelemsize = PixelUtil::getNumElemBytes(dst.format);
 
-        // srcdata stays at beginning, pdst is a moving pointer
-        uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        // srcdata and dstdata stay at beginning
+        uchar* srcdata = src.getTopLeftFrontPixelPtr();
+        uchar* dstdata = dst.getTopLeftFrontPixelPtr();
         
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -109,7 +112,7 @@ struct LinearResampler {
         // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
         // for the center of the destination pixel, not the top-left corner
         uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48+=stepz) {
+        for (size_t z = 0; z < dst.getDepth(); z++, sz_48+=stepz) {
             // temp is 16/16 bit fixed precision, used to adjust a source
             // coordinate (x, y, or z) backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -121,13 +124,14 @@ struct LinearResampler {
             uint32 sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
             float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + rowBegin * stepy;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
                 temp = static_cast<unsigned int>(sy_48 >> 32);
                 temp = (temp > 0x8000)? temp - 0x8000 : 0;
                 uint32 sy1 = temp >> 16;                    // src y #1
                 uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
                 float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+                uchar* pdst = dstdata + dstelemsize*(y*dst.rowPitch + z*dst.slicePitch);
                 
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
@@ -163,9 +167,7 @@ struct LinearResampler {
 
                     pdst += dstelemsize;
                 }
-                pdst += dstelemsize*dst.getRowSkip();
             }
-            pdst += dstelemsize*dst.getSliceSkip();
         }
     }
 };
@@ -174,15 +176,15 @@ struct LinearResampler {
 // float32 linear resampler, converts FLOAT32_RGB/FLOAT32_RGBA only.
 // avoids overhead of pixel unpack/repack function calls
 struct LinearResampler_Float32 {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
         size_t srcchannels = PixelUtil::getNumElemBytes(src.format) / sizeof(float);
         size_t dstchannels = PixelUtil::getNumElemBytes(dst.format) / sizeof(float);
         // assert(srcchannels == 3 || srcchannels == 4);
         // assert(dstchannels == 3 || dstchannels == 4);
 
-        // srcdata stays at beginning, pdst is a moving pointer
+        // srcdata and dstdata stay at beginning
         float* srcdata = (float*)src.getTopLeftFrontPixelPtr();
-        float* pdst = (float*)dst.getTopLeftFrontPixelPtr();
+        float* dstdata = (float*)dst.getTopLeftFrontPixelPtr();
         
         // sx_48,sy_48,sz_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
@@ -193,7 +195,7 @@ struct LinearResampler_Float32 {
         // note: ((stepz>>1) - 1) is an extra half-step increment to adjust
         // for the center of the destination pixel, not the top-left corner
         uint64 sz_48 = (stepz >> 1) - 1;
-        for (size_t z = dst.front; z < dst.back; z++, sz_48+=stepz) {
+        for (size_t z = 0; z < dst.getDepth(); z++, sz_48+=stepz) {
             // temp is 16/16 bit fixed precision, used to adjust a source
             // coordinate (x, y, or z) backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -205,13 +207,14 @@ struct LinearResampler_Float32 {
             uint32 sz2 = std::min(sz1+1,src.getDepth()-1);// src z, sample #2
             float szf = (temp & 0xFFFF) / 65536.f; // weight of sample #2
 
-            uint64 sy_48 = (stepy >> 1) - 1;
-            for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+            uint64 sy_48 = (stepy >> 1) - 1 + rowBegin * stepy;
+            for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
                 temp = static_cast<unsigned int>(sy_48 >> 32);
                 temp = (temp > 0x8000)? temp - 0x8000 : 0;
                 uint32 sy1 = temp >> 16;                    // src y #1
                 uint32 sy2 = std::min(sy1+1,src.getHeight()-1);// src y #2
                 float syf = (temp & 0xFFFF) / 65536.f; // weight of #2
+                float* pdst = dstdata + dstchannels*(y*dst.rowPitch + z*dst.slicePitch);
                 
                 uint64 sx_48 = (stepx >> 1) - 1;
                 for (size_t x = dst.left; x < dst.right; x++, sx_48+=stepx) {
@@ -220,6 +223,39 @@ struct LinearResampler_Float32 {
                     uint32 sx1 = temp >> 16;                    // src x #1
                     uint32 sx2 = std::min(sx1+1,src.getWidth()-1);// src x #2
                     float sxf = (temp & 0xFFFF) / 65536.f; // weight of #2
+
+#if __OGRE_HAVE_SSE || OGRE_IMAGE_NEON
+                    if (srcchannels == 4 && dstchannels == 4) {
+                        // RGBA, all channels at once in the same order as ACCUM4
+#if __OGRE_HAVE_SSE
+                        __m128 accum = _mm_setzero_ps();
+#define ACCUM4V(x,y,z,factor) \
+    accum = _mm_add_ps(accum, _mm_mul_ps(_mm_loadu_ps(srcdata + \
+        (x+y*src.rowPitch+z*src.slicePitch)*4), _mm_set1_ps(factor)));
+#else
+                        float32x4_t accum = vdupq_n_f32(0.0f);
+#define ACCUM4V(x,y,z,factor) \
+    accum = vaddq_f32(accum, vmulq_n_f32(vld1q_f32(srcdata + \
+        (x+y*src.rowPitch+z*src.slicePitch)*4), factor));
+#endif
+                        ACCUM4V(sx1,sy1,sz1,(1.0f-sxf)*(1.0f-syf)*(1.0f-szf));
+                        ACCUM4V(sx2,sy1,sz1,      sxf *(1.0f-syf)*(1.0f-szf));
+                        ACCUM4V(sx1,sy2,sz1,(1.0f-sxf)*      syf *(1.0f-szf));
+                        ACCUM4V(sx2,sy2,sz1,      sxf *      syf *(1.0f-szf));
+                        ACCUM4V(sx1,sy1,sz2,(1.0f-sxf)*(1.0f-syf)*      szf );
+                        ACCUM4V(sx2,sy1,sz2,      sxf *(1.0f-syf)*      szf );
+                        ACCUM4V(sx1,sy2,sz2,(1.0f-sxf)*      syf *      szf );
+                        ACCUM4V(sx2,sy2,sz2,      sxf *      syf *      szf );
+#undef ACCUM4V
+#if __OGRE_HAVE_SSE
+                        _mm_storeu_ps(pdst, accum);
+#else
+                        vst1q_f32(pdst, accum);
+#endif
+                        pdst += 4;
+                        continue;
+                    }
+#endif
                     
                     // process R,G,B,A simultaneously for cache coherence?
                     float accum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
@@ -266,14 +302,22 @@ struct LinearResampler_Float32 {
 
                     pdst += dstchannels;
                 }
-                pdst += dstchannels*dst.getRowSkip();
             }
-            pdst += dstchannels*dst.getSliceSkip();
         }
     }
 };
 
 
+#if OGRE_IMAGE_SSE2
+// low 32 bits of a 32x32 bit multiply, SSE2 lacks _mm_mullo_epi32
+static inline __m128i mulloEpi32(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
 
 // byte linear resampler, does not do any format conversions.
 // only handles pixel formats that use 1 byte per color channel.
@@ -281,26 +325,26 @@ struct LinearResampler_Float32 {
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as unrolling loops and replacing multiplies with bitshifts
 template<unsigned int channels> struct LinearResampler_Byte {
-    static void scale(const PixelBox& src, const PixelBox& dst) {
+    static void scale(const PixelBox& src, const PixelBox& dst, size_t rowBegin, size_t rowEnd) {
         // assert(src.format == dst.format);
 
         // only optimized for 2D
         if (src.getDepth() > 1 || dst.getDepth() > 1) {
-            LinearResampler::scale(src, dst);
+            LinearResampler::scale(src, dst, rowBegin, rowEnd);
             return;
         }
 
         // srcdata stays at beginning of slice, pdst is a moving pointer
-        uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* srcdata = src.getTopLeftFrontPixelPtr();
+        uchar* pdst = dst.getTopLeftFrontPixelPtr() + channels*rowBegin*dst.rowPitch;
 
         // sx_48,sy_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
         uint64 stepx = ((uint64)src.getWidth() << 48) / dst.getWidth();
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
         
-        uint64 sy_48 = (stepy >> 1) - 1;
-        for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+        uint64 sy_48 = (stepy >> 1) - 1 + rowBegin * stepy;
+        for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
             // bottom 28 bits of temp are 16/12 bit fixed precision, used to
             // adjust a source coordinate backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -321,6 +365,48 @@ template<unsigned int channels> struct LinearResampler_Byte {
                 uint32 sx1 = temp >> 12;
                 uint32 sx2 = std::min(sx1+1, src.right-src.left-1);
 
+#if OGRE_IMAGE_SSE2 || OGRE_IMAGE_NEON
+                if (channels == 4) {
+                    // the weights below factor into (0x1000-sxf|sxf) * (0x1000-syf|syf),
+                    // so filter horizontally first and vertically second. Same
+                    // integer result, but without 32 bit products per channel.
+                    uint32 p11, p21, p12, p22;
+                    memcpy(&p11, srcdata + (sx1 + syoff1)*4, 4);
+                    memcpy(&p21, srcdata + (sx2 + syoff1)*4, 4);
+                    memcpy(&p12, srcdata + (sx1 + syoff2)*4, 4);
+                    memcpy(&p22, srcdata + (sx2 + syoff2)*4, 4);
+#if OGRE_IMAGE_SSE2
+                    const __m128i zero = _mm_setzero_si128();
+                    __m128i wx = _mm_set1_epi32(int((sxf << 16) | (0x1000 - sxf)));
+                    __m128i h1 = _mm_madd_epi16(_mm_unpacklo_epi16(
+                        _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(p11)), zero),
+                        _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(p21)), zero)), wx);
+                    __m128i h2 = _mm_madd_epi16(_mm_unpacklo_epi16(
+                        _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(p12)), zero),
+                        _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(p22)), zero)), wx);
+                    __m128i accum = _mm_add_epi32(mulloEpi32(h1, _mm_set1_epi32(int(0x1000 - syf))),
+                                                  mulloEpi32(h2, _mm_set1_epi32(int(syf))));
+                    accum = _mm_srli_epi32(_mm_add_epi32(accum, _mm_set1_epi32(0x800000)), 24);
+                    accum = _mm_packs_epi32(accum, accum);
+                    uint32 result = uint32(_mm_cvtsi128_si32(_mm_packus_epi16(accum, accum)));
+#elif OGRE_IMAGE_NEON
+                    uint16x4_t a = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p11))));
+                    uint16x4_t b = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p21))));
+                    uint16x4_t c = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p12))));
+                    uint16x4_t d = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p22))));
+                    uint32x4_t h1 = vmlal_n_u16(vmull_n_u16(a, uint16(0x1000 - sxf)), b, uint16(sxf));
+                    uint32x4_t h2 = vmlal_n_u16(vmull_n_u16(c, uint16(0x1000 - sxf)), d, uint16(sxf));
+                    uint32x4_t accum = vmlaq_n_u32(vmulq_n_u32(h1, 0x1000 - syf), h2, syf);
+                    accum = vshrq_n_u32(vaddq_u32(accum, vdupq_n_u32(0x800000)), 24);
+                    uint16x4_t narrow = vmovn_u32(accum);
+                    uint32 result = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(narrow, narrow))), 0);
+#endif
+                    memcpy(pdst, &result, 4);
+                    pdst += 4;
+                    continue;
+                }
+#endif
+
                 unsigned int sxfsyf = sxf*syf;
                 for (unsigned int k = 0; k < channels; k++) {
                     unsigned int accum =
@@ -337,6 +423,117 @@ template<unsigned int channels> struct LinearResampler_Byte {
         }
     }
 };
+
+// sum of weights[i] * src[i*stride], for FLOAT32_RGBA pixels
+static inline void weightedSumRGBA(float* out, const float* src, size_t stride, const float* weights, size_t n)
+{
+#if __OGRE_HAVE_SSE
+    __m128 accum = _mm_setzero_ps();
+    for (size_t i = 0; i < n; i++)
+        accum = _mm_add_ps(accum, _mm_mul_ps(_mm_loadu_ps(src + i*stride), _mm_set1_ps(weights[i])));
+    _mm_storeu_ps(out, accum);
+#elif OGRE_IMAGE_NEON
+    float32x4_t accum = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < n; i++)
+        accum = vaddq_f32(accum, vmulq_n_f32(vld1q_f32(src + i*stride), weights[i]));
+    vst1q_f32(out, accum);
+#else
+    float accum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (size_t i = 0; i < n; i++)
+        for (int k = 0; k < 4; k++)
+            accum[k] += src[i*stride + k] * weights[i];
+    memcpy(out, accum, sizeof(accum));
+#endif
+}
+
+// separable lanczos resampler with a = 3, FLOAT32_RGBA to FLOAT32_RGBA only.
+// 2D only. When minifying the kernel is stretched by the scale factor, so
+// every source pixel contributes.
+struct LanczosResampler_Float32 {
+    // filter taps of one axis: destination pixel i reads count[i] source
+    // pixels starting at first[i], with weights at i*taps
+    struct Taps {
+        std::vector<uint32> first, count;
+        std::vector<float> weights;
+        size_t taps;
+    };
+
+    static float lanczos3(float x) {
+        if (x == 0.0f)
+            return 1.0f;
+        if (x <= -3.0f || x >= 3.0f)
+            return 0.0f;
+        float px = Math::PI * x;
+        return 3.0f * std::sin(px) * std::sin(px / 3.0f) / (px * px);
+    }
+
+    static void computeTaps(uint32 srcSize, uint32 dstSize, Taps& t) {
+        float ratio = float(srcSize) / dstSize;
+        float stretch = std::max(1.0f, ratio);
+        float support = 3.0f * stretch;
+        t.taps = size_t(std::ceil(support)) * 2 + 1;
+        t.first.resize(dstSize);
+        t.count.resize(dstSize);
+        t.weights.assign(dstSize * t.taps, 0.0f);
+
+        for (uint32 i = 0; i < dstSize; i++) {
+            // pixel centres of destination and source line up
+            float centre = (i + 0.5f) * ratio - 0.5f;
+            int lo = std::max(0, int(std::ceil(centre - support)));
+            int hi = std::min(int(srcSize) - 1, int(std::floor(centre + support)));
+            hi = std::min(hi, lo + int(t.taps) - 1);
+
+            float* w = &t.weights[i * t.taps];
+            float sum = 0.0f;
+            for (int j = lo; j <= hi; j++) {
+                w[j - lo] = lanczos3((j - centre) / stretch);
+                sum += w[j - lo];
+            }
+            // renormalise, which also takes care of the clipped edges
+            for (int j = lo; j <= hi; j++)
+                w[j - lo] /= sum;
+
+            t.first[i] = uint32(lo);
+            t.count[i] = uint32(hi - lo + 1);
+        }
+    }
+
+    static void scale(const PixelBox& src, const PixelBox& dst) {
+        // assert(src.format == PF_FLOAT32_RGBA && dst.format == PF_FLOAT32_RGBA);
+        uint32 srcWidth = src.getWidth(), srcHeight = src.getHeight();
+        uint32 dstWidth = dst.getWidth(), dstHeight = dst.getHeight();
+
+        Taps tx, ty;
+        computeTaps(srcWidth, dstWidth, tx);
+        computeTaps(srcHeight, dstHeight, ty);
+
+        const float* srcdata = (const float*)src.getTopLeftFrontPixelPtr();
+        float* dstdata = (float*)dst.getTopLeftFrontPixelPtr();
+
+        // horizontal pass into srcHeight x dstWidth
+        std::vector<float> temp(size_t(srcHeight) * dstWidth * 4);
+        processRowBands(srcHeight, temp.size() * sizeof(float), [&](size_t rowBegin, size_t rowEnd) {
+            for (size_t y = rowBegin; y < rowEnd; y++) {
+                const float* srcrow = srcdata + y * src.rowPitch * 4;
+                float* temprow = &temp[y * dstWidth * 4];
+                for (uint32 x = 0; x < dstWidth; x++)
+                    weightedSumRGBA(temprow + x * 4, srcrow + tx.first[x] * 4, 4,
+                                    &tx.weights[x * tx.taps], tx.count[x]);
+            }
+        });
+
+        // vertical pass into the destination
+        processRowBands(dstHeight, size_t(dstHeight) * dstWidth * 4 * sizeof(float), [&](size_t rowBegin, size_t rowEnd) {
+            for (size_t y = rowBegin; y < rowEnd; y++) {
+                const float* tempcol = &temp[ty.first[y] * dstWidth * 4];
+                float* dstrow = dstdata + y * dst.rowPitch * 4;
+                for (uint32 x = 0; x < dstWidth; x++)
+                    weightedSumRGBA(dstrow + x * 4, tempcol + x * 4, dstWidth * 4,
+                                    &ty.weights[y * ty.taps], ty.count[y]);
+            }
+        });
+    }
+};
 /** @} */
 /** @} */
 
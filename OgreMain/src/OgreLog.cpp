@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 
 #include <iostream>
+#include <thread>
+#include <condition_variable>
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
 #   include <windows.h>
@@ -47,6 +49,173 @@ namespace {
 
 namespace Ogre
 {
+    /// Bounded queue of messages, filled by any thread and emptied by a single writer thread
+    struct Log::AsyncWriter
+    {
+        struct Record
+        {
+            /// position in the queue this record is ready for, see push and front
+            std::atomic<size_t> sequence;
+            /// keeps its capacity, so filling the record does not allocate in the long run
+            String message;
+            LogMessageLevel lml;
+            bool maskDebug;
+            time_t time;
+        };
+
+        std::unique_ptr<Record[]> records;
+        size_t mask;
+        /// the next position to be claimed by a logging thread
+        std::atomic<size_t> pushPos;
+        /// the next position to be written, only changed by the writer thread
+        std::atomic<size_t> popPos;
+
+        std::mutex queueMutex;
+        /// signals the writer thread that there are messages
+        std::condition_variable messagesQueued;
+        /// signals flushing threads that the queue was written out
+        std::condition_variable messagesWritten;
+        std::atomic<bool> writerWaiting;
+        bool stop;
+        std::thread thread;
+
+        explicit AsyncWriter(size_t queueSize)
+            : pushPos(0), popPos(0), writerWaiting(false), stop(false)
+        {
+            size_t size = 1;
+            while (size < queueSize)
+                size *= 2;
+            records.reset(new Record[size]);
+            mask = size - 1;
+            for (size_t i = 0; i < size; ++i)
+                records[i].sequence = i;
+        }
+
+        /// Queue a message without locking, waits while the queue is full
+        size_t push(const String& message, LogMessageLevel lml, bool maskDebug, time_t time)
+        {
+            size_t pos = pushPos.load(std::memory_order_relaxed);
+            Record* record;
+            while (true)
+            {
+                record = &records[pos & mask];
+                intptr_t diff = intptr_t(record->sequence.load(std::memory_order_acquire)) - intptr_t(pos);
+                if (diff == 0)
+                {
+                    if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    // full, give the writer time to catch up
+                    wakeWriter();
+                    std::this_thread::yield();
+                    pos = pushPos.load(std::memory_order_relaxed);
+                }
+                else
+                {
+                    pos = pushPos.load(std::memory_order_relaxed);
+                }
+            }
+
+            record->message = message;
+            record->lml = lml;
+            record->maskDebug = maskDebug;
+            record->time = time;
+            record->sequence.store(pos + 1);
+
+            wakeWriter();
+            return pos + 1;
+        }
+
+        /// The oldest queued record or NULL, only called by the writer thread
+        Record* front()
+        {
+            size_t pos = popPos.load(std::memory_order_relaxed);
+            Record* record = &records[pos & mask];
+            return record->sequence.load() == pos + 1 ? record : NULL;
+        }
+
+        /// Release the record returned by front
+        void pop()
+        {
+            size_t pos = popPos.load(std::memory_order_relaxed);
+            records[pos & mask].sequence.store(pos + mask + 1, std::memory_order_release);
+            popPos.store(pos + 1);
+        }
+
+        void wakeWriter()
+        {
+            if (writerWaiting.load())
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                messagesQueued.notify_one();
+            }
+        }
+
+        /// Wait until the messages up to the given position are written
+        void waitWritten(size_t pos)
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            messagesQueued.notify_one();
+            messagesWritten.wait(lock, [this, pos]() { return popPos.load() >= pos; });
+        }
+    };
+
+    /// Stream buffer appending to a String, which keeps its capacity when it is reused
+    struct Log::StreamBuffer : public std::streambuf
+    {
+        String message;
+        std::ostream stream;
+
+        StreamBuffer() : stream(this) {}
+
+        int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+                message.push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            message.append(s, size_t(n));
+            return n;
+        }
+
+        /// The buffers not used by a Stream of the current thread
+        static std::vector<std::unique_ptr<StreamBuffer>>& getFreeBuffers()
+        {
+            thread_local std::vector<std::unique_ptr<StreamBuffer>> freeBuffers;
+            return freeBuffers;
+        }
+
+        /// Take a buffer of the current thread, nested streams get a buffer each
+        static StreamBuffer* acquire()
+        {
+            auto& freeBuffers = getFreeBuffers();
+            if (freeBuffers.empty())
+                return new StreamBuffer();
+
+            StreamBuffer* buffer = freeBuffers.back().release();
+            freeBuffers.pop_back();
+
+            // forget the formatting of the previous message
+            std::ostream& stream = buffer->stream;
+            stream.flags(std::ios_base::dec | std::ios_base::skipws);
+            stream.precision(6);
+            stream.width(0);
+            stream.fill(' ');
+            stream.clear();
+            return buffer;
+        }
+
+        static void release(StreamBuffer* buffer)
+        {
+            buffer->message.clear();
+            getFreeBuffers().emplace_back(buffer);
+        }
+    };
     //-----------------------------------------------------------------------
     Log::Log( const String& name, bool debuggerOutput, bool suppressFile ) : 
         mLogLevel(LML_NORMAL), mDebugOut(debuggerOutput),
@@ -85,6 +254,9 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Log::~Log()
     {
+        // write out the queued messages
+        setAsynchronous(false);
+
         OGRE_LOCK_AUTO_MUTEX;
         if (!mSuppressFile)
         {
@@ -95,59 +267,78 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void Log::logMessage( const String& message, LogMessageLevel lml, bool maskDebug )
     {
+        if (mAsyncWriter && mAsyncWriter->thread.get_id() != std::this_thread::get_id())
+        {
+            if (lml < mLogLevel)
+                return;
+
+            size_t pos = mAsyncWriter->push(message, lml, maskDebug, time(NULL));
+
+            // make sure errors reach the file, even if the application terminates right after
+            if (lml >= LML_CRITICAL)
+                mAsyncWriter->waitWritten(pos);
+            return;
+        }
+
         OGRE_LOCK_AUTO_MUTEX;
         if (lml >= mLogLevel)
         {
-            bool skipThisMessage = false;
-            for( mtLogListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
-                (*i)->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage);
-            
-            if (!skipThisMessage)
+            writeMessage(message, lml, maskDebug, time(NULL));
+
+            // Flush stream to ensure it is written (incase of a crash, we need log to be up to date)
+            if (!mSuppressFile)
+                mLog.flush();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+    void Log::writeMessage(const String& message, LogMessageLevel lml, bool maskDebug, time_t ctTime)
+    {
+        bool skipThisMessage = false;
+        for( mtLogListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
+            (*i)->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage);
+        
+        if (!skipThisMessage)
+        {
+            if (mDebugOut && !maskDebug)
             {
-                if (mDebugOut && !maskDebug)
-                {
 #    if (OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT) && OGRE_DEBUG_MODE
-                    OutputDebugStringA("Ogre: ");
-                    OutputDebugStringA(message.c_str());
-                    OutputDebugStringA("\n");
+                OutputDebugStringA("Ogre: ");
+                OutputDebugStringA(message.c_str());
+                OutputDebugStringA("\n");
 #    endif
 
-                    std::ostream& os = int(lml) >= int(LML_WARNING) ? std::cerr : std::cout;
+                std::ostream& os = int(lml) >= int(LML_WARNING) ? std::cerr : std::cout;
 
-                    if(mTermHasColours) {
-                        if(lml == LML_WARNING)
-                            os << YELLOW;
-                        if(lml == LML_CRITICAL)
-                            os << RED;
-                    }
-
-                    os << message;
+                if(mTermHasColours) {
+                    if(lml == LML_WARNING)
+                        os << YELLOW;
+                    if(lml == LML_CRITICAL)
+                        os << RED;
+                }
 
-                    if(mTermHasColours) {
-                        os << RESET;
-                    }
+                os << message;
 
-                    os << std::endl;
+                if(mTermHasColours) {
+                    os << RESET;
                 }
 
-                // Write time into log
-                if (!mSuppressFile)
-                {
-                    if (mTimeStamp)
-                    {
-                        struct tm *pTime;
-                        time_t ctTime; time(&ctTime);
-                        pTime = localtime( &ctTime );
-                        mLog << std::setw(2) << std::setfill('0') << pTime->tm_hour
-                            << ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
-                            << ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec
-                            << ": ";
-                    }
-                    mLog << message << std::endl;
+                os << std::endl;
+            }
 
-                    // Flush stcmdream to ensure it is written (incase of a crash, we need log to be up to date)
-                    mLog.flush();
+            // Write time into log
+            if (!mSuppressFile)
+            {
+                if (mTimeStamp)
+                {
+                    struct tm *pTime;
+                    pTime = localtime( &ctTime );
+                    mLog << std::setw(2) << std::setfill('0') << pTime->tm_hour
+                        << ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
+                        << ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec
+                        << ": ";
                 }
+                mLog << message << '\n';
             }
         }
     }
@@ -195,10 +386,113 @@ namespace Ogre
         if (i != mListeners.end())
             mListeners.erase(i);
     }
+    //-----------------------------------------------------------------------
+    void Log::setAsynchronous(bool async, size_t queueSize)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (async == isAsynchronous())
+            return;
+
+        if (async)
+        {
+            OgreAssert(queueSize > 0, "the queue must hold at least one message");
+            mAsyncWriter.reset(new AsyncWriter(queueSize));
+            AsyncWriter* writer = mAsyncWriter.get();
+
+            // the writer starts once its thread id is known, which tells it apart from logging threads
+            std::lock_guard<std::mutex> startLock(writer->queueMutex);
+            writer->thread = std::thread([this, writer]() {
+                {
+                    std::lock_guard<std::mutex> lock(writer->queueMutex);
+                }
+                while (true)
+                {
+                    if (writer->front())
+                    {
+                        OGRE_LOCK_AUTO_MUTEX;
+                        while (AsyncWriter::Record* record = writer->front())
+                        {
+                            writeMessage(record->message, record->lml, record->maskDebug, record->time);
+                            writer->pop();
+                        }
+                        if (!mSuppressFile)
+                            mLog.flush();
+                    }
+
+                    std::unique_lock<std::mutex> lock(writer->queueMutex);
+                    writer->messagesWritten.notify_all();
+
+                    // announce the wait before checking for messages, so no wake up is missed
+                    writer->writerWaiting = true;
+                    if (!writer->front())
+                    {
+                        if (writer->stop)
+                            break;
+                        writer->messagesQueued.wait(lock);
+                    }
+                    writer->writerWaiting = false;
+                }
+            });
+        }
+        else
+        {
+            {
+                std::lock_guard<std::mutex> lock(mAsyncWriter->queueMutex);
+                mAsyncWriter->stop = true;
+                mAsyncWriter->messagesQueued.notify_one();
+            }
+            mAsyncWriter->thread.join();
+            mAsyncWriter.reset();
+        }
+#endif
+    }
+
+    //-----------------------------------------------------------------------
+    void Log::flush()
+    {
+        if (mAsyncWriter)
+            mAsyncWriter->waitWritten(mAsyncWriter->pushPos.load());
+    }
+
     //---------------------------------------------------------------------
     Log::Stream Log::stream(LogMessageLevel lml, bool maskDebug) 
     {
         return Stream(this, lml, maskDebug);
 
     }
+
+    //---------------------------------------------------------------------
+    Log::Stream::Stream(Log* target, LogMessageLevel lml, bool maskDebug)
+        : mTarget(target), mLevel(lml), mMaskDebug(maskDebug), mBuffer(StreamBuffer::acquire()),
+          mCache(&mBuffer->stream)
+    {
+    }
+
+    Log::Stream::Stream(Stream&& rhs)
+        : mTarget(rhs.mTarget), mLevel(rhs.mLevel), mMaskDebug(rhs.mMaskDebug), mBuffer(rhs.mBuffer),
+          mCache(rhs.mCache)
+    {
+        rhs.mBuffer = NULL;
+    }
+
+    Log::Stream::~Stream()
+    {
+        if (!mBuffer)
+            return;
+
+        // flush on destroy
+        if (!mBuffer->message.empty())
+        {
+            mTarget->logMessage(mBuffer->message, mLevel, mMaskDebug);
+        }
+        StreamBuffer::release(mBuffer);
+    }
+
+    Log::Stream& Log::Stream::operator<< (const Flush& v)
+    {
+        (void)v;
+        mTarget->logMessage(mBuffer->message, mLevel, mMaskDebug);
+        mBuffer->message.clear();
+        return *this;
+    }
 }
@@ -58,6 +58,11 @@ namespace Ogre {
     enum MeshChunkID {
         M_HEADER                = 0x1000,
             // char*          version           : Version number check
+        M_BLOB_TABLE            = 0x2000, // mapped layout only, directly after M_HEADER
+            // unsigned int blobCount
+            // Repeating section (blobCount)
+            // unsigned int offset          : from the start of the file, 16 byte aligned
+            // unsigned int size            : in bytes, raw buffer data ready for upload
         M_MESH                = 0x3000,
             // bool skeletallyAnimated   // important flag which affects h/w buffer policies
             // Optional M_GEOMETRY chunk
@@ -69,6 +74,10 @@ namespace Ogre {
                 // unsigned int* faceVertexIndices (indexCount)
                 // OR
                 // unsigned short* faceVertexIndices (indexCount)
+                // OR (mapped layout, if indexCount > 0)
+                // unsigned int blobIndex
+                // OR (compressed layout, if indexCount > 0)
+                // packed block of delta + zigzag coded indices, byte plane transposed
                 // M_GEOMETRY chunk (Optional: present only if useSharedVertices = false)
                 M_SUBMESH_OPERATION = 0x4010, // optional, trilist assumed if missing
                     // unsigned short operationType
@@ -98,6 +107,15 @@ namespace Ogre {
                     // unsigned short vertexSize;   // Per-vertex size, must agree with declaration at this index
                     M_GEOMETRY_VERTEX_BUFFER_DATA = 0x5210,
                         // raw buffer data
+                        // OR (mapped layout)
+                        // unsigned int blobIndex
+                        // OR (compressed layout)
+                        // Repeating section (elements bound to this buffer, declaration order)
+                        //     unsigned char encoding  : 0 raw, 1 quantized position, 2 octahedral, 3 half
+                        //     float offset[3]         : quantized position only
+                        //     float scale[3]          : quantized position only
+                        // packed block of all encoded elements, each stored as one
+                        // byte plane transposed array over all vertices
             M_MESH_SKELETON_LINK = 0x6000,
                 // Optional link to skeleton
                 // char* skeletonName           : name of .skeleton to use
@@ -208,6 +226,13 @@ namespace Ogre {
             // unsigned short submesh_index;
             // float extremes [n_extremes][3];
 
+    /* Packed block as used by the compressed layout
+        unsigned char method        : 0 stored, 1 deflate
+        unsigned int rawSize
+        unsigned int storedSize
+        unsigned char* data (storedSize)
+    */
+
     /* Version 1.2 of the .mesh format (deprecated)
     enum MeshChunkID {
         M_HEADER                = 0x1000,
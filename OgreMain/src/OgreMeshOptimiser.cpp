@@ -0,0 +1,605 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMeshOptimiser.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationTrack.h"
+#include "OgreKeyFrame.h"
+#include "OgrePose.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// size of the LRU cache the triangle scores are tuned for
+        const uint32 SCORE_CACHE_SIZE = 32;
+
+        float vertexScore(int cachePos, uint32 activeTris)
+        {
+            if (activeTris == 0)
+                return -1;
+
+            float score = 0;
+            if (cachePos >= 0)
+            {
+                // the last triangle's vertices are deliberately penalised, so strips are avoided
+                if (cachePos < 3)
+                    score = 0.75f;
+                else
+                    score = std::pow(1 - (cachePos - 3) / float(SCORE_CACHE_SIZE - 3), 1.5f);
+            }
+            // prefer vertices with few remaining triangles, to get rid of lone triangles early
+            return score + 2.0f / std::sqrt(float(activeTris));
+        }
+
+        /// FIFO cache simulation, timestamps instead of an explicit queue
+        class FifoCache
+        {
+            std::vector<uint32> mTimestamps;
+            uint32 mTime;
+            uint32 mSize;
+        public:
+            FifoCache(size_t vertexCount, uint32 size) : mTimestamps(vertexCount, 0), mTime(size + 1), mSize(size) {}
+            void reset() { mTime += mSize + 1; }
+            uint32 access(uint32 v)
+            {
+                if (mTime - mTimestamps[v] <= mSize)
+                    return 0;
+                mTimestamps[v] = mTime++;
+                return 1;
+            }
+            uint32 accessTriangle(const uint32* tri) { return access(tri[0]) + access(tri[1]) + access(tri[2]); }
+        };
+
+        /// transformed vertices and referenced vertices of a triangle list
+        void simulateCache(const uint32* indices, size_t indexCount, size_t vertexCount, uint32 cacheSize,
+                           size_t& misses, size_t& uniqueVertices)
+        {
+            FifoCache cache(vertexCount, cacheSize);
+            std::vector<bool> referenced(vertexCount, false);
+            misses = uniqueVertices = 0;
+            for (size_t i = 0; i < indexCount / 3 * 3; ++i)
+            {
+                misses += cache.access(indices[i]);
+                if (!referenced[indices[i]])
+                {
+                    referenced[indices[i]] = true;
+                    uniqueVertices++;
+                }
+            }
+        }
+
+        void readIndices(const IndexData* indexData, std::vector<uint32>& indices)
+        {
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            size_t indexSize = ibuf->getIndexSize();
+            indices.resize(indexData->indexCount);
+            HardwareBufferLockGuard ibufLock(ibuf, indexData->indexStart * indexSize, indexData->indexCount * indexSize,
+                                             HardwareBuffer::HBL_READ_ONLY);
+            if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+                memcpy(indices.data(), ibufLock.pData, indices.size() * sizeof(uint32));
+            else
+                std::copy_n(static_cast<const uint16*>(ibufLock.pData), indices.size(), indices.begin());
+        }
+
+        void writeIndices(IndexData* indexData, const std::vector<uint32>& indices)
+        {
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            size_t indexSize = ibuf->getIndexSize();
+            HardwareBufferLockGuard ibufLock(ibuf, indexData->indexStart * indexSize, indexData->indexCount * indexSize,
+                                             HardwareBuffer::HBL_NORMAL);
+            if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+                memcpy(ibufLock.pData, indices.data(), indices.size() * sizeof(uint32));
+            else
+                std::copy(indices.begin(), indices.end(), static_cast<uint16*>(ibufLock.pData));
+        }
+
+        bool readPositions(const VertexData* vertexData, std::vector<Vector3>& positions)
+        {
+            const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+            if (!posElem || posElem->getType() != VET_FLOAT3)
+                return false;
+
+            const HardwareVertexBufferSharedPtr& vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+            size_t vertexSize = vbuf->getVertexSize();
+            positions.resize(vertexData->vertexCount);
+            HardwareBufferLockGuard vbufLock(vbuf, vertexData->vertexStart * vertexSize,
+                                             vertexData->vertexCount * vertexSize, HardwareBuffer::HBL_READ_ONLY);
+            for (size_t v = 0; v < positions.size(); ++v)
+            {
+                float* pFloat;
+                posElem->baseVertexPointerToElement(static_cast<uchar*>(vbufLock.pData) + v * vertexSize, &pFloat);
+                positions[v] = Vector3(pFloat);
+            }
+            return true;
+        }
+
+        /// reorder the vertices in every block of vertexCount vertices, so extruded shadow volume copies follow
+        void remapVertexBuffer(const HardwareVertexBufferSharedPtr& vbuf, size_t vertexCount,
+                               const std::vector<uint32>& remap)
+        {
+            size_t vertexSize = vbuf->getVertexSize();
+            std::vector<uchar> tmp(vertexCount * vertexSize);
+            HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_NORMAL);
+            for (size_t block = 0; block + vertexCount <= vbuf->getNumVertices(); block += vertexCount)
+            {
+                uchar* pBlock = static_cast<uchar*>(vbufLock.pData) + block * vertexSize;
+                memcpy(tmp.data(), pBlock, tmp.size());
+                for (size_t v = 0; v < vertexCount; ++v)
+                    memcpy(pBlock + remap[v] * vertexSize, &tmp[v * vertexSize], vertexSize);
+            }
+        }
+
+        template <typename T> void remapKeys(std::map<size_t, T>& map, const std::vector<uint32>& remap)
+        {
+            std::map<size_t, T> remapped;
+            for (typename std::map<size_t, T>::iterator it = map.begin(); it != map.end(); ++it)
+                remapped[it->first < remap.size() ? remap[it->first] : it->first] = it->second;
+            map.swap(remapped);
+        }
+    }
+    //---------------------------------------------------------------------
+    MeshOptimiser::MeshOptimiser() : mCacheSize(16), mOverdrawThreshold(1.05f), mReorderVertices(true)
+    {
+    }
+    //---------------------------------------------------------------------
+    void MeshOptimiser::optimiseVertexCache(uint32* indices, size_t indexCount, size_t vertexCount)
+    {
+        size_t triCount = indexCount / 3;
+        if (triCount < 2)
+            return;
+
+        // triangles using each vertex
+        std::vector<uint32> activeTris(vertexCount, 0);
+        for (size_t i = 0; i < triCount * 3; ++i)
+            activeTris[indices[i]]++;
+        std::vector<uint32> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v)
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + activeTris[v];
+        std::vector<uint32> adjacency(triCount * 3);
+        {
+            std::vector<uint32> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < triCount * 3; ++i)
+                adjacency[fill[indices[i]]++] = static_cast<uint32>(i / 3);
+        }
+
+        std::vector<int> cachePos(vertexCount, -1);
+        std::vector<float> vScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+            vScore[v] = vertexScore(-1, activeTris[v]);
+
+        std::vector<float> tScore(triCount);
+        std::vector<bool> emitted(triCount, false);
+        for (size_t t = 0; t < triCount; ++t)
+            tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+
+        std::vector<uint32> output;
+        output.reserve(triCount * 3);
+        std::vector<uint32> cache, newCache;
+        cache.reserve(SCORE_CACHE_SIZE + 3);
+        newCache.reserve(SCORE_CACHE_SIZE + 3);
+
+        size_t nextUnemitted = 0;
+        long best = 0;
+        while (output.size() < triCount * 3)
+        {
+            if (best < 0)
+            {
+                // nothing adjacent to the cache left, continue with the next triangle in input order
+                while (emitted[nextUnemitted])
+                    ++nextUnemitted;
+                best = static_cast<long>(nextUnemitted);
+            }
+
+            const uint32* tri = &indices[best * 3];
+            output.insert(output.end(), tri, tri + 3);
+            emitted[best] = true;
+
+            newCache.clear();
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32 v = tri[k];
+                // remove the triangle from the vertex' active list
+                uint32* begin = &adjacency[adjacencyOffsets[v]];
+                uint32* end = begin + activeTris[v];
+                std::swap(*std::find(begin, end, static_cast<uint32>(best)), *(end - 1));
+                activeTris[v]--;
+
+                if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+                    newCache.push_back(v);
+            }
+            for (size_t i = 0; i < cache.size(); ++i)
+            {
+                if (std::find(newCache.begin(), newCache.end(), cache[i]) == newCache.end())
+                    newCache.push_back(cache[i]);
+            }
+
+            // rescore the vertices that moved in the cache, including the evicted ones
+            for (size_t i = 0; i < newCache.size(); ++i)
+            {
+                uint32 v = newCache[i];
+                cachePos[v] = i < SCORE_CACHE_SIZE ? static_cast<int>(i) : -1;
+                vScore[v] = vertexScore(cachePos[v], activeTris[v]);
+            }
+
+            best = -1;
+            float bestScore = -1;
+            for (size_t i = 0; i < newCache.size(); ++i)
+            {
+                uint32 v = newCache[i];
+                for (uint32 a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + activeTris[v]; ++a)
+                {
+                    uint32 t = adjacency[a];
+                    tScore[t] = vScore[indices[t * 3]] + vScore[indices[t * 3 + 1]] + vScore[indices[t * 3 + 2]];
+                    if (tScore[t] > bestScore)
+                    {
+                        bestScore = tScore[t];
+                        best = t;
+                    }
+                }
+            }
+
+            newCache.resize(std::min<size_t>(newCache.size(), SCORE_CACHE_SIZE));
+            cache.swap(newCache);
+        }
+
+        std::copy(output.begin(), output.end(), indices);
+    }
+    //---------------------------------------------------------------------
+    void MeshOptimiser::optimiseOverdraw(uint32* indices, size_t indexCount, const Vector3* positions,
+                                         size_t vertexCount, uint32 cacheSize, float threshold)
+    {
+        size_t triCount = indexCount / 3;
+        if (triCount < 2)
+            return;
+
+        FifoCache cache(vertexCount, cacheSize);
+
+        // hard boundaries: the cache is completely cold there anyway
+        std::vector<size_t> hardClusters;
+        for (size_t t = 0; t < triCount; ++t)
+        {
+            if (cache.accessTriangle(&indices[t * 3]) == 3 || t == 0)
+                hardClusters.push_back(t);
+        }
+        hardClusters.push_back(triCount);
+
+        // soft boundaries: split further where the cache efficiency stays within the threshold
+        std::vector<size_t> clusters;
+        for (size_t c = 0; c + 1 < hardClusters.size(); ++c)
+        {
+            size_t start = hardClusters[c], end = hardClusters[c + 1];
+
+            cache.reset();
+            uint32 misses = 0;
+            for (size_t t = start; t < end; ++t)
+                misses += cache.accessTriangle(&indices[t * 3]);
+            float clusterThreshold = threshold * misses / (end - start);
+
+            cache.reset();
+            clusters.push_back(start);
+            size_t clusterStart = start;
+            misses = 0;
+            for (size_t t = start; t < end; ++t)
+            {
+                misses += cache.accessTriangle(&indices[t * 3]);
+                if (t + 1 < end && misses <= clusterThreshold * (t + 1 - clusterStart))
+                {
+                    clusters.push_back(t + 1);
+                    cache.reset();
+                    clusterStart = t + 1;
+                    misses = 0;
+                }
+            }
+        }
+        clusters.push_back(triCount);
+
+        // sort clusters facing away from the centre first, they are likely to occlude the rest
+        size_t clusterCount = clusters.size() - 1;
+        std::vector<Vector3> centroids(clusterCount, Vector3::ZERO), normals(clusterCount, Vector3::ZERO);
+        Vector3 meshCentroid = Vector3::ZERO;
+        Real meshArea = 0;
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            Real clusterArea = 0;
+            for (size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                const Vector3& p0 = positions[indices[t * 3]];
+                const Vector3& p1 = positions[indices[t * 3 + 1]];
+                const Vector3& p2 = positions[indices[t * 3 + 2]];
+                Vector3 n = (p1 - p0).crossProduct(p2 - p0);
+                Real area = n.length();
+                centroids[c] += (p0 + p1 + p2) * (area / 3);
+                normals[c] += n;
+                clusterArea += area;
+            }
+            meshCentroid += centroids[c];
+            meshArea += clusterArea;
+            if (clusterArea > 0)
+                centroids[c] /= clusterArea;
+        }
+        if (meshArea > 0)
+            meshCentroid /= meshArea;
+
+        std::vector<std::pair<Real, size_t> > order(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c)
+            order[c] = std::make_pair(-(centroids[c] - meshCentroid).dotProduct(normals[c].normalisedCopy()), c);
+        std::stable_sort(order.begin(), order.end(),
+                         [](const std::pair<Real, size_t>& a, const std::pair<Real, size_t>& b) { return a.first < b.first; });
+
+        std::vector<uint32> output;
+        output.reserve(triCount * 3);
+        for (size_t i = 0; i < clusterCount; ++i)
+        {
+            size_t c = order[i].second;
+            output.insert(output.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+        }
+        std::copy(output.begin(), output.end(), indices);
+    }
+    //---------------------------------------------------------------------
+    MeshOptimiser::Statistics MeshOptimiser::analyseVertexCache(const uint32* indices, size_t indexCount,
+                                                                size_t vertexCount, uint32 cacheSize)
+    {
+        Statistics stats;
+        size_t misses, uniqueVertices;
+        simulateCache(indices, indexCount, vertexCount, cacheSize, misses, uniqueVertices);
+        if (indexCount >= 3)
+        {
+            stats.acmr = float(misses) / (indexCount / 3);
+            stats.atvr = float(misses) / uniqueVertices;
+        }
+        return stats;
+    }
+    //---------------------------------------------------------------------
+    MeshOptimiser::Result MeshOptimiser::optimise(Mesh* mesh)
+    {
+        // totals of all triangle lists, so the statistics are weighted by size
+        size_t missesBefore = 0, missesAfter = 0, totalTris = 0, totalVertices = 0;
+
+        std::vector<uint32> indices;
+        std::map<const VertexData*, std::vector<Vector3> > positions;
+        for (ushort i = 0; i < mesh->getNumSubMeshes(); ++i)
+        {
+            SubMesh* sm = mesh->getSubMesh(i);
+            if (sm->operationType != RenderOperation::OT_TRIANGLE_LIST || !sm->indexData->indexBuffer ||
+                sm->indexData->indexCount < 3)
+                continue;
+
+            const VertexData* vertexData = sm->useSharedVertices ? mesh->sharedVertexData : sm->vertexData;
+            size_t vertexCount = vertexData->vertexCount;
+
+            readIndices(sm->indexData, indices);
+            size_t misses, uniqueVertices;
+            simulateCache(indices.data(), indices.size(), vertexCount, mCacheSize, misses, uniqueVertices);
+            missesBefore += misses;
+            totalVertices += uniqueVertices;
+            totalTris += indices.size() / 3;
+
+            optimiseVertexCache(indices.data(), indices.size(), vertexCount);
+            if (mOverdrawThreshold > 0)
+            {
+                if (!positions.count(vertexData) && !readPositions(vertexData, positions[vertexData]))
+                    positions[vertexData].clear();
+                if (!positions[vertexData].empty())
+                    optimiseOverdraw(indices.data(), indices.size(), positions[vertexData].data(), vertexCount,
+                                     mCacheSize, mOverdrawThreshold);
+            }
+            writeIndices(sm->indexData, indices);
+
+            simulateCache(indices.data(), indices.size(), vertexCount, mCacheSize, misses, uniqueVertices);
+            missesAfter += misses;
+
+            // generated LOD levels, unless they are packed into a shared index buffer
+            std::map<HardwareIndexBuffer*, int> bufferUse;
+            bufferUse[sm->indexData->indexBuffer.get()]++;
+            for (size_t l = 0; l < sm->mLodFaceList.size(); ++l)
+            {
+                if (sm->mLodFaceList[l] && sm->mLodFaceList[l]->indexBuffer)
+                    bufferUse[sm->mLodFaceList[l]->indexBuffer.get()]++;
+            }
+            for (size_t l = 0; l < sm->mLodFaceList.size(); ++l)
+            {
+                IndexData* lod = sm->mLodFaceList[l];
+                if (!lod || !lod->indexBuffer || lod->indexCount < 3 || bufferUse[lod->indexBuffer.get()] > 1)
+                    continue;
+                readIndices(lod, indices);
+                optimiseVertexCache(indices.data(), indices.size(), vertexCount);
+                writeIndices(lod, indices);
+            }
+        }
+
+        if (mReorderVertices)
+        {
+            if (mesh->sharedVertexData)
+                reorderVertices(mesh, mesh->sharedVertexData, 0);
+            for (ushort i = 0; i < mesh->getNumSubMeshes(); ++i)
+            {
+                SubMesh* sm = mesh->getSubMesh(i);
+                if (!sm->useSharedVertices)
+                    reorderVertices(mesh, sm->vertexData, i + 1);
+            }
+        }
+
+        // triangle indices in the edge lists are stale now
+        if (mesh->isEdgeListBuilt())
+        {
+            mesh->freeEdgeList();
+            mesh->buildEdgeList();
+        }
+
+        Result res;
+        if (totalTris)
+        {
+            res.before.acmr = float(missesBefore) / totalTris;
+            res.before.atvr = float(missesBefore) / totalVertices;
+            res.after.acmr = float(missesAfter) / totalTris;
+            res.after.atvr = float(missesAfter) / totalVertices;
+        }
+        LogManager::getSingleton().stream()
+            << "MeshOptimiser: " << mesh->getName() << " ACMR " << res.before.acmr << " -> " << res.after.acmr
+            << ", ATVR " << res.before.atvr << " -> " << res.after.atvr;
+        return res;
+    }
+    //---------------------------------------------------------------------
+    void MeshOptimiser::reorderVertices(Mesh* mesh, VertexData* vertexData, ushort target)
+    {
+        size_t vertexCount = vertexData->vertexCount;
+        if (vertexCount == 0 || vertexData->vertexStart != 0)
+            return;
+
+        // all index data referring to this vertex data, LOD0 first
+        std::vector<IndexData*> indexDatas;
+        for (ushort lod = 0; lod < mesh->getNumLodLevels(); ++lod)
+        {
+            for (ushort i = 0; i < mesh->getNumSubMeshes(); ++i)
+            {
+                SubMesh* sm = mesh->getSubMesh(i);
+                if ((target == 0) != sm->useSharedVertices || (target != 0 && target != i + 1))
+                    continue;
+
+                if (lod == 0 && (!sm->indexData->indexBuffer || sm->indexData->indexCount == 0))
+                    return; // vertex order is significant for non indexed geometry
+                IndexData* indexData = lod == 0 ? sm->indexData
+                                       : lod <= sm->mLodFaceList.size() ? sm->mLodFaceList[lod - 1]
+                                                                              : NULL;
+                if (indexData && indexData->indexBuffer &&
+                    std::find(indexDatas.begin(), indexDatas.end(), indexData) == indexDatas.end())
+                    indexDatas.push_back(indexData);
+            }
+        }
+
+        // order of first use, unreferenced vertices go last
+        const uint32 UNUSED = ~0u;
+        std::vector<uint32> remap(vertexCount, UNUSED);
+        uint32 next = 0;
+        std::vector<uint32> indices;
+        for (size_t i = 0; i < indexDatas.size(); ++i)
+        {
+            readIndices(indexDatas[i], indices);
+            for (size_t j = 0; j < indices.size(); ++j)
+            {
+                if (indices[j] < vertexCount && remap[indices[j]] == UNUSED)
+                    remap[indices[j]] = next++;
+            }
+        }
+        bool identity = true;
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            if (remap[v] == UNUSED)
+                remap[v] = next++;
+            identity = identity && remap[v] == v;
+        }
+        if (identity)
+            return;
+
+        // vertex buffers, possibly bound several times
+        std::set<HardwareVertexBuffer*> remapped;
+        const VertexBufferBinding::VertexBufferBindingMap& bindings = vertexData->vertexBufferBinding->getBindings();
+        for (VertexBufferBinding::VertexBufferBindingMap::const_iterator vbi = bindings.begin(); vbi != bindings.end(); ++vbi)
+        {
+            if (remapped.insert(vbi->second.get()).second)
+                remapVertexBuffer(vbi->second, vertexCount, remap);
+        }
+
+        // index data, where LOD levels may share a buffer
+        std::set<HardwareIndexBuffer*> remappedIndices;
+        for (size_t i = 0; i < indexDatas.size(); ++i)
+        {
+            IndexData* indexData = indexDatas[i];
+            if (!remappedIndices.insert(indexData->indexBuffer.get()).second)
+                continue;
+
+            // cover the range used by all index data sharing this buffer
+            size_t start = indexData->indexStart, end = indexData->indexStart + indexData->indexCount;
+            for (size_t j = i + 1; j < indexDatas.size(); ++j)
+            {
+                if (indexDatas[j]->indexBuffer == indexData->indexBuffer)
+                {
+                    start = std::min(start, indexDatas[j]->indexStart);
+                    end = std::max(end, indexDatas[j]->indexStart + indexDatas[j]->indexCount);
+                }
+            }
+            IndexData range;
+            range.indexBuffer = indexData->indexBuffer;
+            range.indexStart = start;
+            range.indexCount = end - start;
+            readIndices(&range, indices);
+            for (size_t j = 0; j < indices.size(); ++j)
+            {
+                if (indices[j] < vertexCount)
+                    indices[j] = remap[indices[j]];
+            }
+            writeIndices(&range, indices);
+        }
+
+        // bone assignments
+        Mesh::VertexBoneAssignmentList assignments =
+            target == 0 ? mesh->getBoneAssignments() : mesh->getSubMesh(target - 1)->getBoneAssignments();
+        if (!assignments.empty())
+        {
+            if (target == 0)
+                mesh->clearBoneAssignments();
+            else
+                mesh->getSubMesh(target - 1)->clearBoneAssignments();
+            for (Mesh::VertexBoneAssignmentList::iterator it = assignments.begin(); it != assignments.end(); ++it)
+            {
+                VertexBoneAssignment vba = it->second;
+                vba.vertexIndex = remap[vba.vertexIndex];
+                if (target == 0)
+                    mesh->addBoneAssignment(vba);
+                else
+                    mesh->getSubMesh(target - 1)->addBoneAssignment(vba);
+            }
+        }
+
+        // poses
+        for (size_t i = 0; i < mesh->getPoseCount(); ++i)
+        {
+            Pose* pose = mesh->getPose(i);
+            if (pose->getTarget() != target)
+                continue;
+            remapKeys(pose->_getVertexOffsets(), remap);
+            remapKeys(pose->_getNormals(), remap);
+        }
+
+        // morph animation
+        for (ushort a = 0; a < mesh->getNumAnimations(); ++a)
+        {
+            const Animation::VertexTrackList& tracks = mesh->getAnimation(a)->_getVertexTrackList();
+            Animation::VertexTrackList::const_iterator it = tracks.find(target);
+            if (it == tracks.end() || it->second->getAnimationType() != VAT_MORPH)
+                continue;
+            for (ushort k = 0; k < it->second->getNumKeyFrames(); ++k)
+            {
+                const HardwareVertexBufferSharedPtr& vbuf = it->second->getVertexMorphKeyFrame(k)->getVertexBuffer();
+                if (remapped.insert(vbuf.get()).second)
+                    remapVertexBuffer(vbuf, vertexCount, remap);
+            }
+        }
+    }
+}
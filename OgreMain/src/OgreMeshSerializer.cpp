@@ -60,6 +60,14 @@ namespace Ogre {
             MESH_VERSION_1_10, "[MeshSerializer_v1.100]", 
             OGRE_NEW MeshSerializerImpl()));
 
+        mVersionData.push_back(OGRE_NEW MeshVersionData(
+            MESH_VERSION_1_10_MAPPED, "[MeshSerializer_v1.100_mapped]",
+            OGRE_NEW MeshSerializerImpl_Mapped()));
+
+        mVersionData.push_back(OGRE_NEW MeshVersionData(
+            MESH_VERSION_1_10_COMPRESSED, "[MeshSerializer_v1.100_compressed]",
+            OGRE_NEW MeshSerializerImpl_Compressed()));
+
         mVersionData.push_back(OGRE_NEW MeshVersionData(
             MESH_VERSION_1_8, "[MeshSerializer_v1.8]", 
             OGRE_NEW MeshSerializerImpl_v1_8()));
@@ -176,24 +184,25 @@ namespace Ogre {
         stream->seek(0);
 
         // Find the implementation to use
-        MeshSerializerImpl* impl = 0;
+        MeshVersionData* data = 0;
         for (MeshVersionDataList::iterator i = mVersionData.begin(); 
              i != mVersionData.end(); ++i)
         {
             if ((*i)->versionString == ver)
             {
-                impl = (*i)->impl;
+                data = *i;
                 break;
             }
         }           
-        if (!impl)
+        if (!data)
             OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Cannot find serializer implementation for "
                         "mesh version " + ver, "MeshSerializer::importMesh");
         
         // Call implementation
-        impl->importMesh(stream, pDest, mListener);
+        data->impl->importMesh(stream, pDest, mListener);
         // Warn on old version of mesh
-        if (ver != mVersionData[0]->versionString)
+        if (ver != mVersionData[0]->versionString && data->version != MESH_VERSION_1_10_MAPPED &&
+            data->version != MESH_VERSION_1_10_COMPRESSED)
         {
             LogManager::getSingleton().logWarning(pDest->getName() + " uses an old format " + ver +
                                                   "; upgrade with the OgreMeshUpgrader tool");
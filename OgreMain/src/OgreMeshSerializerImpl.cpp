@@ -34,6 +34,11 @@ THE SOFTWARE.
 #include "OgreLodStrategyManager.h"
 #include "OgreDistanceLodStrategy.h"
 
+#if OGRE_NO_ZIP_ARCHIVE == 0
+#define MINIZ_HEADER_FILE_ONLY
+#include <miniz.h>
+#endif
+
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 // Disable conversion warnings, we do a lot of them, intentionally
 #   pragma warning (disable : 4267)
@@ -255,19 +260,7 @@ namespace Ogre {
 
         if (indexCount > 0)
         {
-            // unsigned short* faceVertexIndices ((indexCount)
-            HardwareIndexBufferSharedPtr ibuf = s->indexData->indexBuffer;
-            HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_READ_ONLY);
-            if (idx32bit)
-            {
-                unsigned int* pIdx32 = static_cast<unsigned int*>(ibufLock.pData);
-                writeInts(pIdx32, s->indexData->indexCount);
-            }
-            else
-            {
-                unsigned short* pIdx16 = static_cast<unsigned short*>(ibufLock.pData);
-                writeShorts(pIdx16, s->indexData->indexCount);
-            }
+            writeSubMeshIndexData(s);
         }
 
         pushInnerChunk(mStream);
@@ -300,6 +293,23 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeSubMeshIndexData(const SubMesh* s)
+    {
+        // unsigned short* faceVertexIndices ((indexCount)
+        const HardwareIndexBufferSharedPtr& ibuf = s->indexData->indexBuffer;
+        HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_READ_ONLY);
+        if (ibuf->getType() == HardwareIndexBuffer::IT_32BIT)
+        {
+            unsigned int* pIdx32 = static_cast<unsigned int*>(ibufLock.pData);
+            writeInts(pIdx32, s->indexData->indexCount);
+        }
+        else
+        {
+            unsigned short* pIdx16 = static_cast<unsigned short*>(ibufLock.pData);
+            writeShorts(pIdx16, s->indexData->indexCount);
+        }
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::writeExtremes(const Mesh *pMesh)
     {
         bool has_extremes = false;
@@ -450,8 +460,8 @@ namespace Ogre {
         for (vbi = bindings.begin(); vbi != vbiend; ++vbi)
         {
             const HardwareVertexBufferSharedPtr& vbuf = vbi->second;
-            size_t vbufSizeInBytes = vbuf->getVertexSize() * vertexData->vertexCount; // vbuf->getSizeInBytes() is too large for meshes prepared for shadow volumes
-            size = (MSTREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2) + vbufSizeInBytes;
+            size_t dataSize = calcGeometryVertexBufferDataSize(vertexData, vbuf);
+            size = (MSTREAM_OVERHEAD_SIZE * 2) + (sizeof(unsigned short) * 2) + dataSize;
             writeChunkHeader(M_GEOMETRY_VERTEX_BUFFER,  size);
             // unsigned short bindIndex;    // Index to bind this buffer to
                 unsigned short tmp = vbi->first;
@@ -462,28 +472,9 @@ namespace Ogre {
                 pushInnerChunk(mStream);
                 {
             // Data
-            size = MSTREAM_OVERHEAD_SIZE + vbufSizeInBytes;
+            size = MSTREAM_OVERHEAD_SIZE + dataSize;
             writeChunkHeader(M_GEOMETRY_VERTEX_BUFFER_DATA, size);
-            HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
-
-            if (mFlipEndian)
-            {
-                // endian conversion
-                // Copy data
-                unsigned char* tempData = OGRE_ALLOC_T(unsigned char, vbufSizeInBytes, MEMCATEGORY_GEOMETRY);
-                memcpy(tempData, vbufLock.pData, vbufSizeInBytes);
-                flipToLittleEndian(
-                    tempData,
-                    vertexData->vertexCount,
-                    vbuf->getVertexSize(),
-                    vertexData->vertexDeclaration->findElementsBySource(vbi->first));
-                writeData(tempData, vbuf->getVertexSize(), vertexData->vertexCount);
-                OGRE_FREE(tempData, MEMCATEGORY_GEOMETRY);
-            }
-            else
-            {
-                writeData(vbufLock.pData, vbuf->getVertexSize(), vertexData->vertexCount);
-            }
+            writeGeometryVertexBufferData(vertexData, vbi->first, vbuf);
         }
                 popInnerChunk(mStream);
             }
@@ -491,6 +482,32 @@ namespace Ogre {
         popInnerChunk(mStream);
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeGeometryVertexBufferData(const VertexData* vertexData,
+        unsigned short bindIndex, const HardwareVertexBufferSharedPtr& vbuf)
+    {
+        size_t vbufSizeInBytes = vbuf->getVertexSize() * vertexData->vertexCount; // vbuf->getSizeInBytes() is too large for meshes prepared for shadow volumes
+        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+
+        if (mFlipEndian)
+        {
+            // endian conversion
+            // Copy data
+            unsigned char* tempData = OGRE_ALLOC_T(unsigned char, vbufSizeInBytes, MEMCATEGORY_GEOMETRY);
+            memcpy(tempData, vbufLock.pData, vbufSizeInBytes);
+            flipToLittleEndian(
+                tempData,
+                vertexData->vertexCount,
+                vbuf->getVertexSize(),
+                vertexData->vertexDeclaration->findElementsBySource(bindIndex));
+            writeData(tempData, vbuf->getVertexSize(), vertexData->vertexCount);
+            OGRE_FREE(tempData, MEMCATEGORY_GEOMETRY);
+        }
+        else
+        {
+            writeData(vbufLock.pData, vbuf->getVertexSize(), vertexData->vertexCount);
+        }
+    }
+    //---------------------------------------------------------------------
     size_t MeshSerializerImpl::calcSubMeshNameTableSize(const Mesh* pMesh)
     {
         size_t size = MSTREAM_OVERHEAD_SIZE;
@@ -585,13 +602,8 @@ namespace Ogre {
         // bool indexes32bit
         size += sizeof(bool);
 
-        bool idx32bit = (pSub->indexData->indexBuffer &&
-            pSub->indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
-        // unsigned int* / unsigned short* faceVertexIndices
-        if (idx32bit)
-            size += sizeof(unsigned int) * pSub->indexData->indexCount;
-        else
-            size += sizeof(unsigned short) * pSub->indexData->indexCount;
+        if (pSub->indexData->indexCount > 0)
+            size += calcSubMeshIndexDataSize(pSub);
 
         // Geometry
         if (!pSub->useSharedVertices)
@@ -616,6 +628,16 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcSubMeshIndexDataSize(const SubMesh* pSub)
+    {
+        bool idx32bit = (pSub->indexData->indexBuffer &&
+            pSub->indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
+        // unsigned int* / unsigned short* faceVertexIndices
+        if (idx32bit)
+            return sizeof(unsigned int) * pSub->indexData->indexCount;
+        return sizeof(unsigned short) * pSub->indexData->indexCount;
+    }
+    //---------------------------------------------------------------------
     size_t MeshSerializerImpl::calcSubMeshOperationSize(const SubMesh* pSub)
     {
         return MSTREAM_OVERHEAD_SIZE + sizeof(uint16);
@@ -658,12 +680,17 @@ namespace Ogre {
         vbiend = bindings.end();
         for (vbi = bindings.begin(); vbi != vbiend; ++vbi)
         {
-            const HardwareVertexBufferSharedPtr& vbuf = vbi->second;
-            size += vbuf->getVertexSize() * vertexData->vertexCount; // vbuf->getSizeInBytes() is too large for meshes prepared for shadow volumes
+            size += calcGeometryVertexBufferDataSize(vertexData, vbi->second);
         }
         return size;
     }
     //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcGeometryVertexBufferDataSize(const VertexData* vertexData,
+                                                                const HardwareVertexBufferSharedPtr& vbuf)
+    {
+        return vbuf->getVertexSize() * vertexData->vertexCount; // vbuf->getSizeInBytes() is too large for meshes prepared for shadow volumes
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::readGeometry(const DataStreamPtr& stream, Mesh* pMesh,
         VertexData* dest)
     {
@@ -801,6 +828,20 @@ namespace Ogre {
         }
 
         // Create / populate vertex buffer
+        HardwareVertexBufferSharedPtr vbuf =
+            readGeometryVertexBufferData(stream, pMesh, dest, bindIndex, vertexSize);
+
+        // Set binding
+        dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
+        }
+        popInnerChunk(stream);
+
+    }
+    //---------------------------------------------------------------------
+    HardwareVertexBufferSharedPtr MeshSerializerImpl::readGeometryVertexBufferData(
+        const DataStreamPtr& stream, Mesh* pMesh, VertexData* dest, unsigned short bindIndex,
+        unsigned short vertexSize)
+    {
         HardwareVertexBufferSharedPtr vbuf;
         vbuf = pMesh->getHardwareBufferManager()->createVertexBuffer(
             vertexSize,
@@ -817,11 +858,7 @@ namespace Ogre {
             vertexSize,
             dest->vertexDeclaration->findElementsBySource(bindIndex));
 
-        // Set binding
-        dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
-        }
-        popInnerChunk(stream);
-
+        return vbuf;
     }
     //---------------------------------------------------------------------
     void MeshSerializerImpl::readSubMeshNameTable(const DataStreamPtr& stream, Mesh* pMesh)
@@ -1005,27 +1042,7 @@ namespace Ogre {
         readBools(stream, &idx32bit, 1);
         if (indexCount > 0)
         {
-            if (idx32bit)
-            {
-                ibuf = pMesh->getHardwareBufferManager()->createIndexBuffer(
-                        HardwareIndexBuffer::IT_32BIT,
-                        sm->indexData->indexCount,
-                        pMesh->mIndexBufferUsage,
-                        pMesh->mIndexBufferShadowBuffer);
-                HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
-                readInts(stream, static_cast<unsigned int*>(ibufLock.pData), sm->indexData->indexCount);
-
-            }
-            else // 16-bit
-            {
-                ibuf = pMesh->getHardwareBufferManager()->createIndexBuffer(
-                        HardwareIndexBuffer::IT_16BIT,
-                        sm->indexData->indexCount,
-                        pMesh->mIndexBufferUsage,
-                        pMesh->mIndexBufferShadowBuffer);
-                HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
-                readShorts(stream, static_cast<unsigned short*>(ibufLock.pData), sm->indexData->indexCount);
-            }
+            ibuf = readSubMeshIndexData(stream, pMesh, sm, idx32bit);
         }
         sm->indexData->indexBuffer = ibuf;
 
@@ -1091,6 +1108,34 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    HardwareIndexBufferSharedPtr MeshSerializerImpl::readSubMeshIndexData(const DataStreamPtr& stream,
+        Mesh* pMesh, SubMesh* sm, bool idx32bit)
+    {
+        HardwareIndexBufferSharedPtr ibuf;
+        if (idx32bit)
+        {
+            ibuf = pMesh->getHardwareBufferManager()->createIndexBuffer(
+                    HardwareIndexBuffer::IT_32BIT,
+                    sm->indexData->indexCount,
+                    pMesh->mIndexBufferUsage,
+                    pMesh->mIndexBufferShadowBuffer);
+            HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
+            readInts(stream, static_cast<unsigned int*>(ibufLock.pData), sm->indexData->indexCount);
+
+        }
+        else // 16-bit
+        {
+            ibuf = pMesh->getHardwareBufferManager()->createIndexBuffer(
+                    HardwareIndexBuffer::IT_16BIT,
+                    sm->indexData->indexCount,
+                    pMesh->mIndexBufferUsage,
+                    pMesh->mIndexBufferShadowBuffer);
+            HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
+            readShorts(stream, static_cast<unsigned short*>(ibufLock.pData), sm->indexData->indexCount);
+        }
+        return ibuf;
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::readSubMeshOperation(const DataStreamPtr& stream,
         Mesh* pMesh, SubMesh* sm)
     {
@@ -2728,6 +2773,775 @@ namespace Ogre {
     }
 
 
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_Mapped::MeshSerializerImpl_Mapped() : mFileBase(NULL)
+    {
+        // Version number
+        mVersion = "[MeshSerializer_v1.100_mapped]";
+    }
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_Mapped::~MeshSerializerImpl_Mapped()
+    {
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Mapped::exportMesh(const Mesh* pMesh, const DataStreamPtr stream,
+                                               Endian endianMode)
+    {
+        LogManager::getSingleton().logMessage("MeshSerializer writing mapped mesh data to stream " +
+                                              stream->getName() + "...");
+
+        // Decide on endian mode
+        determineEndianness(endianMode);
+
+        // Check that the mesh has it's bounds set
+        if (pMesh->getBounds().isNull() || pMesh->getBoundingSphereRadius() == 0.0f)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "The Mesh you have supplied does not have its"
+                " bounds completely defined. Define them first before exporting.",
+                "MeshSerializerImpl_Mapped::exportMesh");
+        }
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Unable to use stream " + stream->getName() + " for writing",
+                "MeshSerializerImpl_Mapped::exportMesh");
+        }
+
+        // The chunk stream goes to memory first, as the blob offsets are only known once
+        // all buffers have been collected
+        mBlobs.clear();
+        MemoryDataStream* meshData = OGRE_NEW MemoryDataStream(calcMeshSize(pMesh));
+        DataStreamPtr meshStream(meshData);
+        mStream = meshStream;
+        pushInnerChunk(mStream);
+        writeMesh(pMesh);
+        popInnerChunk(mStream);
+        size_t meshSize = meshData->tell();
+
+        // Lay out the file: header, blob table, chunk stream, terminator, blobs
+        size_t tableSize = MSTREAM_OVERHEAD_SIZE + sizeof(uint32) + mBlobs.size() * sizeof(uint32) * 2;
+        size_t offset = sizeof(uint16) + calcStringSize(mVersion) + tableSize + meshSize +
+                        MSTREAM_OVERHEAD_SIZE; // zeroed chunk header terminates the chunk stream
+
+        BlobRegionList regions(mBlobs.size());
+        for (size_t i = 0; i < mBlobs.size(); ++i)
+        {
+            offset = (offset + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+            regions[i].offset = static_cast<uint32>(offset);
+            regions[i].size = static_cast<uint32>(mBlobs[i].size);
+            offset += mBlobs[i].size;
+        }
+
+        mStream = stream;
+        writeFileHeader();
+
+        writeChunkHeader(M_BLOB_TABLE, tableSize);
+        uint32 blobCount = static_cast<uint32>(regions.size());
+        writeInts(&blobCount, 1);
+        for (size_t i = 0; i < regions.size(); ++i)
+        {
+            writeInts(&regions[i].offset, 1);
+            writeInts(&regions[i].size, 1);
+        }
+
+        writeData(meshData->getPtr(), 1, meshSize);
+
+        const uchar zeros[BLOB_ALIGNMENT + MSTREAM_OVERHEAD_SIZE] = {0};
+        size_t pos = mStream->tell();
+        writeData(zeros, 1, MSTREAM_OVERHEAD_SIZE);
+        pos += MSTREAM_OVERHEAD_SIZE;
+
+        for (size_t i = 0; i < mBlobs.size(); ++i)
+        {
+            writeData(zeros, 1, regions[i].offset - pos);
+            // the v1.10 payload writers already take care of endian conversion
+            const Blob& blob = mBlobs[i];
+            if (blob.subMesh)
+                MeshSerializerImpl::writeSubMeshIndexData(blob.subMesh);
+            else
+                MeshSerializerImpl::writeGeometryVertexBufferData(
+                    blob.vertexData, blob.bindIndex, blob.vertexData->vertexBufferBinding->getBuffer(blob.bindIndex));
+            pos = regions[i].offset + regions[i].size;
+        }
+        mBlobs.clear();
+
+        LogManager::getSingleton().logMessage("MeshSerializer export successful.");
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Mapped::importMesh(const DataStreamPtr& stream, Mesh* pMesh,
+                                               MeshSerializerListener* listener)
+    {
+        // Determine endianness (must be the first thing we do!)
+        determineEndianness(stream);
+
+        // Mesh::prepare already reads the whole file into memory, so we can use it in place.
+        // Anything else is read once as a whole.
+        DataStreamPtr src = stream;
+        if (!dynamic_cast<MemoryDataStream*>(src.get()))
+            src.reset(OGRE_NEW MemoryDataStream(stream->getName(), stream));
+        mFileBase = static_cast<MemoryDataStream*>(src.get())->getCurrentPtr();
+
+#if OGRE_SERIALIZER_VALIDATE_CHUNKSIZE
+        enableValidation();
+#endif
+        readFileHeader(src);
+        if (readChunk(src) != M_BLOB_TABLE)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Missing blob table in " + src->getName(),
+                        "MeshSerializerImpl_Mapped::importMesh");
+        }
+
+        uint32 blobCount;
+        readInts(src, &blobCount, 1);
+        mBlobTable.resize(blobCount);
+        size_t fileSize = src->size() - (mFileBase - static_cast<MemoryDataStream*>(src.get())->getPtr());
+        for (uint32 i = 0; i < blobCount; ++i)
+        {
+            readInts(src, &mBlobTable[i].offset, 1);
+            readInts(src, &mBlobTable[i].size, 1);
+            if (size_t(mBlobTable[i].offset) + mBlobTable[i].size > fileSize)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Blob exceeds file size in " + src->getName(),
+                            "MeshSerializerImpl_Mapped::importMesh");
+            }
+        }
+
+        // there is exactly one mesh and it is followed by the blob data
+        pushInnerChunk(src);
+        if (readChunk(src) != M_MESH)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Missing mesh data in " + src->getName(),
+                        "MeshSerializerImpl_Mapped::importMesh");
+        }
+        readMesh(src, pMesh, listener);
+        popInnerChunk(src);
+
+        mBlobTable.clear();
+        mFileBase = NULL;
+    }
+    //---------------------------------------------------------------------
+    const uchar* MeshSerializerImpl_Mapped::getBlob(uint32 blobIndex, size_t expectedSize)
+    {
+        if (blobIndex >= mBlobTable.size() || mBlobTable[blobIndex].size != expectedSize)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid blob reference",
+                        "MeshSerializerImpl_Mapped::getBlob");
+        }
+        return mFileBase + mBlobTable[blobIndex].offset;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Mapped::writeGeometryVertexBufferData(const VertexData* pGeom,
+        unsigned short bindIndex, const HardwareVertexBufferSharedPtr& vbuf)
+    {
+        Blob blob = {MeshSerializerImpl::calcGeometryVertexBufferDataSize(pGeom, vbuf), NULL, pGeom, bindIndex};
+        uint32 blobIndex = static_cast<uint32>(mBlobs.size());
+        mBlobs.push_back(blob);
+        writeInts(&blobIndex, 1);
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Mapped::writeSubMeshIndexData(const SubMesh* s)
+    {
+        Blob blob = {MeshSerializerImpl::calcSubMeshIndexDataSize(s), s, NULL, 0};
+        uint32 blobIndex = static_cast<uint32>(mBlobs.size());
+        mBlobs.push_back(blob);
+        writeInts(&blobIndex, 1);
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_Mapped::calcGeometryVertexBufferDataSize(const VertexData* pGeom,
+                                                                       const HardwareVertexBufferSharedPtr& vbuf)
+    {
+        // uint32 blobIndex
+        return sizeof(uint32);
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_Mapped::calcSubMeshIndexDataSize(const SubMesh* pSub)
+    {
+        // uint32 blobIndex
+        return sizeof(uint32);
+    }
+    //---------------------------------------------------------------------
+    HardwareVertexBufferSharedPtr MeshSerializerImpl_Mapped::readGeometryVertexBufferData(
+        const DataStreamPtr& stream, Mesh* pMesh, VertexData* dest, unsigned short bindIndex,
+        unsigned short vertexSize)
+    {
+        uint32 blobIndex;
+        readInts(stream, &blobIndex, 1);
+        size_t size = dest->vertexCount * vertexSize;
+        const uchar* pData = getBlob(blobIndex, size);
+
+        HardwareVertexBufferSharedPtr vbuf = pMesh->getHardwareBufferManager()->createVertexBuffer(
+            vertexSize, dest->vertexCount, pMesh->getVertexBufferUsage(), pMesh->isVertexBufferShadowed());
+
+        if (!mFlipEndian)
+        {
+            vbuf->writeData(0, size, pData, true);
+            return vbuf;
+        }
+
+        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_DISCARD);
+        memcpy(vbufLock.pData, pData, size);
+        flipFromLittleEndian(vbufLock.pData, dest->vertexCount, vertexSize,
+                             dest->vertexDeclaration->findElementsBySource(bindIndex));
+        return vbuf;
+    }
+    //---------------------------------------------------------------------
+    HardwareIndexBufferSharedPtr MeshSerializerImpl_Mapped::readSubMeshIndexData(const DataStreamPtr& stream,
+        Mesh* pMesh, SubMesh* sm, bool idx32bit)
+    {
+        uint32 blobIndex;
+        readInts(stream, &blobIndex, 1);
+        HardwareIndexBuffer::IndexType itype = idx32bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
+        size_t indexSize = HardwareIndexBuffer::indexSize(itype);
+        size_t size = sm->indexData->indexCount * indexSize;
+        const uchar* pData = getBlob(blobIndex, size);
+
+        HardwareIndexBufferSharedPtr ibuf = pMesh->getHardwareBufferManager()->createIndexBuffer(
+            itype, sm->indexData->indexCount, pMesh->getIndexBufferUsage(), pMesh->isIndexBufferShadowed());
+
+        if (!mFlipEndian)
+        {
+            ibuf->writeData(0, size, pData, true);
+            return ibuf;
+        }
+
+        HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
+        memcpy(ibufLock.pData, pData, size);
+        Serializer::flipFromLittleEndian(ibufLock.pData, indexSize, sm->indexData->indexCount);
+        return ibuf;
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    namespace
+    {
+        /// size of the words an element is made of, which is the unit for endian flipping
+        size_t rawWordSize(VertexElementType type)
+        {
+            if (type == VET_INT_10_10_10_2_NORM)
+                return 4;
+            return VertexElement::getTypeSize(type) / VertexElement::getTypeCount(type);
+        }
+
+        /// reorder count words of wordSize bytes so that byte b of every word is stored in plane b
+        void transposeBytePlanes(const uchar* pSrc, uchar* pDest, size_t wordSize, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                for (size_t b = 0; b < wordSize; ++b)
+                    pDest[b * count + i] = pSrc[i * wordSize + b];
+        }
+
+        void untransposeBytePlanes(const uchar* pSrc, uchar* pDest, size_t wordSize, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                for (size_t b = 0; b < wordSize; ++b)
+                    pDest[i * wordSize + b] = pSrc[b * count + i];
+        }
+
+        int16 toSnorm16(float v)
+        {
+            return static_cast<int16>(Math::Floor(Math::Clamp(v, -1.0f, 1.0f) * 32767.0f + 0.5f));
+        }
+
+        float fromSnorm16(int16 v)
+        {
+            return std::max(v / 32767.0f, -1.0f);
+        }
+
+        void encodeOctahedral(const float* n, int16* pOut)
+        {
+            float l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+            float x = l1 > 0 ? n[0] / l1 : 0;
+            float y = l1 > 0 ? n[1] / l1 : 0;
+            if (n[2] < 0)
+            {
+                float ox = x;
+                x = (1 - std::abs(y)) * (ox >= 0 ? 1 : -1);
+                y = (1 - std::abs(ox)) * (y >= 0 ? 1 : -1);
+            }
+            pOut[0] = toSnorm16(x);
+            pOut[1] = toSnorm16(y);
+        }
+
+        void decodeOctahedral(const int16* pIn, float* n)
+        {
+            Vector3 v(fromSnorm16(pIn[0]), fromSnorm16(pIn[1]), 0);
+            v.z = 1 - std::abs(v.x) - std::abs(v.y);
+            float t = std::max(-v.z, 0.0f);
+            v.x += v.x >= 0 ? -t : t;
+            v.y += v.y >= 0 ? -t : t;
+            v.normalise();
+            n[0] = v.x;
+            n[1] = v.y;
+            n[2] = v.z;
+        }
+    }
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_Compressed::MeshSerializerImpl_Compressed()
+    {
+        // Version number
+        mVersion = "[MeshSerializer_v1.100_compressed]";
+    }
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_Compressed::~MeshSerializerImpl_Compressed()
+    {
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Compressed::exportMesh(const Mesh* pMesh, const DataStreamPtr stream,
+                                                   Endian endianMode)
+    {
+        // payloads are encoded during the size pass and must not outlive the mesh
+        mPayloads.clear();
+        MeshSerializerImpl::exportMesh(pMesh, stream, endianMode);
+        mPayloads.clear();
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Compressed::writePackedBlock(const uchar* pData, size_t size)
+    {
+        uchar method = PM_STORED;
+        const uchar* pStored = pData;
+        uint32 storedSize = static_cast<uint32>(size);
+        std::vector<uchar> deflated;
+#if OGRE_NO_ZIP_ARCHIVE == 0
+        mz_ulong deflatedSize = mz_compressBound(size);
+        deflated.resize(deflatedSize);
+        if (size && mz_compress2(deflated.data(), &deflatedSize, pData, size, MZ_BEST_COMPRESSION) == MZ_OK &&
+            deflatedSize < size)
+        {
+            method = PM_DEFLATE;
+            pStored = deflated.data();
+            storedSize = static_cast<uint32>(deflatedSize);
+        }
+#endif
+        uint32 rawSize = static_cast<uint32>(size);
+        writeData(&method, 1, 1);
+        writeInts(&rawSize, 1);
+        writeInts(&storedSize, 1);
+        writeData(pStored, 1, storedSize);
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Compressed::readPackedBlock(const DataStreamPtr& stream, uchar* pDest, size_t size)
+    {
+        uchar method;
+        uint32 rawSize, storedSize;
+        stream->read(&method, 1);
+        readInts(stream, &rawSize, 1);
+        readInts(stream, &storedSize, 1);
+        if (rawSize != size || (method == PM_STORED && storedSize != size) || method > PM_DEFLATE)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt packed block in " + stream->getName(),
+                        "MeshSerializerImpl_Compressed::readPackedBlock");
+        }
+
+        if (method == PM_STORED)
+        {
+            stream->read(pDest, size);
+            return;
+        }
+#if OGRE_NO_ZIP_ARCHIVE == 0
+        std::vector<uchar> deflated(storedSize);
+        stream->read(deflated.data(), storedSize);
+        mz_ulong destSize = size;
+        if (mz_uncompress(pDest, &destSize, deflated.data(), storedSize) != MZ_OK || destSize != size)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt packed block in " + stream->getName(),
+                        "MeshSerializerImpl_Compressed::readPackedBlock");
+        }
+#else
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Ogre was not built with Zip file support!",
+                    "MeshSerializerImpl_Compressed::readPackedBlock");
+#endif
+    }
+    //---------------------------------------------------------------------
+    const std::vector<uchar>& MeshSerializerImpl_Compressed::encodeVertexBuffer(const VertexData* vertexData,
+        unsigned short bindIndex, const HardwareVertexBufferSharedPtr& vbuf)
+    {
+        PayloadKey key(vertexData, vbuf.get());
+        PayloadMap::iterator it = mPayloads.find(key);
+        if (it != mPayloads.end())
+            return it->second;
+
+        size_t vertexCount = vertexData->vertexCount;
+        size_t vertexSize = vbuf->getVertexSize();
+        VertexDeclaration::VertexElementList elems = vertexData->vertexDeclaration->findElementsBySource(bindIndex);
+
+        // the payload is assembled through mStream, so writeInts & co take care of the endianness
+        DataStreamPtr origStream = mStream;
+        MemoryDataStream* payload = OGRE_NEW MemoryDataStream(
+            elems.size() * (1 + sizeof(float) * 6) + 1 + sizeof(uint32) * 2 + vertexCount * vertexSize * 2);
+        mStream.reset(payload);
+
+        std::vector<uchar> planes, words;
+        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+        for (VertexDeclaration::VertexElementList::iterator ei = elems.begin(); ei != elems.end(); ++ei)
+        {
+            VertexElementType type = ei->getType();
+            ushort count = VertexElement::getTypeCount(type);
+            bool isFloat = VertexElement::getBaseType(type) == VET_FLOAT1;
+
+            // gather the element as float, if possible, to pick the encoding
+            std::vector<float> values;
+            if (isFloat)
+            {
+                values.resize(vertexCount * count);
+                for (size_t v = 0; v < vertexCount; ++v)
+                {
+                    float* pFloat;
+                    ei->baseVertexPointerToElement(static_cast<uchar*>(vbufLock.pData) + v * vertexSize, &pFloat);
+                    memcpy(&values[v * count], pFloat, sizeof(float) * count);
+                }
+            }
+
+            uchar encoding = EE_RAW;
+            VertexElementSemantic sem = ei->getSemantic();
+            if (isFloat && sem == VES_POSITION && count == 3)
+            {
+                encoding = EE_QUANTIZED_POSITION;
+            }
+            else if (isFloat && (sem == VES_NORMAL || sem == VES_TANGENT || sem == VES_BINORMAL) && count >= 3)
+            {
+                // only exact directions survive the octahedral mapping, leave anything else alone
+                encoding = EE_OCTAHEDRAL;
+                for (size_t v = 0; v < vertexCount && encoding == EE_OCTAHEDRAL; ++v)
+                {
+                    const float* n = &values[v * count];
+                    if (std::abs(Vector3(n).length() - 1) > 1e-3f || (count == 4 && std::abs(n[3]) > 1))
+                        encoding = EE_RAW;
+                }
+            }
+            else if (isFloat && sem == VES_TEXTURE_COORDINATES)
+            {
+                // half floats keep at least 10 bits of precision up to this range
+                encoding = EE_HALF;
+                for (size_t i = 0; i < values.size() && encoding == EE_HALF; ++i)
+                {
+                    if (!(std::abs(values[i]) <= 4))
+                        encoding = EE_RAW;
+                }
+            }
+            writeData(&encoding, 1, 1);
+
+            size_t wordSize = 2;
+            words.clear();
+            switch (encoding)
+            {
+            case EE_QUANTIZED_POSITION:
+            {
+                float offset[3], scale[3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    float minVal = std::numeric_limits<float>::max(), maxVal = -minVal;
+                    for (size_t v = 0; v < vertexCount; ++v)
+                    {
+                        minVal = std::min(minVal, values[v * 3 + c]);
+                        maxVal = std::max(maxVal, values[v * 3 + c]);
+                    }
+                    offset[c] = vertexCount ? minVal : 0;
+                    scale[c] = vertexCount ? (maxVal - minVal) / 65535.0f : 0;
+                }
+                writeFloats(offset, 3);
+                writeFloats(scale, 3);
+                words.resize(vertexCount * 3 * sizeof(uint16));
+                uint16* pWord = reinterpret_cast<uint16*>(words.data());
+                for (size_t v = 0; v < vertexCount; ++v)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        float q = scale[c] > 0 ? (values[v * 3 + c] - offset[c]) / scale[c] : 0;
+                        *pWord++ = static_cast<uint16>(Math::Clamp(Math::Floor(q + 0.5f), 0.0f, 65535.0f));
+                    }
+                }
+                break;
+            }
+            case EE_OCTAHEDRAL:
+            {
+                size_t wordCount = count == 4 ? 3 : 2;
+                words.resize(vertexCount * wordCount * sizeof(int16));
+                int16* pWord = reinterpret_cast<int16*>(words.data());
+                for (size_t v = 0; v < vertexCount; ++v)
+                {
+                    encodeOctahedral(&values[v * count], pWord);
+                    if (count == 4)
+                        pWord[2] = toSnorm16(values[v * count + 3]);
+                    pWord += wordCount;
+                }
+                break;
+            }
+            case EE_HALF:
+            {
+                words.resize(values.size() * sizeof(uint16));
+                uint16* pWord = reinterpret_cast<uint16*>(words.data());
+                for (size_t i = 0; i < values.size(); ++i)
+                    pWord[i] = Bitwise::floatToHalf(values[i]);
+                break;
+            }
+            default:
+            {
+                size_t elemSize = ei->getSize();
+                wordSize = rawWordSize(type);
+                words.resize(vertexCount * elemSize);
+                for (size_t v = 0; v < vertexCount; ++v)
+                {
+                    uchar* pElem;
+                    ei->baseVertexPointerToElement(static_cast<uchar*>(vbufLock.pData) + v * vertexSize, &pElem);
+                    memcpy(&words[v * elemSize], pElem, elemSize);
+                }
+                break;
+            }
+            }
+
+            // little endian words, split into byte planes so that deflate sees the slowly
+            // changing high bytes next to each other
+            size_t wordCount = words.size() / wordSize;
+            Serializer::flipToLittleEndian(words.data(), wordSize, wordCount);
+            size_t planeOffset = planes.size();
+            planes.resize(planeOffset + words.size());
+            transposeBytePlanes(words.data(), &planes[planeOffset], wordSize, wordCount);
+        }
+
+        writePackedBlock(planes.data(), planes.size());
+
+        std::vector<uchar>& ret = mPayloads[key];
+        ret.assign(payload->getPtr(), payload->getPtr() + payload->tell());
+        mStream = origStream;
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    const std::vector<uchar>& MeshSerializerImpl_Compressed::encodeIndexBuffer(const SubMesh* s)
+    {
+        PayloadKey key(s, NULL);
+        PayloadMap::iterator it = mPayloads.find(key);
+        if (it != mPayloads.end())
+            return it->second;
+
+        const HardwareIndexBufferSharedPtr& ibuf = s->indexData->indexBuffer;
+        size_t indexCount = s->indexData->indexCount;
+        size_t indexSize = ibuf->getIndexSize();
+        std::vector<uchar> words(indexCount * indexSize), planes(indexCount * indexSize);
+        {
+            // consecutive indices are close to each other, so store zigzag coded deltas
+            HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_READ_ONLY);
+            if (indexSize == 4)
+            {
+                const uint32* pIdx = static_cast<const uint32*>(ibufLock.pData);
+                uint32* pOut = reinterpret_cast<uint32*>(words.data());
+                uint32 prev = 0;
+                for (size_t i = 0; i < indexCount; ++i)
+                {
+                    int32 delta = static_cast<int32>(pIdx[i] - prev);
+                    pOut[i] = (static_cast<uint32>(delta) << 1) ^ static_cast<uint32>(delta >> 31);
+                    prev = pIdx[i];
+                }
+            }
+            else
+            {
+                const uint16* pIdx = static_cast<const uint16*>(ibufLock.pData);
+                uint16* pOut = reinterpret_cast<uint16*>(words.data());
+                uint16 prev = 0;
+                for (size_t i = 0; i < indexCount; ++i)
+                {
+                    int16 delta = static_cast<int16>(pIdx[i] - prev);
+                    pOut[i] = static_cast<uint16>((static_cast<uint16>(delta) << 1) ^ static_cast<uint16>(delta >> 15));
+                    prev = pIdx[i];
+                }
+            }
+        }
+        Serializer::flipToLittleEndian(words.data(), indexSize, indexCount);
+        transposeBytePlanes(words.data(), planes.data(), indexSize, indexCount);
+
+        DataStreamPtr origStream = mStream;
+        MemoryDataStream* payload = OGRE_NEW MemoryDataStream(planes.size() + 1 + sizeof(uint32) * 2);
+        mStream.reset(payload);
+        writePackedBlock(planes.data(), planes.size());
+
+        std::vector<uchar>& ret = mPayloads[key];
+        ret.assign(payload->getPtr(), payload->getPtr() + payload->tell());
+        mStream = origStream;
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Compressed::writeGeometryVertexBufferData(const VertexData* pGeom,
+        unsigned short bindIndex, const HardwareVertexBufferSharedPtr& vbuf)
+    {
+        const std::vector<uchar>& payload = encodeVertexBuffer(pGeom, bindIndex, vbuf);
+        writeData(payload.data(), 1, payload.size());
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_Compressed::writeSubMeshIndexData(const SubMesh* s)
+    {
+        const std::vector<uchar>& payload = encodeIndexBuffer(s);
+        writeData(payload.data(), 1, payload.size());
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_Compressed::calcGeometryVertexBufferDataSize(const VertexData* pGeom,
+                                                                           const HardwareVertexBufferSharedPtr& vbuf)
+    {
+        const VertexBufferBinding::VertexBufferBindingMap& bindings = pGeom->vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator vbi;
+        for (vbi = bindings.begin(); vbi != bindings.end(); ++vbi)
+        {
+            if (vbi->second == vbuf)
+                return encodeVertexBuffer(pGeom, vbi->first, vbuf).size();
+        }
+        OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Vertex buffer is not bound",
+                    "MeshSerializerImpl_Compressed::calcGeometryVertexBufferDataSize");
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_Compressed::calcSubMeshIndexDataSize(const SubMesh* pSub)
+    {
+        return encodeIndexBuffer(pSub).size();
+    }
+    //---------------------------------------------------------------------
+    HardwareVertexBufferSharedPtr MeshSerializerImpl_Compressed::readGeometryVertexBufferData(
+        const DataStreamPtr& stream, Mesh* pMesh, VertexData* dest, unsigned short bindIndex,
+        unsigned short vertexSize)
+    {
+        size_t vertexCount = dest->vertexCount;
+        VertexDeclaration::VertexElementList elems = dest->vertexDeclaration->findElementsBySource(bindIndex);
+
+        // element headers come first, then the planes of all elements in one block
+        std::vector<uchar> encodings;
+        std::vector<float> ranges; // offset & scale of quantized positions
+        size_t planesSize = 0;
+        for (VertexDeclaration::VertexElementList::iterator ei = elems.begin(); ei != elems.end(); ++ei)
+        {
+            uchar encoding;
+            stream->read(&encoding, 1);
+            VertexElementType type = ei->getType();
+            ushort count = VertexElement::getTypeCount(type);
+            bool isFloat = VertexElement::getBaseType(type) == VET_FLOAT1;
+            if ((encoding == EE_QUANTIZED_POSITION && !(isFloat && count == 3)) ||
+                (encoding == EE_OCTAHEDRAL && !(isFloat && count >= 3)) ||
+                (encoding == EE_HALF && !isFloat) || encoding > EE_HALF)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid element encoding in " + stream->getName(),
+                            "MeshSerializerImpl_Compressed::readGeometryVertexBufferData");
+            }
+            encodings.push_back(encoding);
+
+            switch (encoding)
+            {
+            case EE_QUANTIZED_POSITION:
+                ranges.resize(ranges.size() + 6);
+                readFloats(stream, &ranges[ranges.size() - 6], 6);
+                planesSize += vertexCount * 3 * sizeof(uint16);
+                break;
+            case EE_OCTAHEDRAL:
+                planesSize += vertexCount * (count == 4 ? 3 : 2) * sizeof(int16);
+                break;
+            case EE_HALF:
+                planesSize += vertexCount * count * sizeof(uint16);
+                break;
+            default:
+                planesSize += vertexCount * ei->getSize();
+                break;
+            }
+        }
+
+        std::vector<uchar> planes(planesSize), words;
+        readPackedBlock(stream, planes.data(), planesSize);
+
+        HardwareVertexBufferSharedPtr vbuf = pMesh->getHardwareBufferManager()->createVertexBuffer(
+            vertexSize, vertexCount, pMesh->getVertexBufferUsage(), pMesh->isVertexBufferShadowed());
+        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_DISCARD);
+        uchar* pBase = static_cast<uchar*>(vbufLock.pData);
+        memset(pBase, 0, vertexCount * vertexSize);
+
+        const uchar* pPlanes = planes.data();
+        const float* pRange = ranges.data();
+        for (size_t e = 0; e < elems.size(); ++e)
+        {
+            const VertexElement& elem = *std::next(elems.begin(), e);
+            ushort count = VertexElement::getTypeCount(elem.getType());
+            size_t wordSize = encodings[e] == EE_RAW ? rawWordSize(elem.getType()) : 2;
+            size_t byteCount = encodings[e] == EE_QUANTIZED_POSITION ? vertexCount * 3 * sizeof(uint16)
+                             : encodings[e] == EE_OCTAHEDRAL ? vertexCount * (count == 4 ? 3 : 2) * sizeof(int16)
+                             : encodings[e] == EE_HALF ? vertexCount * count * sizeof(uint16)
+                             : vertexCount * elem.getSize();
+            size_t wordCount = byteCount / wordSize;
+            words.resize(byteCount);
+            untransposeBytePlanes(pPlanes, words.data(), wordSize, wordCount);
+            Serializer::flipFromLittleEndian(words.data(), wordSize, wordCount);
+            pPlanes += byteCount;
+
+            for (size_t v = 0; v < vertexCount; ++v)
+            {
+                float* pFloat;
+                elem.baseVertexPointerToElement(pBase + v * vertexSize, &pFloat);
+                switch (encodings[e])
+                {
+                case EE_QUANTIZED_POSITION:
+                {
+                    const uint16* pWord = reinterpret_cast<const uint16*>(words.data()) + v * 3;
+                    for (int c = 0; c < 3; ++c)
+                        pFloat[c] = pRange[c] + pWord[c] * pRange[3 + c];
+                    break;
+                }
+                case EE_OCTAHEDRAL:
+                {
+                    const int16* pWord = reinterpret_cast<const int16*>(words.data()) + v * (count == 4 ? 3 : 2);
+                    decodeOctahedral(pWord, pFloat);
+                    if (count == 4)
+                        pFloat[3] = fromSnorm16(pWord[2]);
+                    break;
+                }
+                case EE_HALF:
+                {
+                    const uint16* pWord = reinterpret_cast<const uint16*>(words.data()) + v * count;
+                    for (ushort c = 0; c < count; ++c)
+                        pFloat[c] = Bitwise::halfToFloat(pWord[c]);
+                    break;
+                }
+                default:
+                    memcpy(pFloat, &words[v * elem.getSize()], elem.getSize());
+                    break;
+                }
+            }
+            if (encodings[e] == EE_QUANTIZED_POSITION)
+                pRange += 6;
+        }
+        return vbuf;
+    }
+    //---------------------------------------------------------------------
+    HardwareIndexBufferSharedPtr MeshSerializerImpl_Compressed::readSubMeshIndexData(const DataStreamPtr& stream,
+        Mesh* pMesh, SubMesh* sm, bool idx32bit)
+    {
+        size_t indexCount = sm->indexData->indexCount;
+        HardwareIndexBuffer::IndexType itype = idx32bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT;
+        size_t indexSize = HardwareIndexBuffer::indexSize(itype);
+        std::vector<uchar> planes(indexCount * indexSize), words(indexCount * indexSize);
+        readPackedBlock(stream, planes.data(), planes.size());
+        untransposeBytePlanes(planes.data(), words.data(), indexSize, indexCount);
+        Serializer::flipFromLittleEndian(words.data(), indexSize, indexCount);
+
+        HardwareIndexBufferSharedPtr ibuf = pMesh->getHardwareBufferManager()->createIndexBuffer(
+            itype, indexCount, pMesh->getIndexBufferUsage(), pMesh->isIndexBufferShadowed());
+        HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
+        if (idx32bit)
+        {
+            const uint32* pIn = reinterpret_cast<const uint32*>(words.data());
+            uint32* pIdx = static_cast<uint32*>(ibufLock.pData);
+            uint32 prev = 0;
+            for (size_t i = 0; i < indexCount; ++i)
+            {
+                prev += (pIn[i] >> 1) ^ (0u - (pIn[i] & 1));
+                pIdx[i] = prev;
+            }
+        }
+        else
+        {
+            const uint16* pIn = reinterpret_cast<const uint16*>(words.data());
+            uint16* pIdx = static_cast<uint16*>(ibufLock.pData);
+            uint16 prev = 0;
+            for (size_t i = 0; i < indexCount; ++i)
+            {
+                prev = static_cast<uint16>(prev + ((pIn[i] >> 1) ^ (0u - (pIn[i] & 1))));
+                pIdx[i] = prev;
+            }
+        }
+        return ibuf;
+    }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -70,7 +70,7 @@ namespace Ogre {
         @param stream The destination stream
         @param endianMode The endian mode for the written file
         */
-        void exportMesh(const Mesh* pMesh, const DataStreamPtr stream,
+        virtual void exportMesh(const Mesh* pMesh, const DataStreamPtr stream,
             Endian endianMode = ENDIAN_NATIVE);
 
         /** Imports Mesh and (optionally) Material data from a .mesh file DataStream.
@@ -80,7 +80,7 @@ namespace Ogre {
         @param stream The DataStream holding the .mesh data. Must be initialised (pos at the start of the buffer).
         @param pDest Pointer to the Mesh object which will receive the data. Should be blank already.
         */
-        void importMesh(const DataStreamPtr& stream, Mesh* pDest, MeshSerializerListener *listener);
+        virtual void importMesh(const DataStreamPtr& stream, Mesh* pDest, MeshSerializerListener *listener);
 
     protected:
 
@@ -91,6 +91,11 @@ namespace Ogre {
         virtual void writeSubMeshOperation(const SubMesh* s);
         virtual void writeSubMeshTextureAliases(const SubMesh* s);
         virtual void writeGeometry(const VertexData* pGeom);
+        /// Writes the payload of M_GEOMETRY_VERTEX_BUFFER_DATA
+        virtual void writeGeometryVertexBufferData(const VertexData* pGeom, unsigned short bindIndex,
+                                                   const HardwareVertexBufferSharedPtr& vbuf);
+        /// Writes the index payload of M_SUBMESH
+        virtual void writeSubMeshIndexData(const SubMesh* s);
         virtual void writeSkeletonLink(const String& skelName);
         virtual void writeMeshBoneAssignment(const VertexBoneAssignment& assign);
         virtual void writeSubMeshBoneAssignment(const VertexBoneAssignment& assign);
@@ -116,6 +121,9 @@ namespace Ogre {
         virtual size_t calcMeshSize(const Mesh* pMesh);
         virtual size_t calcSubMeshSize(const SubMesh* pSub);
         virtual size_t calcGeometrySize(const VertexData* pGeom);
+        virtual size_t calcGeometryVertexBufferDataSize(const VertexData* pGeom,
+                                                        const HardwareVertexBufferSharedPtr& vbuf);
+        virtual size_t calcSubMeshIndexDataSize(const SubMesh* pSub);
         virtual size_t calcSkeletonLinkSize(const String& skelName);
         virtual size_t calcBoneAssignmentSize(void);
         virtual size_t calcSubMeshOperationSize(const SubMesh* pSub);
@@ -151,6 +159,12 @@ namespace Ogre {
         virtual void readGeometryVertexDeclaration(const DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
         virtual void readGeometryVertexElement(const DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
         virtual void readGeometryVertexBuffer(const DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
+        /// Reads the payload of M_GEOMETRY_VERTEX_BUFFER_DATA into a new vertex buffer
+        virtual HardwareVertexBufferSharedPtr readGeometryVertexBufferData(const DataStreamPtr& stream,
+            Mesh* pMesh, VertexData* dest, unsigned short bindIndex, unsigned short vertexSize);
+        /// Reads the index payload of M_SUBMESH into a new index buffer
+        virtual HardwareIndexBufferSharedPtr readSubMeshIndexData(const DataStreamPtr& stream, Mesh* pMesh,
+                                                                  SubMesh* sm, bool idx32bit);
 
         virtual void readSkeletonLink(const DataStreamPtr& stream, Mesh* pMesh, MeshSerializerListener *listener);
         virtual void readMeshBoneAssignment(const DataStreamPtr& stream, Mesh* pMesh);
@@ -190,6 +204,118 @@ namespace Ogre {
     };
 
 
+    /** Mapped variant of the v1.10 .mesh format.
+
+     The chunk stream is the same as for v1.10, but vertex buffer and index payloads are
+     replaced by indices into a M_BLOB_TABLE that follows the header. The blobs themselves
+     are stored 16 byte aligned at the end of the file, so that the loader can hand regions
+     of the (memory resident) file straight to the HardwareBufferManager without copying
+     them into temporaries or walking them for endian conversion.
+     */
+    class _OgrePrivate MeshSerializerImpl_Mapped : public MeshSerializerImpl
+    {
+    public:
+        MeshSerializerImpl_Mapped();
+        ~MeshSerializerImpl_Mapped();
+
+        void exportMesh(const Mesh* pMesh, const DataStreamPtr stream, Endian endianMode = ENDIAN_NATIVE) override;
+        void importMesh(const DataStreamPtr& stream, Mesh* pDest, MeshSerializerListener *listener) override;
+    protected:
+        /// buffer written to the blob area, either index data of a SubMesh or a vertex buffer
+        struct Blob
+        {
+            size_t size;
+            const SubMesh* subMesh;
+            const VertexData* vertexData;
+            unsigned short bindIndex;
+        };
+        typedef std::vector<Blob> BlobList;
+        /// blobs collected during export
+        BlobList mBlobs;
+
+        struct BlobRegion
+        {
+            uint32 offset;
+            uint32 size;
+        };
+        typedef std::vector<BlobRegion> BlobRegionList;
+        /// blob table read during import
+        BlobRegionList mBlobTable;
+        /// start of the file in memory during import
+        const uchar* mFileBase;
+
+        /// 16 byte alignment, so SIMD loads and DMA uploads can use the data in place
+        static const size_t BLOB_ALIGNMENT = 16;
+
+        const uchar* getBlob(uint32 blobIndex, size_t expectedSize);
+
+        void writeGeometryVertexBufferData(const VertexData* pGeom, unsigned short bindIndex,
+                                           const HardwareVertexBufferSharedPtr& vbuf) override;
+        void writeSubMeshIndexData(const SubMesh* s) override;
+        size_t calcGeometryVertexBufferDataSize(const VertexData* pGeom,
+                                                const HardwareVertexBufferSharedPtr& vbuf) override;
+        size_t calcSubMeshIndexDataSize(const SubMesh* pSub) override;
+        HardwareVertexBufferSharedPtr readGeometryVertexBufferData(const DataStreamPtr& stream, Mesh* pMesh,
+                                                                   VertexData* dest, unsigned short bindIndex,
+                                                                   unsigned short vertexSize) override;
+        HardwareIndexBufferSharedPtr readSubMeshIndexData(const DataStreamPtr& stream, Mesh* pMesh, SubMesh* sm,
+                                                          bool idx32bit) override;
+    };
+
+    /** Compressed variant of the v1.10 .mesh format.
+
+     The chunk stream is the same as for v1.10, but vertex buffer and index payloads are
+     replaced by packed blocks. Positions are quantized to 16 bit against their bounding box,
+     unit length normals and tangents are octahedral encoded, small texture coordinates are
+     stored as half floats and indices are delta coded. Every stream is byte plane transposed
+     and deflated. The data is expanded back to the original VertexDeclaration on load.
+     */
+    class _OgrePrivate MeshSerializerImpl_Compressed : public MeshSerializerImpl
+    {
+    public:
+        MeshSerializerImpl_Compressed();
+        ~MeshSerializerImpl_Compressed();
+
+        void exportMesh(const Mesh* pMesh, const DataStreamPtr stream, Endian endianMode = ENDIAN_NATIVE) override;
+    protected:
+        enum ElementEncoding
+        {
+            EE_RAW = 0,
+            EE_QUANTIZED_POSITION = 1,
+            EE_OCTAHEDRAL = 2,
+            EE_HALF = 3
+        };
+        enum PackMethod
+        {
+            PM_STORED = 0,
+            PM_DEFLATE = 1
+        };
+        typedef std::pair<const void*, const void*> PayloadKey;
+        typedef std::map<PayloadKey, std::vector<uchar> > PayloadMap;
+        /// encoded payloads, calculated once for the size pass and reused when writing
+        PayloadMap mPayloads;
+
+        const std::vector<uchar>& encodeVertexBuffer(const VertexData* pGeom, unsigned short bindIndex,
+                                                     const HardwareVertexBufferSharedPtr& vbuf);
+        const std::vector<uchar>& encodeIndexBuffer(const SubMesh* s);
+        /// write a packed block of raw bytes to mStream
+        void writePackedBlock(const uchar* pData, size_t size);
+        /// read a packed block, which must expand to exactly size bytes
+        void readPackedBlock(const DataStreamPtr& stream, uchar* pDest, size_t size);
+
+        void writeGeometryVertexBufferData(const VertexData* pGeom, unsigned short bindIndex,
+                                           const HardwareVertexBufferSharedPtr& vbuf) override;
+        void writeSubMeshIndexData(const SubMesh* s) override;
+        size_t calcGeometryVertexBufferDataSize(const VertexData* pGeom,
+                                                const HardwareVertexBufferSharedPtr& vbuf) override;
+        size_t calcSubMeshIndexDataSize(const SubMesh* pSub) override;
+        HardwareVertexBufferSharedPtr readGeometryVertexBufferData(const DataStreamPtr& stream, Mesh* pMesh,
+                                                                   VertexData* dest, unsigned short bindIndex,
+                                                                   unsigned short vertexSize) override;
+        HardwareIndexBufferSharedPtr readSubMeshIndexData(const DataStreamPtr& stream, Mesh* pMesh, SubMesh* sm,
+                                                          bool idx32bit) override;
+    };
+
     /** Class for providing backwards-compatibility for loading version 1.8 of the .mesh format. 
      This mesh format was used from Ogre v1.8.
      */
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreLight.h"
 #include "OgreEntity.h"
 #include "OgreLodListener.h"
+#include "OgreSceneQueryTree.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -63,6 +64,8 @@ namespace Ogre {
         , mVisibilityFlags(msDefaultVisibilityFlags)
         , mLightListUpdated(0)
         , mLightMask(0xFFFFFFFF)
+        , mSceneQueryTree(0)
+        , mSceneQueryProxy(-1)
     {
         if (Root::getSingletonPtr())
             mMinPixelSize = Root::getSingleton().getDefaultMinPixelSize();
@@ -70,6 +73,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     MovableObject::~MovableObject()
     {
+        if (mSceneQueryTree)
+            mSceneQueryTree->removeObject(this);
+
         // Call listener (note, only called if there's something to do)
         if (mListener)
         {
@@ -304,12 +310,19 @@ namespace Ogre {
         {
             mWorldAABB = this->getBoundingBox();
             mWorldAABB.transform(_getParentNodeFullTransform());
+            _notifyWorldBoundsChanged();
         }
 
         return mWorldAABB;
 
     }
     //-----------------------------------------------------------------------
+    void MovableObject::_notifyWorldBoundsChanged() const
+    {
+        if (mSceneQueryTree)
+            mSceneQueryTree->updateObject(this);
+    }
+    //-----------------------------------------------------------------------
     const Sphere& MovableObject::getWorldBoundingSphere(bool derive) const
     {
         if (derive)
@@ -0,0 +1,260 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreOcclusionBuffer.h"
+#include "OgreCamera.h"
+#include "OgreParallel.h"
+
+namespace Ogre {
+    namespace {
+        /// rows rasterised by a single task
+        const uint32 ROWS_PER_TASK = 32;
+        /// number of triangles below which projecting and rasterising on several threads does not pay off
+        const size_t PARALLEL_MIN_TRIANGLES = 1024;
+        /// relative distance an occluder must be in front of a box, absorbing the rounding of the rasteriser
+        const float DEPTH_TOLERANCE = 1e-4f;
+    }
+    //---------------------------------------------------------------------
+    OcclusionBuffer::OcclusionBuffer(uint32 width, uint32 height)
+        : mWidth(width), mHeight(height), mCamera(NULL), mDepth(size_t(width) * height, 0.0f)
+    {
+        OgreAssert(width > 0 && height > 0, "the occlusion buffer must not be empty");
+    }
+    //---------------------------------------------------------------------
+    bool OcclusionBuffer::begin(const Camera* cam)
+    {
+        mCamera = NULL;
+        mOccluders.clear();
+        if (cam->getProjectionType() != PT_PERSPECTIVE)
+            return false;
+
+        mViewProj = cam->getProjectionMatrix() * cam->getViewMatrix(true);
+        std::fill(mDepth.begin(), mDepth.end(), 0.0f);
+        mCamera = cam;
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void OcclusionBuffer::addOccluder(const std::vector<Vector3>& vertices, const Affine3& world)
+    {
+        if (mCamera && !vertices.empty())
+            mOccluders.push_back({&vertices, world});
+    }
+    //---------------------------------------------------------------------
+    void OcclusionBuffer::projectTriangles(const Occluder& occluder, std::vector<ScreenTriangle>& triangles) const
+    {
+        Matrix4 worldViewProj = mViewProj * occluder.world;
+        const std::vector<Vector3>& vertices = *occluder.vertices;
+
+        for (size_t i = 0; i + 2 < vertices.size(); i += 3)
+        {
+            Vector4 corners[3] = {worldViewProj * Vector4(vertices[i], 1),
+                                  worldViewProj * Vector4(vertices[i + 1], 1),
+                                  worldViewProj * Vector4(vertices[i + 2], 1)};
+
+            // clip at the near plane, which leaves a polygon of up to 4 corners
+            Vector4 clipped[4];
+            int count = 0;
+            for (int j = 0; j < 3; j++)
+            {
+                const Vector4& a = corners[j];
+                const Vector4& b = corners[(j + 1) % 3];
+                Real da = a.z + a.w, db = b.z + b.w;
+                if (da >= 0)
+                    clipped[count++] = a;
+                if ((da >= 0) != (db >= 0))
+                    clipped[count++] = a + (b - a) * (da / (da - db));
+            }
+            if (count < 3)
+                continue;
+
+            float x[4], y[4], invDepth[4];
+            for (int j = 0; j < count; j++)
+            {
+                Real invW = 1 / clipped[j].w;
+                x[j] = float((clipped[j].x * invW * 0.5f + 0.5f) * mWidth);
+                y[j] = float((0.5f - clipped[j].y * invW * 0.5f) * mHeight);
+                invDepth[j] = float(invW);
+            }
+
+            for (int j = 1; j + 1 < count; j++)
+            {
+                ScreenTriangle t = {{x[0], x[j], x[j + 1]}, {y[0], y[j], y[j + 1]},
+                                    {invDepth[0], invDepth[j], invDepth[j + 1]}};
+
+                // skip triangles outside of the screen
+                if (std::max({t.x[0], t.x[1], t.x[2]}) <= 0 || std::min({t.x[0], t.x[1], t.x[2]}) >= mWidth ||
+                    std::max({t.y[0], t.y[1], t.y[2]}) <= 0 || std::min({t.y[0], t.y[1], t.y[2]}) >= mHeight)
+                    continue;
+
+                // orient all triangles the same way, so they are visible from both sides
+                float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+                if (area == 0)
+                    continue;
+                if (area < 0)
+                {
+                    std::swap(t.x[1], t.x[2]);
+                    std::swap(t.y[1], t.y[2]);
+                    std::swap(t.invDepth[1], t.invDepth[2]);
+                }
+                triangles.push_back(t);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OcclusionBuffer::rasteriseRows(uint32 rowBegin, uint32 rowEnd)
+    {
+        for (const ScreenTriangle& t : mTriangles)
+        {
+            int y0 = int(std::max(float(rowBegin), std::floor(std::min({t.y[0], t.y[1], t.y[2]}))));
+            int y1 = int(std::min(float(rowEnd), std::ceil(std::max({t.y[0], t.y[1], t.y[2]}))));
+            int x0 = int(std::max(0.0f, std::floor(std::min({t.x[0], t.x[1], t.x[2]}))));
+            int x1 = int(std::min(float(mWidth), std::ceil(std::max({t.x[0], t.x[1], t.x[2]}))));
+            if (y0 >= y1 || x0 >= x1)
+                continue;
+
+            float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+            float invArea = 1 / area;
+
+            // edge function k is positive inside and 0 on the edge opposite to vertex k,
+            // so divided by the area it is the barycentric weight of vertex k
+            float a[3], b[3];
+            for (int k = 0; k < 3; k++)
+            {
+                int i = (k + 1) % 3, j = (k + 2) % 3;
+                a[k] = t.y[i] - t.y[j];
+                b[k] = t.x[j] - t.x[i];
+            }
+
+            for (int y = y0; y < y1; y++)
+            {
+                float py = float(y) + 0.5f;
+                float c[3];
+                for (int k = 0; k < 3; k++)
+                {
+                    int i = (k + 1) % 3;
+                    c[k] = b[k] * (py - t.y[i]) - a[k] * t.x[i];
+                }
+
+                // no dependencies between the pixels, so this loop is vectorised
+                float* row = &mDepth[size_t(y) * mWidth];
+                for (int x = x0; x < x1; x++)
+                {
+                    float px = float(x) + 0.5f;
+                    float e0 = a[0] * px + c[0];
+                    float e1 = a[1] * px + c[1];
+                    float e2 = a[2] * px + c[2];
+                    float depth = (e0 * t.invDepth[0] + e1 * t.invDepth[1] + e2 * t.invDepth[2]) * invArea;
+                    bool inside = (e0 > 0) & (e1 > 0) & (e2 > 0);
+                    row[x] = inside ? std::max(row[x], depth) : row[x];
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void OcclusionBuffer::rasterise()
+    {
+        if (!mCamera)
+            return;
+
+        size_t numTriangles = 0;
+        for (const Occluder& occluder : mOccluders)
+            numTriangles += occluder.vertices->size() / 3;
+
+        mTriangles.clear();
+        if (numTriangles < PARALLEL_MIN_TRIANGLES)
+        {
+            for (const Occluder& occluder : mOccluders)
+                projectTriangles(occluder, mTriangles);
+        }
+        else
+        {
+            std::vector<std::vector<ScreenTriangle>> triangles(mOccluders.size());
+            parallelFor(mOccluders.size(), 1, [this, &triangles](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    projectTriangles(mOccluders[i], triangles[i]);
+            });
+
+            for (const auto& t : triangles)
+                mTriangles.insert(mTriangles.end(), t.begin(), t.end());
+        }
+        mOccluders.clear();
+
+        // each task owns a band of rows, so no pixel is written by two threads
+        uint32 tasks = (mHeight + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+        size_t minTasks = mTriangles.size() < PARALLEL_MIN_TRIANGLES ? tasks : 1;
+        parallelFor(tasks, minTasks, [this](size_t begin, size_t end) {
+            rasteriseRows(uint32(begin) * ROWS_PER_TASK, std::min(uint32(end) * ROWS_PER_TASK, mHeight));
+        });
+    }
+    //---------------------------------------------------------------------
+    bool OcclusionBuffer::isOccluded(const AxisAlignedBox& box) const
+    {
+        if (!mCamera || !box.isFinite())
+            return false;
+
+        float minX = std::numeric_limits<float>::max(), minY = minX;
+        float maxX = -minX, maxY = -minX;
+        float nearest = 0;
+        for (const Vector3& corner : box.getAllCorners())
+        {
+            Vector4 clip = mViewProj * Vector4(corner, 1);
+            // boxes reaching the near plane are never occluded
+            if (clip.z + clip.w <= 0 || clip.w <= 0)
+                return false;
+
+            Real invW = 1 / clip.w;
+            float x = float((clip.x * invW * 0.5f + 0.5f) * mWidth);
+            float y = float((0.5f - clip.y * invW * 0.5f) * mHeight);
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            nearest = std::max(nearest, float(invW));
+        }
+
+        // the pixels touched by the box, anything off the screen is left to frustum culling
+        int x0 = int(std::max(0.0f, std::floor(minX)));
+        int x1 = int(std::min(float(mWidth), std::ceil(maxX)));
+        int y0 = int(std::max(0.0f, std::floor(minY)));
+        int y1 = int(std::min(float(mHeight), std::ceil(maxY)));
+        if (x0 >= x1 || y0 >= y1)
+            return false;
+
+        nearest *= 1 + DEPTH_TOLERANCE;
+        for (int y = y0; y < y1; y++)
+        {
+            const float* row = &mDepth[size_t(y) * mWidth];
+            for (int x = x0; x < x1; x++)
+            {
+                if (row[x] <= nearest)
+                    return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,108 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OcclusionBuffer_H__
+#define __OcclusionBuffer_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreMatrix4.h"
+
+namespace Ogre {
+
+    /** Low resolution depth buffer of the occluders seen by a camera, used for software occlusion culling.
+
+        The triangles of the occluders are rasterised on the CPU, storing the inverse view depth of the
+        nearest occluder per pixel. A bounding box is occluded if its nearest point is behind the
+        occluders in every pixel it covers. Only pixels whose centre is inside an occluder triangle are
+        covered, while a box covers every pixel it touches, so nothing visible is culled as long as the
+        occluders do not extend beyond the geometry they stand for.
+    */
+    class OcclusionBuffer : public SceneMgtAlloc
+    {
+    public:
+        OcclusionBuffer(uint32 width, uint32 height);
+
+        /** Start collecting occluders for the given camera, discarding the previous ones
+        @return false if the camera does not use a perspective projection, in which case nothing
+            is occluded
+        */
+        bool begin(const Camera* cam);
+
+        /** Add the triangles of an occluder
+        @param vertices three positions per triangle, which must stay valid until rasterise is called
+        @param world the transform of the positions
+        */
+        void addOccluder(const std::vector<Vector3>& vertices, const Affine3& world);
+
+        /// Rasterise the added occluders on worker threads
+        void rasterise();
+
+        /// Stop occluding anything until the next begin call
+        void reset() { mCamera = NULL; }
+
+        /** Test whether the given world space box is hidden behind the occluders
+        @remarks
+            This only reads the buffer, so several threads may test boxes at once.
+        */
+        bool isOccluded(const AxisAlignedBox& box) const;
+
+        /// The camera the buffer was rasterised for, NULL if none
+        const Camera* getCamera() const { return mCamera; }
+
+        uint32 getWidth() const { return mWidth; }
+        uint32 getHeight() const { return mHeight; }
+        /// Inverse view depth of the nearest occluder per pixel, 0 where there is none
+        const std::vector<float>& getDepth() const { return mDepth; }
+
+    private:
+        struct Occluder
+        {
+            const std::vector<Vector3>* vertices;
+            Affine3 world;
+        };
+        /// a triangle in pixel coordinates, along with the inverse view depth of its vertices
+        struct ScreenTriangle
+        {
+            float x[3], y[3], invDepth[3];
+        };
+
+        /// clip the triangles of an occluder at the near plane and project them to the screen
+        void projectTriangles(const Occluder& occluder, std::vector<ScreenTriangle>& triangles) const;
+        /// rasterise all triangles into the rows [rowBegin, rowEnd)
+        void rasteriseRows(uint32 rowBegin, uint32 rowEnd);
+
+        uint32 mWidth;
+        uint32 mHeight;
+        const Camera* mCamera;
+        Matrix4 mViewProj;
+        std::vector<float> mDepth;
+        std::vector<Occluder> mOccluders;
+        std::vector<ScreenTriangle> mTriangles;
+    };
+}
+
+#endif
@@ -0,0 +1,165 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreParallel.h"
+
+#if OGRE_THREAD_SUPPORT
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#endif
+
+namespace Ogre {
+#if OGRE_THREAD_SUPPORT
+    namespace {
+    /// The tasks of one parallelFor call, claimed one by one by the participating threads
+    struct ParallelJob
+    {
+        const std::function<void(size_t)>* task;
+        size_t count;
+        std::atomic<size_t> next;
+        /// number of workers running tasks of this job, guarded by the mutex of ParallelWorkers
+        size_t users;
+        std::vector<std::exception_ptr> errors;
+
+        ParallelJob(const std::function<void(size_t)>& func, size_t numTasks)
+            : task(&func), count(numTasks), next(0), users(0), errors(numTasks)
+        {
+        }
+
+        void run()
+        {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                try
+                {
+                    (*task)(i);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            }
+        }
+    };
+
+    /// Threads kept alive between parallelFor calls, so a call does not pay for starting threads
+    class ParallelWorkers
+    {
+        std::mutex mMutex;
+        std::condition_variable mJobQueued;
+        std::condition_variable mJobReleased;
+        std::deque<ParallelJob*> mJobs;
+        std::vector<std::thread> mThreads;
+        bool mStop;
+
+        void workerLoop()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (true)
+            {
+                mJobQueued.wait(lock, [this]() { return mStop || !mJobs.empty(); });
+                if (mStop)
+                    return;
+
+                ParallelJob* job = mJobs.front();
+                if (job->next >= job->count)
+                {
+                    // all tasks are taken, the owner waits for them to finish
+                    mJobs.pop_front();
+                    continue;
+                }
+
+                job->users++;
+                lock.unlock();
+                job->run();
+                lock.lock();
+                if (--job->users == 0)
+                    mJobReleased.notify_all();
+            }
+        }
+    public:
+        ParallelWorkers() : mStop(false)
+        {
+            size_t numThreads = std::max(OGRE_THREAD_HARDWARE_CONCURRENCY, 2u) - 1;
+            for (size_t i = 0; i < numThreads; ++i)
+                mThreads.emplace_back([this]() { workerLoop(); });
+        }
+
+        ~ParallelWorkers()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStop = true;
+            }
+            mJobQueued.notify_all();
+            for (auto& t : mThreads)
+                t.join();
+        }
+
+        void run(ParallelJob& job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mJobs.push_back(&job);
+            }
+            // the calling thread takes part as well
+            for (size_t i = 1; i < std::min(job.count, mThreads.size() + 1); ++i)
+                mJobQueued.notify_one();
+
+            job.run();
+
+            // no worker may pick the job up once this returns
+            std::unique_lock<std::mutex> lock(mMutex);
+            auto it = std::find(mJobs.begin(), mJobs.end(), &job);
+            if (it != mJobs.end())
+                mJobs.erase(it);
+            mJobReleased.wait(lock, [&job]() { return job.users == 0; });
+        }
+    };
+    }
+#endif
+    //---------------------------------------------------------------------
+    void _parallelForTasks(size_t count, const std::function<void(size_t)>& task)
+    {
+#if OGRE_THREAD_SUPPORT
+        static ParallelWorkers workers;
+
+        ParallelJob job(task, count);
+        workers.run(job);
+        for (auto& e : job.errors)
+        {
+            if (e)
+                std::rethrow_exception(e);
+        }
+#else
+        for (size_t i = 0; i < count; ++i)
+            task(i);
+#endif
+    }
+}
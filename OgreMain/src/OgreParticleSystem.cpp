@@ -866,6 +866,7 @@ namespace Ogre {
                 }
                 mWorldAABB.setExtents(min, max);
             }
+            _notifyWorldBoundsChanged();
 
 
             if (mLocalSpace)
@@ -105,102 +105,6 @@ struct Col4f {
     float r,g,b,a;
 };
 
-struct A8R8G8B8toA8B8G8R8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8R8G8B8, Ogre::PF_A8B8G8R8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x000000FF)<<16)|(inp&0xFF00FF00)|((inp&0x00FF0000)>>16);
-    }
-};
-
-struct A8R8G8B8toB8G8R8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8R8G8B8, Ogre::PF_B8G8R8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x000000FF)<<24)|((inp&0x0000FF00)<<8)|((inp&0x00FF0000)>>8)|((inp&0xFF000000)>>24);
-    }
-};
-
-struct A8R8G8B8toR8G8B8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8R8G8B8, Ogre::PF_R8G8B8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x00FFFFFF)<<8)|((inp&0xFF000000)>>24);
-    }
-};
-
-struct A8B8G8R8toA8R8G8B8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8B8G8R8, Ogre::PF_A8R8G8B8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x000000FF)<<16)|(inp&0xFF00FF00)|((inp&0x00FF0000)>>16);
-    }
-};
-
-struct A8B8G8R8toB8G8R8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8B8G8R8, Ogre::PF_B8G8R8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x00FFFFFF)<<8)|((inp&0xFF000000)>>24);
-    }
-};
-
-struct A8B8G8R8toR8G8B8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_A8B8G8R8, Ogre::PF_R8G8B8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x000000FF)<<24)|((inp&0x0000FF00)<<8)|((inp&0x00FF0000)>>8)|((inp&0xFF000000)>>24);
-    }
-};
-
-struct B8G8R8A8toA8R8G8B8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_B8G8R8A8, Ogre::PF_A8R8G8B8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x000000FF)<<24)|((inp&0x0000FF00)<<8)|((inp&0x00FF0000)>>8)|((inp&0xFF000000)>>24);
-    }
-};
-
-struct B8G8R8A8toA8B8G8R8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_B8G8R8A8, Ogre::PF_A8B8G8R8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x000000FF)<<24)|((inp&0xFFFFFF00)>>8);
-    }
-};
-
-struct B8G8R8A8toR8G8B8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_B8G8R8A8, Ogre::PF_R8G8B8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x0000FF00)<<16)|(inp&0x00FF00FF)|((inp&0xFF000000)>>16);
-    }
-};
-
-struct R8G8B8A8toA8R8G8B8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_R8G8B8A8, Ogre::PF_A8R8G8B8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x000000FF)<<24)|((inp&0xFFFFFF00)>>8);
-    }
-};
-
-struct R8G8B8A8toA8B8G8R8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_R8G8B8A8, Ogre::PF_A8B8G8R8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x000000FF)<<24)|((inp&0x0000FF00)<<8)|((inp&0x00FF0000)>>8)|((inp&0xFF000000)>>24);
-    }
-};
-
-struct R8G8B8A8toB8G8R8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_R8G8B8A8, Ogre::PF_B8G8R8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x0000FF00)<<16)|(inp&0x00FF00FF)|((inp&0xFF000000)>>16);
-    }
-};
-
 struct A8B8G8R8toR8: public PixelConverter <Ogre::uint32, Ogre::uint8, FMTCONVERTERID(Ogre::PF_A8B8G8R8, Ogre::PF_R8)>
 {
     inline static DstType pixelConvert(SrcType inp)
@@ -365,87 +269,283 @@ struct A8R8G8B8toB8G8R8: public PixelConverter <Ogre::uint32, Col3b, FMTCONVERTE
     }
 };
 
-// Only conversions from X8R8G8B8 to formats with alpha need to be defined, the rest is implicitly the same
-// as A8R8G8B8
-struct X8R8G8B8toA8R8G8B8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_X8R8G8B8, Ogre::PF_A8R8G8B8)>
+/**
+ * Row kernels for the conversions that are worth vectorising. They work on
+ * whole rows, so PixelBoxRowConverter only has to walk the box.
+ */
+template <class F> void PixelBoxRowConverter(const Ogre::PixelBox &src, const Ogre::PixelBox &dst, const F& rowConvert)
 {
-    inline static DstType pixelConvert(SrcType inp)
+    const size_t srcElemSize = Ogre::PixelUtil::getNumElemBytes(src.format);
+    const size_t dstElemSize = Ogre::PixelUtil::getNumElemBytes(dst.format);
+    const Ogre::uchar *srcptr = src.getTopLeftFrontPixelPtr();
+    Ogre::uchar *dstptr = dst.getTopLeftFrontPixelPtr();
+    const size_t k = src.right - src.left;
+    for(size_t z=0; z<src.getDepth(); z++)
     {
-        return inp | 0xFF000000;
+        for(size_t y=0; y<src.getHeight(); y++)
+        {
+            rowConvert(srcptr + (y * src.rowPitch + z * src.slicePitch) * srcElemSize,
+                       dstptr + (y * dst.rowPitch + z * dst.slicePitch) * dstElemSize, k);
+        }
     }
-};
-struct X8R8G8B8toA8B8G8R8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_X8R8G8B8, Ogre::PF_A8B8G8R8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x0000FF)<<16)|((inp&0xFF0000)>>16)|(inp&0x00FF00)|0xFF000000;
+}
+
+/// Moves the 8 bit channels of native endian 32 bit pixels to new positions
+struct Swizzle32
+{
+    Ogre::uint32 srcShift[4];
+    Ogre::uint32 dstShift[4];
+    /// number of channels copied from the source
+    int channels;
+    /// value or-ed into every pixel, used to set alpha for X8 sources
+    Ogre::uint32 fill;
+
+    void operator()(const Ogre::uchar* srcRow, Ogre::uchar* dstRow, size_t count) const
+    {
+        const Ogre::uint32* src = reinterpret_cast<const Ogre::uint32*>(srcRow);
+        Ogre::uint32* dst = reinterpret_cast<Ogre::uint32*>(dstRow);
+        size_t x = 0;
+#if OGRE_IMAGE_SSE2
+        const __m128i mask = _mm_set1_epi32(0xFF);
+        const __m128i fillv = _mm_set1_epi32(int(fill));
+        __m128i shr[4], shl[4];
+        for (int c = 0; c < channels; c++)
+        {
+            shr[c] = _mm_cvtsi32_si128(int(srcShift[c]));
+            shl[c] = _mm_cvtsi32_si128(int(dstShift[c]));
+        }
+        for (; x + 4 <= count; x += 4)
+        {
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+            __m128i r = fillv;
+            for (int c = 0; c < channels; c++)
+                r = _mm_or_si128(r, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(p, shr[c]), mask), shl[c]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), r);
+        }
+#elif OGRE_IMAGE_NEON
+        const uint32x4_t mask = vdupq_n_u32(0xFF);
+        const uint32x4_t fillv = vdupq_n_u32(fill);
+        int32x4_t shr[4], shl[4];
+        for (int c = 0; c < channels; c++)
+        {
+            // vshlq shifts right for negative counts
+            shr[c] = vdupq_n_s32(-int(srcShift[c]));
+            shl[c] = vdupq_n_s32(int(dstShift[c]));
+        }
+        for (; x + 4 <= count; x += 4)
+        {
+            uint32x4_t p = vld1q_u32(src + x);
+            uint32x4_t r = fillv;
+            for (int c = 0; c < channels; c++)
+                r = vorrq_u32(r, vshlq_u32(vandq_u32(vshlq_u32(p, shr[c]), mask), shl[c]));
+            vst1q_u32(dst + x, r);
+        }
+#endif
+        for (; x < count; x++)
+        {
+            Ogre::uint32 r = fill;
+            for (int c = 0; c < channels; c++)
+                r |= ((src[x] >> srcShift[c]) & 0xFF) << dstShift[c];
+            dst[x] = r;
+        }
+    }
+};
+
+/// Converts float16 components to float32, bit exact with Bitwise::halfToFloat
+inline void HalfToFloatRow(const Ogre::uint16* src, Ogre::uint32* dst, size_t count)
+{
+    size_t x = 0;
+    // only normals and zeros are vectorised, anything else takes the scalar path
+#if OGRE_IMAGE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i expMask = _mm_set1_epi32(0x7C00);
+    for (; x + 4 <= count; x += 4)
+    {
+        __m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x)), zero);
+        __m128i e = _mm_and_si128(h, expMask);
+        __m128i mag = _mm_and_si128(h, _mm_set1_epi32(0x7FFF));
+        __m128i isZero = _mm_cmpeq_epi32(mag, zero);
+        __m128i special = _mm_or_si128(_mm_andnot_si128(isZero, _mm_cmpeq_epi32(e, zero)),
+                                       _mm_cmpeq_epi32(e, expMask));
+        if (_mm_movemask_epi8(special))
+        {
+            for (size_t i = x; i < x + 4; i++)
+                dst[i] = Ogre::Bitwise::halfToFloatI(src[i]);
+            continue;
+        }
+        __m128i f = _mm_add_epi32(_mm_slli_epi32(mag, 13), _mm_set1_epi32((127 - 15) << 23));
+        f = _mm_andnot_si128(isZero, f);
+        f = _mm_or_si128(f, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), f);
+    }
+#elif OGRE_IMAGE_NEON
+    const uint32x4_t zero = vdupq_n_u32(0);
+    const uint32x4_t expMask = vdupq_n_u32(0x7C00);
+    for (; x + 4 <= count; x += 4)
+    {
+        uint32x4_t h = vmovl_u16(vld1_u16(src + x));
+        uint32x4_t e = vandq_u32(h, expMask);
+        uint32x4_t mag = vandq_u32(h, vdupq_n_u32(0x7FFF));
+        uint32x4_t isZero = vceqq_u32(mag, zero);
+        uint32x4_t special = vorrq_u32(vbicq_u32(vceqq_u32(e, zero), isZero), vceqq_u32(e, expMask));
+        uint32x2_t any = vorr_u32(vget_low_u32(special), vget_high_u32(special));
+        if (vget_lane_u32(vpmax_u32(any, any), 0))
+        {
+            for (size_t i = x; i < x + 4; i++)
+                dst[i] = Ogre::Bitwise::halfToFloatI(src[i]);
+            continue;
+        }
+        uint32x4_t f = vaddq_u32(vshlq_n_u32(mag, 13), vdupq_n_u32((127 - 15) << 23));
+        f = vbicq_u32(f, isZero);
+        f = vorrq_u32(f, vshlq_n_u32(vandq_u32(h, vdupq_n_u32(0x8000)), 16));
+        vst1q_u32(dst + x, f);
     }
-};
-struct X8R8G8B8toB8G8R8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_X8R8G8B8, Ogre::PF_B8G8R8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
-    {
-        return ((inp&0x0000FF)<<24)|((inp&0xFF0000)>>8)|((inp&0x00FF00)<<8)|0x000000FF;
+#endif
+    for (; x < count; x++)
+        dst[x] = Ogre::Bitwise::halfToFloatI(src[x]);
+}
+
+/// Converts float32 components to float16, bit exact with Bitwise::floatToHalf
+inline void FloatToHalfRow(const Ogre::uint32* src, Ogre::uint16* dst, size_t count)
+{
+    size_t x = 0;
+    // normals and values that flush to zero are vectorised, anything else
+    // (denormals, overflow, inf, nan) takes the scalar path
+#if OGRE_IMAGE_SSE2
+    for (; x + 4 <= count; x += 4)
+    {
+        __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        __m128i e = _mm_and_si128(_mm_srli_epi32(i, 23), _mm_set1_epi32(0xFF));
+        __m128i normal = _mm_and_si128(_mm_cmpgt_epi32(e, _mm_set1_epi32(127 - 15)),
+                                       _mm_cmplt_epi32(e, _mm_set1_epi32(127 - 15 + 31)));
+        __m128i tiny = _mm_cmplt_epi32(e, _mm_set1_epi32(127 - 15 - 10));
+        if (_mm_movemask_epi8(_mm_or_si128(normal, tiny)) != 0xFFFF)
+        {
+            for (size_t j = x; j < x + 4; j++)
+                dst[j] = Ogre::Bitwise::floatToHalfI(src[j]);
+            continue;
+        }
+        __m128i h = _mm_sub_epi32(_mm_srli_epi32(_mm_and_si128(i, _mm_set1_epi32(0x7FFFFFFF)), 13),
+                                  _mm_set1_epi32((127 - 15) << 10));
+        h = _mm_or_si128(h, _mm_and_si128(_mm_srli_epi32(i, 16), _mm_set1_epi32(0x8000)));
+        h = _mm_and_si128(h, normal);
+        // sign extend so the saturating pack keeps the bit pattern
+        h = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packs_epi32(h, h));
+    }
+#elif OGRE_IMAGE_NEON
+    for (; x + 4 <= count; x += 4)
+    {
+        uint32x4_t i = vld1q_u32(src + x);
+        uint32x4_t e = vandq_u32(vshrq_n_u32(i, 23), vdupq_n_u32(0xFF));
+        uint32x4_t normal = vandq_u32(vcgtq_u32(e, vdupq_n_u32(127 - 15)),
+                                      vcltq_u32(e, vdupq_n_u32(127 - 15 + 31)));
+        uint32x4_t tiny = vcltq_u32(e, vdupq_n_u32(127 - 15 - 10));
+        uint32x4_t ok = vorrq_u32(normal, tiny);
+        uint32x2_t all = vand_u32(vget_low_u32(ok), vget_high_u32(ok));
+        if (!vget_lane_u32(vpmin_u32(all, all), 0))
+        {
+            for (size_t j = x; j < x + 4; j++)
+                dst[j] = Ogre::Bitwise::floatToHalfI(src[j]);
+            continue;
+        }
+        uint32x4_t h = vsubq_u32(vshrq_n_u32(vandq_u32(i, vdupq_n_u32(0x7FFFFFFF)), 13),
+                                 vdupq_n_u32((127 - 15) << 10));
+        h = vorrq_u32(h, vandq_u32(vshrq_n_u32(i, 16), vdupq_n_u32(0x8000)));
+        h = vandq_u32(h, normal);
+        vst1_u16(dst + x, vmovn_u32(h));
     }
-};
-struct X8R8G8B8toR8G8B8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_X8R8G8B8, Ogre::PF_R8G8B8A8)>
+#endif
+    for (; x < count; x++)
+        dst[x] = Ogre::Bitwise::floatToHalfI(src[x]);
+}
+
+inline bool isByteSwizzleFormat(Ogre::PixelFormat fmt)
 {
-    inline static DstType pixelConvert(SrcType inp)
+    switch (fmt)
     {
-        return ((inp&0xFFFFFF)<<8)|0x000000FF;
+    case Ogre::PF_A8R8G8B8: case Ogre::PF_A8B8G8R8:
+    case Ogre::PF_B8G8R8A8: case Ogre::PF_R8G8B8A8:
+    case Ogre::PF_X8R8G8B8: case Ogre::PF_X8B8G8R8:
+        return true;
+    default:
+        return false;
     }
-};
+}
 
-// X8B8G8R8
-struct X8B8G8R8toA8R8G8B8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_X8B8G8R8, Ogre::PF_A8R8G8B8)>
+/// component count if fmt is one of the float16/float32 formats, 0 otherwise
+inline size_t getFloatComponentCount(Ogre::PixelFormat fmt, bool half)
 {
-    inline static DstType pixelConvert(SrcType inp)
+    switch (fmt)
     {
-        return ((inp&0x0000FF)<<16)|((inp&0xFF0000)>>16)|(inp&0x00FF00)|0xFF000000;
+    case Ogre::PF_FLOAT16_R: return half ? 1 : 0;
+    case Ogre::PF_FLOAT16_GR: return half ? 2 : 0;
+    case Ogre::PF_FLOAT16_RGB: return half ? 3 : 0;
+    case Ogre::PF_FLOAT16_RGBA: return half ? 4 : 0;
+    case Ogre::PF_FLOAT32_R: return half ? 0 : 1;
+    case Ogre::PF_FLOAT32_GR: return half ? 0 : 2;
+    case Ogre::PF_FLOAT32_RGB: return half ? 0 : 3;
+    case Ogre::PF_FLOAT32_RGBA: return half ? 0 : 4;
+    default:
+        return 0;
     }
-};
-struct X8B8G8R8toA8B8G8R8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_X8B8G8R8, Ogre::PF_A8B8G8R8)>
+}
+
+/// Conversions with a row kernel. Returns 1 if the conversion was handled.
+inline int doRowConversion(const Ogre::PixelBox &src, const Ogre::PixelBox &dst)
 {
-    inline static DstType pixelConvert(SrcType inp)
+    using namespace Ogre;
+    if (isByteSwizzleFormat(src.format) && isByteSwizzleFormat(dst.format))
     {
-        return inp | 0xFF000000;
+        uchar srcShift[4], dstShift[4];
+        PixelUtil::getBitShifts(src.format, srcShift);
+        PixelUtil::getBitShifts(dst.format, dstShift);
+        Swizzle32 swizzle;
+        swizzle.channels = PixelUtil::hasAlpha(src.format) ? 4 : 3;
+        swizzle.fill = PixelUtil::hasAlpha(src.format) ? 0 : 0xFFu << dstShift[3];
+        for (int c = 0; c < 4; c++)
+        {
+            swizzle.srcShift[c] = srcShift[c];
+            swizzle.dstShift[c] = dstShift[c];
+        }
+        PixelBoxRowConverter(src, dst, swizzle);
+        return 1;
     }
-};
-struct X8B8G8R8toB8G8R8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_X8B8G8R8, Ogre::PF_B8G8R8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
+
+    size_t components = getFloatComponentCount(src.format, true);
+    if (components && components == getFloatComponentCount(dst.format, false))
     {
-        return ((inp&0xFFFFFF)<<8)|0x000000FF;
+        PixelBoxRowConverter(src, dst, [components](const uchar* s, uchar* d, size_t count) {
+            HalfToFloatRow(reinterpret_cast<const uint16*>(s), reinterpret_cast<uint32*>(d),
+                           count * components);
+        });
+        return 1;
     }
-};
-struct X8B8G8R8toR8G8B8A8: public PixelConverter <Ogre::uint32, Ogre::uint32, FMTCONVERTERID(Ogre::PF_X8B8G8R8, Ogre::PF_R8G8B8A8)>
-{
-    inline static DstType pixelConvert(SrcType inp)
+
+    components = getFloatComponentCount(src.format, false);
+    if (components && components == getFloatComponentCount(dst.format, true))
     {
-        return ((inp&0x0000FF)<<24)|((inp&0xFF0000)>>8)|((inp&0x00FF00)<<8)|0x000000FF;
+        PixelBoxRowConverter(src, dst, [components](const uchar* s, uchar* d, size_t count) {
+            FloatToHalfRow(reinterpret_cast<const uint32*>(s), reinterpret_cast<uint16*>(d),
+                           count * components);
+        });
+        return 1;
     }
-};
+
+    return 0;
+}
 
 
 #define CASECONVERTER(type) case type::ID : PixelBoxConverter<type>::conversion(src, dst); return 1;
 
 inline int doOptimizedConversion(const Ogre::PixelBox &src, const Ogre::PixelBox &dst)
-{;
+{
+    if(doRowConversion(src, dst))
+        return 1;
+
     switch(FMTCONVERTERID(src.format, dst.format))
     {
         // Register converters here
-        CASECONVERTER(A8R8G8B8toA8B8G8R8);
-        CASECONVERTER(A8R8G8B8toB8G8R8A8);
-        CASECONVERTER(A8R8G8B8toR8G8B8A8);
-        CASECONVERTER(A8B8G8R8toA8R8G8B8);
-        CASECONVERTER(A8B8G8R8toB8G8R8A8);
-        CASECONVERTER(A8B8G8R8toR8G8B8A8);
-        CASECONVERTER(B8G8R8A8toA8R8G8B8);
-        CASECONVERTER(B8G8R8A8toA8B8G8R8);
-        CASECONVERTER(B8G8R8A8toR8G8B8A8);
-        CASECONVERTER(R8G8B8A8toA8R8G8B8);
-        CASECONVERTER(R8G8B8A8toA8B8G8R8);
-        CASECONVERTER(R8G8B8A8toB8G8R8A8);
         CASECONVERTER(A8B8G8R8toR8);
         CASECONVERTER(R8toA8B8G8R8);
         CASECONVERTER(A8R8G8B8toR8);
@@ -470,14 +570,6 @@ inline int doOptimizedConversion(const Ogre::PixelBox &src, const Ogre::PixelBox
         CASECONVERTER(B8G8R8toB8G8R8A8);
         CASECONVERTER(A8R8G8B8toR8G8B8);
         CASECONVERTER(A8R8G8B8toB8G8R8);
-        CASECONVERTER(X8R8G8B8toA8R8G8B8);
-        CASECONVERTER(X8R8G8B8toA8B8G8R8);
-        CASECONVERTER(X8R8G8B8toB8G8R8A8);
-        CASECONVERTER(X8R8G8B8toR8G8B8A8);
-        CASECONVERTER(X8B8G8R8toA8R8G8B8);
-        CASECONVERTER(X8B8G8R8toA8B8G8R8);
-        CASECONVERTER(X8B8G8R8toB8G8R8A8);
-        CASECONVERTER(X8B8G8R8toR8G8B8A8);
 
         default:
             return 0;
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgrePixelFormat.h"
 #include "OgrePixelFormatDescriptions.h"
+#include "OgreImageProcessing.h"
 
 namespace {
 #include "OgrePixelConversions.h"
@@ -658,6 +659,56 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    /* Convert a band of rows, see bulkPixelConversion */
+    static void convertRows(const PixelBox &src, const PixelBox &dst)
+    {
+// NB VC6 can't handle the templates required for optimised conversion, tough
+#if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
+        // Is there a specialized, inlined, conversion?
+        if(doOptimizedConversion(src, dst))
+        {
+            // If so, good
+            return;
+        }
+#endif
+
+        const size_t srcPixelSize = PixelUtil::getNumElemBytes(src.format);
+        const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
+        uint8 *srcptr = src.data
+            + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * srcPixelSize;
+        uint8 *dstptr = dst.data
+            + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * dstPixelSize;
+        
+        // Old way, not taking into account box dimensions
+        //uint8 *srcptr = static_cast<uint8*>(src.data), *dstptr = static_cast<uint8*>(dst.data);
+
+        // Calculate pitches+skips in bytes
+        const size_t srcRowSkipBytes = src.getRowSkip()*srcPixelSize;
+        const size_t srcSliceSkipBytes = src.getSliceSkip()*srcPixelSize;
+        const size_t dstRowSkipBytes = dst.getRowSkip()*dstPixelSize;
+        const size_t dstSliceSkipBytes = dst.getSliceSkip()*dstPixelSize;
+
+        // The brute force fallback
+        float r = 0, g = 0, b = 0, a = 1;
+        for(size_t z=src.front; z<src.back; z++)
+        {
+            for(size_t y=src.top; y<src.bottom; y++)
+            {
+                for(size_t x=src.left; x<src.right; x++)
+                {
+                    PixelUtil::unpackColour(&r, &g, &b, &a, src.format, srcptr);
+                    PixelUtil::packColour(r, g, b, a, dst.format, dstptr);
+                    srcptr += srcPixelSize;
+                    dstptr += dstPixelSize;
+                }
+                srcptr += srcRowSkipBytes;
+                dstptr += dstRowSkipBytes;
+            }
+            srcptr += srcSliceSkipBytes;
+            dstptr += dstSliceSkipBytes;
+        }
+    }
+    //-----------------------------------------------------------------------
     /* Convert pixels from one format to another */
     void PixelUtil::bulkPixelConversion(const PixelBox &src, const PixelBox &dst)
     {
@@ -746,51 +797,17 @@ namespace Ogre {
             return;
         }
 
-// NB VC6 can't handle the templates required for optimised conversion, tough
-#if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
-        // Is there a specialized, inlined, conversion?
-        if(doOptimizedConversion(src, dst))
-        {
-            // If so, good
-            return;
-        }
-#endif
-
-        const size_t srcPixelSize = PixelUtil::getNumElemBytes(src.format);
-        const size_t dstPixelSize = PixelUtil::getNumElemBytes(dst.format);
-        uint8 *srcptr = src.data
-            + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * srcPixelSize;
-        uint8 *dstptr = dst.data
-            + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * dstPixelSize;
-        
-        // Old way, not taking into account box dimensions
-        //uint8 *srcptr = static_cast<uint8*>(src.data), *dstptr = static_cast<uint8*>(dst.data);
-
-        // Calculate pitches+skips in bytes
-        const size_t srcRowSkipBytes = src.getRowSkip()*srcPixelSize;
-        const size_t srcSliceSkipBytes = src.getSliceSkip()*srcPixelSize;
-        const size_t dstRowSkipBytes = dst.getRowSkip()*dstPixelSize;
-        const size_t dstSliceSkipBytes = dst.getSliceSkip()*dstPixelSize;
-
-        // The brute force fallback
-        float r = 0, g = 0, b = 0, a = 1;
-        for(size_t z=src.front; z<src.back; z++)
-        {
-            for(size_t y=src.top; y<src.bottom; y++)
-            {
-                for(size_t x=src.left; x<src.right; x++)
-                {
-                    unpackColour(&r, &g, &b, &a, src.format, srcptr);
-                    packColour(r, g, b, a, dst.format, dstptr);
-                    srcptr += srcPixelSize;
-                    dstptr += dstPixelSize;
-                }
-                srcptr += srcRowSkipBytes;
-                dstptr += dstRowSkipBytes;
-            }
-            srcptr += srcSliceSkipBytes;
-            dstptr += dstSliceSkipBytes;
-        }
+        // Large images are converted in bands of rows, in parallel
+        size_t bytes = getMemorySize(dst.getWidth(), dst.getHeight(), dst.getDepth(), dst.format);
+        processRowBands(src.getHeight(), bytes, [&src, &dst](size_t begin, size_t end) {
+            PixelBox srcBand = src;
+            PixelBox dstBand = dst;
+            srcBand.top = src.top + uint32(begin);
+            srcBand.bottom = src.top + uint32(end);
+            dstBand.top = dst.top + uint32(begin);
+            dstBand.bottom = dst.top + uint32(end);
+            convertRows(srcBand, dstBand);
+        });
     }
     //-----------------------------------------------------------------------
     void PixelUtil::bulkPixelVerticalFlip(const PixelBox &box)
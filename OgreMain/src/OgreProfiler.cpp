@@ -40,6 +40,7 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 */
 
 #include "OgreTimer.h"
+#include "OgreStringConverter.h"
 
 #ifdef USE_REMOTERY
 #include "Remotery.h"
@@ -47,6 +48,77 @@ static Remotery* rmt;
 #endif
 
 namespace Ogre {
+    /// The ring buffer of trace events recorded by a thread
+    struct Profiler::ThreadTrace
+    {
+        /// Deepest nesting of profiles tracked per thread
+        static const uint32 MAX_DEPTH = 64;
+
+        /// The recorded events, allocated when the thread records the first one
+        std::vector<ProfileTraceEvent> events;
+        /// Number of events recorded so far, event n is stored at n % events.size()
+        std::atomic<uint64> numWritten;
+        /// Events before this one were discarded by clearTrace
+        std::atomic<uint64> numCleared;
+        /// Whether a thread is recording into this buffer
+        std::atomic<bool> inUse;
+
+        /// The profiles begun by the thread, but not yet ended
+        const char* openNames[MAX_DEPTH];
+        uint64 openTimes[MAX_DEPTH];
+        uint32 depth;
+
+        /// The entries of Profiler::mTraceNames used by the thread, so only new names take the lock
+        std::unordered_map<String, const char*> names;
+
+        uint32 index;
+        /// guarded by Profiler::mTraceMutex
+        String name;
+
+        explicit ThreadTrace(uint32 _index)
+            : numWritten(0), numCleared(0), inUse(true), depth(0), index(_index)
+        {
+        }
+    };
+
+    namespace
+    {
+        std::atomic<uint64> gNextTraceId(1);
+
+        /// Releases the trace buffer of a thread once it exits, so the next thread can reuse it
+        struct ThreadTraceHandle
+        {
+            uint64 profilerId;
+            std::shared_ptr<void> trace;
+            std::atomic<bool>* inUse;
+
+            ThreadTraceHandle() : profilerId(0), inUse(NULL) {}
+            ~ThreadTraceHandle() { release(); }
+            void release()
+            {
+                if (inUse)
+                    inUse->store(false);
+                trace.reset();
+                inUse = NULL;
+            }
+        };
+        thread_local ThreadTraceHandle gThreadTrace;
+
+        void writeJsonString(std::ostream& stream, const char* str)
+        {
+            stream << '"';
+            for (; *str; ++str)
+            {
+                if (*str == '"' || *str == '\\')
+                    stream << '\\' << *str;
+                else if (uchar(*str) < 0x20)
+                    stream << "\\u00" << "0123456789abcdef"[*str >> 4] << "0123456789abcdef"[*str & 0xF];
+                else
+                    stream << *str;
+            }
+            stream << '"';
+        }
+    }
     //-----------------------------------------------------------------------
     // PROFILE DEFINITIONS
     //-----------------------------------------------------------------------
@@ -78,8 +150,13 @@ namespace Ogre {
         , mMaxTotalFrameTime(0)
         , mAverageFrameTime(0)
         , mResetExtents(false)
+        , mMainThread(std::this_thread::get_id())
+        , mTraceEnabled(false)
+        , mTraceBufferSize(65536)
+        , mTraceId(gNextTraceId++)
     {
         mRoot.hierarchicalLvl = 0 - 1;
+        setTraceThreadName("Main");
 
 #ifdef USE_REMOTERY
         rmt_Settings()->reuse_open_port = true;
@@ -195,7 +272,49 @@ namespace Ogre {
         mDisabledProfiles.erase(profileName);
     }
     //-----------------------------------------------------------------------
-    void Profiler::beginProfile(const String& profileName, uint32 groupID) 
+    void Profiler::beginProfile(const String& profileName, uint32 groupID)
+    {
+        if (mTraceEnabled && (groupID & mProfileMask))
+            beginTraceEvent(getTraceName(profileName));
+
+        beginProfileStats(profileName, groupID);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endProfile(const String& profileName, uint32 groupID)
+    {
+        if (groupID & mProfileMask)
+            endTraceEvent(profileName.c_str());
+
+        endProfileStats(profileName, groupID);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginStaticProfile(const char* profileName, uint32 groupID)
+    {
+        if (mTraceEnabled && (groupID & mProfileMask))
+            beginTraceEvent(profileName);
+
+#ifndef USE_REMOTERY
+        // only copy the name if the statistics need it
+        if (!mEnabled)
+            return;
+#endif
+        beginProfileStats(profileName, groupID);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endStaticProfile(const char* profileName, uint32 groupID)
+    {
+        if (groupID & mProfileMask)
+            endTraceEvent(profileName);
+
+#ifndef USE_REMOTERY
+        // only copy the name if the statistics need it
+        if (!mEnabled && mNewEnableState == mEnabled)
+            return;
+#endif
+        endProfileStats(profileName, groupID);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginProfileStats(const String& profileName, uint32 groupID)
     {
 #ifdef USE_REMOTERY
         // mask groups
@@ -208,6 +327,10 @@ namespace Ogre {
         if (!mEnabled)
             return;
 
+        // the statistics only cover the thread which created the profiler
+        if (std::this_thread::get_id() != mMainThread)
+            return;
+
         // mask groups
         if ((groupID & mProfileMask) == 0)
             return;
@@ -262,7 +385,7 @@ namespace Ogre {
 #endif
     }
     //-----------------------------------------------------------------------
-    void Profiler::endProfile(const String& profileName, uint32 groupID) 
+    void Profiler::endProfileStats(const String& profileName, uint32 groupID)
     {
 #ifdef USE_REMOTERY
         // mask groups
@@ -271,6 +394,10 @@ namespace Ogre {
 
         rmt_EndCPUSample();
 #else
+        // the statistics only cover the thread which created the profiler
+        if (std::this_thread::get_id() != mMainThread)
+            return;
+
         if(!mEnabled) 
         {
             // if the profiler received a request to be enabled or disabled
@@ -372,6 +499,196 @@ namespace Ogre {
 #endif
     }
     //-----------------------------------------------------------------------
+    Profiler::ThreadTrace* Profiler::getThreadTrace()
+    {
+        ThreadTraceHandle& handle = gThreadTrace;
+        if (handle.profilerId == mTraceId)
+            return static_cast<ThreadTrace*>(handle.trace.get());
+
+        // first event of this thread, reuse the buffer of a thread which exited
+        handle.release();
+        std::shared_ptr<ThreadTrace> trace;
+        {
+            OGRE_LOCK_MUTEX(mTraceMutex);
+            for (const auto& t : mThreadTraces)
+            {
+                bool inUse = false;
+                if (t->inUse.compare_exchange_strong(inUse, true))
+                {
+                    trace = t;
+                    break;
+                }
+            }
+
+            if (trace)
+            {
+                trace->depth = 0;
+                trace->name.clear();
+            }
+            else
+            {
+                trace = std::make_shared<ThreadTrace>(uint32(mThreadTraces.size()));
+                mThreadTraces.push_back(trace);
+            }
+        }
+
+        handle.profilerId = mTraceId;
+        handle.inUse = &trace->inUse;
+        handle.trace = trace;
+        return trace.get();
+    }
+    //-----------------------------------------------------------------------
+    const char* Profiler::getTraceName(const String& name)
+    {
+        auto& names = getThreadTrace()->names;
+        auto it = names.find(name);
+        if (it != names.end())
+            return it->second;
+
+        const char* traceName;
+        {
+            OGRE_LOCK_MUTEX(mTraceMutex);
+            traceName = mTraceNames.insert(name).first->c_str();
+        }
+        names.emplace(name, traceName);
+        return traceName;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginTraceEvent(const char* name)
+    {
+        // need a timer to profile!
+        assert (mTimer && "Timer not set!");
+
+        ThreadTrace* trace = getThreadTrace();
+        if (trace->events.empty())
+        {
+            // the exporter reads the buffer while holding the mutex
+            OGRE_LOCK_MUTEX(mTraceMutex);
+            trace->events.resize(std::max<size_t>(mTraceBufferSize, 1));
+        }
+
+        if (trace->depth < ThreadTrace::MAX_DEPTH)
+        {
+            trace->openNames[trace->depth] = name;
+            trace->openTimes[trace->depth] = mTimer->getMicroseconds();
+        }
+        ++trace->depth;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endTraceEvent(const char* name)
+    {
+        // nothing was begun on this thread
+        if (gThreadTrace.profilerId != mTraceId)
+            return;
+
+        ThreadTrace* trace = static_cast<ThreadTrace*>(gThreadTrace.trace.get());
+        if (trace->depth == 0)
+            return;
+
+        if (trace->depth > ThreadTrace::MAX_DEPTH)
+        {
+            // too deep to be recorded
+            --trace->depth;
+            return;
+        }
+
+        // the profile might have begun before the trace was enabled
+        const char* openName = trace->openNames[trace->depth - 1];
+        if (openName != name && strcmp(openName, name) != 0)
+            return;
+
+        --trace->depth;
+        ProfileTraceEvent event = {openName, trace->openTimes[trace->depth], mTimer->getMicroseconds(),
+                                   trace->index};
+        uint64 n = trace->numWritten.load(std::memory_order_relaxed);
+        trace->events[n % trace->events.size()] = event;
+        trace->numWritten.store(n + 1, std::memory_order_release);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::setTraceBufferSize(size_t numEvents)
+    {
+        OgreAssert(numEvents > 0, "the trace buffer must not be empty");
+        mTraceBufferSize = numEvents;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::setTraceThreadName(const String& name)
+    {
+        ThreadTrace* trace = getThreadTrace();
+        OGRE_LOCK_MUTEX(mTraceMutex);
+        trace->name = name;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::getTraceEvents(std::vector<ProfileTraceEvent>& events)
+    {
+        events.clear();
+        {
+            OGRE_LOCK_MUTEX(mTraceMutex);
+            for (const auto& trace : mThreadTraces)
+            {
+                uint64 size = trace->events.size();
+                uint64 end = trace->numWritten.load(std::memory_order_acquire);
+                uint64 begin = std::max(trace->numCleared.load(), end > size ? end - size : 0);
+
+                size_t first = events.size();
+                for (uint64 n = begin; n < end; ++n)
+                    events.push_back(trace->events[n % size]);
+
+                // drop the events the thread overwrote in the meantime
+                uint64 written = trace->numWritten.load(std::memory_order_acquire);
+                if (written > begin + size)
+                {
+                    size_t overwritten = size_t(std::min(written - size - begin, end - begin));
+                    events.erase(events.begin() + first, events.begin() + first + overwritten);
+                }
+            }
+        }
+
+        // parents before their children
+        std::stable_sort(events.begin(), events.end(),
+                         [](const ProfileTraceEvent& a, const ProfileTraceEvent& b) {
+                             return a.begin < b.begin || (a.begin == b.begin && a.end > b.end);
+                         });
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::exportChromeTrace(std::ostream& stream)
+    {
+        std::vector<ProfileTraceEvent> events;
+        getTraceEvents(events);
+
+        stream << "{\"traceEvents\":[";
+        bool first = true;
+        {
+            OGRE_LOCK_MUTEX(mTraceMutex);
+            for (const auto& trace : mThreadTraces)
+            {
+                String name = trace->name.empty() ? "Thread " + StringConverter::toString(trace->index)
+                                                  : trace->name;
+                stream << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+                       << trace->index << ",\"args\":{\"name\":";
+                writeJsonString(stream, name.c_str());
+                stream << "}}";
+                first = false;
+            }
+        }
+
+        for (const ProfileTraceEvent& event : events)
+        {
+            stream << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(stream, event.name);
+            stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread << ",\"ts\":" << event.begin
+                   << ",\"dur\":" << event.end - event.begin << "}";
+            first = false;
+        }
+        stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::clearTrace()
+    {
+        OGRE_LOCK_MUTEX(mTraceMutex);
+        for (const auto& trace : mThreadTraces)
+            trace->numCleared.store(trace->numWritten.load());
+    }
+    //-----------------------------------------------------------------------
     void Profiler::beginGPUEvent(const String& event)
     {
         Root::getSingleton().getRenderSystem()->beginProfileEvent(event);
@@ -46,6 +46,10 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
 #include "OgreDefaultDebugDrawer.h"
+#include "OgreSceneQueryTree.h"
+#include "OgreParallel.h"
+#include "OgreOcclusionBuffer.h"
+#include "OgreTriangleBVH.h"
 
 // This class implements the most basic scene manager
 
@@ -84,6 +88,10 @@ mIlluminationStage(IRS_NONE),
 mLightClippingInfoMapFrameNumber(999),
 mVisibilityMask(0xFFFFFFFF),
 mFindVisibleObjects(true),
+mParallelCulling(false),
+mOcclusionBufferWidth(256),
+mOcclusionBufferHeight(128),
+mSceneQueryTreeEnabled(true),
 mCameraRelativeRendering(false),
 mLastLightHash(0),
 mGpuParamsDirty((uint16)GPV_ALL)
@@ -1180,7 +1188,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
         // Update scene graph for this camera (can happen multiple times per frame)
         {
-            OgreProfileGroup("_updateSceneGraph", OGREPROF_GENERAL);
+            OgreProfileStaticGroup("_updateSceneGraph", OGREPROF_GENERAL);
             _updateSceneGraph(camera);
 
             // Auto-track nodes
@@ -1207,7 +1215,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
             // technique in use
             if (isShadowTechniqueTextureBased() && vp->getShadowsEnabled())
             {
-                OgreProfileGroup("prepareShadowTextures", OGREPROF_GENERAL);
+                OgreProfileStaticGroup("prepareShadowTextures", OGREPROF_GENERAL);
 
                 // *******
                 // WARNING
@@ -1247,13 +1255,13 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
         // Prepare render queue for receiving new objects
         {
-            OgreProfileGroup("prepareRenderQueue", OGREPROF_GENERAL);
+            OgreProfileStaticGroup("prepareRenderQueue", OGREPROF_GENERAL);
             prepareRenderQueue();
         }
 
         if (mFindVisibleObjects)
         {
-            OgreProfileGroup("_findVisibleObjects", OGREPROF_CULLING);
+            OgreProfileStaticGroup("_findVisibleObjects", OGREPROF_CULLING);
 
             // Assemble an AAB on the fly which contains the scene elements visible
             // by the camera.
@@ -1292,7 +1300,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Render scene content
     {
-        OgreProfileGroup("_renderVisibleObjects", OGREPROF_RENDERING);
+        OgreProfileStaticGroup("_renderVisibleObjects", OGREPROF_RENDERING);
         _renderVisibleObjects();
     }
 
@@ -1482,13 +1490,156 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+namespace
+{
+    /// A visible scene node and its depth below the root node
+    struct VisibleNode
+    {
+        SceneNode* node;
+        size_t depth;
+    };
+    typedef std::vector<VisibleNode> VisibleNodeList;
+
+    /// Number of nodes a culling thread should get on average
+    const size_t PARALLEL_CULLING_MIN_NODES = 64;
+
+    /// Appends the visible ones of the given nodes and their children in depth first order
+    void findVisibleNodes(const SceneManager* sm, const Camera* cam, Node* const* nodes, size_t count,
+                          size_t depth, VisibleNodeList& visibleNodes)
+    {
+        const size_t BATCH_SIZE = 16;
+        const AxisAlignedBox* bounds[BATCH_SIZE];
+        bool visible[BATCH_SIZE];
+
+        for (size_t first = 0; first < count; first += BATCH_SIZE)
+        {
+            size_t num = std::min(count - first, BATCH_SIZE);
+            for (size_t i = 0; i < num; ++i)
+                bounds[i] = &static_cast<SceneNode*>(nodes[first + i])->_getWorldAABB();
+            cam->isVisible(bounds, num, visible);
+
+            for (size_t i = 0; i < num; ++i)
+            {
+                if (!visible[i] || sm->_isOccluded(cam, *bounds[i]))
+                    continue;
+
+                SceneNode* node = static_cast<SceneNode*>(nodes[first + i]);
+                visibleNodes.push_back({node, depth});
+                const Node::ChildNodeMap& children = node->getChildren();
+                if (!children.empty())
+                    findVisibleNodes(sm, cam, children.data(), children.size(), depth + 1, visibleNodes);
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
-    // Tell nodes to find, cascade down all nodes
-    getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
-        mDisplayNodes, onlyShadowCasters);
+    _updateOcclusionBuffer(cam, onlyShadowCasters);
+
+    // small scenes are culled faster than the work is handed to the workers
+    if (!mParallelCulling || mSceneNodes.size() < 2 * PARALLEL_CULLING_MIN_NODES)
+    {
+        // Tell nodes to find, cascade down all nodes
+        getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true,
+            mDisplayNodes, onlyShadowCasters);
+        return;
+    }
+
+    // This also brings the frustum planes up to date before the workers read them
+    SceneNode* root = getRootSceneNode();
+    if (!cam->isVisible(root->_getWorldAABB()) || _isOccluded(cam, root->_getWorldAABB()))
+        return;
+
+    // Cull the subtrees below the root node in parallel. Each range of subtrees
+    // stores its visible nodes at the index of its first subtree.
+    const Node::ChildNodeMap& children = root->getChildren();
+    std::vector<VisibleNodeList> rangeNodes(children.size());
+    size_t minChildren = (children.size() * PARALLEL_CULLING_MIN_NODES + mSceneNodes.size() - 1) / mSceneNodes.size();
+    parallelFor(children.size(), minChildren, [&](size_t begin, size_t end) {
+        findVisibleNodes(this, cam, children.data() + begin, end - begin, 1, rangeNodes[begin]);
+    });
+
+    // Queue the objects in the order of SceneNode::_findVisibleObjects, including
+    // drawing each node after its children
+    DebugDrawer* debugDrawer = getDebugDrawer();
+    std::vector<SceneNode*> openNodes;
+    auto processNode = [&](const VisibleNode& visibleNode) {
+        if (debugDrawer)
+        {
+            for (; openNodes.size() > visibleNode.depth; openNodes.pop_back())
+                debugDrawer->drawSceneNode(openNodes.back());
+            openNodes.push_back(visibleNode.node);
+        }
 
+        for (MovableObject* mo : visibleNode.node->getAttachedObjects())
+            getRenderQueue()->processVisibleObject(mo, cam, onlyShadowCasters, visibleBounds);
+    };
+
+    processNode({root, 0});
+    for (const VisibleNodeList& visibleNodes : rangeNodes)
+    {
+        for (const VisibleNode& visibleNode : visibleNodes)
+            processNode(visibleNode);
+    }
+    for (; !openNodes.empty(); openNodes.pop_back())
+        debugDrawer->drawSceneNode(openNodes.back());
+}
+//-----------------------------------------------------------------------
+void SceneManager::setOcclusionCullingEnabled(bool enabled)
+{
+    if (!enabled)
+        mOcclusionBuffer.reset();
+    else if (!mOcclusionBuffer)
+        mOcclusionBuffer.reset(new OcclusionBuffer(mOcclusionBufferWidth, mOcclusionBufferHeight));
+}
+//-----------------------------------------------------------------------
+void SceneManager::setOcclusionBufferSize(uint32 width, uint32 height)
+{
+    OgreAssert(width > 0 && height > 0, "the occlusion buffer must not be empty");
+    mOcclusionBufferWidth = width;
+    mOcclusionBufferHeight = height;
+    if (mOcclusionBuffer)
+        mOcclusionBuffer.reset(new OcclusionBuffer(width, height));
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifyOccluder(Entity* ent, bool add)
+{
+    if (add)
+        mOccluders.push_back(ent);
+    else
+        mOccluders.erase(std::remove(mOccluders.begin(), mOccluders.end(), ent), mOccluders.end());
+}
+//-----------------------------------------------------------------------
+void SceneManager::_updateOcclusionBuffer(const Camera* cam, bool onlyShadowCasters)
+{
+    if (!mOcclusionBuffer)
+        return;
+
+    // shadow casters must not disappear behind occluders of the camera view
+    if (onlyShadowCasters || !mOcclusionBuffer->begin(cam))
+    {
+        mOcclusionBuffer->reset();
+        return;
+    }
+
+    for (Entity* ent : mOccluders)
+    {
+        if (!ent->isInScene() || !cam->isVisible(ent->getWorldBoundingBox(true)))
+            continue;
+
+        const MeshPtr& mesh = ent->getOccluderMesh();
+        mesh->load();
+        for (SubMesh* sub : mesh->getSubMeshes())
+            mOcclusionBuffer->addOccluder(sub->_getTriangleBVH()->getVertices(), ent->_getParentNodeFullTransform());
+    }
+    mOcclusionBuffer->rasterise();
+}
+//-----------------------------------------------------------------------
+bool SceneManager::_isOccluded(const Camera* cam, const AxisAlignedBox& box) const
+{
+    return mOcclusionBuffer && mOcclusionBuffer->getCamera() == cam && mOcclusionBuffer->isOccluded(box);
 }
 //-----------------------------------------------------------------------
 void SceneManager::renderVisibleObjectsDefaultSequence(void)
@@ -3343,6 +3494,30 @@ void SceneManager::destroyQuery(SceneQuery* query)
     OGRE_DELETE query;
 }
 //---------------------------------------------------------------------
+void SceneManager::setSceneQueryTreeEnabled(bool enabled)
+{
+    mSceneQueryTreeEnabled = enabled;
+    if (!enabled)
+        mSceneQueryTree.reset();
+}
+//---------------------------------------------------------------------
+SceneQueryTree* SceneManager::_getSceneQueryTree()
+{
+    if (!mSceneQueryTree && mSceneQueryTreeEnabled)
+    {
+        mSceneQueryTree.reset(new SceneQueryTree());
+
+        OGRE_LOCK_MUTEX(mMovableObjectCollectionMapMutex);
+        for (const auto& coll : mMovableObjectCollectionMap)
+        {
+            OGRE_LOCK_MUTEX(coll.second->mutex);
+            for (const auto& obj : coll.second->map)
+                mSceneQueryTree->addObject(obj.second);
+        }
+    }
+    return mSceneQueryTree.get();
+}
+//---------------------------------------------------------------------
 SceneManager::MovableObjectCollection* 
 SceneManager::getMovableObjectCollection(const String& typeName)
 {
@@ -3410,6 +3585,8 @@ MovableObject* SceneManager::createMovableObject(const String& name,
 
         MovableObject* newObj = factory->createInstance(name, this, params);
         objectMap->map[name] = newObj;
+        if (mSceneQueryTree)
+            mSceneQueryTree->addObject(newObj);
         return newObj;
     }
 
@@ -3467,6 +3644,10 @@ void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
             {
                 factory->destroyInstance(i->second);
             }
+            else if (mSceneQueryTree)
+            {
+                mSceneQueryTree->removeObject(i->second);
+            }
         }
         objectMap->map.clear();
     }
@@ -3498,8 +3679,17 @@ void SceneManager::destroyAllMovableObjects(void)
                 {
                     factory->destroyInstance(i->second);
                 }
+                else if (mSceneQueryTree)
+                {
+                    mSceneQueryTree->removeObject(i->second);
+                }
             }
         }
+        else if (mSceneQueryTree)
+        {
+            for (auto& i : coll->map)
+                mSceneQueryTree->removeObject(i.second);
+        }
         coll->map.clear();
     }
 
@@ -3577,6 +3767,8 @@ void SceneManager::injectMovableObject(MovableObject* m)
             OGRE_LOCK_MUTEX(objectMap->mutex);
 
         objectMap->map[m->getName()] = m;
+        if (mSceneQueryTree)
+            mSceneQueryTree->addObject(m);
     }
 }
 //---------------------------------------------------------------------
@@ -3589,6 +3781,8 @@ void SceneManager::extractMovableObject(const String& name, const String& typeNa
         if (mi != objectMap->map.end())
         {
             // no delete
+            if (mSceneQueryTree)
+                mSceneQueryTree->removeObject(mi->second);
             objectMap->map.erase(mi);
         }
     }
@@ -3606,6 +3800,11 @@ void SceneManager::extractAllMovableObjectsByType(const String& typeName)
     {
             OGRE_LOCK_MUTEX(objectMap->mutex);
         // no deletion
+        if (mSceneQueryTree)
+        {
+            for (auto& i : objectMap->map)
+                mSceneQueryTree->removeObject(i.second);
+        }
         objectMap->map.clear();
     }
 }
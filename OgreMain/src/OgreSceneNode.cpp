@@ -232,6 +232,10 @@ namespace Ogre {
         if (!cam->isVisible(mWorldAABB))
             return;
 
+        // Check whether hidden behind the occluders
+        if (mCreator && mCreator->_isOccluded(cam, mWorldAABB))
+            return;
+
         // Add all entities
         ObjectMap::iterator iobj;
         ObjectMap::iterator iobjend = mObjectsByName.end();
@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreSceneQuery.h"
+#include "OgreEntity.h"
 
 namespace Ogre {
 
@@ -193,6 +194,7 @@ namespace Ogre {
     RaySceneQuery::RaySceneQuery(SceneManager* mgr) : SceneQuery(mgr)
     {
         mSortByDistance = false;
+        mQueryTriangles = false;
         mMaxResults = 0;
     }
     //-----------------------------------------------------------------------
@@ -270,6 +272,17 @@ namespace Ogre {
         dets.distance = distance;
         dets.movable = obj;
         dets.worldFragment = NULL;
+        dets.subMeshIndex = -1;
+        dets.triangleIndex = -1;
+        if (mQueryTriangles && obj->getMovableType() == EntityFactory::FACTORY_TYPE_NAME)
+        {
+            std::pair<bool, Real> hit =
+                static_cast<Entity*>(obj)->intersectTriangles(mRay, &dets.subMeshIndex, &dets.triangleIndex);
+            // only the bounding box was hit
+            if (!hit.first)
+                return true;
+            dets.distance = hit.second;
+        }
         mResult.push_back(dets);
         // Continue
         return true;
@@ -282,6 +295,8 @@ namespace Ogre {
         dets.distance = distance;
         dets.movable = NULL;
         dets.worldFragment = fragment;
+        dets.subMeshIndex = -1;
+        dets.triangleIndex = -1;
         mResult.push_back(dets);
         // Continue
         return true;
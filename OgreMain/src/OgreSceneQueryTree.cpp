@@ -0,0 +1,408 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSceneQueryTree.h"
+
+namespace Ogre {
+    namespace {
+        /// fraction of the size a leaf box is enlarged by on each side
+        const Real FAT_MARGIN = 0.1;
+
+        AxisAlignedBox enlarge(const AxisAlignedBox& box, Real factor)
+        {
+            Vector3 margin = box.getSize() * factor;
+            return AxisAlignedBox(box.getMinimum() - margin, box.getMaximum() + margin);
+        }
+
+        AxisAlignedBox combine(const AxisAlignedBox& a, const AxisAlignedBox& b)
+        {
+            Vector3 min = a.getMinimum(), max = a.getMaximum();
+            min.makeFloor(b.getMinimum());
+            max.makeCeil(b.getMaximum());
+            return AxisAlignedBox(min, max);
+        }
+
+        Real surfaceArea(const AxisAlignedBox& box)
+        {
+            Vector3 size = box.getSize();
+            return 2 * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+    }
+    //---------------------------------------------------------------------
+    SceneQueryTree::SceneQueryTree() : mRoot(NULL_NODE), mFreeList(NULL_NODE), mObjectCount(0) {}
+    //---------------------------------------------------------------------
+    SceneQueryTree::~SceneQueryTree()
+    {
+        for (Node& node : mNodes)
+        {
+            if (node.isLeaf() && node.object)
+            {
+                node.object->mSceneQueryTree = NULL;
+                node.object->mSceneQueryProxy = NULL_NODE;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    int SceneQueryTree::allocateNode()
+    {
+        int node = mFreeList;
+        if (node == NULL_NODE)
+        {
+            node = int(mNodes.size());
+            mNodes.emplace_back();
+        }
+        else
+        {
+            mFreeList = mNodes[node].parent;
+        }
+
+        Node& n = mNodes[node];
+        n.object = NULL;
+        n.parent = n.child1 = n.child2 = NULL_NODE;
+        n.height = 0;
+        n.type = LT_FINITE;
+        return node;
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::freeNode(int node)
+    {
+        mNodes[node].object = NULL;
+        mNodes[node].height = -1;
+        mNodes[node].parent = mFreeList;
+        mFreeList = node;
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::addObject(MovableObject* obj)
+    {
+        // already tracked, possibly by the tree of another SceneManager
+        if (obj->mSceneQueryTree)
+            return;
+
+        int leaf = allocateNode();
+        mNodes[leaf].object = obj;
+        linkLeaf(leaf, obj->getWorldBoundingBox());
+
+        obj->mSceneQueryTree = this;
+        obj->mSceneQueryProxy = leaf;
+        mObjectCount++;
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::removeObject(MovableObject* obj)
+    {
+        if (obj->mSceneQueryTree != this)
+            return;
+
+        int leaf = obj->mSceneQueryProxy;
+        unlinkLeaf(leaf);
+        freeNode(leaf);
+
+        obj->mSceneQueryTree = NULL;
+        obj->mSceneQueryProxy = NULL_NODE;
+        mObjectCount--;
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::updateObject(const MovableObject* obj)
+    {
+        int leaf = obj->mSceneQueryProxy;
+        const AxisAlignedBox& box = obj->getWorldBoundingBox();
+
+        if (box.isFinite() && mNodes[leaf].type == LT_FINITE)
+        {
+            const AxisAlignedBox& fatBox = mNodes[leaf].box;
+            // still inside the enlarged box, which is not way too large either
+            if (fatBox.contains(box) && enlarge(box, 4 * FAT_MARGIN).contains(fatBox))
+                return;
+        }
+        else if ((box.isNull() && mNodes[leaf].type == LT_NULL) ||
+                 (box.isInfinite() && mNodes[leaf].type == LT_INFINITE))
+        {
+            return;
+        }
+
+        unlinkLeaf(leaf);
+        linkLeaf(leaf, box);
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::linkLeaf(int leaf, const AxisAlignedBox& box)
+    {
+        Node& node = mNodes[leaf];
+        if (box.isNull())
+        {
+            node.type = LT_NULL;
+        }
+        else if (box.isInfinite())
+        {
+            node.type = LT_INFINITE;
+            mInfiniteLeaves.push_back(leaf);
+        }
+        else
+        {
+            node.type = LT_FINITE;
+            node.box = enlarge(box, FAT_MARGIN);
+            insertLeaf(leaf);
+        }
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::unlinkLeaf(int leaf)
+    {
+        switch (mNodes[leaf].type)
+        {
+        case LT_FINITE:
+            removeLeaf(leaf);
+            break;
+        case LT_INFINITE:
+            mInfiniteLeaves.erase(std::find(mInfiniteLeaves.begin(), mInfiniteLeaves.end(), leaf));
+            break;
+        case LT_NULL:
+            break;
+        }
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::insertLeaf(int leaf)
+    {
+        if (mRoot == NULL_NODE)
+        {
+            mRoot = leaf;
+            mNodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // find the sibling that increases the surface area of the tree the least
+        AxisAlignedBox leafBox = mNodes[leaf].box;
+        int index = mRoot;
+        while (!mNodes[index].isLeaf())
+        {
+            const Node& node = mNodes[index];
+
+            Real area = surfaceArea(node.box);
+            Real combinedArea = surfaceArea(combine(node.box, leafBox));
+
+            // cost of making a new parent for this node and the leaf
+            Real cost = 2 * combinedArea;
+            // minimum cost of pushing the leaf further down the tree
+            Real inheritanceCost = 2 * (combinedArea - area);
+
+            Real childCost[2];
+            int children[2] = {node.child1, node.child2};
+            for (int i = 0; i < 2; i++)
+            {
+                const Node& child = mNodes[children[i]];
+                Real newArea = surfaceArea(combine(child.box, leafBox));
+                childCost[i] = (child.isLeaf() ? newArea : newArea - surfaceArea(child.box)) + inheritanceCost;
+            }
+
+            if (cost < childCost[0] && cost < childCost[1])
+                break;
+
+            index = childCost[0] < childCost[1] ? children[0] : children[1];
+        }
+
+        int sibling = index;
+        int oldParent = mNodes[sibling].parent;
+        int newParent = allocateNode();
+
+        Node& parent = mNodes[newParent];
+        parent.parent = oldParent;
+        parent.box = combine(leafBox, mNodes[sibling].box);
+        parent.height = mNodes[sibling].height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (mNodes[oldParent].child1 == sibling)
+                mNodes[oldParent].child1 = newParent;
+            else
+                mNodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        refit(newParent);
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::removeLeaf(int leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        int parent = mNodes[leaf].parent;
+        int grandParent = mNodes[parent].parent;
+        int sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        // replace the parent by the sibling
+        if (grandParent != NULL_NODE)
+        {
+            if (mNodes[grandParent].child1 == parent)
+                mNodes[grandParent].child1 = sibling;
+            else
+                mNodes[grandParent].child2 = sibling;
+        }
+        else
+        {
+            mRoot = sibling;
+        }
+        mNodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refit(grandParent);
+    }
+    //---------------------------------------------------------------------
+    void SceneQueryTree::refit(int index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            Node& node = mNodes[index];
+            const Node& child1 = mNodes[node.child1];
+            const Node& child2 = mNodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.box = combine(child1.box, child2.box);
+
+            index = node.parent;
+        }
+    }
+    //---------------------------------------------------------------------
+    int SceneQueryTree::balance(int iA)
+    {
+        Node& A = mNodes[iA];
+        if (A.isLeaf() || A.height < 2)
+            return iA;
+
+        int iB = A.child1;
+        int iC = A.child2;
+        Node& B = mNodes[iB];
+        Node& C = mNodes[iC];
+
+        int balance = C.height - B.height;
+
+        // rotate C up
+        if (balance > 1)
+        {
+            int iF = C.child1;
+            int iG = C.child2;
+            Node& F = mNodes[iF];
+            Node& G = mNodes[iG];
+
+            C.child1 = iA;
+            C.parent = A.parent;
+            A.parent = iC;
+
+            if (C.parent != NULL_NODE)
+            {
+                if (mNodes[C.parent].child1 == iA)
+                    mNodes[C.parent].child1 = iC;
+                else
+                    mNodes[C.parent].child2 = iC;
+            }
+            else
+            {
+                mRoot = iC;
+            }
+
+            if (F.height > G.height)
+            {
+                C.child2 = iF;
+                A.child2 = iG;
+                G.parent = iA;
+                A.box = combine(B.box, G.box);
+                C.box = combine(A.box, F.box);
+                A.height = 1 + std::max(B.height, G.height);
+                C.height = 1 + std::max(A.height, F.height);
+            }
+            else
+            {
+                C.child2 = iG;
+                A.child2 = iF;
+                F.parent = iA;
+                A.box = combine(B.box, F.box);
+                C.box = combine(A.box, G.box);
+                A.height = 1 + std::max(B.height, F.height);
+                C.height = 1 + std::max(A.height, G.height);
+            }
+            return iC;
+        }
+
+        // rotate B up
+        if (balance < -1)
+        {
+            int iD = B.child1;
+            int iE = B.child2;
+            Node& D = mNodes[iD];
+            Node& E = mNodes[iE];
+
+            B.child1 = iA;
+            B.parent = A.parent;
+            A.parent = iB;
+
+            if (B.parent != NULL_NODE)
+            {
+                if (mNodes[B.parent].child1 == iA)
+                    mNodes[B.parent].child1 = iB;
+                else
+                    mNodes[B.parent].child2 = iB;
+            }
+            else
+            {
+                mRoot = iB;
+            }
+
+            if (D.height > E.height)
+            {
+                B.child2 = iD;
+                A.child1 = iE;
+                E.parent = iA;
+                A.box = combine(C.box, E.box);
+                B.box = combine(A.box, D.box);
+                A.height = 1 + std::max(C.height, E.height);
+                B.height = 1 + std::max(A.height, D.height);
+            }
+            else
+            {
+                B.child2 = iE;
+                A.child1 = iD;
+                D.parent = iA;
+                A.box = combine(C.box, D.box);
+                B.box = combine(A.box, E.box);
+                A.height = 1 + std::max(C.height, D.height);
+                B.height = 1 + std::max(A.height, E.height);
+            }
+            return iB;
+        }
+
+        return iA;
+    }
+}
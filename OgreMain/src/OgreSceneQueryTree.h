@@ -0,0 +1,177 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneQueryTree_H__
+#define __SceneQueryTree_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+
+namespace Ogre {
+
+    /** Dynamic AABB tree over the movable objects of a SceneManager, used by the default scene queries.
+
+        The leaves store the world bounding box of an object enlarged by a margin relative to its size,
+        so a moving object only needs to be reinserted once it leaves that box. New leaves are paired
+        with the sibling that increases the surface area of the tree the least and the tree is kept
+        balanced by rotations, so queries only visit O(log n) nodes for small query volumes.
+
+        Objects with an infinite bounding box are kept in a separate list and passed to every query,
+        objects with a null bounding box are tracked but never passed to a query.
+
+        The tree is a broad phase only: a query visits every object whose enlarged box passes the
+        test, the caller then has to check the actual world bounding box of the object.
+    */
+    class SceneQueryTree : public SceneMgtAlloc
+    {
+    public:
+        SceneQueryTree();
+        /// untracks the remaining objects
+        ~SceneQueryTree();
+
+        /// Track the given object, using its current world bounding box
+        void addObject(MovableObject* obj);
+        /// Stop tracking the given object
+        void removeObject(MovableObject* obj);
+        /// Update the leaf of a tracked object after its world bounding box changed
+        void updateObject(const MovableObject* obj);
+
+        /** Visit the tracked objects whose enlarged bounding box passes a test
+        @param test callable as bool(const AxisAlignedBox&), applied to the boxes of the tree nodes
+        @param visitor callable as bool(MovableObject*), return false to stop the query
+        @return false, if the visitor stopped the query
+        */
+        template <typename Test, typename Visitor> bool query(const Test& test, const Visitor& visitor) const
+        {
+            for (int leaf : mInfiniteLeaves)
+            {
+                if (!visitor(mNodes[leaf].object))
+                    return false;
+            }
+
+            if (mRoot == NULL_NODE)
+                return true;
+
+            std::vector<int> stack;
+            stack.reserve(64);
+            stack.push_back(mRoot);
+            while (!stack.empty())
+            {
+                const Node& node = mNodes[stack.back()];
+                stack.pop_back();
+
+                if (!test(node.box))
+                    continue;
+
+                if (node.isLeaf())
+                {
+                    if (!visitor(node.object))
+                        return false;
+                }
+                else
+                {
+                    stack.push_back(node.child1);
+                    stack.push_back(node.child2);
+                }
+            }
+            return true;
+        }
+
+        /** Visit all tracked objects that have a finite or infinite bounding box
+        @param visitor callable as bool(MovableObject*), return false to stop
+        @return false, if the visitor stopped
+        */
+        template <typename Visitor> bool forEachObject(const Visitor& visitor) const
+        {
+            for (const Node& node : mNodes)
+            {
+                if (node.isLeaf() && node.object && node.type != LT_NULL && !visitor(node.object))
+                    return false;
+            }
+            return true;
+        }
+
+        /// Number of tracked objects
+        size_t getObjectCount() const { return mObjectCount; }
+
+        /// Height of the tree, 0 for a single leaf
+        int getHeight() const { return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height; }
+
+    private:
+        static const int NULL_NODE = -1;
+
+        enum LeafType
+        {
+            /// leaf is part of the hierarchy
+            LT_FINITE,
+            /// leaf is in mInfiniteLeaves
+            LT_INFINITE,
+            /// leaf is not visited at all
+            LT_NULL
+        };
+
+        struct Node
+        {
+            /// enlarged bounds of a leaf or the bounds of the children
+            AxisAlignedBox box;
+            /// the tracked object, if this is a leaf
+            MovableObject* object;
+            /// parent node, or the next free node
+            int parent;
+            int child1;
+            int child2;
+            /// 0 for a leaf, -1 for a free node
+            int height;
+            LeafType type;
+
+            bool isLeaf() const { return height == 0; }
+        };
+
+        int allocateNode();
+        void freeNode(int node);
+
+        /// put a leaf into the hierarchy or the infinite list, based on its type
+        void linkLeaf(int leaf, const AxisAlignedBox& box);
+        /// take a leaf out of the hierarchy or the infinite list
+        void unlinkLeaf(int leaf);
+
+        void insertLeaf(int leaf);
+        void removeLeaf(int leaf);
+        /// refit the boxes and heights from the given node up to the root
+        void refit(int node);
+        /// rotate the given node, if its children are unbalanced
+        int balance(int node);
+
+        std::vector<Node> mNodes;
+        std::vector<int> mInfiniteLeaves;
+        int mRoot;
+        int mFreeList;
+        size_t mObjectCount;
+    };
+}
+
+#endif
@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreTriangleBVH.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -162,7 +163,7 @@ namespace Ogre {
         Vector3 mMin, mMax;
         std::set<uint32> mIndices;
 
-        Cluster ()
+        Cluster () : mMin(Vector3::ZERO), mMax(Vector3::ZERO)
         { }
 
         bool empty () const
@@ -418,6 +419,21 @@ namespace Ogre {
         }
         return newSub;
     }
+    //---------------------------------------------------------------------
+    const TriangleBVH* SubMesh::_getTriangleBVH()
+    {
+        if (!mTriangleBVH)
+        {
+            mTriangleBVH.reset(new TriangleBVH(useSharedVertices ? parent->sharedVertexData : vertexData,
+                                               indexData, operationType));
+        }
+        return mTriangleBVH.get();
+    }
+    //---------------------------------------------------------------------
+    void SubMesh::_discardTriangleBVH()
+    {
+        mTriangleBVH.reset();
+    }
 }
 
 
@@ -0,0 +1,268 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreTriangleBVH.h"
+
+namespace Ogre {
+    namespace {
+        /// triangles a leaf is allowed to hold
+        const uint32 MAX_LEAF_TRIANGLES = 4;
+
+        bool intersectsBox(const Vector3& min, const Vector3& max, const Vector3& origin,
+                           const Vector3& invDirection, Real maxDistance)
+        {
+            Real tmin = 0, tmax = maxDistance;
+            for (int i = 0; i < 3; i++)
+            {
+                Real t1 = (min[i] - origin[i]) * invDirection[i];
+                Real t2 = (max[i] - origin[i]) * invDirection[i];
+                tmin = std::max(tmin, std::min(t1, t2));
+                tmax = std::min(tmax, std::max(t1, t2));
+            }
+            return tmin <= tmax;
+        }
+    }
+    //---------------------------------------------------------------------
+    TriangleBVH::TriangleBVH(const VertexData* vertexData, const IndexData* indexData,
+                             RenderOperation::OperationType operationType)
+    {
+        std::vector<Vector3> vertices;
+        readTriangles(vertexData, indexData, operationType, vertices);
+
+        uint32 triangleCount = uint32(vertices.size() / 3);
+        if (triangleCount == 0)
+            return;
+
+        std::vector<Vector3> centroids(triangleCount);
+        mTriangles.resize(triangleCount);
+        for (uint32 i = 0; i < triangleCount; i++)
+        {
+            centroids[i] = (vertices[3 * i] + vertices[3 * i + 1] + vertices[3 * i + 2]) / 3;
+            mTriangles[i] = i;
+        }
+
+        mNodes.reserve(2 * triangleCount / MAX_LEAF_TRIANGLES + 1);
+        build(0, triangleCount, vertices, centroids);
+
+        // store the positions in the order of the leaves
+        mVertices.resize(vertices.size());
+        for (uint32 i = 0; i < triangleCount; i++)
+        {
+            for (int j = 0; j < 3; j++)
+                mVertices[3 * i + j] = vertices[3 * mTriangles[i] + j];
+        }
+    }
+    //---------------------------------------------------------------------
+    uint32 TriangleBVH::build(uint32 begin, uint32 end, const std::vector<Vector3>& vertices,
+                              const std::vector<Vector3>& centroids)
+    {
+        uint32 index = uint32(mNodes.size());
+        mNodes.emplace_back();
+
+        Vector3 min(Math::POS_INFINITY), max(Math::NEG_INFINITY);
+        Vector3 centroidMin(Math::POS_INFINITY), centroidMax(Math::NEG_INFINITY);
+        for (uint32 i = begin; i < end; i++)
+        {
+            uint32 triangle = mTriangles[i];
+            for (int j = 0; j < 3; j++)
+            {
+                min.makeFloor(vertices[3 * triangle + j]);
+                max.makeCeil(vertices[3 * triangle + j]);
+            }
+            centroidMin.makeFloor(centroids[triangle]);
+            centroidMax.makeCeil(centroids[triangle]);
+        }
+        mNodes[index].min = min;
+        mNodes[index].max = max;
+
+        Vector3 extent = centroidMax - centroidMin;
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+        // all centroids at the same spot cannot be split either
+        if (end - begin <= MAX_LEAF_TRIANGLES || extent[axis] <= 0)
+        {
+            mNodes[index].start = begin;
+            mNodes[index].count = end - begin;
+            return index;
+        }
+
+        uint32 mid = (begin + end) / 2;
+        std::nth_element(mTriangles.begin() + begin, mTriangles.begin() + mid, mTriangles.begin() + end,
+                         [&centroids, axis](uint32 a, uint32 b) { return centroids[a][axis] < centroids[b][axis]; });
+
+        build(begin, mid, vertices, centroids);
+        uint32 second = build(mid, end, vertices, centroids);
+        mNodes[index].start = second;
+        mNodes[index].count = 0;
+        return index;
+    }
+    //---------------------------------------------------------------------
+    std::pair<bool, Real> TriangleBVH::intersects(const Ray& ray, Real maxDistance, uint32& triangle) const
+    {
+        std::pair<bool, Real> nearest(false, maxDistance);
+        if (mNodes.empty())
+            return nearest;
+
+        const Vector3& origin = ray.getOrigin();
+        Vector3 invDirection = 1 / ray.getDirection();
+
+        // the depth of a median split hierarchy is logarithmic in the number of triangles
+        uint32 stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            uint32 index = stack[--top];
+            const Node& node = mNodes[index];
+            if (!intersectsBox(node.min, node.max, origin, invDirection, nearest.second))
+                continue;
+
+            if (node.count == 0)
+            {
+                stack[top++] = node.start;
+                stack[top++] = index + 1;
+                continue;
+            }
+
+            for (uint32 i = node.start; i < node.start + node.count; i++)
+            {
+                std::pair<bool, Real> hit =
+                    Math::intersects(ray, mVertices[3 * i], mVertices[3 * i + 1], mVertices[3 * i + 2]);
+                if (hit.first && hit.second < nearest.second)
+                {
+                    nearest = hit;
+                    triangle = mTriangles[i];
+                }
+            }
+        }
+        return nearest;
+    }
+    //---------------------------------------------------------------------
+    std::pair<bool, Real> TriangleBVH::intersects(const Ray& ray, const std::vector<Vector3>& vertices,
+                                                  Real maxDistance, uint32& triangle)
+    {
+        std::pair<bool, Real> nearest(false, maxDistance);
+        for (size_t i = 0; i < vertices.size(); i += 3)
+        {
+            std::pair<bool, Real> hit = Math::intersects(ray, vertices[i], vertices[i + 1], vertices[i + 2]);
+            if (hit.first && hit.second < nearest.second)
+            {
+                nearest = hit;
+                triangle = uint32(i / 3);
+            }
+        }
+        return nearest;
+    }
+    //---------------------------------------------------------------------
+    void TriangleBVH::readTriangles(const VertexData* vertexData, const IndexData* indexData,
+                                    RenderOperation::OperationType operationType,
+                                    std::vector<Vector3>& vertices)
+    {
+        vertices.clear();
+
+        const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        if (!posElem || vertexData->vertexCount == 0)
+            return;
+
+        bool indexed = indexData && indexData->indexCount && indexData->indexBuffer;
+        size_t count = indexed ? indexData->indexCount : vertexData->vertexCount;
+        size_t triangleCount;
+        switch (operationType)
+        {
+        case RenderOperation::OT_TRIANGLE_LIST:
+            triangleCount = count / 3;
+            break;
+        case RenderOperation::OT_TRIANGLE_STRIP:
+        case RenderOperation::OT_TRIANGLE_FAN:
+            triangleCount = count < 3 ? 0 : count - 2;
+            break;
+        default:
+            // no triangles to hit
+            return;
+        }
+
+        OgreAssert(posElem->getType() == VET_FLOAT3, "Positions must be stored as VET_FLOAT3");
+
+        const HardwareVertexBufferSharedPtr& vbuf =
+            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        size_t vertexSize = vbuf->getVertexSize();
+        HardwareBufferLockGuard vertexLock(vbuf, vertexData->vertexStart * vertexSize,
+                                           vertexData->vertexCount * vertexSize, HardwareBuffer::HBL_READ_ONLY);
+        const uchar* vertex = static_cast<const uchar*>(vertexLock.pData);
+
+        HardwareBufferLockGuard indexLock;
+        bool use32bit = false;
+        if (indexed)
+        {
+            const HardwareIndexBufferSharedPtr& ibuf = indexData->indexBuffer;
+            size_t indexSize = ibuf->getIndexSize();
+            indexLock.lock(ibuf.get(), indexData->indexStart * indexSize, indexData->indexCount * indexSize,
+                           HardwareBuffer::HBL_READ_ONLY);
+            use32bit = ibuf->getType() == HardwareIndexBuffer::IT_32BIT;
+        }
+
+        auto getIndex = [&](size_t i) -> size_t {
+            if (!indexed)
+                return i;
+            return use32bit ? static_cast<const uint32*>(indexLock.pData)[i]
+                            : static_cast<const uint16*>(indexLock.pData)[i];
+        };
+
+        vertices.resize(triangleCount * 3);
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            size_t corners[3];
+            switch (operationType)
+            {
+            case RenderOperation::OT_TRIANGLE_STRIP:
+                corners[0] = getIndex(t);
+                corners[1] = getIndex(t + 1);
+                corners[2] = getIndex(t + 2);
+                break;
+            case RenderOperation::OT_TRIANGLE_FAN:
+                corners[0] = getIndex(0);
+                corners[1] = getIndex(t + 1);
+                corners[2] = getIndex(t + 2);
+                break;
+            default:
+                corners[0] = getIndex(3 * t);
+                corners[1] = getIndex(3 * t + 1);
+                corners[2] = getIndex(3 * t + 2);
+                break;
+            }
+
+            for (int j = 0; j < 3; j++)
+            {
+                float* pFloat;
+                posElem->baseVertexPointerToElement(const_cast<uchar*>(vertex) + corners[j] * vertexSize,
+                                                    &pFloat);
+                vertices[3 * t + j] = Vector3(pFloat[0], pFloat[1], pFloat[2]);
+            }
+        }
+    }
+}
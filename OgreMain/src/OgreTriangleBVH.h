@@ -0,0 +1,103 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TriangleBVH_H__
+#define __TriangleBVH_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreRenderOperation.h"
+#include "OgreVector.h"
+
+namespace Ogre {
+
+    /** Bounding volume hierarchy over the triangles of a SubMesh, used for triangle accurate ray queries.
+
+        The positions of the triangles are copied once on construction, so rays can be tested without
+        locking any hardware buffer afterwards. The hierarchy is split at the median of the longest axis
+        and stored depth first, so the first child of a node directly follows it.
+    */
+    class TriangleBVH : public SubMeshAlloc
+    {
+    public:
+        /// Build the hierarchy over the triangles of the given geometry
+        TriangleBVH(const VertexData* vertexData, const IndexData* indexData,
+                    RenderOperation::OperationType operationType);
+
+        /** Find the nearest triangle hit by a ray
+        @param ray the ray, in the space of the vertex positions
+        @param maxDistance only hits closer than this are considered
+        @param triangle receives the index of the triangle hit
+        @return whether a triangle was hit, and the distance along the ray
+        */
+        std::pair<bool, Real> intersects(const Ray& ray, Real maxDistance, uint32& triangle) const;
+
+        /// Three positions per triangle, in the order of the leaves
+        const std::vector<Vector3>& getVertices() const { return mVertices; }
+
+        /** Read the triangles of the given geometry
+        @param vertexData the vertex positions, which must be stored as VET_FLOAT3
+        @param indexData the indices, the vertices are used in order if there are none
+        @param operationType only triangle lists, strips and fans result in triangles
+        @param vertices receives three positions per triangle
+        */
+        static void readTriangles(const VertexData* vertexData, const IndexData* indexData,
+                                  RenderOperation::OperationType operationType, std::vector<Vector3>& vertices);
+
+        /** Find the nearest triangle hit by a ray by testing all of them
+        @param ray the ray, in the space of the vertex positions
+        @param vertices three positions per triangle, as returned by readTriangles
+        @param maxDistance only hits closer than this are considered
+        @param triangle receives the index of the triangle hit
+        @return whether a triangle was hit, and the distance along the ray
+        */
+        static std::pair<bool, Real> intersects(const Ray& ray, const std::vector<Vector3>& vertices,
+                                                Real maxDistance, uint32& triangle);
+
+    private:
+        struct Node
+        {
+            Vector3 min;
+            /// first triangle of a leaf, or the second child of an inner node
+            uint32 start;
+            Vector3 max;
+            /// number of triangles of a leaf, 0 for an inner node
+            uint32 count;
+        };
+
+        /// build the subtree over the given range of mTriangles and return its index
+        uint32 build(uint32 begin, uint32 end, const std::vector<Vector3>& vertices,
+                     const std::vector<Vector3>& centroids);
+
+        std::vector<Node> mNodes;
+        /// three positions per triangle, in the order of the leaves
+        std::vector<Vector3> mVertices;
+        /// index of the triangle in the SubMesh, in the order of the leaves
+        std::vector<uint32> mTriangles;
+    };
+}
+
+#endif
@@ -633,6 +633,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     WorkQueue::Response* DefaultWorkQueueBase::processRequest(Request* r)
     {
+        OgreProfileStaticGroup("WorkQueue::processRequest", OGREPROF_GENERAL);
         RequestHandlerListByChannel handlerListCopy;
         {
             // lock the list only to make a copy of it, to maximise parallelism
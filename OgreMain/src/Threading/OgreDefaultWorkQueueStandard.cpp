@@ -160,6 +160,11 @@ namespace Ogre
             "DefaultWorkQueue('" << getName() << "')::WorkerFunc - thread " 
             << OGRE_THREAD_CURRENT_ID << " starting.";
 
+#if OGRE_PROFILING
+        if (Profiler* profiler = Profiler::getSingletonPtr())
+            profiler->setTraceThreadName("DefaultWorkQueue('" + getName() + "')");
+#endif
+
         // Initialise the thread for RS if necessary
         if (mWorkerRenderSystemAccess)
         {
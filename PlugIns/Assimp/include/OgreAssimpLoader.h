@@ -75,7 +75,10 @@ public:
         LP_CUT_ANIMATION_WHERE_NO_FURTHER_CHANGE = 1 << 0,
 
         // Quiet mode - don't output anything
-        LP_QUIET_MODE = 1 << 1
+        LP_QUIET_MODE = 1 << 1,
+
+        // Reorder triangles and vertices for vertex cache, overdraw and vertex fetch, see MeshOptimiser
+        LP_OPTIMISE_GEOMETRY = 1 << 2
     };
 
     struct Options
@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include <Ogre.h>
 
 #include <OgreCodec.h>
+#include <OgreMeshOptimiser.h>
 
 #ifdef OGRE_BUILD_COMPONENT_RTSHADERSYSTEM
 #include <OgreShaderGenerator.h>
@@ -445,6 +446,11 @@ bool AssimpLoader::_load(const char* name, Assimp::Importer& importer, Mesh* mes
         }
     }
 
+    if (mLoaderParams & LP_OPTIMISE_GEOMETRY)
+    {
+        MeshOptimiser().optimise(mesh);
+    }
+
     // clean up
     mBonesByName.clear();
     mBoneNodesByName.clear();
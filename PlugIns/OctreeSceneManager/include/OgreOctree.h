@@ -58,6 +58,9 @@ This is a loose octree implementation, meaning that each
 octant child of the octree actually overlaps it's siblings by a factor
 of .5.  This guarantees that any thing that is half the size of the parent will
 fit completely into a child, with no splitting necessary.
+@par
+The overlap is controlled by the looseness, the ratio between the culling bounds
+and the actual bounds of an octant, which defaults to 2.
 */
 
 class Octree : public NodeAlloc
@@ -109,10 +112,24 @@ public:
     /** Determines if this octree is twice as big as the given box.
     @remarks
     This method is used by the OctreeSceneManager to determine if the given
-    box will fit into a child of this octree.
+    box will fit into a child of this octree. With a looseness other than 2,
+    the box has to fit into the culling bounds of the child instead.
     */
     bool _isTwiceSize( const AxisAlignedBox &box ) const;
 
+    /** Determines if the given box may be placed into this octree.
+    @remarks
+    This is the case if the centre of the box is within the bounds of the octree and the
+    box is small enough to fit into the culling bounds wherever its centre is.
+    */
+    bool _canHold( const AxisAlignedBox &box ) const;
+
+    /** Determines if the given box is within the culling bounds of this octree.
+    @remarks
+    Nodes stay in their octree as long as this holds, so moving nodes rarely change octrees.
+    */
+    bool _isInCullBounds( const AxisAlignedBox &box ) const;
+
     /**  Returns the appropriate indexes for the child of this octree into which the box will fit.
     @remarks
     This is used by the OctreeSceneManager to determine which child to traverse next when
@@ -127,9 +144,24 @@ public:
     */
     void _getCullBounds( AxisAlignedBox * ) const;
 
+    /** Returns the parent octree, or 0 for the root
+    */
+    Octree * getParent() const
+    {
+        return mParent;
+    };
+
+    /** Ratio between the culling bounds and the bounds of this octree.
+    @remarks
+    Children inherit the looseness of their parent on creation.
+    */
+    Real mLooseness;
+
 
     typedef std::vector< OctreeNode * > NodeList;
     /** Public list of SceneNodes attached to this particular octree
+    @remarks
+    Removing a node moves the last node into its place, so the order changes.
     */
     NodeList mNodes;
 
@@ -137,6 +137,16 @@ protected:
     ///Octree this node is attached to.
     Octree *mOctant;
 
+    /// Index of this node in the node list of its octree
+    size_t mOctantIndex;
+
+    /// Index of this node in the nodes waiting to be placed in the octree, NOT_PENDING otherwise
+    size_t mPendingIndex;
+    static const size_t NOT_PENDING = ~size_t(0);
+
+    friend class Octree;
+    friend class OctreeSceneManager;
+
     /// Preallocated corners for rendering
     Real mCorners[ 24 ];
     /// Shared colors for rendering
@@ -121,10 +121,25 @@ public:
         VisibleObjectsBoundsInfo* visibleBounds, bool foundvisible, 
         bool onlyShadowCasters);
 
+    /** Same as walkOctree starting at the root octant, but culls the children of the root
+        octant on several threads before adding the visible objects to the render queue.
+    @see SceneManager::setParallelCullingEnabled
+    */
+    void walkOctreeParallel( OctreeCamera *, RenderQueue *,
+        VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters );
+
     /** Checks the given OctreeNode, and determines if it needs to be moved
     * to a different octant.
+    @remarks
+    Nodes needing to move are only placed by the next _updatePendingNodes call.
     */
     void _updateOctreeNode( OctreeNode * );
+    /** Places all nodes which were found to need a different octant since the last call.
+    @remarks
+    This happens once per frame and before each query, so nodes updated several times
+    are only moved once.
+    */
+    void _updatePendingNodes();
     /** Removes the given octree node */
     void _removeOctreeNode( OctreeNode * );
     /** Adds the Octree Node, starting at the given octree, and recursing at max to the specified depth.
@@ -165,6 +180,9 @@ public:
         Options are:
         "Size", AxisAlignedBox *;
         "Depth", int *;
+        "Looseness", Real *, the ratio between the culling bounds and the bounds
+        of the octants, greater than 1. Higher values let moving nodes change octants
+        less often, at the expense of coarser culling;
         "ShowOctree", bool *;
     */
 
@@ -202,6 +220,10 @@ protected:
 
     /// Max depth for the tree
     int mMaxDepth;
+    /// Ratio between the culling bounds and the bounds of the octants
+    Real mLooseness;
+    /// Nodes to be placed by the next _updatePendingNodes call, removed nodes leave a NULL entry
+    Octree::NodeList mPendingNodes;
     /// Size of the octree
     AxisAlignedBox mBox;
 
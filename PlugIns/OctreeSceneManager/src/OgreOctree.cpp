@@ -49,12 +49,33 @@ bool Octree::_isTwiceSize( const AxisAlignedBox &box ) const
     if (box.isInfinite())
         return false;
 
-    Vector3 halfMBoxSize = mBox.getHalfSize();
+    // the child culling bounds have to contain the box wherever its centre is in the child
+    Vector3 maxSize = mBox.getHalfSize() * ( mLooseness - 1 );
     Vector3 boxSize = box.getSize();
-    return ((boxSize.x <= halfMBoxSize.x) && (boxSize.y <= halfMBoxSize.y) && (boxSize.z <= halfMBoxSize.z));
+    return ((boxSize.x <= maxSize.x) && (boxSize.y <= maxSize.y) && (boxSize.z <= maxSize.z));
 
 }
 
+bool Octree::_canHold( const AxisAlignedBox &box ) const
+{
+    if (!box.isFinite())
+        return false;
+
+    if ( !mBox.contains( box.getCenter() ) )
+        return false;
+
+    Vector3 maxSize = mBox.getSize() * ( mLooseness - 1 );
+    Vector3 boxSize = box.getSize();
+    return ((boxSize.x <= maxSize.x) && (boxSize.y <= maxSize.y) && (boxSize.z <= maxSize.z));
+}
+
+bool Octree::_isInCullBounds( const AxisAlignedBox &box ) const
+{
+    AxisAlignedBox cullBounds;
+    _getCullBounds( &cullBounds );
+    return cullBounds.contains( box );
+}
+
 /** It's assumed the the given box has already been proven to fit into
 * a child.  Since it's a loose octree, only the centers need to be
 * compared to find the appropriate node.
@@ -84,7 +105,8 @@ void Octree::_getChildIndexes( const AxisAlignedBox &box, int *x, int *y, int *z
 
 Octree::Octree( Octree * parent ) 
     : mWireBoundingBox(0),
-      mHalfSize( 0, 0, 0 )
+      mHalfSize( 0, 0, 0 ),
+      mLooseness( parent ? parent->mLooseness : 2 )
 {
     //initialize all children to null.
     for ( int i = 0; i < 2; i++ )
@@ -125,6 +147,7 @@ Octree::~Octree()
 
 void Octree::_addNode( OctreeNode * n )
 {
+    n -> mOctantIndex = mNodes.size();
     mNodes.push_back( n );
     n -> setOctant( this );
 
@@ -135,7 +158,12 @@ void Octree::_addNode( OctreeNode * n )
 
 void Octree::_removeNode( OctreeNode * n )
 {
-    mNodes.erase( std::find( mNodes.begin(), mNodes.end(), n ) );
+    size_t index = n -> mOctantIndex;
+    assert( index < mNodes.size() && mNodes[ index ] == n );
+
+    mNodes[ index ] = mNodes.back();
+    mNodes[ index ] -> mOctantIndex = index;
+    mNodes.pop_back();
     n -> setOctant( 0 );
 
     //update total counts.
@@ -144,7 +172,8 @@ void Octree::_removeNode( OctreeNode * n )
 
 void Octree::_getCullBounds( AxisAlignedBox *b ) const
 {
-    b -> setExtents( mBox.getMinimum() - mHalfSize, mBox.getMaximum() + mHalfSize );
+    Vector3 margin = mHalfSize * ( mLooseness - 1 );
+    b -> setExtents( mBox.getMinimum() - margin, mBox.getMaximum() + margin );
 }
 
 WireBoundingBox* Octree::getWireBoundingBox()
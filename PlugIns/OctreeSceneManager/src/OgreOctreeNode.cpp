@@ -50,11 +50,15 @@ unsigned long OctreeNode::mColors[ 8 ] = {green, green, green, green, green, gre
 OctreeNode::OctreeNode( SceneManager* creator ) : SceneNode( creator )
 {
     mOctant = 0;
+    mOctantIndex = 0;
+    mPendingIndex = NOT_PENDING;
 }
 
 OctreeNode::OctreeNode( SceneManager* creator, const String& name ) : SceneNode( creator, name )
 {
     mOctant = 0;
+    mOctantIndex = 0;
+    mPendingIndex = NOT_PENDING;
 }
 
 OctreeNode::~OctreeNode()
@@ -39,6 +39,7 @@ email                : janders@users.sf.net
 #include "OgreOctreeNode.h"
 #include "OgreOctreeCamera.h"
 #include "OgreWireBoundingBox.h"
+#include "OgreParallel.h"
 
 namespace Ogre
 {
@@ -272,7 +273,7 @@ unsigned short OctreeSceneManager::mIndexes[ 24 ] = {0, 1, 1, 2, 2, 3, 3, 0,
 unsigned long OctreeSceneManager::mColors[ 8 ] = {white, white, white, white, white, white, white, white };
 
 
-OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
+OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name), mLooseness(2)
 {
     AxisAlignedBox b( -10000, -10000, -10000, 10000, 10000, 10000 );
     int depth = 8; 
@@ -281,7 +282,7 @@ OctreeSceneManager::OctreeSceneManager(const String& name) : SceneManager(name)
 }
 
 OctreeSceneManager::OctreeSceneManager(const String& name, AxisAlignedBox &box, int max_depth ) 
-: SceneManager(name)
+: SceneManager(name), mLooseness(2)
 {
     mOctree = 0;
     init( box, max_depth );
@@ -299,11 +300,13 @@ void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
         OGRE_DELETE mOctree;
 
     mOctree = OGRE_NEW Octree( 0 );
+    mPendingNodes.clear();
 
     mMaxDepth = depth;
     mBox = box;
 
     mOctree -> mBox = box;
+    mOctree -> mLooseness = mLooseness;
 
     Vector3 min = box.getMinimum();
 
@@ -381,6 +384,7 @@ bool OctreeSceneManager::getOptionKeys( StringVector & refKeys )
     refKeys.push_back( "Size" );
     refKeys.push_back( "ShowOctree" );
     refKeys.push_back( "Depth" );
+    refKeys.push_back( "Looseness" );
 
     return true;
 }
@@ -397,26 +401,52 @@ void OctreeSceneManager::_updateOctreeNode( OctreeNode * onode )
     if (!mOctree)
         return;
 
-    if ( onode -> getOctant() == 0 )
-    {
-        //if outside the octree, force into the root node.
-        if ( ! onode -> _isIn( mOctree -> mBox ) )
-            mOctree->_addNode( onode );
-        else
-            _addOctreeNode( onode, mOctree );
+    // The node stays in its octant as long as it is within the culling bounds.
+    // The root octant is never culled, so it holds anything.
+    Octree * octant = onode -> getOctant();
+    if ( octant && ( octant == mOctree || octant -> _isInCullBounds( box ) ) )
         return ;
+
+    // place it along with all other nodes that moved since the last update
+    if ( onode -> mPendingIndex == OctreeNode::NOT_PENDING )
+    {
+        onode -> mPendingIndex = mPendingNodes.size();
+        mPendingNodes.push_back( onode );
     }
+}
 
-    if ( ! onode -> _isIn( onode -> getOctant() -> mBox ) )
+void OctreeSceneManager::_updatePendingNodes()
+{
+    for ( OctreeNode * onode : mPendingNodes )
     {
+        if ( !onode )
+            continue;
+
+        onode -> mPendingIndex = OctreeNode::NOT_PENDING;
+        if ( onode -> _getWorldAABB().isNull() )
+            continue;
+
+        // Instead of descending from the root, start at the lowest
+        // octant above the current one which may hold the node
+        Octree * octant = onode -> getOctant();
+        while ( octant && octant != mOctree && !octant -> _canHold( onode -> _getWorldAABB() ) )
+            octant = octant -> getParent();
+
+        int depth = 0;
+        for ( Octree * o = octant; o && o != mOctree; o = o -> getParent() )
+            depth++;
+
         _removeOctreeNode( onode );
 
         //if outside the octree, force into the root node.
-        if ( ! onode -> _isIn( mOctree -> mBox ) )
+        if ( octant && octant != mOctree )
+            _addOctreeNode( onode, octant, depth );
+        else if ( ! onode -> _isIn( mOctree -> mBox ) )
             mOctree->_addNode( onode );
         else
             _addOctreeNode( onode, mOctree );
     }
+    mPendingNodes.clear();
 }
 
 /** Only removes the node from the octree.  It leaves the octree, even if it's empty.
@@ -435,6 +465,14 @@ void OctreeSceneManager::_removeOctreeNode( OctreeNode * n )
     }
 
     n->setOctant(0);
+
+    // leave a gap, so the indices of the other pending nodes stay valid
+    if ( n -> mPendingIndex != OctreeNode::NOT_PENDING )
+    {
+        assert( mPendingNodes[ n -> mPendingIndex ] == n );
+        mPendingNodes[ n -> mPendingIndex ] = 0;
+        n -> mPendingIndex = OctreeNode::NOT_PENDING;
+    }
 }
 
 
@@ -526,6 +564,7 @@ SceneNode * OctreeSceneManager::createSceneNodeImpl( const String &name )
 void OctreeSceneManager::_updateSceneGraph( Camera * cam )
 {
     SceneManager::_updateSceneGraph( cam );
+    _updatePendingNodes();
 }
 
 void OctreeSceneManager::_alertVisibleObjects( void )
@@ -544,6 +583,9 @@ void OctreeSceneManager::_alertVisibleObjects( void )
 //    }
 }
 
+/// Number of nodes below which culling on several threads does not pay off
+static const size_t PARALLEL_CULLING_MIN_NODES = 128;
+
 void OctreeSceneManager::_findVisibleObjects(Camera * cam, 
     VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters )
 {
@@ -552,11 +594,23 @@ void OctreeSceneManager::_findVisibleObjects(Camera * cam,
     mBoxes.clear();
     mVisible.clear();
 
+    _updatePendingNodes();
+    _updateOcclusionBuffer( cam, onlyShadowCasters );
+
     mNumObjects = 0;
 
-    //walk the octree, adding all visible Octreenodes nodes to the render queue.
-    walkOctree( static_cast < OctreeCamera * > ( cam ), getRenderQueue(), mOctree, 
-                visibleBounds, false, onlyShadowCasters );
+    // small scenes are culled faster than the work is handed to the workers
+    if ( mParallelCulling && size_t( mOctree -> numNodes() ) >= PARALLEL_CULLING_MIN_NODES )
+    {
+        walkOctreeParallel( static_cast < OctreeCamera * > ( cam ), getRenderQueue(),
+                            visibleBounds, onlyShadowCasters );
+    }
+    else
+    {
+        //walk the octree, adding all visible Octreenodes nodes to the render queue.
+        walkOctree( static_cast < OctreeCamera * > ( cam ), getRenderQueue(), mOctree,
+                    visibleBounds, false, onlyShadowCasters );
+    }
 
     // Show the octree boxes & cull camera if required
     if ( mShowBoxes )
@@ -596,6 +650,14 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
         v = camera -> getVisibility( box );
     }
 
+    // skip the whole octant if it is hidden behind the occluders
+    if ( v != OctreeCamera::NONE && octant != mOctree && mOcclusionBuffer )
+    {
+        AxisAlignedBox box;
+        octant -> _getCullBounds( &box );
+        if ( _isOccluded( camera, box ) )
+            return ;
+    }
 
     // if the octant is visible, or if it's the root node...
     if ( v != OctreeCamera::NONE )
@@ -621,7 +683,7 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
             if ( v == OctreeCamera::PARTIAL )
                 vis = camera -> isVisible( sn -> _getWorldAABB() );
 
-            if ( vis )
+            if ( vis && !_isOccluded( camera, sn -> _getWorldAABB() ) )
             {
 
                 mNumObjects++;
@@ -666,6 +728,129 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
 
 }
 
+/// The visible octants and nodes found below an octant, in the order walkOctree visits them
+struct OctreeCullResult
+{
+    std::vector< Octree * > octants;
+    Octree::NodeList nodes;
+};
+
+static void cullOctantNodes( const SceneManager *sm, OctreeCamera *camera, Octree *octant,
+                             OctreeCamera::Visibility v, OctreeCullResult &result )
+{
+    result.octants.push_back( octant );
+
+    if ( v == OctreeCamera::FULL )
+    {
+        for ( OctreeNode *sn : octant -> mNodes )
+        {
+            if ( !sm -> _isOccluded( camera, sn -> _getWorldAABB() ) )
+                result.nodes.push_back( sn );
+        }
+        return;
+    }
+
+    // the octant is partially visible, so test the nodes in batches
+    const size_t BATCH_SIZE = 16;
+    const AxisAlignedBox* bounds[ BATCH_SIZE ];
+    bool visible[ BATCH_SIZE ];
+
+    const Octree::NodeList &nodes = octant -> mNodes;
+    for ( size_t first = 0; first < nodes.size(); first += BATCH_SIZE )
+    {
+        size_t num = std::min( nodes.size() - first, BATCH_SIZE );
+        for ( size_t i = 0; i < num; ++i )
+            bounds[ i ] = &nodes[ first + i ] -> _getWorldAABB();
+        camera -> isVisible( bounds, num, visible );
+
+        for ( size_t i = 0; i < num; ++i )
+        {
+            if ( visible[ i ] && !sm -> _isOccluded( camera, *bounds[ i ] ) )
+                result.nodes.push_back( nodes[ first + i ] );
+        }
+    }
+}
+
+/// Collects the children of an octant in the order walkOctree visits them
+static size_t getOctantChildren( Octree *octant, Octree **children )
+{
+    size_t count = 0;
+    for ( int z = 0; z < 2; ++z )
+        for ( int y = 0; y < 2; ++y )
+            for ( int x = 0; x < 2; ++x )
+                if ( octant -> mChildren[ x ][ y ][ z ] )
+                    children[ count++ ] = octant -> mChildren[ x ][ y ][ z ];
+    return count;
+}
+
+/// Same traversal as OctreeSceneManager::walkOctree, but only collecting the results
+static void cullOctree( const SceneManager *sm, OctreeCamera *camera, Octree *octant, bool foundvisible,
+                        OctreeCullResult &result )
+{
+    if ( octant -> numNodes() == 0 )
+        return ;
+
+    OctreeCamera::Visibility v = OctreeCamera::FULL;
+    AxisAlignedBox box;
+    octant -> _getCullBounds( &box );
+
+    if ( !foundvisible )
+        v = camera -> getVisibility( box );
+
+    if ( v == OctreeCamera::NONE || sm -> _isOccluded( camera, box ) )
+        return ;
+
+    cullOctantNodes( sm, camera, octant, v, result );
+
+    Octree* children[ 8 ];
+    size_t numChildren = getOctantChildren( octant, children );
+    for ( size_t i = 0; i < numChildren; ++i )
+        cullOctree( sm, camera, children[ i ], v == OctreeCamera::FULL, result );
+}
+
+void OctreeSceneManager::walkOctreeParallel( OctreeCamera *camera, RenderQueue *queue,
+    VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters )
+{
+    if ( mOctree -> numNodes() == 0 )
+        return ;
+
+    // bring the frustum planes up to date before the workers read them
+    camera -> getFrustumPlane( FRUSTUM_PLANE_NEAR );
+
+    // the root octant is always partially visible, its children are culled in parallel.
+    // Each range of children stores its results at the index of its first child.
+    OctreeCullResult results[ 9 ];
+    cullOctantNodes( this, camera, mOctree, OctreeCamera::PARTIAL, results[ 0 ] );
+
+    Octree* children[ 8 ];
+    size_t numChildren = getOctantChildren( mOctree, children );
+    parallelFor( numChildren, 1, [&]( size_t begin, size_t end ) {
+        for ( size_t i = begin; i < end; ++i )
+            cullOctree( this, camera, children[ i ], false, results[ begin + 1 ] );
+    } );
+
+    // add the results to the render queue in the order of walkOctree
+    for ( const OctreeCullResult &result : results )
+    {
+        if ( mShowBoxes )
+        {
+            for ( Octree *octant : result.octants )
+                mBoxes.push_back( octant -> getWireBoundingBox() );
+        }
+
+        for ( OctreeNode *sn : result.nodes )
+        {
+            mNumObjects++;
+            sn -> _addToRenderQueue( camera, queue, onlyShadowCasters, visibleBounds );
+
+            mVisible.push_back( sn );
+
+            if ( mDebugDrawer )
+                mDebugDrawer -> drawSceneNode( sn );
+        }
+    }
+}
+
 // --- non template versions
 static void _findNodes( const AxisAlignedBox &t, std::list< SceneNode * > &list, SceneNode *exclude, bool full, Octree *octant )
 {
@@ -962,21 +1147,25 @@ static void _findNodes( const Ray &t, std::list< SceneNode * > &list, SceneNode
 
 void OctreeSceneManager::findNodesIn( const AxisAlignedBox &box, std::list< SceneNode * > &list, SceneNode *exclude )
 {
+    _updatePendingNodes();
     _findNodes( box, list, exclude, false, mOctree );
 }
 
 void OctreeSceneManager::findNodesIn( const Sphere &sphere, std::list< SceneNode * > &list, SceneNode *exclude )
 {
+    _updatePendingNodes();
     _findNodes( sphere, list, exclude, false, mOctree );
 }
 
 void OctreeSceneManager::findNodesIn( const PlaneBoundedVolume &volume, std::list< SceneNode * > &list, SceneNode *exclude )
 {
+    _updatePendingNodes();
     _findNodes( volume, list, exclude, false, mOctree );
 }
 
 void OctreeSceneManager::findNodesIn( const Ray &r, std::list< SceneNode * > &list, SceneNode *exclude )
 {
+    _updatePendingNodes();
     _findNodes( r, list, exclude, false, mOctree );
 }
 
@@ -987,10 +1176,23 @@ void OctreeSceneManager::resize( const AxisAlignedBox &box )
 
     _findNodes( mOctree->mBox, nodes, 0, true, mOctree );
 
+    // the nodes waiting for placement are in the list too, if they are in an octant already
+    for ( OctreeNode * on : mPendingNodes )
+    {
+        if ( !on )
+            continue;
+
+        on -> mPendingIndex = OctreeNode::NOT_PENDING;
+        if ( !on -> getOctant() )
+            nodes.push_back( on );
+    }
+    mPendingNodes.clear();
+
     OGRE_DELETE mOctree;
 
     mOctree = OGRE_NEW Octree( 0 );
     mOctree->mBox = box;
+    mOctree->mLooseness = mLooseness;
 
     const Vector3 &min = box.getMinimum();
     const Vector3 &max = box.getMaximum();
@@ -1005,6 +1207,7 @@ void OctreeSceneManager::resize( const AxisAlignedBox &box )
         _updateOctreeNode( on );
         ++it;
     }
+    _updatePendingNodes();
 
 }
 
@@ -1025,6 +1228,16 @@ bool OctreeSceneManager::setOption( const String & key, const void * val )
         return true;
     }
 
+    else if ( key == "Looseness" )
+    {
+        Real looseness = * static_cast < const Real * > ( val );
+        OgreAssert( looseness > 1, "the looseness must be greater than 1" );
+        mLooseness = looseness;
+        AxisAlignedBox box = mOctree->mBox;
+        resize(box);
+        return true;
+    }
+
     else if ( key == "ShowOctree" )
     {
         mShowBoxes = * static_cast < const bool * > ( val );
@@ -1052,6 +1265,12 @@ bool OctreeSceneManager::getOption( const String & key, void *val )
         return true;
     }
 
+    else if ( key == "Looseness" )
+    {
+        * static_cast < Real * > ( val ) = mLooseness;
+        return true;
+    }
+
     else if ( key == "ShowOctree" )
     {
 
@@ -1066,6 +1285,14 @@ bool OctreeSceneManager::getOption( const String & key, void *val )
 
 void OctreeSceneManager::clearScene(void)
 {
+    // the root node survives, the other pending nodes are about to be destroyed
+    for ( OctreeNode * on : mPendingNodes )
+    {
+        if ( on )
+            on -> mPendingIndex = OctreeNode::NOT_PENDING;
+    }
+    mPendingNodes.clear();
+
     SceneManager::clearScene();
     init(mBox, mMaxDepth);
 
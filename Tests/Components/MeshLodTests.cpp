@@ -20,6 +20,9 @@
 #include "OgreRenderWindow.h"
 #include "OgreLodConfigSerializer.h"
 #include "OgreWorkQueue.h"
+#include "OgreLodData.h"
+
+#include <random>
 
 using namespace Ogre;
 
@@ -202,3 +205,72 @@ void MeshLodTests::setTestLodConfig(LodConfig& config)
     config.advanced.useBackgroundQueue = false;
 }
 //--------------------------------------------------------------------------
+TEST(LodCollapseCostHeap, MatchesMultimapOrder)
+{
+    // The heap has to collapse in the same order as the multimap it replaced, ties included.
+    LodData::VertexList vertices(500);
+    LodData::CollapseCostHeap heap;
+    std::multimap<Real, LodData::Vertex*> reference;
+    std::vector<std::multimap<Real, LodData::Vertex*>::iterator> positions(vertices.size());
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> cost(0, 20);
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        Real c = cost(rng);
+        heap.append(&vertices[i], c);
+        positions[i] = reference.emplace(c, &vertices[i]);
+    }
+    heap.build();
+
+    for (int step = 0; step < 2000 && !reference.empty(); step++) {
+        ASSERT_EQ(heap.size(), reference.size());
+        EXPECT_EQ(heap.top().vertex, reference.begin()->second);
+        EXPECT_EQ(heap.top().cost, reference.begin()->first);
+
+        LodData::Vertex* v = &vertices[rng() % vertices.size()];
+        size_t id = v - &vertices[0];
+        if (!heap.contains(v)) {
+            continue;
+        }
+        EXPECT_EQ(heap.getCost(v), positions[id]->first);
+        if (step % 3 == 0) {
+            heap.erase(v);
+            reference.erase(positions[id]);
+        } else {
+            Real c = cost(rng);
+            heap.update(v, c);
+            reference.erase(positions[id]);
+            positions[id] = reference.emplace(c, v);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshLodTests,BatchMatchesSerial)
+{
+    LodConfig config;
+    setTestLodConfig(config);
+    MeshLodGenerator::getSingleton().generateLodLevels(config);
+
+    config.mesh.reset();
+    std::vector<MeshPtr> meshes;
+    for (int i = 0; i < 3; i++)
+        meshes.push_back(mMesh->clone("SinbadBatch" + StringConverter::toString(i) + ".mesh"));
+    for (auto& mesh : meshes)
+        mesh->removeLodLevels();
+
+    MeshLodGenerator::BatchResultList results;
+    MeshLodGenerator::getSingleton().generateBatchLodLevels(meshes, config, results, 2, 1);
+    ASSERT_EQ(results.size(), meshes.size());
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        EXPECT_TRUE(results[i].error.empty()) << results[i].error;
+        EXPECT_EQ(results[i].meshName, meshes[i]->getName());
+        ASSERT_EQ(results[i].levels.size(), config.levels.size());
+        for (size_t n = 0; n < config.levels.size(); n++)
+            EXPECT_EQ(results[i].levels[n].outUniqueVertexCount, config.levels[n].outUniqueVertexCount);
+        ASSERT_EQ(meshes[i]->getNumLodLevels(), mMesh->getNumLodLevels());
+        for (ushort n = 1; n < mMesh->getNumLodLevels(); n++)
+            EXPECT_EQ(meshes[i]->getSubMesh(0)->mLodFaceList[n - 1]->indexCount,
+                      mMesh->getSubMesh(0)->mLodFaceList[n - 1]->indexCount);
+    }
+}
@@ -37,6 +37,8 @@ THE SOFTWARE.
 #include "OgrePaging.h"
 #include "OgreLogManager.h"
 
+#include <thread>
+
 using namespace Ogre;
 
 class PageCoreTests : public ::testing::Test
@@ -101,4 +103,77 @@ TEST_F(PageCoreTests,SimpleCreateSaveLoadWorld)
     EXPECT_TRUE(section != 0);
 }
 //--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+namespace
+{
+struct ProceduralPageProvider : public PageProvider
+{
+    bool prepareProceduralPage(Page* page, PagedWorldSection* section) { return true; }
+    bool loadProceduralPage(Page* page, PagedWorldSection* section) { return true; }
+};
+}
+TEST_F(PageCoreTests,LoadStatistics)
+{
+    ProceduralPageProvider provider;
+    mPageManager->setPageProvider(&provider);
+
+    PagedWorld* world = mPageManager->createWorld();
+    PagedWorldSection* section = world->createSection("Grid2D", mSceneMgr);
+    Page* p = section->loadOrCreatePage(Vector3::ZERO);
 
+    const PageManager::PageLoadStatistics& stats = mPageManager->getPageLoadStatistics();
+    EXPECT_EQ(stats.requested, 1u);
+    EXPECT_EQ(stats.completed, 1u);
+    EXPECT_EQ(stats.failed, 0u);
+    EXPECT_EQ(stats.aborted, 0u);
+    EXPECT_GE(stats.maxLatency, p->getLoadLatency());
+    EXPECT_EQ(stats.lastLatency, p->getLoadLatency());
+
+    mPageManager->resetPageLoadStatistics();
+    EXPECT_EQ(stats.requested, 0u);
+
+    mPageManager->setPageProvider(NULL);
+}
+//--------------------------------------------------------------------------
+TEST_F(PageCoreTests,PredictiveStrategyCancelsStaleLoads)
+{
+    ProceduralPageProvider provider;
+    mPageManager->setPageProvider(&provider);
+    Camera* cam = mSceneMgr->createCamera("PagingCam");
+    SceneNode* camNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+
+    // keep the requests queued, so they are pending when the camera moves on
+    Root::getSingleton().getWorkQueue()->setPaused(true);
+
+    PagedWorld* world = mPageManager->createWorld();
+    PagedWorldSection* section = world->createSection("Grid2DPredictive", mSceneMgr);
+    Grid2DPredictivePageStrategy* strategy = static_cast<Grid2DPredictivePageStrategy*>(section->getStrategy());
+    Grid2DPageStrategyData* data = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+    data->setCellSize(100);
+    data->setLoadRadius(150);
+    data->setHoldRadius(1000);
+
+    // closest pages first, within the pending budget
+    section->notifyCamera(cam);
+    const PageManager::PageLoadStatistics& stats = mPageManager->getPageLoadStatistics();
+    EXPECT_EQ(stats.requested, strategy->getMaxPendingLoads());
+    EXPECT_TRUE(section->getPage(data->calculatePageID(0, 0)));
+    EXPECT_FALSE(section->getPage(data->calculatePageID(1, 1)));
+    EXPECT_EQ(strategy->getCameraVelocity(cam, section), Vector3::ZERO);
+
+    // all pages around the origin are behind the camera now
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    camNode->setPosition(600, 0, 0);
+    section->notifyCamera(cam);
+    EXPECT_GT(strategy->getCameraVelocity(cam, section).x, 0);
+    EXPECT_EQ(stats.aborted, strategy->getMaxPendingLoads());
+    EXPECT_EQ(stats.requested, 2 * strategy->getMaxPendingLoads());
+    EXPECT_FALSE(section->getPage(data->calculatePageID(0, 0)));
+    EXPECT_TRUE(section->getPage(data->calculatePageID(6, 0)));
+
+    mPageManager->destroyWorld(world);
+    Root::getSingleton().getWorkQueue()->abortAllRequests();
+    Root::getSingleton().getWorkQueue()->setPaused(false);
+    mPageManager->setPageProvider(NULL);
+}
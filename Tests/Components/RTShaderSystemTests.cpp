@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "OgreShaderGenerator.h"
 #include "OgreShaderProgramManager.h"
 #include "OgreShaderFunctionAtom.h"
+#include "OgreFileSystemLayer.h"
 
 using namespace Ogre;
 
@@ -121,3 +122,228 @@ TEST_F(RTShaderSystem, FunctionInvocationOrder)
     EXPECT_TRUE(c == a);
     EXPECT_FALSE(c < a);
 }
+
+TEST_F(RTShaderSystem, ProgramReuse)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    shaderGen.getRenderState(MSN_SHADERGEN)->setLightCountAutoUpdate(false);
+
+    auto createPass = [&shaderGen](const String& name, int variant)
+    {
+        auto mat = MaterialManager::getSingleton().create(name, RGN_DEFAULT);
+        auto pass = mat->getTechniques()[0]->getPasses()[0];
+        switch (variant)
+        {
+        case 1:
+            pass->setLightingEnabled(false);
+            break;
+        case 2:
+            pass->setVertexColourTracking(TVC_DIFFUSE);
+            break;
+        case 3:
+            pass->setFog(true, FOG_LINEAR);
+            break;
+        case 4:
+            pass->createTextureUnitState();
+            break;
+        }
+        shaderGen.createShaderBasedTechnique(*mat, MSN_DEFAULT, MSN_SHADERGEN);
+        shaderGen.validateMaterial(MSN_SHADERGEN, *mat);
+        return mat->getTechniques()[1]->getPasses()[0];
+    };
+
+    const int numVariants = 5;
+    std::vector<Pass*> passes;
+    for (int i = 0; i < 2 * numVariants; i++)
+        passes.push_back(createPass("TestMat" + std::to_string(i), i % numVariants));
+
+    for (int i = 0; i < numVariants; i++)
+    {
+        // equal passes share their programs
+        EXPECT_EQ(passes[i]->getVertexProgram(), passes[i + numVariants]->getVertexProgram());
+        EXPECT_EQ(passes[i]->getFragmentProgram(), passes[i + numVariants]->getFragmentProgram());
+
+        for (int j = i + 1; j < numVariants; j++)
+        {
+            EXPECT_FALSE(passes[i]->getVertexProgram() == passes[j]->getVertexProgram() &&
+                         passes[i]->getFragmentProgram() == passes[j]->getFragmentProgram());
+        }
+    }
+}
+
+TEST_F(RTShaderSystem, ValidateSchemeMatchesSerial)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    shaderGen.getRenderState(MSN_SHADERGEN)->setLightCountAutoUpdate(false);
+
+    auto createMaterial = [&shaderGen](const String& name, int variant)
+    {
+        auto mat = MaterialManager::getSingleton().create(name, RGN_DEFAULT);
+        auto pass = mat->getTechniques()[0]->getPasses()[0];
+        pass->setLightingEnabled(variant % 2);
+        pass->setFog(true, variant % 3 ? FOG_LINEAR : FOG_NONE);
+        for (int i = 0; i < variant % 4; i++)
+            pass->createTextureUnitState();
+        shaderGen.createShaderBasedTechnique(*mat, MSN_DEFAULT, MSN_SHADERGEN);
+        return mat;
+    };
+
+    // compacting the outputs merges parameters, which must not race between the passes
+    for (auto policy : {RTShader::VSOCP_LOW, RTShader::VSOCP_HIGH})
+    {
+        shaderGen.setVertexShaderOutputsCompactPolicy(policy);
+        String prefix = std::to_string(policy);
+
+        // programs built one material at a time
+        const int numVariants = 12;
+        std::vector<Pass*> reference;
+        for (int i = 0; i < numVariants; i++)
+        {
+            auto mat = createMaterial(prefix + "SerialMat" + std::to_string(i), i);
+            shaderGen.validateMaterial(MSN_SHADERGEN, *mat);
+            reference.push_back(mat->getTechniques()[1]->getPasses()[0]);
+            ASSERT_TRUE(reference.back()->getVertexProgram());
+        }
+
+        // the same programs built by validating the whole scheme at once
+        std::vector<MaterialPtr> materials;
+        for (int i = 0; i < 4 * numVariants; i++)
+            materials.push_back(createMaterial(prefix + "SchemeMat" + std::to_string(i), i % numVariants));
+        EXPECT_TRUE(shaderGen.validateScheme(MSN_SHADERGEN));
+
+        for (size_t i = 0; i < materials.size(); i++)
+        {
+            ASSERT_EQ(materials[i]->getNumTechniques(), 2);
+            auto pass = materials[i]->getTechniques()[1]->getPasses()[0];
+            EXPECT_EQ(pass->getVertexProgram(), reference[i % numVariants]->getVertexProgram());
+            EXPECT_EQ(pass->getFragmentProgram(), reference[i % numVariants]->getFragmentProgram());
+        }
+    }
+}
+
+TEST_F(RTShaderSystem, ProgramCache)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    shaderGen.getRenderState(MSN_SHADERGEN)->setLightCountAutoUpdate(false);
+    const String cachePath = "RTShaderCacheTest/";
+    const String indexFile = cachePath + "RTShaderCache.txt";
+    FileSystemLayer::createDirectory(cachePath);
+    shaderGen.setShaderCachePath(cachePath);
+
+    auto createPass = [&shaderGen]()
+    {
+        auto mat = MaterialManager::getSingleton().createOrRetrieve("TestMat", RGN_DEFAULT).first;
+        shaderGen.createShaderBasedTechnique(*static_cast<Material*>(mat.get()), MSN_DEFAULT, MSN_SHADERGEN);
+        shaderGen.validateMaterial(MSN_SHADERGEN, mat->getName(), mat->getGroup());
+        return static_cast<Material*>(mat.get())->getTechniques()[1]->getPasses()[0];
+    };
+
+    auto vs = createPass()->getVertexProgram();
+    auto fs = createPass()->getFragmentProgram();
+    ASSERT_TRUE(vs && fs);
+
+    std::ifstream in(indexFile.c_str());
+    String index((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    EXPECT_NE(index.find(vs->getName()), String::npos);
+    EXPECT_NE(index.find(fs->getName()), String::npos);
+
+    // point the vertex program at a different file, as if it had been generated by an earlier run
+    shaderGen.removeAllShaderBasedTechniques();
+    shaderGen.flushShaderCache();
+    shaderGen.setShaderCachePath("");
+
+    const String cachedName = "CachedProgram_VS";
+    std::ofstream(cachePath + cachedName + ".glsl") << vs->getSource();
+    index.replace(index.find(vs->getName()), vs->getName().size(), cachedName);
+    std::ofstream(indexFile.c_str()) << index;
+    String fsName = fs->getName();
+    vs.reset();
+    fs.reset();
+
+    shaderGen.setShaderCachePath(cachePath);
+    auto pass = createPass();
+    EXPECT_EQ(pass->getVertexProgram()->getName(), cachedName);
+    EXPECT_EQ(pass->getFragmentProgram()->getName(), fsName);
+
+    // an index of a different setup is discarded
+    shaderGen.removeAllShaderBasedTechniques();
+    shaderGen.flushShaderCache();
+    shaderGen.setShaderCachePath("");
+    std::ofstream(indexFile.c_str()) << "RTShaderCache 0 None 0\n" << index.substr(index.find('\n') + 1);
+    shaderGen.setShaderCachePath(cachePath);
+    EXPECT_NE(createPass()->getVertexProgram()->getName(), cachedName);
+
+    shaderGen.removeAllShaderBasedTechniques();
+    shaderGen.flushShaderCache();
+    shaderGen.setShaderCachePath("");
+    auto archive = ArchiveManager::getSingleton().load(cachePath, "FileSystem", true);
+    StringVectorPtr files = archive->list();
+    for (const auto& file : *files)
+        FileSystemLayer::removeFile(cachePath + file);
+    ArchiveManager::getSingleton().unload(archive);
+    FileSystemLayer::removeDirectory(cachePath);
+}
+
+TEST_F(RTShaderSystem, Manifest)
+{
+    auto& shaderGen = RTShader::ShaderGenerator::getSingleton();
+    shaderGen.getRenderState(MSN_SHADERGEN)->setLightCountAutoUpdate(false);
+
+    std::vector<MaterialPtr> materials;
+    for (int i = 0; i < 3; i++)
+    {
+        materials.push_back(MaterialManager::getSingleton().create("TestMat" + std::to_string(i), RGN_DEFAULT));
+        materials.back()->getTechniques()[0]->getPasses()[0]->setLightingEnabled(i == 1);
+        shaderGen.createShaderBasedTechnique(*materials.back(), MSN_DEFAULT, MSN_SHADERGEN);
+    }
+    // the last material was never used
+    shaderGen.validateMaterial(MSN_SHADERGEN, *materials[0]);
+    shaderGen.validateMaterial(MSN_SHADERGEN, *materials[1]);
+
+    auto out = std::make_shared<MemoryDataStream>(4096);
+    shaderGen.saveManifest(out);
+
+    shaderGen.removeAllShaderBasedTechniques();
+    for (const auto& mat : materials)
+        ASSERT_EQ(mat->getNumTechniques(), 1);
+
+    DataStreamPtr in = std::make_shared<MemoryDataStream>(out->getPtr(), out->tell());
+    EXPECT_EQ(shaderGen.loadManifest(in), 2);
+
+    for (int i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(materials[i]->getNumTechniques(), 2);
+        auto pass = materials[i]->getTechniques()[1]->getPasses()[0];
+        EXPECT_TRUE(pass->getVertexProgram());
+        EXPECT_TRUE(pass->getFragmentProgram());
+    }
+    EXPECT_EQ(materials[2]->getNumTechniques(), 1);
+}
+
+TEST_F(RTShaderSystem, FunctionAtomStructuralKey)
+{
+    using namespace RTShader;
+
+    auto a = ParameterFactory::createConstParam(Vector3::ZERO);
+    auto b = ParameterFactory::createConstParam(Vector3(1, 0, 0));
+    auto dst = std::make_shared<Parameter>(GCT_FLOAT3, "dst", Parameter::SPS_UNKNOWN, 0, Parameter::SPC_UNKNOWN);
+
+    std::set<String> keys;
+    for (char op : {'+', '*'})
+    {
+        for (const auto& rhs : {a, b})
+        {
+            String key;
+            BinaryOpAtom(op, a, rhs, dst, 0).appendStructuralKey(key, "glsl");
+            keys.insert(key);
+        }
+    }
+    FunctionInvocation f("name", 0);
+    f.pushOperand(a, Operand::OPS_IN, Operand::OPM_XY);
+    String key;
+    f.appendStructuralKey(key, "glsl");
+    keys.insert(key);
+
+    EXPECT_EQ(keys.size(), 5u);
+}
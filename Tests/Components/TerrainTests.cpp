@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgreRoot.h"
 #include "OgreTerrain.h"
+#include "OgreTerrainLodManager.h"
 #include "OgreFileSystemLayer.h"
 
 #include "OgreBuildSettings.h"
@@ -78,8 +79,15 @@ void TerrainTests::SetUp()
         {
             typeName = i->first;
             archName = i->second;
-            ResourceGroupManager::getSingleton().addResourceLocation(
-                archName, typeName, secName);
+            try
+            {
+                ResourceGroupManager::getSingleton().addResourceLocation(
+                    archName, typeName, secName);
+            }
+            catch (FileNotFoundException&)
+            {
+                // optional media archives may be missing, the tests do not rely on them
+            }
         }
     }
 
@@ -125,3 +133,261 @@ TEST_F(TerrainTests, create)
     FileSystemLayer::removeFile("TerrainTest.dat");
 }
 //--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, lightmap)
+{
+    mTerrainOpts->setLightMapSize(128);
+    mTerrainOpts->setLightMapDirection(Vector3(1, -0.6, 0.3).normalisedCopy());
+
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Terrain::ImportData imp;
+    imp.terrainSize = 129;
+    imp.worldSize = 1000;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    // gentle slope with a tower in the middle
+    imp.inputFloat = OGRE_ALLOC_T(float, imp.terrainSize * imp.terrainSize, MEMCATEGORY_GEOMETRY);
+    imp.deleteInputData = true;
+    for (uint32 y = 0; y < imp.terrainSize; y++)
+    {
+        for (uint32 x = 0; x < imp.terrainSize; x++)
+        {
+            bool tower = x >= 56 && x < 72 && y >= 56 && y < 72;
+            imp.inputFloat[y * imp.terrainSize + x] = tower ? 150 : 0.2f * x;
+        }
+    }
+    ASSERT_TRUE(t->prepare(imp));
+
+    Rect finalRect;
+    PixelBox* box = t->calculateLightmap(Rect(0, 0, 129, 129), Rect(), finalRect);
+    ASSERT_EQ(finalRect, Rect(0, 0, 128, 128));
+
+    // compare against casting a ray towards the light from every texel
+    const Vector3& lightVec = mTerrainOpts->getLightMapDirection();
+    Real heightPad = (t->getMaxHeight() - t->getMinHeight()) * 1.0e-3f;
+    int mismatches = 0, shadowed = 0;
+    for (uint32 y = 0; y < 128; y++)
+    {
+        for (uint32 x = 0; x < 128; x++)
+        {
+            Real tx = x / 127.0f, ty = y / 127.0f;
+            Vector3 wpos;
+            t->getPosition(tx, ty, t->getHeightAtTerrainPosition(tx, ty) + heightPad, &wpos);
+            wpos += t->getPosition();
+            bool lit = !t->rayIntersects(Ray(wpos, -lightVec), true, 1000).first;
+            uint8 val = static_cast<uint8*>(box->data)[(127 - y) * 128 + x];
+            EXPECT_TRUE(val == 0 || val == 255);
+            mismatches += lit != (val == 255);
+            shadowed += val == 0;
+        }
+    }
+    // the tower casts a long shadow, the texels may only differ at its edges
+    EXPECT_GT(shadowed, 500);
+    EXPECT_LT(mismatches, 128 * 128 / 100);
+
+    OGRE_FREE(box->data, MEMCATEGORY_GENERAL);
+    OGRE_DELETE box;
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, normals)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Terrain::ImportData imp;
+    imp.terrainSize = 129;
+    imp.worldSize = 1280;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    // an inclined plane, so all normals are equal, including on the edges
+    imp.inputFloat = OGRE_ALLOC_T(float, imp.terrainSize * imp.terrainSize, MEMCATEGORY_GEOMETRY);
+    imp.deleteInputData = true;
+    for (uint32 y = 0; y < imp.terrainSize; y++)
+        for (uint32 x = 0; x < imp.terrainSize; x++)
+            imp.inputFloat[y * imp.terrainSize + x] = 5.0f * x - 2.5f * y;
+    ASSERT_TRUE(t->prepare(imp));
+
+    Rect finalRect;
+    PixelBox* box = t->calculateNormals(Rect(0, 0, 129, 129), finalRect);
+    ASSERT_EQ(finalRect, Rect(0, 0, 129, 129));
+
+    // vertices are 10 units apart
+    Vector3 expected;
+    Terrain::convertTerrainToWorldAxes(t->getAlignment(), Vector3(-0.5, 0.25, 1).normalisedCopy(), &expected);
+    for (uint32 y = 0; y < 129; y++)
+    {
+        for (uint32 x = 0; x < 129; x++)
+        {
+            ColourValue c = box->getColourAt(x, y, 0);
+            Vector3 n(c.r * 2 - 1, c.g * 2 - 1, c.b * 2 - 1);
+            ASSERT_TRUE(n.positionEquals(expected, 0.01)) << x << " " << y << " " << n;
+        }
+    }
+
+    OGRE_FREE(box->data, MEMCATEGORY_GENERAL);
+    OGRE_DELETE box;
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+static Terrain* createHillyTerrain(SceneManager* sceneMgr)
+{
+    Terrain* t = OGRE_NEW Terrain(sceneMgr);
+    Terrain::ImportData imp;
+    imp.terrainSize = 257;
+    imp.worldSize = 2560;
+    imp.minBatchSize = 17;
+    imp.maxBatchSize = 65;
+    imp.inputFloat = OGRE_ALLOC_T(float, imp.terrainSize * imp.terrainSize, MEMCATEGORY_GEOMETRY);
+    imp.deleteInputData = true;
+    for (uint32 y = 0; y < imp.terrainSize; y++)
+        for (uint32 x = 0; x < imp.terrainSize; x++)
+            imp.inputFloat[y * imp.terrainSize + x] =
+                100 * Math::Sin(x * 0.1f) * Math::Cos(y * 0.07f) + (x * 31 + y * 17) % 13;
+    t->prepare(imp);
+    return t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, rayIntersects)
+{
+    Terrain* t = createHillyTerrain(mSceneMgr);
+
+    srand(5);
+    std::vector<Ray> rays;
+    for (int i = 0; i < 2000; i++)
+    {
+        // start above the terrain, so the rays cannot enter below its surface
+        Vector3 o(rand() % 2400 - 1200, rand() % 300 + 120, rand() % 2400 - 1200);
+        Vector3 d(rand() % 200 - 100, rand() % 200 - 150, rand() % 200 - 100);
+        if (!d.isZeroLength())
+            rays.push_back(Ray(o, d.normalisedCopy()));
+    }
+
+    std::vector<std::pair<bool, Vector3> > results(rays.size());
+    t->rayIntersectsBatch(rays.data(), rays.size(), results.data());
+
+    int hits = 0;
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        auto single = t->rayIntersects(rays[i]);
+        ASSERT_EQ(single.first, results[i].first);
+        if (!single.first)
+            continue;
+        hits++;
+        EXPECT_EQ(single.second, results[i].second);
+
+        // the hit is on the terrain and it is the first one
+        const Vector3& hit = single.second;
+        EXPECT_NEAR(hit.y, t->getHeightAtWorldPosition(hit), 0.5f);
+        Real dist = rays[i].getOrigin().distance(hit);
+        for (int k = 0; k < 64; k++)
+        {
+            Vector3 p = rays[i].getPoint(dist * k / 64);
+            Vector3 tp;
+            t->getTerrainPosition(p, &tp);
+            if (tp.x >= 0 && tp.x <= 1 && tp.y >= 0 && tp.y <= 1)
+            {
+                ASSERT_GE(p.y, t->getHeightAtWorldPosition(p) - 0.5f);
+            }
+        }
+    }
+    EXPECT_GT(hits, 500);
+
+    // raised heights are found right away, before any update
+    Ray down(Vector3(5, 1000, -5), Vector3::NEGATIVE_UNIT_Y);
+    *t->getHeightData(128, 128) = 500;
+    t->dirtyRect(Rect(128, 128, 129, 129));
+    auto hit = t->rayIntersects(down);
+    ASSERT_TRUE(hit.first);
+    EXPECT_GT(hit.second.y, 200);
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, heightsAtWorldPositions)
+{
+    Terrain* t = createHillyTerrain(mSceneMgr);
+
+    srand(7);
+    std::vector<Vector3> positions;
+    for (int i = 0; i < 1001; i++)
+        positions.push_back(Vector3(rand() % 3000 - 1500 + 0.25f, 0, rand() % 3000 - 1500 + 0.75f));
+    // vertices and the terrain edges
+    positions.push_back(Vector3(0, 0, 0));
+    positions.push_back(Vector3(1280, 0, 1280));
+    positions.push_back(Vector3(-1280, 0, -1280));
+
+    std::vector<float> heights(positions.size());
+    t->getHeightsAtWorldPositions(positions.data(), positions.size(), heights.data());
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        // positions outside are clamped to the edge
+        Vector3 tp;
+        t->getTerrainPosition(positions[i], &tp);
+        float expected = t->getHeightAtTerrainPosition(Math::saturate(tp.x), Math::saturate(tp.y));
+        EXPECT_NEAR(heights[i], expected, 1e-3f) << positions[i];
+    }
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+static size_t saveToFile(Terrain* t, const String& filename)
+{
+    DataStreamPtr stream = Root::createFileStream(filename);
+    StreamSerialiser ser(stream);
+    t->save(ser);
+    return stream->tell();
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, quantisedHeightData)
+{
+    DefaultHardwareBufferManager hbm;
+    Terrain* t = createHillyTerrain(mSceneMgr);
+    uint16 size = t->getSize();
+    uint16 numLodLevels = t->getNumLodLevels();
+
+    size_t floatSize = saveToFile(t, "TerrainTest.dat");
+
+    mTerrainOpts->setHeightDataQuantisationBits(16);
+    size_t quantisedSize = saveToFile(t, "TerrainTest.dat");
+    EXPECT_LT(quantisedSize * 2, floatSize);
+
+    float minHeight = *std::min_element(t->getHeightData(), t->getHeightData() + size * size);
+    float maxHeight = *std::max_element(t->getHeightData(), t->getHeightData() + size * size);
+    float tolerance = (maxHeight - minHeight) / 65535 + 1e-4f;
+
+    Terrain* loaded = OGRE_NEW Terrain(mSceneMgr);
+    DataStreamPtr stream = Root::openFileStream("TerrainTest.dat");
+    ASSERT_TRUE(loaded->prepare(stream));
+    stream->seek(0);
+    TerrainLodManager lodManager(loaded, stream);
+
+    // only the coarse levels, finer vertices are not touched
+    int coarseLod = numLodLevels - 3;
+    int coarseStep = 1 << coarseLod;
+    lodManager.readLodData(numLodLevels - 1, coarseLod);
+    for (uint16 y = 0; y < size; y++)
+    {
+        for (uint16 x = 0; x < size; x++)
+        {
+            if (x % coarseStep == 0 && y % coarseStep == 0)
+                EXPECT_NEAR(*loaded->getHeightData(x, y), *t->getHeightData(x, y), tolerance);
+            else
+                EXPECT_EQ(*loaded->getHeightData(x, y), 0);
+        }
+    }
+
+    // then refine
+    lodManager.readLodData(coarseLod - 1, 0);
+    for (uint16 y = 0; y < size; y++)
+    {
+        for (uint16 x = 0; x < size; x++)
+        {
+            EXPECT_NEAR(*loaded->getHeightData(x, y), *t->getHeightData(x, y), tolerance);
+            EXPECT_NEAR(*loaded->getDeltaData(x, y), *t->getDeltaData(x, y), 2 * tolerance);
+        }
+    }
+
+    OGRE_DELETE loaded;
+    OGRE_DELETE t;
+
+    FileSystemLayer::removeFile("TerrainTest.dat");
+}
@@ -0,0 +1,301 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreVolumeCSGSource.h"
+#include "OgreVolumeGridSource.h"
+#include "OgreVolumeSimplexNoise.h"
+#include "OgreVolumeMeshBuilder.h"
+#include "OgreVolumeCacheSource.h"
+#include "OgreVolumeChunk.h"
+#include "OgreSceneManager.h"
+#include "OgreWorkQueue.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace Ogre;
+using namespace Ogre::Volume;
+
+namespace
+{
+/// A small procedural grid to exercise the batched trilinear filtering.
+class TestGridSource : public GridSource
+{
+    std::vector<float> mData;
+
+protected:
+    float getVolumeGridValue(size_t x, size_t y, size_t z) const override
+    {
+        x = std::min(x, mWidth - 1);
+        y = std::min(y, mHeight - 1);
+        z = std::min(z, mDepth - 1);
+        return mData[(z * mHeight + y) * mWidth + x];
+    }
+    void setVolumeGridValue(int x, int y, int z, float value) override
+    {
+        mData[(z * mHeight + y) * mWidth + x] = value;
+    }
+
+public:
+    TestGridSource(bool trilinear) : GridSource(trilinear, false, false)
+    {
+        mWidth = mHeight = mDepth = 8;
+        mPosXScale = mPosYScale = mPosZScale = 0.5f;
+        mData.resize(mWidth * mHeight * mDepth);
+        for (size_t i = 0; i < mData.size(); ++i)
+            mData[i] = Math::Sin(float(i) * 0.37f) * 3;
+    }
+};
+
+struct Positions
+{
+    std::vector<Real> x, y, z;
+    Positions(size_t count, Real extent)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<Real> dist(-extent, extent);
+        for (size_t i = 0; i < count; ++i)
+        {
+            x.push_back(dist(rng));
+            y.push_back(dist(rng));
+            z.push_back(dist(rng));
+        }
+    }
+};
+
+void expectBatchMatches(const Source& src, const Positions& p, Real tolerance = 1e-4)
+{
+    size_t count = p.x.size();
+    std::vector<Real> values(count), gx(count), gy(count), gz(count), w(count);
+    src.getValues(p.x.data(), p.y.data(), p.z.data(), count, values.data());
+    src.getValuesAndGradients(p.x.data(), p.y.data(), p.z.data(), count, gx.data(), gy.data(), gz.data(), w.data());
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 pos(p.x[i], p.y[i], p.z[i]);
+        Real value = src.getValue(pos);
+        Vector4 valueAndGradient = src.getValueAndGradient(pos);
+        EXPECT_NEAR(values[i], value, tolerance * std::max<Real>(1, std::abs(value)));
+        EXPECT_NEAR(w[i], valueAndGradient.w, tolerance * std::max<Real>(1, std::abs(valueAndGradient.w)));
+        EXPECT_NEAR(gx[i], valueAndGradient.x, tolerance * std::max<Real>(1, std::abs(valueAndGradient.x)));
+        EXPECT_NEAR(gy[i], valueAndGradient.y, tolerance * std::max<Real>(1, std::abs(valueAndGradient.y)));
+        EXPECT_NEAR(gz[i], valueAndGradient.z, tolerance * std::max<Real>(1, std::abs(valueAndGradient.z)));
+    }
+}
+}
+
+TEST(VolumeSource, BatchedCSGMatchesScalar)
+{
+    // more than one block and a partial SIMD group at the end
+    Positions p(157, 12);
+    CSGSphereSource sphere(5, Vector3(1, 2, -1));
+    CSGPlaneSource plane(1, Vector3(0.3f, 1, 0.2f));
+    CSGCubeSource cube(Vector3(-4, -3, -2), Vector3(3, 4, 5));
+    CSGUnionSource unite(&sphere, &cube);
+    CSGIntersectionSource intersection(&unite, &plane);
+    CSGDifferenceSource difference(&intersection, &sphere);
+    CSGNegateSource negate(&difference);
+    CSGScaleSource scale(&negate, 2);
+
+    expectBatchMatches(sphere, p);
+    expectBatchMatches(plane, p);
+    expectBatchMatches(cube, p);
+    expectBatchMatches(unite, p);
+    expectBatchMatches(intersection, p);
+    expectBatchMatches(difference, p);
+    expectBatchMatches(negate, p);
+    expectBatchMatches(scale, p);
+
+    // the zero gradient of the sphere center is left alone
+    Real cx = 1, cy = 2, cz = -1, gx, gy, gz, w;
+    sphere.getValuesAndGradients(&cx, &cy, &cz, 1, &gx, &gy, &gz, &w);
+    EXPECT_EQ(Vector3(gx, gy, gz), Vector3::ZERO);
+    EXPECT_EQ(w, 5);
+}
+
+TEST(VolumeSource, BatchedNoiseMatchesScalar)
+{
+    Positions p(67, 20);
+    SimplexNoise noise(1234);
+    std::vector<Real> values(p.x.size(), 1);
+    noise.addNoise(p.x.data(), p.y.data(), p.z.data(), p.x.size(), 0.3f, 2, values.data());
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_NEAR(values[i], 1 + noise.noise(p.x[i] * 0.3f, p.y[i] * 0.3f, p.z[i] * 0.3f) * 2, 1e-5);
+
+    CSGPlaneSource plane(0, Vector3::UNIT_Y);
+    Real frequencies[] = {0.05f, 0.2f};
+    Real amplitudes[] = {3, 0.5f};
+    CSGNoiseSource noiseSource(&plane, frequencies, amplitudes, 2, 99);
+    expectBatchMatches(noiseSource, p);
+}
+
+TEST(VolumeSource, BatchedGridMatchesScalar)
+{
+    Positions p(70, 8);
+    for (auto& x : p.x)
+        x = std::abs(x);
+    for (auto& y : p.y)
+        y = std::abs(y);
+    for (auto& z : p.z)
+        z = std::abs(z);
+    expectBatchMatches(TestGridSource(true), p);
+    expectBatchMatches(TestGridSource(false), p);
+}
+
+namespace
+{
+struct MeshCapture : public MeshBuilderCallback
+{
+    VecVertex vertices;
+    VecIndices indices;
+    void ready(const SimpleRenderable*, const VecVertex& v, const VecIndices& i, size_t, int) override
+    {
+        vertices = v;
+        indices = i;
+    }
+};
+
+struct CountingSource : public Source
+{
+    mutable int calls = 0;
+    Vector4 getValueAndGradient(const Vector3& p) const override
+    {
+        ++calls;
+        return Vector4(p.x, p.y, p.z, p.length());
+    }
+    Real getValue(const Vector3& p) const override { return getValueAndGradient(p).w; }
+};
+}
+
+TEST(VolumeMeshBuilder, WeldsVertices)
+{
+    MeshBuilder mb;
+    // a strip of quads sharing their edges, enough to grow the hash table
+    const int quads = 2000;
+    for (int i = 0; i < quads; ++i)
+    {
+        Vector3 a(i, 0, 0), b(i + 1, 0, 0), c(i, 1, 0), d(i + 1, 1, 0);
+        mb.addTriangle(a, Vector3::UNIT_Z, b, Vector3::UNIT_Z, c, Vector3::UNIT_Z);
+        mb.addTriangle(b, Vector3::UNIT_Z, d, Vector3::UNIT_Z, c, Vector3::UNIT_Z);
+    }
+    // same position, different normal is a different vertex
+    mb.addTriangle(Vector3::ZERO, Vector3::UNIT_X, Vector3::UNIT_X, Vector3::UNIT_Z, Vector3::UNIT_Y, Vector3::UNIT_Z);
+
+    MeshCapture capture;
+    mb.executeCallback(&capture, NULL, 0, 0);
+    ASSERT_EQ(capture.vertices.size(), size_t(2 * (quads + 1) + 1));
+    ASSERT_EQ(capture.indices.size(), size_t(quads * 6 + 3));
+    for (size_t i = 0; i < capture.indices.size(); ++i)
+        ASSERT_LT(capture.indices[i], capture.vertices.size());
+    // first quad: a b c, b d c
+    EXPECT_EQ(capture.indices[3], capture.indices[1]);
+    EXPECT_EQ(capture.indices[5], capture.indices[2]);
+    // the next quad reuses the right edge of the previous one
+    EXPECT_EQ(capture.indices[6], capture.indices[1]);
+    EXPECT_EQ(capture.indices[quads * 6], size_t(2 * (quads + 1)));
+    EXPECT_EQ(capture.indices[quads * 6 + 1], capture.indices[1]);
+    EXPECT_EQ(mb.getBoundingBox(), AxisAlignedBox(Vector3::ZERO, Vector3(quads, 1, 0)));
+}
+
+TEST(VolumeCacheSource, CachesValues)
+{
+    CountingSource src;
+    CacheSource cache(&src);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int i = 0; i < 3000; ++i)
+        {
+            Vector3 p(i * 0.5f, -i, 2);
+            EXPECT_EQ(cache.getValueAndGradient(p), Vector4(p.x, p.y, p.z, p.length()));
+        }
+    }
+    EXPECT_EQ(src.calls, 3000);
+    cache.clear();
+    cache.getValue(Vector3::ZERO);
+    EXPECT_EQ(src.calls, 3001);
+}
+
+typedef RootWithoutRenderSystemFixture VolumeChunkTests;
+
+TEST_F(VolumeChunkTests, UpdateRegionRebuildsIntersectingChunks)
+{
+    mRoot->getWorkQueue()->startup();
+    SceneManager* sceneMgr = mRoot->createSceneManager();
+
+    CSGSphereSource sphereA(8, Vector3(16));
+    CSGSphereSource nowhere(1, Vector3(-100));
+    CSGSphereSource sphereB(8, Vector3(48));
+    CSGUnionSource src(&sphereA, &nowhere);
+
+    ChunkParameters parameters;
+    parameters.sceneManager = sceneMgr;
+    parameters.src = &src;
+    parameters.baseError = 1.8;
+    parameters.errorMultiplicator = 1.5;
+    parameters.skirtFactor = 0.7;
+
+    Chunk* volumeRoot = OGRE_NEW Chunk();
+    volumeRoot->load(sceneMgr->getRootSceneNode()->createChildSceneNode(), Vector3::ZERO, Vector3(64), 3, &parameters);
+
+    Chunk::VecChunk chunks;
+    volumeRoot->getChunksOfLevel(2, chunks);
+    ASSERT_EQ(chunks.size(), 1u);
+    RenderOperation op;
+    const_cast<Chunk*>(chunks[0])->getRenderOperation(op);
+    VertexData* untouched = op.vertexData;
+    ASSERT_TRUE(untouched);
+
+    // Outside of the dirty area, so nothing may change here
+    src.setSourceB(&sphereB);
+    volumeRoot->updateRegion(AxisAlignedBox(Vector3(-10), Vector3(-5)));
+    chunks.clear();
+    volumeRoot->getChunksOfLevel(2, chunks);
+    EXPECT_EQ(chunks.size(), 1u);
+
+    volumeRoot->updateRegion(AxisAlignedBox(Vector3(38), Vector3(58)));
+    chunks.clear();
+    volumeRoot->getChunksOfLevel(2, chunks);
+    ASSERT_EQ(chunks.size(), 2u);
+    for (auto chunk : chunks)
+    {
+        const_cast<Chunk*>(chunk)->getRenderOperation(op);
+        if (chunk->getBoundingBox().getCenter().x < 32)
+            EXPECT_EQ(op.vertexData, untouched);
+        else
+            EXPECT_NE(op.vertexData, untouched);
+    }
+
+    // Removing the sphere again drops the geometry of its chunk
+    src.setSourceB(&nowhere);
+    volumeRoot->updateRegion(AxisAlignedBox(Vector3(38), Vector3(58)));
+    chunks.clear();
+    volumeRoot->getChunksOfLevel(2, chunks);
+    EXPECT_EQ(chunks.size(), 1u);
+
+    OGRE_DELETE volumeRoot;
+}
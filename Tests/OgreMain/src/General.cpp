@@ -31,6 +31,10 @@ THE SOFTWARE.
 #include "OgreSceneNode.h"
 #include "OgreEntity.h"
 #include "OgreCamera.h"
+#include "OgreManualObject.h"
+#include "OgreLogManager.h"
+#include "OgreTimer.h"
+#include "OgreBone.h"
 #include "RootWithoutRenderSystemFixture.h"
 #include "OgreStaticPluginLoader.h"
 
@@ -43,15 +47,19 @@ THE SOFTWARE.
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreMeshManager.h"
 #include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreMeshOptimiser.h"
 #include "OgreSkeletonManager.h"
 #include "OgreSkeletonInstance.h"
 #include "OgreCompositorManager.h"
 #include "OgreTextureManager.h"
 #include "OgreFileSystem.h"
 #include "OgreArchiveManager.h"
+#include "OgreProfiler.h"
 
 #include "OgreHighLevelGpuProgram.h"
 
+#include <array>
 #include <random>
 using std::minstd_rand;
 
@@ -159,14 +167,18 @@ TEST_F(SceneQueryTest,Intersection)
     IntersectionSceneQueryResult& results = intersectionQuery->execute();
     EXPECT_EQ(results.movables2movables.size(), sizeof(expected)/sizeof(expected[0]));
 
+    // the order of the pairs is not defined, sort them by name
+    std::vector<std::pair<String, String>> pairs;
+    for (const SceneQueryMovableObjectPair& thepair : results.movables2movables)
+        pairs.push_back(std::minmax(thepair.first->getName(), thepair.second->getName()));
+    std::sort(pairs.begin(), pairs.end());
+
     int i = 0;
-    for (SceneQueryMovableIntersectionList::iterator mov = results.movables2movables.begin();
-         mov != results.movables2movables.end(); ++mov)
+    for (const auto& thepair : pairs)
     {
-        SceneQueryMovableObjectPair& thepair = *mov;
-        // printf("{%d, %d},", StringConverter::parseInt(thepair.first->getName()), StringConverter::parseInt(thepair.second->getName()));
-        ASSERT_EQ(expected[i][0], StringConverter::parseInt(thepair.first->getName()));
-        ASSERT_EQ(expected[i][1], StringConverter::parseInt(thepair.second->getName()));
+        // printf("{%s, %s},", thepair.first.c_str(), thepair.second.c_str());
+        ASSERT_EQ(expected[i][0], StringConverter::parseInt(thepair.first));
+        ASSERT_EQ(expected[i][1], StringConverter::parseInt(thepair.second));
         i++;
     }
     // printf("\n");
@@ -182,6 +194,353 @@ TEST_F(SceneQueryTest, Ray) {
     ASSERT_EQ("397", results[1].movable->getName());
 }
 
+TEST_F(SceneQueryTest, RayTriangles)
+{
+    Ray ray = mCamera->getCameraToViewportRay(0.5, 0.5);
+    RaySceneQuery* rayQuery = mSceneMgr->createRayQuery(ray);
+    rayQuery->setSortByDistance(true, 1);
+
+    RaySceneQueryResultEntry boxHit = rayQuery->execute().at(0);
+    ASSERT_EQ("501", boxHit.movable->getName());
+    EXPECT_EQ(-1, boxHit.triangleIndex);
+
+    rayQuery->setQueryTriangles(true);
+    RaySceneQueryResultEntry hit = rayQuery->execute().at(0);
+    ASSERT_EQ("501", hit.movable->getName());
+    EXPECT_EQ(0, hit.subMeshIndex);
+    EXPECT_GT(hit.distance, boxHit.distance);
+
+    // the reported triangle is the one which was hit
+    SubMesh* subMesh = static_cast<Entity*>(hit.movable)->getMesh()->getSubMesh(hit.subMeshIndex);
+    VertexData* vertexData = subMesh->useSharedVertices ? subMesh->parent->sharedVertexData : subMesh->vertexData;
+    const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+    HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+    HardwareIndexBufferSharedPtr ibuf = subMesh->indexData->indexBuffer;
+    ASSERT_LT(size_t(hit.triangleIndex) * 3, subMesh->indexData->indexCount);
+
+    HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+    HardwareBufferLockGuard indexLock(ibuf, HardwareBuffer::HBL_READ_ONLY);
+    Vector3 corners[3];
+    for (int i = 0; i < 3; i++)
+    {
+        size_t n = subMesh->indexData->indexStart + hit.triangleIndex * 3 + i;
+        uint32 index = ibuf->getType() == HardwareIndexBuffer::IT_32BIT ? static_cast<uint32*>(indexLock.pData)[n]
+                                                                         : static_cast<uint16*>(indexLock.pData)[n];
+        float* pFloat;
+        posElem->baseVertexPointerToElement(static_cast<uchar*>(vertexLock.pData) + index * vbuf->getVertexSize(),
+                                            &pFloat);
+        corners[i] = Vector3(pFloat[0], pFloat[1], pFloat[2]);
+    }
+    std::pair<bool, Real> triangleHit = Math::intersects(ray, corners[0], corners[1], corners[2]);
+    EXPECT_TRUE(triangleHit.first);
+    EXPECT_FLOAT_EQ(hit.distance, triangleHit.second);
+
+    // passes the corner of the bounding box, but misses the sphere
+    const AxisAlignedBox& box = hit.movable->getWorldBoundingBox();
+    Vector3 corner = box.getMaximum() * Vector3(0.9, 0.9, 0);
+    rayQuery->setRay(Ray(corner + Vector3(0, 0, 500), Vector3::NEGATIVE_UNIT_Z));
+    rayQuery->setSortByDistance(false);
+
+    rayQuery->setQueryTriangles(false);
+    auto isHit = [](const RaySceneQueryResultEntry& e) { return e.movable->getName() == "501"; };
+    RaySceneQueryResult& boxResults = rayQuery->execute();
+    EXPECT_TRUE(std::any_of(boxResults.begin(), boxResults.end(), isHit));
+
+    rayQuery->setQueryTriangles(true);
+    RaySceneQueryResult& results = rayQuery->execute();
+    EXPECT_FALSE(std::any_of(results.begin(), results.end(), isHit));
+
+    mSceneMgr->destroyQuery(rayQuery);
+}
+
+TEST_F(SceneQueryTest, RayTrianglesSoftwareSkinned)
+{
+    SceneManager* sceneMgr = mRoot->createSceneManager();
+    Entity* ent = sceneMgr->createEntity("robot.mesh");
+    sceneMgr->getRootSceneNode()->attachObject(ent);
+    ASSERT_FALSE(ent->isHardwareAnimationEnabled());
+
+    const AxisAlignedBox& box = ent->getBoundingBox();
+    Vector3 top = box.getCenter();
+    top.y = box.getMaximum().y + 10;
+    Ray ray(top, Vector3::NEGATIVE_UNIT_Y);
+
+    std::pair<bool, Real> restHit = ent->intersectTriangles(ray);
+    ASSERT_TRUE(restHit.first);
+
+    // move the whole skeleton
+    Vector3 offset(1000, 2000, 3000);
+    for (Bone* root : ent->getSkeleton()->getRootBones())
+    {
+        root->setManuallyControlled(true);
+        root->translate(offset);
+    }
+
+    EXPECT_FALSE(ent->intersectTriangles(ray).first);
+    std::pair<bool, Real> movedHit = ent->intersectTriangles(Ray(top + offset, Vector3::NEGATIVE_UNIT_Y));
+    ASSERT_TRUE(movedHit.first);
+    EXPECT_NEAR(restHit.second, movedHit.second, 1e-3);
+
+    mRoot->destroySceneManager(sceneMgr);
+}
+
+static StringVector getQueryResult(SceneQuery* query)
+{
+    StringVector names;
+    if (auto intersectionQuery = dynamic_cast<IntersectionSceneQuery*>(query))
+    {
+        for (const auto& thepair : intersectionQuery->execute().movables2movables)
+        {
+            auto sortedPair = std::minmax(thepair.first->getName(), thepair.second->getName());
+            names.push_back(sortedPair.first + "-" + sortedPair.second);
+        }
+    }
+    else if (auto rayQuery = dynamic_cast<RaySceneQuery*>(query))
+    {
+        for (const auto& entry : rayQuery->execute())
+            names.push_back(entry.movable->getName());
+    }
+    else
+    {
+        for (auto movable : static_cast<RegionSceneQuery*>(query)->execute().movables)
+            names.push_back(movable->getName());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+TEST_F(SceneQueryTest, TreeMatchesBruteForce)
+{
+    Ray ray(Vector3(-2500, 0, 0), Vector3::UNIT_X);
+    Sphere sphere(Vector3(100, -200, 300), 800);
+    AxisAlignedBox box(Vector3(-1000, -500, -200), Vector3(0, 700, 1500));
+    PlaneBoundedVolumeList volumes(1, mCamera->getCameraToViewportBoxVolume(0.25, 0.25, 0.75, 0.75));
+
+    std::vector<SceneQuery*> queries = {
+        mSceneMgr->createIntersectionQuery(), mSceneMgr->createRayQuery(ray),
+        mSceneMgr->createSphereQuery(sphere), mSceneMgr->createAABBQuery(box),
+        mSceneMgr->createPlaneBoundedVolumeQuery(volumes)};
+
+    auto compare = [&]() {
+        std::vector<StringVector> results;
+        mSceneMgr->setSceneQueryTreeEnabled(true);
+        for (auto query : queries)
+            results.push_back(getQueryResult(query));
+
+        mSceneMgr->setSceneQueryTreeEnabled(false);
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            EXPECT_FALSE(results[i].empty());
+            EXPECT_EQ(results[i], getQueryResult(queries[i]));
+        }
+        mSceneMgr->setSceneQueryTreeEnabled(true);
+    };
+
+    compare();
+
+    // move objects around, while the tree is maintained
+    minstd_rand rng;
+    auto& entities = mSceneMgr->getMovableObjects("Entity");
+    for (const auto& e : entities)
+    {
+        if (rng() % 3 == 0)
+            e.second->getParentSceneNode()->translate(Vector3(Real(rng() % 200), 0, 0) - Vector3(100, 0, 0));
+    }
+    mSceneMgr->_updateSceneGraph(mCamera);
+    compare();
+
+    // destroy and create some
+    for (int i = 0; i < 100; i += 7)
+        mSceneMgr->destroyEntity(StringConverter::toString(i));
+    Entity* ent = mSceneMgr->createEntity("new", "sphere.mesh");
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(-1000, 0, 0))->attachObject(ent);
+    ManualObject* infinite = mSceneMgr->createManualObject("infinite");
+    infinite->setBoundingBox(AxisAlignedBox::BOX_INFINITE);
+    mSceneMgr->getRootSceneNode()->attachObject(infinite);
+    mSceneMgr->_updateSceneGraph(mCamera);
+    compare();
+
+    // the hierarchy is rebuilt after toggling it
+    mSceneMgr->setSceneQueryTreeEnabled(false);
+    mSceneMgr->setSceneQueryTreeEnabled(true);
+    compare();
+
+    for (auto query : queries)
+        mSceneMgr->destroyQuery(query);
+}
+
+TEST_F(SceneQueryTest, TreeBenchmark)
+{
+    SceneManager* sceneMgr = mRoot->createSceneManager();
+    Camera* camera = sceneMgr->createCamera("Camera");
+    sceneMgr->getRootSceneNode()->attachObject(camera);
+    Entity* ent = sceneMgr->createEntity("sphere.mesh");
+    createRandomEntityClones(ent, 10000, Vector3(-25000), Vector3(25000), sceneMgr);
+    sceneMgr->_updateSceneGraph(camera);
+
+    minstd_rand rng;
+    auto randomPoint = [&rng]() {
+        return Vector3(Real(rng() % 50000), Real(rng() % 50000), Real(rng() % 50000)) - Vector3(25000);
+    };
+
+    RaySceneQuery* rayQuery = sceneMgr->createRayQuery(Ray());
+    SphereSceneQuery* sphereQuery = sceneMgr->createSphereQuery(Sphere());
+
+    auto run = [&](bool useTree) {
+        sceneMgr->setSceneQueryTreeEnabled(useTree);
+        // build the tree outside of the timing
+        sceneMgr->_getSceneQueryTree();
+
+        rng.seed();
+        size_t hits = 0;
+        Timer timer;
+        for (int i = 0; i < 200; i++)
+        {
+            Vector3 origin = randomPoint();
+            rayQuery->setRay(Ray(origin, (randomPoint() - origin).normalisedCopy()));
+            hits += rayQuery->execute().size();
+
+            sphereQuery->setSphere(Sphere(randomPoint(), 1000));
+            hits += sphereQuery->execute().movables.size();
+        }
+        LogManager::getSingleton().stream()
+            << "SceneQuery " << (useTree ? "tree" : "brute force") << ": " << timer.getMicroseconds()
+            << " us, " << hits << " hits";
+        return hits;
+    };
+
+    EXPECT_EQ(run(false), run(true));
+
+    sceneMgr->destroyQuery(rayQuery);
+    sceneMgr->destroyQuery(sphereQuery);
+    mRoot->destroySceneManager(sceneMgr);
+}
+
+struct VisibleObjectRecorder : public MovableObject::Listener
+{
+    std::vector<const MovableObject*> objects;
+    bool objectRendering(const MovableObject* mo, const Camera*) override
+    {
+        objects.push_back(mo);
+        // there is nothing to render without a render system
+        return false;
+    }
+};
+
+typedef RootWithoutRenderSystemFixture CullingTests;
+TEST_F(CullingTests, Parallel)
+{
+    SceneManager* sceneMgr = mRoot->createSceneManager();
+    Camera* camera = sceneMgr->createCamera("Camera");
+    SceneNode* cameraNode = sceneMgr->getRootSceneNode()->createChildSceneNode();
+    cameraNode->attachObject(camera);
+
+    // random subtrees of varying depth, so whole subtrees get culled
+    VisibleObjectRecorder recorder;
+    minstd_rand rng;
+    auto randomPoint = [&rng](int range) {
+        return Vector3(Real(rng() % range), Real(rng() % range), Real(rng() % range)) - Vector3(range / 2);
+    };
+    for (int i = 0; i < 500; i++)
+    {
+        SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(randomPoint(5000));
+        for (int depth = rng() % 4; depth >= 0; depth--)
+        {
+            ManualObject* mo = sceneMgr->createManualObject();
+            mo->setBoundingBox(AxisAlignedBox(Vector3(-50), Vector3(50)));
+            mo->setListener(&recorder);
+            node->attachObject(mo);
+            node = node->createChildSceneNode(randomPoint(400));
+        }
+    }
+    size_t numObjects = sceneMgr->getMovableObjects("ManualObject").size();
+
+    auto findVisibleObjects = [&](bool parallel) {
+        sceneMgr->setParallelCullingEnabled(parallel);
+        recorder.objects.clear();
+        VisibleObjectsBoundsInfo visibleBounds;
+        sceneMgr->_findVisibleObjects(camera, &visibleBounds, false);
+        return recorder.objects;
+    };
+
+    for (auto direction : {Vector3::NEGATIVE_UNIT_Z, Vector3::UNIT_X, Vector3(1, 1, -1)})
+    {
+        cameraNode->setDirection(direction, Node::TS_WORLD);
+        sceneMgr->_updateSceneGraph(camera);
+
+        auto serial = findVisibleObjects(false);
+        EXPECT_FALSE(serial.empty());
+        EXPECT_LT(serial.size(), numObjects);
+        EXPECT_EQ(serial, findVisibleObjects(true));
+    }
+    mRoot->destroySceneManager(sceneMgr);
+}
+
+TEST_F(CullingTests, Occlusion)
+{
+    SceneManager* sceneMgr = mRoot->createSceneManager();
+    Camera* camera = sceneMgr->createCamera("Camera");
+    camera->setNearClipDistance(1);
+    sceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(camera);
+
+    // a wall covering the view vertically and half of it horizontally, hiding the objects behind it.
+    // The invisible entity only provides the occluder.
+    MeshPtr wallMesh = MeshManager::getSingleton().createPlane("Wall", RGN_DEFAULT, Plane(Vector3::UNIT_Z, 0), 100, 100);
+    Entity* wall = sceneMgr->createEntity(wallMesh);
+    wall->setVisible(false);
+    wall->setOccluderMesh(wallMesh);
+    sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, -100))->attachObject(wall);
+
+    VisibleObjectRecorder recorder;
+    auto createObject = [&](SceneNode* parent, const Vector3& pos) {
+        ManualObject* mo = sceneMgr->createManualObject();
+        mo->setBoundingBox(AxisAlignedBox(Vector3(-20), Vector3(20)));
+        mo->setListener(&recorder);
+        parent->createChildSceneNode(pos)->attachObject(mo);
+        return mo;
+    };
+    SceneNode* root = sceneMgr->getRootSceneNode();
+    ManualObject* hidden = createObject(root, Vector3(0, 0, -300));
+    ManualObject* hiddenChild = createObject(hidden->getParentSceneNode(), Vector3(0, 0, -100));
+    ManualObject* inFront = createObject(root, Vector3(0, 0, -50));
+    ManualObject* besideWall = createObject(root, Vector3(150, 0, -300));
+    sceneMgr->_updateSceneGraph(camera);
+
+    auto findVisibleObjects = [&]() {
+        recorder.objects.clear();
+        VisibleObjectsBoundsInfo visibleBounds;
+        sceneMgr->_findVisibleObjects(camera, &visibleBounds, false);
+        return recorder.objects;
+    };
+    typedef std::vector<const MovableObject*> ObjectList;
+
+    EXPECT_EQ(findVisibleObjects(), ObjectList({hidden, hiddenChild, inFront, besideWall}));
+
+    sceneMgr->setOcclusionCullingEnabled(true);
+    for (bool parallel : {false, true})
+    {
+        sceneMgr->setParallelCullingEnabled(parallel);
+        EXPECT_EQ(findVisibleObjects(), ObjectList({inFront, besideWall}));
+    }
+
+    // finely tessellated occluders are projected and rasterised on several threads
+    wall->setOccluderMesh(MeshManager::getSingleton().createPlane(
+        "TessellatedWall", RGN_DEFAULT, Plane(Vector3::UNIT_Z, 0), 100, 100, 32, 32));
+    EXPECT_EQ(findVisibleObjects(), ObjectList({inFront, besideWall}));
+
+    // nothing is occluded in shadow passes
+    recorder.objects.clear();
+    VisibleObjectsBoundsInfo visibleBounds;
+    sceneMgr->_findVisibleObjects(camera, &visibleBounds, true);
+    EXPECT_FALSE(sceneMgr->_isOccluded(camera, hidden->getWorldBoundingBox(true)));
+
+    // removing the occluder shows everything again
+    wall->setOccluderMesh(MeshPtr());
+    EXPECT_EQ(findVisibleObjects(), ObjectList({hidden, hiddenChild, inFront, besideWall}));
+
+    mRoot->destroySceneManager(sceneMgr);
+}
+
 TEST(MaterialSerializer, Basic)
 {
     Root root;
@@ -263,6 +622,92 @@ TEST(Image, Resize)
     ASSERT_TRUE(!memcmp(img.getData(), ref.getData(), ref.getSize()));
 }
 
+TEST(Image, ResizeRGBAMatchesRGB)
+{
+    // the RGBA resamplers are vectorised, the RGB ones are not. Both must agree.
+    // Large enough to be split into bands of rows on multi core machines.
+    Image rgba(PF_BYTE_RGBA, 601, 419);
+    Image rgbaFloat(PF_FLOAT32_RGBA, 601, 419);
+    srand(0);
+    for (size_t i = 0; i < rgba.getSize(); i++)
+    {
+        rgba.getData()[i] = uchar(rand());
+        rgbaFloat.getData<float>()[i] = rgba.getData()[i] / 255.0f;
+    }
+
+    Image rgb(PF_BYTE_RGB, 601, 419);
+    Image rgbFloat(PF_FLOAT32_RGB, 601, 419);
+    PixelUtil::bulkPixelConversion(rgba.getPixelBox(), rgb.getPixelBox());
+    PixelUtil::bulkPixelConversion(rgbaFloat.getPixelBox(), rgbFloat.getPixelBox());
+
+    for (auto img : {&rgba, &rgb, &rgbaFloat, &rgbFloat})
+        img->resize(1031, 777);
+
+    for (size_t i = 0, n = size_t(rgb.getWidth()) * rgb.getHeight(); i < n; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            ASSERT_EQ(rgba.getData()[i * 4 + c], rgb.getData()[i * 3 + c]);
+            ASSERT_NEAR(rgbaFloat.getData<float>()[i * 4 + c], rgbFloat.getData<float>()[i * 3 + c], 1e-6);
+        }
+    }
+}
+
+
+TEST(Image, GenerateMipmaps)
+{
+    // 1 pixel checkerboard, every 2x2 block averages to 50% grey
+    Image img(PF_BYTE_RGBA, 64, 32);
+    for (uint32 y = 0; y < img.getHeight(); y++)
+        for (uint32 x = 0; x < img.getWidth(); x++)
+            img.setColourAt((x + y) % 2 ? ColourValue::White : ColourValue::Black, x, y, 0);
+
+    Image box = img;
+    box.generateMipmaps();
+    ASSERT_EQ(box.getNumMipmaps(), 6u);
+    EXPECT_EQ(box.getPixelBox(0, 6).getWidth(), 1u);
+    EXPECT_EQ(box.getPixelBox(0, 6).getHeight(), 1u);
+    EXPECT_NEAR(box.getPixelBox(0, 1).getColourAt(3, 4, 0).r, 0.5, 0.01);
+    EXPECT_NEAR(box.getPixelBox(0, 6).getColourAt(0, 0, 0).g, 0.5, 0.01);
+
+    // averaging in linear space is brighter once encoded again
+    Image srgb = img;
+    srgb.generateMipmaps(true);
+    EXPECT_NEAR(srgb.getPixelBox(0, 1).getColourAt(3, 4, 0).r, 0.735, 0.01);
+
+    Image lanczos = img;
+    lanczos.generateMipmaps(false, Image::FILTER_LANCZOS);
+    EXPECT_NEAR(lanczos.getPixelBox(0, 2).getColourAt(2, 2, 0).b, 0.5, 0.01);
+}
+
+TEST(Image, GenerateMipmapsAlphaCoverage)
+{
+    // noisy alpha, where about 20% of the texels pass the test
+    Image img(PF_BYTE_RGBA, 64, 64);
+    srand(0);
+    for (uint32 y = 0; y < img.getHeight(); y++)
+        for (uint32 x = 0; x < img.getWidth(); x++)
+            img.setColourAt(ColourValue(1, 1, 1, float(rand()) / RAND_MAX), x, y, 0);
+
+    auto coverage = [](const PixelBox& box) {
+        size_t passed = 0;
+        for (uint32 y = 0; y < box.getHeight(); y++)
+            for (uint32 x = 0; x < box.getWidth(); x++)
+                passed += box.getColourAt(x, y, 0).a >= 0.8f;
+        return float(passed) / (box.getWidth() * box.getHeight());
+    };
+
+    Image plain = img;
+    plain.generateMipmaps();
+    Image preserved = img;
+    preserved.generateMipmaps(false, Image::FILTER_BILINEAR, 0.8f);
+
+    float topCoverage = coverage(img.getPixelBox());
+    EXPECT_NEAR(topCoverage, 0.2f, 0.05f);
+    // averaging pulls alpha towards 0.5, so without the adjustment texels vanish
+    EXPECT_LT(coverage(plain.getPixelBox(0, 2)), 0.05f);
+    EXPECT_NEAR(coverage(preserved.getPixelBox(0, 2)), topCoverage, 0.05f);
+}
 
 TEST(Image, Combine)
 {
@@ -450,4 +895,232 @@ TEST(MaterialLoading, LateShadowCaster)
     tech->_load();
 
     EXPECT_TRUE(tech->getShadowCasterMaterial());
-}
\ No newline at end of file
+}
+TEST(MeshOptimiser, VertexCache)
+{
+    // shuffled grid, as bad as it gets for the cache
+    const uint32 size = 32;
+    std::vector<uint32> indices;
+    for (uint32 y = 0; y < size; y++)
+    {
+        for (uint32 x = 0; x < size; x++)
+        {
+            uint32 v = y * (size + 1) + x;
+            uint32 quad[6] = {v, v + 1, v + size + 1, v + 1, v + size + 2, v + size + 1};
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+    std::vector<std::array<uint32, 3>> tris(indices.size() / 3);
+    memcpy(tris.data(), indices.data(), indices.size() * sizeof(uint32));
+    std::shuffle(tris.begin(), tris.end(), std::minstd_rand());
+    memcpy(indices.data(), tris.data(), indices.size() * sizeof(uint32));
+
+    std::vector<Vector3> positions;
+    for (uint32 y = 0; y <= size; y++)
+        for (uint32 x = 0; x <= size; x++)
+            positions.push_back(Vector3(x, y, 0));
+
+    auto before = MeshOptimiser::analyseVertexCache(indices.data(), indices.size(), positions.size(), 16);
+    MeshOptimiser::optimiseVertexCache(indices.data(), indices.size(), positions.size());
+    auto after = MeshOptimiser::analyseVertexCache(indices.data(), indices.size(), positions.size(), 16);
+    EXPECT_LT(after.acmr, 0.8f);
+    EXPECT_LT(after.acmr, before.acmr);
+    EXPECT_LT(after.atvr, before.atvr);
+
+    MeshOptimiser::optimiseOverdraw(indices.data(), indices.size(), positions.data(), positions.size(), 16, 1.05f);
+    auto overdraw = MeshOptimiser::analyseVertexCache(indices.data(), indices.size(), positions.size(), 16);
+    EXPECT_LT(overdraw.acmr, before.acmr);
+
+    // same triangles with the same winding
+    std::vector<std::array<uint32, 3>> result(indices.size() / 3);
+    memcpy(result.data(), indices.data(), indices.size() * sizeof(uint32));
+    std::sort(tris.begin(), tris.end());
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(tris, result);
+}
+
+typedef RootWithoutRenderSystemFixture MeshOptimiserTests;
+TEST_F(MeshOptimiserTests, ReorderVertices)
+{
+    auto mesh = MeshManager::getSingleton().load("jaiqua.mesh", RGN_DEFAULT);
+
+    // triangles as positions, which must survive the vertex remapping
+    auto getTriangles = [](Mesh* m) {
+        std::vector<std::array<float, 9>> triangles;
+        for (auto sm : m->getSubMeshes())
+        {
+            VertexData* vertexData = sm->useSharedVertices ? m->sharedVertexData : sm->vertexData;
+            auto posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+            auto vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+            auto ibuf = sm->indexData->indexBuffer;
+            HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+            HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_READ_ONLY);
+            for (size_t i = 0; i < sm->indexData->indexCount; i += 3)
+            {
+                std::array<float, 9> tri;
+                for (int k = 0; k < 3; k++)
+                {
+                    size_t idx = ibuf->getType() == HardwareIndexBuffer::IT_32BIT
+                                     ? static_cast<uint32*>(ibufLock.pData)[i + k]
+                                     : static_cast<uint16*>(ibufLock.pData)[i + k];
+                    float* pFloat;
+                    posElem->baseVertexPointerToElement(
+                        static_cast<uchar*>(vbufLock.pData) + idx * vbuf->getVertexSize(), &pFloat);
+                    std::copy(pFloat, pFloat + 3, &tri[k * 3]);
+                }
+                triangles.push_back(tri);
+            }
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    };
+
+    auto ref = getTriangles(mesh.get());
+    size_t assignments = mesh->getSubMesh(0)->getBoneAssignments().size();
+
+    auto res = MeshOptimiser().optimise(mesh.get());
+    EXPECT_LE(res.after.acmr, res.before.acmr);
+    EXPECT_EQ(getTriangles(mesh.get()), ref);
+    EXPECT_EQ(mesh->getSubMesh(0)->getBoneAssignments().size(), assignments);
+}
+
+TEST(Profiler, Trace)
+{
+    Timer timer;
+    Profiler profiler;
+    profiler.setTimer(&timer);
+    profiler.setTraceBufferSize(4);
+    profiler.setTraceEnabled(true);
+
+    {
+        Profile frame(Profile::StaticName{"Frame"});
+        std::thread worker([&profiler]() {
+            profiler.setTraceThreadName("Worker");
+            Profile work(Profile::StaticName{"Work"}, OGREPROF_GENERAL);
+            Profile named(String("Named \"work\""));
+
+            // names in temporary buffers are copied
+            char buffer[16];
+            strcpy(buffer, "Buffer");
+            {
+                Profile buffered(buffer);
+            }
+            strcpy(buffer, "Overwritten");
+        });
+        worker.join();
+
+        // masked profiles are not recorded
+        profiler.setProfileGroupMask(OGREPROF_USER_DEFAULT);
+        Profile masked("Masked", OGREPROF_CULLING);
+    }
+    profiler.setProfileGroupMask(0xFFFFFFFF);
+
+    std::vector<ProfileTraceEvent> events;
+    profiler.getTraceEvents(events);
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_STREQ(events[0].name, "Frame");
+    EXPECT_EQ(events[0].thread, 0u);
+    EXPECT_EQ(std::set<String>({events[1].name, events[2].name, events[3].name}),
+              std::set<String>({"Work", "Named \"work\"", "Buffer"}));
+    for (int i = 1; i < 4; i++)
+    {
+        EXPECT_EQ(events[i].thread, 1u);
+        EXPECT_LE(events[0].begin, events[i].begin);
+        EXPECT_GE(events[0].end, events[i].end);
+    }
+
+    std::ostringstream trace;
+    profiler.exportChromeTrace(trace);
+    EXPECT_NE(trace.str().find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,\"args\":{\"name\":\"Worker\"}}"),
+              String::npos);
+    EXPECT_NE(trace.str().find("{\"name\":\"Named \\\"work\\\"\",\"ph\":\"X\",\"pid\":0,\"tid\":1,"), String::npos);
+
+    // the ring buffer keeps the latest events
+    profiler.clearTrace();
+    for (int i = 0; i < 10; i++)
+    {
+        Profile loop("Loop");
+    }
+    // a new thread reuses the buffer of the exited one
+    std::thread([]() { Profile reused("Reused"); }).join();
+
+    profiler.getTraceEvents(events);
+    ASSERT_EQ(events.size(), 5u);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_STREQ(events[i].name, "Loop");
+        EXPECT_EQ(events[i].thread, 0u);
+        // the copy of a name is shared by all of its profiles
+        EXPECT_EQ(events[i].name, events[0].name);
+    }
+    EXPECT_STREQ(events[4].name, "Reused");
+    EXPECT_EQ(events[4].thread, 1u);
+}
+
+struct RecordingLogListener : public LogListener
+{
+    std::vector<String> messages;
+    std::set<std::thread::id> threads;
+    void messageLogged(const String& message, LogMessageLevel lml, bool maskDebug, const String& logName,
+                       bool& skipThisMessage) override
+    {
+        messages.push_back(message);
+        threads.insert(std::this_thread::get_id());
+    }
+};
+
+TEST(Log, Asynchronous)
+{
+    RecordingLogListener listener;
+    std::unique_ptr<Log> log(new Log("Asynchronous.log", false, true));
+    log->addListener(&listener);
+    log->setAsynchronous(true, 4);
+    ASSERT_TRUE(log->isAsynchronous());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&log, t]() {
+            for (int i = 0; i < 100; i++)
+            {
+                if (i % 2)
+                    log->logMessage(StringConverter::toString(t) + " " + StringConverter::toString(i));
+                else
+                    log->stream() << t << " " << i;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    log->flush();
+    ASSERT_EQ(listener.messages.size(), 400u);
+    EXPECT_EQ(listener.threads.size(), 1u);
+    EXPECT_EQ(listener.threads.count(std::this_thread::get_id()), 0u);
+
+    // messages of each thread keep their order
+    std::vector<int> next(4, 0);
+    for (const String& message : listener.messages)
+    {
+        StringVector parts = StringUtil::split(message);
+        ASSERT_EQ(parts.size(), 2u);
+        int t = StringConverter::parseInt(parts[0]);
+        EXPECT_EQ(StringConverter::parseInt(parts[1]), next[t]++);
+    }
+
+    // reused stream buffers start with the default formatting
+    log->stream() << std::hex << 255;
+    log->stream() << 255;
+    // errors are written before returning
+    log->logMessage("Critical", LML_CRITICAL);
+    ASSERT_EQ(listener.messages.size(), 403u);
+    EXPECT_EQ(listener.messages[400], "ff");
+    EXPECT_EQ(listener.messages[401], "255");
+    EXPECT_EQ(listener.messages[402], "Critical");
+
+    // destroying the log writes the pending messages
+    for (int i = 0; i < 10; i++)
+        log->logMessage("Pending");
+    log.reset();
+    EXPECT_EQ(listener.messages.size(), 413u);
+}
@@ -203,6 +203,16 @@ TEST_F(MeshSerializerTests,Mesh_Version_1_10)
     testMesh(MESH_VERSION_LATEST);
 }
 //--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_Version_1_10_Mapped)
+{
+    testMesh(MESH_VERSION_1_10_MAPPED);
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_Version_1_10_Compressed)
+{
+    testMesh(MESH_VERSION_1_10_COMPRESSED);
+}
+//--------------------------------------------------------------------------
 TEST_F(MeshSerializerTests,Mesh_Version_1_8)
 {
     testMesh(MESH_VERSION_1_8);
@@ -342,7 +352,7 @@ void MeshSerializerTests::assertMeshClone(Mesh* a, Mesh* b, MeshVersion version
     // EXPECT_TRUE(a->getAutoBuildEdgeLists() == b->getAutoBuildEdgeLists());
     EXPECT_TRUE(isHashMapClone(a->getSubMeshNameMap(), b->getSubMeshNameMap()));
 
-    assertVertexDataClone(a->sharedVertexData, b->sharedVertexData);
+    assertVertexDataClone(a->sharedVertexData, b->sharedVertexData, version);
     EXPECT_TRUE(a->getCreator() == b->getCreator());
     EXPECT_TRUE(a->getIndexBufferUsage() == b->getIndexBufferUsage());
     EXPECT_TRUE(a->getSharedVertexDataAnimationIncludesNormals() == b->getSharedVertexDataAnimationIncludesNormals());
@@ -395,7 +405,7 @@ void MeshSerializerTests::assertMeshClone(Mesh* a, Mesh* b, MeshVersion version
             aSubmesh->_getRenderOperation(aop, n);
             bSubmesh->_getRenderOperation(bop, n);
             assertIndexDataClone(aop.indexData, bop.indexData);
-            assertVertexDataClone(aop.vertexData, bop.vertexData);
+            assertVertexDataClone(aop.vertexData, bop.vertexData, version);
             EXPECT_TRUE(aop.operationType == bop.operationType);
             EXPECT_TRUE(aop.useIndexes == bop.useIndexes);
         }
@@ -504,11 +514,31 @@ void MeshSerializerTests::assertVertexDataClone(VertexData* a, VertexData* b, Me
                 size_t elemSize = VertexElement::getTypeSize(aElem.getType());
                 unsigned char* avEnd = avertex + a->vertexCount * avSize;
                 bool error = false;
-                for (; avertex < avEnd; avertex += avSize, bvertex += bvSize) {
-                    float* afloat, * bfloat;
-                    aElem.baseVertexPointerToElement(avertex, &afloat);
-                    bElem.baseVertexPointerToElement(bvertex, &bfloat);
-                    error |= (memcmp(afloat, bfloat, elemSize) != 0);
+                if (version == MESH_VERSION_1_10_COMPRESSED &&
+                    VertexElement::getBaseType(aElem.getType()) == VET_FLOAT1) {
+                    // lossy encoding, allow for the quantisation error relative to the element range
+                    unsigned short count = VertexElement::getTypeCount(aElem.getType());
+                    float maxAbs = 1;
+                    for (unsigned char* av = avertex; av < avEnd; av += avSize) {
+                        float* afloat;
+                        aElem.baseVertexPointerToElement(av, &afloat);
+                        for (unsigned short c = 0; c < count; c++)
+                            maxAbs = std::max(maxAbs, std::abs(afloat[c]));
+                    }
+                    for (; avertex < avEnd; avertex += avSize, bvertex += bvSize) {
+                        float* afloat, * bfloat;
+                        aElem.baseVertexPointerToElement(avertex, &afloat);
+                        bElem.baseVertexPointerToElement(bvertex, &bfloat);
+                        for (unsigned short c = 0; c < count; c++)
+                            error |= std::abs(afloat[c] - bfloat[c]) > 1e-3f * maxAbs;
+                    }
+                } else {
+                    for (; avertex < avEnd; avertex += avSize, bvertex += bvSize) {
+                        float* afloat, * bfloat;
+                        aElem.baseVertexPointerToElement(avertex, &afloat);
+                        bElem.baseVertexPointerToElement(bvertex, &bfloat);
+                        error |= (memcmp(afloat, bfloat, elemSize) != 0);
+                    }
                 }
                 abuf->unlock();
                 bbuf->unlock();
@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "PixelFormatTests.h"
+#include "OgreBitwise.h"
 #include <cstdlib>
 #include <iomanip>
 
@@ -248,4 +249,41 @@ TEST_F(PixelFormatTests,BulkConversion)
     testCase(PF_X8B8G8R8, PF_R8G8B8A8);
 }
 //--------------------------------------------------------------------------
+TEST_F(PixelFormatTests,FloatConversion)
+{
+    // random bits, mostly special values that take the scalar path
+    testCase(PF_FLOAT16_R, PF_FLOAT32_R);
+    testCase(PF_FLOAT16_GR, PF_FLOAT32_GR);
+    testCase(PF_FLOAT16_RGB, PF_FLOAT32_RGB);
+    testCase(PF_FLOAT16_RGBA, PF_FLOAT32_RGBA);
+    testCase(PF_FLOAT32_R, PF_FLOAT16_R);
+    testCase(PF_FLOAT32_GR, PF_FLOAT16_GR);
+    testCase(PF_FLOAT32_RGB, PF_FLOAT16_RGB);
+    testCase(PF_FLOAT32_RGBA, PF_FLOAT16_RGBA);
+
+    // a ramp across the half range, mixed with zeros and values that flush to zero
+    std::vector<float> values;
+    for (float v = -70000; v < 70000; v += 123.25f)
+        values.push_back(v);
+    for (float v = 1e-9f; v < 1; v *= 1.7f)
+    {
+        values.push_back(v);
+        values.push_back(-v);
+        values.push_back(0);
+    }
+    values.resize(values.size() / 4 * 4);
+
+    std::vector<uint16> halves(values.size());
+    std::vector<float> floats(values.size());
+    PixelUtil::bulkPixelConversion(values.data(), PF_FLOAT32_RGBA, halves.data(), PF_FLOAT16_RGBA,
+                                   uint(values.size() / 4));
+    PixelUtil::bulkPixelConversion(halves.data(), PF_FLOAT16_RGBA, floats.data(), PF_FLOAT32_RGBA,
+                                   uint(values.size() / 4));
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(halves[i], Bitwise::floatToHalf(values[i])) << values[i];
+        ASSERT_EQ(floats[i], Bitwise::halfToFloat(halves[i])) << values[i];
+    }
+}
+//--------------------------------------------------------------------------
 
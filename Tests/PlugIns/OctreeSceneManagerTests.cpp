@@ -0,0 +1,237 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreManualObject.h"
+#include "OgreOctreeSceneManager.h"
+#include "OgreOctreeNode.h"
+#include "OgreOctree.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+#include <random>
+
+using namespace Ogre;
+
+class OctreeSceneManagerTests : public RootWithoutRenderSystemFixture
+{
+public:
+    OctreeSceneManager* mSceneMgr;
+
+    void SetUp() override
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+        mSceneMgr = OGRE_NEW OctreeSceneManager("OctreeSceneManagerTests");
+    }
+    void TearDown() override
+    {
+        OGRE_DELETE mSceneMgr;
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+};
+
+struct OctreeObjectRecorder : public MovableObject::Listener
+{
+    std::vector<const MovableObject*> objects;
+    bool objectRendering(const MovableObject* mo, const Camera*) override
+    {
+        objects.push_back(mo);
+        // there is nothing to render without a render system
+        return false;
+    }
+};
+
+TEST_F(OctreeSceneManagerTests, ParallelCulling)
+{
+    Camera* camera = mSceneMgr->createCamera("Camera");
+    SceneNode* cameraNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    cameraNode->attachObject(camera);
+
+    OctreeObjectRecorder recorder;
+    std::minstd_rand rng;
+    for (int i = 0; i < 1000; i++)
+    {
+        Vector3 pos(Real(rng() % 8000), Real(rng() % 8000), Real(rng() % 8000));
+        ManualObject* mo = mSceneMgr->createManualObject();
+        mo->setBoundingBox(AxisAlignedBox(Vector3(-Real(rng() % 500)), Vector3(50)));
+        mo->setListener(&recorder);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(pos - Vector3(4000))->attachObject(mo);
+    }
+
+    auto findVisibleObjects = [&](bool parallel) {
+        mSceneMgr->setParallelCullingEnabled(parallel);
+        recorder.objects.clear();
+        VisibleObjectsBoundsInfo visibleBounds;
+        mSceneMgr->_findVisibleObjects(camera, &visibleBounds, false);
+        return recorder.objects;
+    };
+
+    for (auto direction : {Vector3::NEGATIVE_UNIT_Z, Vector3::UNIT_X, Vector3(1, 1, -1)})
+    {
+        cameraNode->setDirection(direction, Node::TS_WORLD);
+        mSceneMgr->_updateSceneGraph(camera);
+
+        auto serial = findVisibleObjects(false);
+        EXPECT_FALSE(serial.empty());
+        EXPECT_LT(serial.size(), 1000u);
+        EXPECT_EQ(findVisibleObjects(true), serial);
+    }
+
+    // the objects report to the recorder when destroyed
+    mSceneMgr->destroyAllManualObjects();
+}
+
+/// The octant the node with the given bounds was placed in before the looseness became configurable
+static AxisAlignedBox getLooseness2Octant(const AxisAlignedBox& bounds)
+{
+    AxisAlignedBox octant(Vector3(-10000), Vector3(10000));
+    for (int depth = 0; depth < 8; depth++)
+    {
+        Vector3 half = octant.getHalfSize();
+        Vector3 size = bounds.getSize();
+        if (size.x > half.x || size.y > half.y || size.z > half.z)
+            break;
+
+        Vector3 center = octant.getCenter();
+        Vector3 min = octant.getMinimum(), max = octant.getMaximum();
+        for (int i = 0; i < 3; i++)
+        {
+            if (bounds.getCenter()[i] > center[i])
+                min[i] = center[i];
+            else
+                max[i] = center[i];
+        }
+        octant.setExtents(min, max);
+    }
+    return octant;
+}
+
+/// Same as Octree::_getCullBounds, which is not exported
+static AxisAlignedBox getCullBounds(const Octree* octant)
+{
+    Vector3 margin = octant->mBox.getHalfSize() * (octant->mLooseness - 1);
+    return AxisAlignedBox(octant->mBox.getMinimum() - margin, octant->mBox.getMaximum() + margin);
+}
+
+TEST_F(OctreeSceneManagerTests, NodePlacement)
+{
+    Camera* camera = mSceneMgr->createCamera("Camera");
+    std::minstd_rand rng;
+    auto randomPoint = [&rng]() {
+        return Vector3(Real(rng() % 18000), Real(rng() % 18000), Real(rng() % 18000)) - Vector3(9000);
+    };
+
+    std::vector<OctreeNode*> nodes;
+    for (int i = 0; i < 200; i++)
+    {
+        ManualObject* mo = mSceneMgr->createManualObject();
+        Real size = i % 2 ? 5 : Real(rng() % 2000 + 1);
+        mo->setBoundingBox(AxisAlignedBox(Vector3(-size), Vector3(size)));
+        SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(randomPoint());
+        node->attachObject(mo);
+        nodes.push_back(static_cast<OctreeNode*>(node));
+    }
+
+    // the default looseness keeps the previous layout
+    Real looseness = 0;
+    EXPECT_TRUE(mSceneMgr->getOption("Looseness", &looseness));
+    EXPECT_EQ(looseness, 2);
+    mSceneMgr->_updateSceneGraph(camera);
+    for (OctreeNode* node : nodes)
+        EXPECT_EQ(node->getOctant()->mBox, getLooseness2Octant(node->_getWorldAABB()));
+
+    // nodes moved several times within a frame end up where they were placed from scratch,
+    // unless they are still within the culling bounds of their octant
+    std::vector<Octree*> octants;
+    for (OctreeNode* node : nodes)
+    {
+        octants.push_back(node->getOctant());
+        for (int i = 0; i < 3; i++)
+        {
+            node->setPosition(randomPoint());
+            node->_update(true, false);
+        }
+    }
+    mSceneMgr->_updateSceneGraph(camera);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        Octree* octant = nodes[i]->getOctant();
+        ASSERT_TRUE(octant);
+        AxisAlignedBox cullBounds = getCullBounds(octant);
+        EXPECT_TRUE(cullBounds.contains(nodes[i]->_getWorldAABB()));
+        // the small nodes always leave the small culling bounds of their octant
+        if (octant != octants[i] || i % 2)
+        {
+            EXPECT_EQ(octant->mBox, getLooseness2Octant(nodes[i]->_getWorldAABB()));
+        }
+    }
+
+    // a small node leaving its octant, but not the culling bounds, stays
+    OctreeNode* node = nodes[1];
+    Octree* octant = node->getOctant();
+    Vector3 center = node->_getWorldAABB().getCenter();
+    node->translate(center.x > octant->mBox.getCenter().x ? octant->mBox.getMaximum().x + 1 - center.x
+                                                          : octant->mBox.getMinimum().x - 1 - center.x,
+                    0, 0);
+    mSceneMgr->_updateSceneGraph(camera);
+    EXPECT_FALSE(octant->mBox.contains(node->_getWorldAABB().getCenter()));
+    EXPECT_EQ(node->getOctant(), octant);
+
+    // queries see the nodes which are still waiting for placement
+    Vector3 target = -node->getPosition();
+    node->setPosition(target);
+    node->_update(true, false);
+    std::list<SceneNode*> found;
+    mSceneMgr->findNodesIn(AxisAlignedBox(target - 10, target + 10), found);
+    EXPECT_NE(std::find(found.begin(), found.end(), node), found.end());
+    EXPECT_EQ(node->getOctant()->mBox, getLooseness2Octant(node->_getWorldAABB()));
+
+    // destroying waiting nodes does not affect the others
+    for (OctreeNode* n : nodes)
+    {
+        n->setPosition(randomPoint());
+        n->_update(true, false);
+    }
+    for (size_t i = 0; i < nodes.size(); i += 2)
+        static_cast<SceneManager*>(mSceneMgr)->destroySceneNode(nodes[i]);
+    mSceneMgr->_updateSceneGraph(camera);
+    for (size_t i = 1; i < nodes.size(); i += 2)
+        EXPECT_EQ(nodes[i]->getOctant()->mBox, getLooseness2Octant(nodes[i]->_getWorldAABB()));
+
+    // with a higher looseness every node still lies within the culling bounds of its octant
+    looseness = 3;
+    EXPECT_TRUE(mSceneMgr->setOption("Looseness", &looseness));
+    for (size_t i = 1; i < nodes.size(); i += 2)
+    {
+        ASSERT_TRUE(nodes[i]->getOctant());
+        AxisAlignedBox cullBounds = getCullBounds(nodes[i]->getOctant());
+        EXPECT_TRUE(cullBounds.contains(nodes[i]->_getWorldAABB()));
+    }
+}
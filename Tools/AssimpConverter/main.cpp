@@ -61,6 +61,8 @@ Available options:
                       longer time frame than the animation actually plays
 -max_edge_angle deg = When normals are generated, max angle between
                       two faces to smooth over
+-O                  = Optimise triangle order for vertex cache and overdraw
+                      and vertex order for fetch
 sourcefile          = name of file to convert
 destination         = optional name of directory to write to. If you don't
                       specify this the converter will use the same
@@ -93,6 +95,7 @@ AssOptions parseArgs(int numArgs, char** args)
 
     unOpt["-q"] = false;
     unOpt["-3ds_ani_fix"] = false;
+    unOpt["-O"] = false;
     binOpt["-log"] = opts.logFile;
     binOpt["-aniName"] = "";
     binOpt["-aniSpeedMod"] = "1.0";
@@ -108,6 +111,10 @@ AssOptions parseArgs(int numArgs, char** args)
     {
         opts.options.params |= AssimpLoader::LP_CUT_ANIMATION_WHERE_NO_FURTHER_CHANGE;
     }
+    if (unOpt["-O"])
+    {
+        opts.options.params |= AssimpLoader::LP_OPTIMISE_GEOMETRY;
+    }
 
     opts.options.postProcessSteps = aiProcessPreset_TargetRealtime_Quality;
     opts.logFile = binOpt["-log"];
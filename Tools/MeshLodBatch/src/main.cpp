@@ -0,0 +1,305 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreMeshLodGenerator.h"
+#include "OgreDistanceLodStrategy.h"
+#include "OgreLodConfig.h"
+
+#include <iostream>
+#include <fstream>
+
+using namespace std;
+using namespace Ogre;
+
+namespace {
+
+void help(void)
+{
+    cout <<
+R"HELP(Usage: OgreMeshLodBatch [opts] meshfile...
+
+  Generates the LOD levels of many .mesh files concurrently.
+
+-autogen       = Autoconfigure the LOD levels of each mesh (default)
+-l lodlevels   = number of LOD levels, instead of autoconfiguring them
+-d loddist     = distance increment to reduce LOD
+-p lodpercent  = Percentage vertex reduction amount per LOD
+-O             = Optimise triangle order for vertex cache after generating
+-j workers     = number of meshes processed in parallel (default: all cores)
+-m megabytes   = approximate memory budget of the meshes in flight
+                 (default: 0, which means no limit)
+-list filename = read further mesh files from a file, one per line
+-o directory   = write the meshes there instead of overwriting them
+-report file   = per mesh timing report in CSV format
+                 (default: 'OgreMeshLodBatch.csv')
+-log filename  = name of the log file (default: 'OgreMeshLodBatch.log')
+meshfile       = name of a file to generate the LOD levels for
+)HELP";
+}
+
+struct BatchOptions {
+    unsigned short numLods;
+    Real lodDist;
+    Real lodPercent;
+    bool optimise;
+    size_t workers;
+    size_t memoryBudget;
+    String listFile;
+    String outputDir;
+    String reportFile;
+    String logFile;
+};
+
+BatchOptions parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
+{
+    BatchOptions opts;
+    opts.numLods = StringConverter::parseInt(binOpts["-l"]);
+    opts.lodDist = StringConverter::parseReal(binOpts["-d"]);
+    opts.lodPercent = StringConverter::parseReal(binOpts["-p"]);
+    opts.optimise = unOpts["-O"];
+    opts.workers = StringConverter::parseSizeT(binOpts["-j"]);
+    opts.memoryBudget = StringConverter::parseSizeT(binOpts["-m"]) * 1024 * 1024;
+    opts.listFile = binOpts["-list"];
+    opts.outputDir = binOpts["-o"];
+    opts.reportFile = binOpts["-report"];
+    opts.logFile = binOpts["-log"];
+
+    // -autogen wins over manual settings
+    if (unOpts["-autogen"]) {
+        opts.numLods = 0;
+    }
+    return opts;
+}
+
+struct MeshResourceCreator : public MeshSerializerListener
+{
+    void processMaterialName(Mesh *mesh, String *name)
+    {
+        if (name->empty()) {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "The provided mesh file has an empty material name");
+        }
+        // create material because we do not load any .material files
+        MaterialManager::getSingleton().createOrRetrieve(*name, mesh->getGroup());
+    }
+
+    void processSkeletonName(Mesh *mesh, String *name)
+    {
+        if (name->empty()) {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "The provided mesh file uses an empty skeleton name");
+        }
+        // create skeleton because we do not load any .skeleton files
+        SkeletonManager::getSingleton().createOrRetrieve(*name, mesh->getGroup(), true);
+    }
+    void processMeshCompleted(Mesh *mesh) {}
+};
+
+/// Loads the meshes when the generator is ready for them and writes them out right after.
+class MeshFileBatchListener : public MeshLodGenerator::BatchListener
+{
+    const StringVector& mFiles;
+    const BatchOptions& mOpts;
+    MeshSerializer mSerializer;
+    MeshResourceCreator mResourceCreator;
+public:
+    MeshFileBatchListener(const StringVector& files, const BatchOptions& opts) : mFiles(files), mOpts(opts)
+    {
+        mSerializer.setListener(&mResourceCreator);
+    }
+
+    MeshPtr loadMesh(size_t index) override
+    {
+        const String& file = mFiles[index];
+        DataStreamPtr stream = Root::openFileStream(file);
+        MeshPtr mesh = MeshManager::getSingleton().createManual(file, RGN_DEFAULT);
+        try {
+            mSerializer.importMesh(stream, mesh.get());
+        } catch (...) {
+            MeshManager::getSingleton().remove(mesh);
+            throw;
+        }
+        if (mesh->getNumLodLevels() > 1) {
+            LogManager::getSingleton().logMessage("Replacing the existing LOD levels of " + file);
+            mesh->removeLodLevels();
+        }
+        return mesh;
+    }
+
+    void meshCompleted(size_t index, const MeshPtr& mesh, const MeshLodGenerator::BatchResult& result) override
+    {
+        if (!mesh) {
+            LogManager::getSingleton().logError(mFiles[index] + ": " + result.error);
+            return;
+        }
+        if (result.error.empty()) {
+            String dest = mFiles[index];
+            if (!mOpts.outputDir.empty()) {
+                String baseName, path;
+                StringUtil::splitFilename(dest, baseName, path);
+                dest = StringUtil::standardisePath(mOpts.outputDir) + baseName;
+            }
+            mSerializer.exportMesh(mesh.get(), dest);
+            LogManager::getSingleton().stream()
+                << dest << ": " << mesh->getNumLodLevels() - 1 << " LOD levels in "
+                << result.prepareTime + result.processTime + result.injectTime << " ms";
+        } else {
+            LogManager::getSingleton().logError(mFiles[index] + ": " + result.error);
+        }
+        MeshManager::getSingleton().remove(mesh);
+    }
+};
+
+void writeReport(const String& filename, const StringVector& files, const MeshLodGenerator::BatchResultList& results)
+{
+    std::ofstream report(filename.c_str());
+    if (!report) {
+        OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE, "Cannot write report " + filename);
+    }
+    report << "mesh,prepare_ms,process_ms,inject_ms,lod_vertex_counts,error\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const MeshLodGenerator::BatchResult& result = results[i];
+        report << files[i] << ',' << result.prepareTime << ',' << result.processTime << ','
+               << result.injectTime << ',';
+        for (size_t n = 0; n < result.levels.size(); n++) {
+            report << (n ? " " : "") << (result.levels[n].outSkipped ? 0 : result.levels[n].outUniqueVertexCount);
+        }
+        String error = result.error;
+        StringUtil::trim(error);
+        std::replace(error.begin(), error.end(), '\n', ' ');
+        std::replace(error.begin(), error.end(), ',', ';');
+        report << ',' << error << '\n';
+    }
+}
+}
+
+int main(int numargs, char** args)
+{
+    if (numargs < 2) {
+        help();
+        return -1;
+    }
+
+    int retCode = 0;
+
+    LogManager logMgr;
+    // this log catches output from the parseArgs call and routes it to stdout only
+    logMgr.createLog("Temporary log", true, true, true);
+
+    try
+    {
+        UnaryOptionList unOptList;
+        BinaryOptionList binOptList;
+
+        unOptList["-autogen"] = false;
+        unOptList["-O"] = false;
+        binOptList["-l"] = "0";
+        binOptList["-d"] = "500";
+        binOptList["-p"] = "20";
+        binOptList["-j"] = "0";
+        binOptList["-m"] = "0";
+        binOptList["-list"] = "";
+        binOptList["-o"] = "";
+        binOptList["-report"] = "OgreMeshLodBatch.csv";
+        binOptList["-log"] = "OgreMeshLodBatch.log";
+
+        int startIdx = findCommandLineOpts(numargs, args, unOptList, binOptList);
+        BatchOptions opts = parseOpts(unOptList, binOptList);
+
+        StringVector files;
+        for (int i = startIdx; i < numargs; i++) {
+            files.push_back(args[i]);
+        }
+        if (!opts.listFile.empty()) {
+            std::ifstream list(opts.listFile.c_str());
+            if (!list) {
+                OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "File " + opts.listFile + " not found.");
+            }
+            String line;
+            while (std::getline(list, line)) {
+                StringUtil::trim(line);
+                if (!line.empty()) {
+                    files.push_back(line);
+                }
+            }
+        }
+        if (files.empty()) {
+            help();
+            return -1;
+        }
+
+        logMgr.setDefaultLog(NULL); // swallow startup messages
+        Root root("", "", "");
+        // get rid of the temporary log as we use the new log now
+        logMgr.destroyLog("Temporary log");
+
+        // use the log specified by the cmdline params
+        logMgr.setDefaultLog(logMgr.createLog(opts.logFile, true, true));
+
+        MaterialManager::getSingleton().initialise();
+        DefaultHardwareBufferManager bufferManager; // needed because we don't have a rendersystem
+        // keep the bounds the mesh was exported with
+        MeshManager::getSingleton().setBoundsPaddingFactor(0.0f);
+
+        // Without levels, every mesh gets autoconfigured
+        LodConfig lodTemplate;
+        lodTemplate.strategy = DistanceLodBoxStrategy::getSingletonPtr();
+        lodTemplate.advanced.optimiseVertexCache = opts.optimise;
+        LodLevel lodLevel = {};
+        lodLevel.reductionMethod = LodLevel::VRM_PROPORTIONAL;
+        for (unsigned short i = 0; i < opts.numLods; ++i) {
+            lodLevel.reductionValue += opts.lodPercent * 0.01f;
+            lodLevel.distance += opts.lodDist;
+            lodTemplate.levels.push_back(lodLevel);
+        }
+
+        MeshFileBatchListener listener(files, opts);
+        MeshLodGenerator::BatchResultList results;
+        Timer timer;
+        MeshLodGenerator().generateBatchLodLevels(files.size(), &listener, lodTemplate, results,
+                                                  opts.workers, opts.memoryBudget);
+
+        size_t failed = 0;
+        for (const MeshLodGenerator::BatchResult& result : results) {
+            failed += !result.error.empty();
+        }
+        logMgr.stream() << "Processed " << files.size() << " meshes in " << timer.getMilliseconds()
+                        << " ms, " << failed << " failed";
+        writeReport(opts.reportFile, files, results);
+        retCode = failed ? 1 : 0;
+
+        logMgr.setDefaultLog(NULL); // swallow shutdown messages
+    }
+    catch (Exception& e)
+    {
+        LogManager::getSingleton().logError(e.getDescription());
+        retCode = 1;
+    }
+
+    return retCode;
+}
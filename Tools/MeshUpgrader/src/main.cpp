@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreLodStrategyManager.h"
 #include "OgrePixelCountLodStrategy.h"
 #include "OgreLodConfig.h"
+#include "OgreMeshOptimiser.h"
 
 #include <iostream>
 #include <sys/stat.h>
@@ -51,6 +52,8 @@ R"HELP(Usage: OgreMeshUpgrader [opts] sourcefile [destfile]
 
 -i             = Interactive mode, prompt for options
 -pack          = Pack normals and tangents as int_10_10_10_2
+-O             = Optimise triangle order for vertex cache and overdraw
+                 and vertex order for fetch, reports ACMR/ATVR
 -autogen       = Generate autoconfigured LOD. No LOD options needed
 -l lodlevels   = number of LOD levels
 -d loddist     = distance increment to reduce LOD
@@ -68,6 +71,10 @@ R"HELP(Usage: OgreMeshUpgrader [opts] sourcefile [destfile]
 -b             = Recalculate bounding box (static meshes only)
 -V version     = Specify OGRE version format to write instead of latest
                  Options are: 1.10, 1.8, 1.7, 1.4, 1.0
+                 or 'mapped' for the 1.10 layout with aligned buffer
+                 blobs that are uploaded without parsing
+                 or 'compressed' for the 1.10 layout with quantized and
+                 deflated buffers (lossy)
 -log filename  = name of the log file (default: 'OgreMeshUpgrader.log')
 sourcefile     = name of file to convert
 destfile       = optional name of file to write to. If you don't
@@ -86,6 +93,7 @@ struct UpgradeOptions {
     bool dontReorganise;
     bool lodAutoconfigure;
     bool packNormalsTangents;
+    bool optimise;
     unsigned short numLods;
     Real lodDist;
     Real lodPercent;
@@ -113,6 +121,7 @@ UpgradeOptions parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     opts.endian = Serializer::ENDIAN_NATIVE;
 
     opts.packNormalsTangents = false;
+    opts.optimise = false;
 
     opts.lodAutoconfigure = false;
     opts.lodDist = 500;
@@ -131,6 +140,7 @@ UpgradeOptions parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     opts.interactive = unOpts["-i"];
     opts.dontReorganise = unOpts["-r"];
     opts.packNormalsTangents = unOpts["-pack"];
+    opts.optimise = unOpts["-O"];
 
     // Unary options (true/false options that don't take a parameter)
     if (unOpts["-b"]) {
@@ -196,6 +206,10 @@ UpgradeOptions parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
     if (!bi->second.empty()) {
         if (bi->second == "1.10") {
             opts.targetVersion = MESH_VERSION_1_10;
+        } else if (bi->second == "mapped") {
+            opts.targetVersion = MESH_VERSION_1_10_MAPPED;
+        } else if (bi->second == "compressed") {
+            opts.targetVersion = MESH_VERSION_1_10_COMPRESSED;
         } else if (bi->second == "1.8") {
             opts.targetVersion = MESH_VERSION_1_8;
         } else if (bi->second == "1.7") {
@@ -921,6 +935,7 @@ int main(int numargs, char** args)
         unOptList["-byte"] = true; // this is the only option now, dont error if specified
         unOptList["-autogen"] = false;
         unOptList["-pack"] = false;
+        unOptList["-O"] = false;
         unOptList["-b"] = false;
         binOptList["-l"] = "";
         binOptList["-d"] = "";
@@ -1073,6 +1088,11 @@ int main(int numargs, char** args)
             }
         }
 
+        if (opts.optimise) {
+            logMgr.logMessage("Optimising vertex cache, overdraw and vertex fetch...");
+            MeshOptimiser().optimise(mesh);
+        }
+
         if(opts.packNormalsTangents)
         {
             mesh->_convertVertexElement(VES_NORMAL, VET_INT_10_10_10_2_NORM);